@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+//
+//	ozw_config_bundle.cpp
+//
+//	Compile the config directory into a config.ozwb bundle
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include "ConfigBundle.h"
+#include "platform/Log.h"
+
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// <IsXML>
+// Files we put in the bundle
+//-----------------------------------------------------------------------------
+static bool IsXML(string const& _name)
+{
+	return (_name.size() > 4) && (_name.compare(_name.size() - 4, 4, ".xml") == 0);
+}
+
+//-----------------------------------------------------------------------------
+// <FindFiles>
+// Collect the XML files under _dir (relative to the config directory)
+//-----------------------------------------------------------------------------
+static void FindFiles(string const& _configPath, string const& _dir, vector<string>* _names)
+{
+	DIR* dir = opendir((_configPath + _dir).c_str());
+	if (!dir)
+	{
+		return;
+	}
+	while (struct dirent* entry = readdir(dir))
+	{
+		string name = entry->d_name;
+		if (name[0] == '.')
+		{
+			continue;
+		}
+		string path = _dir + name;
+		struct stat st;
+		if (stat((_configPath + path).c_str(), &st) != 0)
+		{
+			continue;
+		}
+		if (S_ISDIR(st.st_mode))
+		{
+			FindFiles(_configPath, path + "/", _names);
+		}
+		else if (IsXML(name))
+		{
+			// The options are the user's to edit, and the template is not a device
+			if (_dir.empty() && (name == "options.xml" || name == "config-template.xml"))
+			{
+				continue;
+			}
+			_names->push_back(path);
+		}
+	}
+	closedir(dir);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <config directory> <bundle file>\n", argv[0]);
+		return 1;
+	}
+
+	string configPath = argv[1];
+	if (configPath.empty() || configPath[configPath.size() - 1] != '/')
+	{
+		configPath += "/";
+	}
+
+	// Warnings about files that cannot be bundled go to the console
+	OpenZWave::Log::Create("", false, true, OpenZWave::LogLevel_Info, OpenZWave::LogLevel_Info, OpenZWave::LogLevel_None);
+
+	vector<string> names;
+	FindFiles(configPath, "", &names);
+	if (names.empty())
+	{
+		fprintf(stderr, "No config files found in %s\n", configPath.c_str());
+		OpenZWave::Log::Destroy();
+		return 1;
+	}
+
+	bool ok = OpenZWave::Internal::ConfigBundle::Write(configPath, names, argv[2]);
+	OpenZWave::Log::Destroy();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+//-----------------------------------------------------------------------------
+//
+//	AESKey.cpp
+//
+//	AES-128 key with a precomputed schedule and hardware accelerated encryption
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "AESKey.h"
+#include "platform/Log.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OZW_AES_NI
+#include <cpuid.h>
+#include <wmmintrin.h>
+#define OZW_AES_TARGET __attribute__((target("aes,sse2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define OZW_AES_NI
+#include <intrin.h>
+#include <wmmintrin.h>
+#define OZW_AES_TARGET
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#define OZW_AES_ARMV8
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		static bool s_hardwareEnabled = true;
+
+#if defined(OZW_AES_NI)
+		static bool CPUHasAES()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 25)) != 0;
+#else
+			unsigned int eax, ebx, ecx, edx;
+			if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			{
+				return false;
+			}
+			return (ecx & bit_AES) != 0;
+#endif
+		}
+
+		OZW_AES_TARGET static void HardwareEncryptBlock(uint8 const* _roundKeys, uint8 const* _in, uint8* _out)
+		{
+			__m128i state = _mm_xor_si128(_mm_loadu_si128((__m128i const*) _in), _mm_loadu_si128((__m128i const*) _roundKeys));
+			for (int round = 1; round < 10; ++round)
+			{
+				state = _mm_aesenc_si128(state, _mm_loadu_si128((__m128i const*) (_roundKeys + 16 * round)));
+			}
+			state = _mm_aesenclast_si128(state, _mm_loadu_si128((__m128i const*) (_roundKeys + 160)));
+			_mm_storeu_si128((__m128i*) _out, state);
+		}
+
+		static char const* const c_hardwareName = "AES-NI";
+#elif defined(OZW_AES_ARMV8)
+		static bool CPUHasAES()
+		{
+#if defined(__linux__) && defined(HWCAP_AES)
+			return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+			// Built for a CPU with the Cryptography Extensions
+			return true;
+#endif
+		}
+
+		static void HardwareEncryptBlock(uint8 const* _roundKeys, uint8 const* _in, uint8* _out)
+		{
+			uint8x16_t state = vld1q_u8(_in);
+			for (int round = 0; round < 9; ++round)
+			{
+				state = vaesmcq_u8(vaeseq_u8(state, vld1q_u8(_roundKeys + 16 * round)));
+			}
+			state = vaeseq_u8(state, vld1q_u8(_roundKeys + 144));
+			state = veorq_u8(state, vld1q_u8(_roundKeys + 160));
+			vst1q_u8(_out, state);
+		}
+
+		static char const* const c_hardwareName = "ARMv8 Crypto Extensions";
+#endif
+
+//-----------------------------------------------------------------------------
+// <HardwareAvailable>
+// Check once whether this CPU can run the hardware implementation
+//-----------------------------------------------------------------------------
+		static bool HardwareAvailable()
+		{
+#if defined(OZW_AES_NI) || defined(OZW_AES_ARMV8)
+			static bool s_available = CPUHasAES();
+			return s_available && s_hardwareEnabled;
+#else
+			return false;
+#endif
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::AESKey>
+// Constructor
+//-----------------------------------------------------------------------------
+		AESKey::AESKey() :
+				m_hardware(false)
+		{
+			memset(&m_ctx, 0, sizeof(m_ctx));
+			memset(m_roundKeys, 0, sizeof(m_roundKeys));
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::SetKey>
+// Expand a new key
+//-----------------------------------------------------------------------------
+		bool AESKey::SetKey(uint8 const _key[16])
+		{
+			m_hardware = false;
+			if (aes_encrypt_key128(_key, &m_ctx) == EXIT_FAILURE)
+			{
+				return false;
+			}
+			if (!HardwareAvailable())
+			{
+				return true;
+			}
+
+			// The portable schedule holds each 4 byte column as a little endian word
+			for (int i = 0; i < 44; ++i)
+			{
+				uint32 word = m_ctx.ks[i];
+				m_roundKeys[4 * i] = (uint8) (word & 0xff);
+				m_roundKeys[4 * i + 1] = (uint8) ((word >> 8) & 0xff);
+				m_roundKeys[4 * i + 2] = (uint8) ((word >> 16) & 0xff);
+				m_roundKeys[4 * i + 3] = (uint8) ((word >> 24) & 0xff);
+			}
+
+#if defined(OZW_AES_NI) || defined(OZW_AES_ARMV8)
+			// Only trust the hardware path if it agrees with the portable one
+			uint8 block[16];
+			uint8 portable[16];
+			uint8 hardware[16];
+			for (int i = 0; i < 16; ++i)
+			{
+				block[i] = (uint8) (i * 17);
+			}
+			aes_encrypt(block, portable, &m_ctx);
+			HardwareEncryptBlock(m_roundKeys, block, hardware);
+			if (memcmp(portable, hardware, 16) != 0)
+			{
+				Log::Write(LogLevel_Warning, "AESKey: %s result does not match the portable AES implementation, not using it", c_hardwareName);
+				return true;
+			}
+			m_hardware = true;
+#endif
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::EncryptBlock>
+// Encrypt one block
+//-----------------------------------------------------------------------------
+		void AESKey::EncryptBlock(uint8 const _in[16], uint8 _out[16]) const
+		{
+#if defined(OZW_AES_NI) || defined(OZW_AES_ARMV8)
+			if (m_hardware)
+			{
+				HardwareEncryptBlock(m_roundKeys, _in, _out);
+				return;
+			}
+#endif
+			aes_encrypt(_in, _out, &m_ctx);
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::OFB>
+// Output Feedback mode, which is the same for encryption and decryption
+//-----------------------------------------------------------------------------
+		void AESKey::OFB(uint8 const* _in, uint8* _out, uint32 _length, uint8 const _iv[16]) const
+		{
+			uint8 stream[16];
+			memcpy(stream, _iv, 16);
+			for (uint32 pos = 0; pos < _length; pos += 16)
+			{
+				EncryptBlock(stream, stream);
+				for (uint32 i = 0; (i < 16) && (pos + i < _length); ++i)
+				{
+					_out[pos + i] = _in[pos + i] ^ stream[i];
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::CBCMAC>
+// Chain the zero padded data through the cipher
+//-----------------------------------------------------------------------------
+		void AESKey::CBCMAC(uint8 const* _data, uint32 _length, uint8 const _iv[16], uint8 _mac[16]) const
+		{
+			EncryptBlock(_iv, _mac);
+			for (uint32 pos = 0; pos < _length; pos += 16)
+			{
+				for (uint32 i = 0; (i < 16) && (pos + i < _length); ++i)
+				{
+					_mac[i] ^= _data[pos + i];
+				}
+				EncryptBlock(_mac, _mac);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::GetBackendName>
+// Which implementation new keys will use
+//-----------------------------------------------------------------------------
+		char const* AESKey::GetBackendName()
+		{
+#if defined(OZW_AES_NI) || defined(OZW_AES_ARMV8)
+			if (HardwareAvailable())
+			{
+				return c_hardwareName;
+			}
+#endif
+			return "Portable";
+		}
+
+//-----------------------------------------------------------------------------
+// <AESKey::SetHardwareEnabled>
+// Allow or prevent the hardware implementation
+//-----------------------------------------------------------------------------
+		void AESKey::SetHardwareEnabled(bool _enabled)
+		{
+			s_hardwareEnabled = _enabled;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------
+//
+//	AESKey.h
+//
+//	AES-128 key with a precomputed schedule and hardware accelerated encryption
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _AESKey_H
+#define _AESKey_H
+
+#include "Defs.h"
+#include "aes/aescpp.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief An AES-128 encryption key, expanded once when it is set.
+		 *
+		 * Blocks are encrypted with AES-NI or the ARMv8 Cryptography Extensions
+		 * when the library was built for a CPU family that has them and the CPU
+		 * we are running on supports them.  Otherwise (or if the hardware result
+		 * does not match the portable implementation for the key) the Brian
+		 * Gladman code in cpp/src/aes is used.
+		 */
+		class AESKey
+		{
+			public:
+				AESKey();
+
+				/**
+				 * Set the 16 byte key and precompute its schedule.
+				 */
+				bool SetKey(uint8 const _key[16]);
+
+				/**
+				 * Encrypt a single 16 byte block (ECB).  _in and _out may be the same buffer.
+				 */
+				void EncryptBlock(uint8 const _in[16], uint8 _out[16]) const;
+
+				/**
+				 * Encrypt or decrypt _length bytes in Output Feedback mode.  Unlike
+				 * aes_ofb_encrypt, _iv is left untouched.
+				 */
+				void OFB(uint8 const* _in, uint8* _out, uint32 _length, uint8 const _iv[16]) const;
+
+				/**
+				 * CBC-MAC of _data, zero padded to a whole number of blocks, starting
+				 * from the encrypted _iv.  This is the S0 message authentication code
+				 * (of which only the first 8 bytes are used).
+				 */
+				void CBCMAC(uint8 const* _data, uint32 _length, uint8 const _iv[16], uint8 _mac[16]) const;
+
+				/**
+				 * Name of the implementation new keys will use.
+				 */
+				static char const* GetBackendName();
+
+				/**
+				 * Allow or prevent the use of the hardware implementation for keys
+				 * set from now on.  Used to compare the two implementations.
+				 */
+				static void SetHardwareEnabled(bool _enabled);
+
+			private:
+				aes_encrypt_ctx m_ctx;
+				uint8 m_roundKeys[176];		// The schedule in FIPS-197 byte order, for the hardware implementations
+				bool m_hardware;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+//
+//	AirtimeCounter.cpp
+//
+//	Radio airtime used, in total and over the last minute and hour
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "AirtimeCounter.h"
+
+namespace OpenZWave
+{
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::AirtimeCounter>
+// Constructor
+//-----------------------------------------------------------------------------
+	AirtimeCounter::AirtimeCounter()
+	{
+		Reset();
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::Reset>
+// Clear the total and the windows
+//-----------------------------------------------------------------------------
+	void AirtimeCounter::Reset()
+	{
+		memset(m_seconds, 0, sizeof(m_seconds));
+		memset(m_minutes, 0, sizeof(m_minutes));
+		m_total = 0;
+		m_frames = 0;
+		m_second = 0;
+		m_minute = 0;
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::AdvanceRing>
+// Clear the buckets of a ring that are being reused for a new slot
+//-----------------------------------------------------------------------------
+	void AirtimeCounter::AdvanceRing(uint16* _ring, uint32* _last, uint32 _slot)
+	{
+		// A slot behind the last one only happens when the 49 day clock wraps,
+		// and is treated like a long gap
+		uint32 gap = _slot - *_last;
+		if (gap >= c_windowBuckets)
+		{
+			memset(_ring, 0, c_windowBuckets * sizeof(uint16));
+		}
+		else
+		{
+			for (uint32 i = 1; i <= gap; ++i)
+			{
+				_ring[(*_last + i) % c_windowBuckets] = 0;
+			}
+		}
+		*_last = _slot;
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::Advance>
+// Expire the airtime that has left the windows
+//-----------------------------------------------------------------------------
+	void AirtimeCounter::Advance(uint32 _now)
+	{
+		AdvanceRing(m_seconds, &m_second, _now / 1000);
+		AdvanceRing(m_minutes, &m_minute, _now / 60000);
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::Record>
+// Count the airtime of one frame
+//-----------------------------------------------------------------------------
+	void AirtimeCounter::Record(uint32 _now, uint32 _ms)
+	{
+		Advance(_now);
+		m_total += _ms;
+		++m_frames;
+
+		// A bucket can not fill with more airtime than it has time, but the
+		// reported times are only as good as the controller's
+		uint16* second = &m_seconds[m_second % c_windowBuckets];
+		*second = (uint16) ((*second + _ms > 0xffff) ? 0xffff : *second + _ms);
+		uint16* minute = &m_minutes[m_minute % c_windowBuckets];
+		*minute = (uint16) ((*minute + _ms > 0xffff) ? 0xffff : *minute + _ms);
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::GetLastMinute>
+// Airtime in the last 60 seconds
+//-----------------------------------------------------------------------------
+	uint32 AirtimeCounter::GetLastMinute() const
+	{
+		uint32 total = 0;
+		for (uint32 i = 0; i < c_windowBuckets; ++i)
+		{
+			total += m_seconds[i];
+		}
+		return total;
+	}
+
+//-----------------------------------------------------------------------------
+// <AirtimeCounter::GetLastHour>
+// Airtime in the last 60 minutes
+//-----------------------------------------------------------------------------
+	uint32 AirtimeCounter::GetLastHour() const
+	{
+		uint32 total = 0;
+		for (uint32 i = 0; i < c_windowBuckets; ++i)
+		{
+			total += m_minutes[i];
+		}
+		return total;
+	}
+} // namespace OpenZWave
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------
+//
+//	AirtimeCounter.h
+//
+//	Radio airtime used, in total and over the last minute and hour
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _AirtimeCounter_H
+#define _AirtimeCounter_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Radio airtime in milliseconds, for the node and driver statistics.
+	 *
+	 * The airtime of each frame is the transmit time the controller reports in
+	 * the status of a Send Data request, so it includes routing through
+	 * repeaters, and every attempt of a message that was retried is counted.
+	 * Besides the total since the driver started, the airtime of the last
+	 * minute (to the second) and of the last hour (to the minute) is kept in
+	 * two rings of buckets.  The buckets are expired as time moves on, by
+	 * Record and by Advance, so a copy should be advanced to the current time
+	 * before the windows are read from it.
+	 */
+	class OPENZWAVE_EXPORT AirtimeCounter
+	{
+		public:
+			AirtimeCounter();
+
+			/**
+			 * Count the airtime of one frame.
+			 * \param _now The time the frame was sent, in milliseconds on the driver's clock.
+			 * \param _ms The airtime of the frame.
+			 */
+			void Record(uint32 _now, uint32 _ms);
+
+			/**
+			 * Move the windows on to _now, dropping the airtime that has left them.
+			 */
+			void Advance(uint32 _now);
+
+			/**
+			 * Forget everything that has been counted.
+			 */
+			void Reset();
+
+			uint64 GetTotal() const
+			{
+				return m_total;
+			}
+			uint32 GetFrames() const
+			{
+				return m_frames;
+			}
+			uint32 GetLastMinute() const;
+			uint32 GetLastHour() const;
+
+			static uint32 const c_windowBuckets = 60;
+
+		private:
+			static void AdvanceRing(uint16* _ring, uint32* _last, uint32 _slot);
+
+			uint64 m_total;
+			uint32 m_frames;
+			uint32 m_second;									// The second m_seconds was last advanced to
+			uint32 m_minute;									// The minute m_minutes was last advanced to
+			uint16 m_seconds[c_windowBuckets];					// Airtime in each of the last 60 seconds
+			uint16 m_minutes[c_windowBuckets];					// Airtime in each of the last 60 minutes
+	};
+} // namespace OpenZWave
+
+#endif
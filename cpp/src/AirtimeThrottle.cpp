@@ -0,0 +1,165 @@
+//-----------------------------------------------------------------------------
+//
+//	AirtimeThrottle.cpp
+//
+//	Token bucket that limits the airtime of background traffic
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "AirtimeThrottle.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		// The rate is never halved more than this many times
+		static uint32 const c_maxLevel = 4;
+
+		// Busy reports closer together than this (ms) only halve the rate once
+		static uint32 const c_backoffHold = 2000;
+
+		// The rate doubles again after this long (ms) without a busy report
+		static uint32 const c_recoverTime = 30000;
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::AirtimeThrottle>
+// Constructor
+//-----------------------------------------------------------------------------
+		AirtimeThrottle::AirtimeThrottle() :
+				m_tokens(0), m_capacity(0), m_rate(0), m_level(0), m_lastRefill(0), m_lastChange(0), m_lastBackoff(0), m_exhausted(0), m_backoffs(0)
+		{
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::Configure>
+// Set the share of the airtime and the burst, and start with a full bucket
+//-----------------------------------------------------------------------------
+		void AirtimeThrottle::Configure(uint32 _percent, uint32 _burstMs)
+		{
+			if (_percent > 100)
+			{
+				_percent = 100;
+			}
+			m_rate = _percent * 10;
+			m_capacity = (int64) _burstMs * 1000;
+			m_tokens = m_capacity;
+			m_level = 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::GetRate>
+// The rate after backing off, which never drops to nothing
+//-----------------------------------------------------------------------------
+		uint32 AirtimeThrottle::GetRate() const
+		{
+			uint32 rate = m_rate >> m_level;
+			return rate ? rate : 1;
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::Refill>
+// Add the airtime earned since the last refill
+//-----------------------------------------------------------------------------
+		void AirtimeThrottle::Refill(uint32 _now)
+		{
+			if ((m_level > 0) && (_now - m_lastChange >= c_recoverTime))
+			{
+				--m_level;
+				m_lastChange = _now;
+			}
+			m_tokens += (int64) (_now - m_lastRefill) * GetRate();
+			if (m_tokens > m_capacity)
+			{
+				m_tokens = m_capacity;
+			}
+			m_lastRefill = _now;
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::Charge>
+// Take the airtime of a frame from the bucket
+//-----------------------------------------------------------------------------
+		void AirtimeThrottle::Charge(uint32 _now, uint32 _ms)
+		{
+			if (!IsEnabled())
+			{
+				return;
+			}
+			Refill(_now);
+			bool wasAvailable = (m_tokens > 0);
+			m_tokens -= (int64) _ms * 1000;
+			if (wasAvailable && (m_tokens <= 0))
+			{
+				++m_exhausted;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::Backoff>
+// Halve the rate, and pause the throttled queues
+//-----------------------------------------------------------------------------
+		void AirtimeThrottle::Backoff(uint32 _now)
+		{
+			if (!IsEnabled())
+			{
+				return;
+			}
+			Refill(_now);
+			if ((m_backoffs != 0) && (_now - m_lastBackoff < c_backoffHold))
+			{
+				return;
+			}
+			if (m_level < c_maxLevel)
+			{
+				++m_level;
+			}
+			m_lastChange = _now;
+			m_lastBackoff = _now;
+			++m_backoffs;
+
+			// Empty the bucket far enough that the queues pause for the hold time
+			int64 pause = -(int64) c_backoffHold * GetRate();
+			if (m_tokens > pause)
+			{
+				m_tokens = pause;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AirtimeThrottle::GetWait>
+// How long until the bucket has airtime in it again
+//-----------------------------------------------------------------------------
+		int32 AirtimeThrottle::GetWait(uint32 _now)
+		{
+			if (!IsEnabled())
+			{
+				return 0;
+			}
+			Refill(_now);
+			if (m_tokens > 0)
+			{
+				return 0;
+			}
+			return (int32) (-m_tokens / GetRate()) + 1;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
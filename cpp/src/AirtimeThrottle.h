@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+//
+//	AirtimeThrottle.h
+//
+//	Token bucket that limits the airtime of background traffic
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _AirtimeThrottle_H
+#define _AirtimeThrottle_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief An airtime budget for the Poll and Query queues.
+		 *
+		 * A token bucket, in microseconds of airtime, that fills at a share of
+		 * real time (ThrottleAirtimePercent) up to ThrottleAirtimeBurst.  Each
+		 * frame sent from a throttled queue takes the airtime the controller
+		 * reported for it, or an estimate if it did not, and the queues are not
+		 * served while the bucket is empty.  The bucket may go below empty, as a
+		 * frame's airtime is only known once it has been sent.
+		 *
+		 * When the network reports it is busy the throttled queues pause for 2
+		 * seconds and the rate is halved (down to a sixteenth).  It doubles again
+		 * for every 30 seconds without a busy report.  The driver's own thread is the only one to use it.
+		 */
+		class AirtimeThrottle
+		{
+			public:
+				AirtimeThrottle();
+
+				/**
+				 * Set the budget.
+				 * \param _percent Share of the airtime the throttled queues may use (0 disables the throttle).
+				 * \param _burstMs Airtime the throttled queues may use at once, after being idle.
+				 */
+				void Configure(uint32 _percent, uint32 _burstMs);
+
+				bool IsEnabled() const
+				{
+					return m_rate != 0;
+				}
+
+				/**
+				 * Take a frame's airtime from the bucket.
+				 */
+				void Charge(uint32 _now, uint32 _ms);
+
+				/**
+				 * The network reported it is busy, so slow down.
+				 */
+				void Backoff(uint32 _now);
+
+				/**
+				 * Milliseconds until the throttled queues may send again (0 if they may send now).
+				 */
+				int32 GetWait(uint32 _now);
+
+				uint32 GetExhausted() const
+				{
+					return m_exhausted;
+				}
+				uint32 GetBackoffs() const
+				{
+					return m_backoffs;
+				}
+
+			private:
+				void Refill(uint32 _now);
+				uint32 GetRate() const;
+
+				int64 m_tokens;						// Microseconds of airtime available
+				int64 m_capacity;					// Most the bucket holds
+				uint32 m_rate;						// Microseconds of airtime added per millisecond (per mille of real time)
+				uint32 m_level;						// How many times the rate has been halved
+				uint32 m_lastRefill;				// Driver clock of the last refill (ms)
+				uint32 m_lastChange;				// Driver clock of the last change of m_level (ms)
+				uint32 m_lastBackoff;				// Driver clock of the last busy report that halved the rate (ms)
+				uint32 m_exhausted;					// Times the bucket was emptied
+				uint32 m_backoffs;					// Times the rate was halved
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
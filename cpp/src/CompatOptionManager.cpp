@@ -81,7 +81,9 @@ namespace OpenZWave
 		{ "TimeOutMins", STATE_FLAG_DOORLOCK_TIMEOUTMINS, COMPAT_FLAG_TYPE_BYTE },
 		{ "TImeOutSecs", STATE_FLAG_DOORLOCK_TIMEOUTSECS, COMPAT_FLAG_TYPE_BYTE },
 		{ "MaxRecords", STATE_FLAG_DOORLOCKLOG_MAXRECORDS, COMPAT_FLAG_TYPE_BYTE },
-		{ "Count", STATE_FLAG_USERCODE_COUNT, COMPAT_FLAG_TYPE_BYTE } };
+		{ "Count", STATE_FLAG_USERCODE_COUNT, COMPAT_FLAG_TYPE_BYTE },
+		{ "ChecksumSupported", STATE_FLAG_USERCODE_CHECKSUM, COMPAT_FLAG_TYPE_BOOL },
+		{ "ParamsDiscovered", STATE_FLAG_CONFIG_DISCOVERED, COMPAT_FLAG_TYPE_BOOL } };
 
 		uint16_t availableDiscoveryFlagsCount = sizeof(availableDiscoveryFlags) / sizeof(availableDiscoveryFlags[0]);
 
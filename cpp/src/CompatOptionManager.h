@@ -85,6 +85,8 @@ namespace OpenZWave
 			STATE_FLAG_DOORLOCK_TIMEOUTSECS,
 			STATE_FLAG_DOORLOCKLOG_MAXRECORDS,
 			STATE_FLAG_USERCODE_COUNT,
+			STATE_FLAG_USERCODE_CHECKSUM,
+			STATE_FLAG_CONFIG_DISCOVERED,
 		};
 
 		enum CompatOptionFlagType
@@ -0,0 +1,582 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigBundle.cpp
+//
+//	The config directory compiled into a single file
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <map>
+#include "ConfigBundle.h"
+#include "Options.h"
+#include "tinyxml.h"
+#include "platform/Log.h"
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/*
+		 * File layout.  All numbers are 32 bit little endian.
+		 *
+		 *	Header (32 bytes):
+		 *		"OZWCFGB1", format version, entry count, index offset,
+		 *		string table offset, string table size, file size
+		 *	Index (24 bytes per file, sorted by name):
+		 *		name, data offset, data size, XML file size, revision, flags
+		 *	String table:
+		 *		NUL terminated strings, each stored once.  Names, attributes and
+		 *		text all refer to them by their offset in the table.
+		 *	Data:
+		 *		The nodes of each document.  An element is c_nodeElement, its
+		 *		name, the number of attributes, a name and value for each of them,
+		 *		then its children and c_nodeEnd.  Text is c_nodeText and the text.
+		 *		The list of top level nodes also ends with c_nodeEnd.
+		 */
+		static char const c_magic[8] =
+		{ 'O', 'Z', 'W', 'C', 'F', 'G', 'B', '1' };
+		static uint32 const c_formatVersion = 1;
+		static uint32 const c_headerSize = 32;
+		static uint32 const c_entrySize = 24;
+
+		static uint8 const c_nodeEnd = 0x00;
+		static uint8 const c_nodeElement = 0x01;
+		static uint8 const c_nodeText = 0x02;
+
+		// The index holds a usable Product Revision for the file
+		static uint32 const c_flagProductRevision = 0x01;
+
+		static uint32 const c_maxDepth = 64;
+
+		ConfigBundle* ConfigBundle::s_instance = NULL;
+
+//-----------------------------------------------------------------------------
+// <Put32>
+// Append a little endian number to a buffer
+//-----------------------------------------------------------------------------
+		static void Put32(string* _buffer, uint32 _value)
+		{
+			_buffer->push_back((char) (_value & 0xff));
+			_buffer->push_back((char) ((_value >> 8) & 0xff));
+			_buffer->push_back((char) ((_value >> 16) & 0xff));
+			_buffer->push_back((char) ((_value >> 24) & 0xff));
+		}
+
+//-----------------------------------------------------------------------------
+// <Set32>
+// Overwrite a little endian number in a buffer
+//-----------------------------------------------------------------------------
+		static void Set32(string* _buffer, uint32 _pos, uint32 _value)
+		{
+			(*_buffer)[_pos] = (char) (_value & 0xff);
+			(*_buffer)[_pos + 1] = (char) ((_value >> 8) & 0xff);
+			(*_buffer)[_pos + 2] = (char) ((_value >> 16) & 0xff);
+			(*_buffer)[_pos + 3] = (char) ((_value >> 24) & 0xff);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::ConfigBundle>
+// Constructor
+//-----------------------------------------------------------------------------
+		ConfigBundle::ConfigBundle() :
+				m_data(NULL), m_size(0), m_mapped(false), m_mtime(0), m_count(0), m_index(0), m_strings(0), m_stringsSize(0)
+		{
+			Options::Get()->GetOptionAsString("ConfigPath", &m_configPath);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::~ConfigBundle>
+// Destructor
+//-----------------------------------------------------------------------------
+		ConfigBundle::~ConfigBundle()
+		{
+			if (m_data)
+			{
+#if !defined _WIN32
+				if (m_mapped)
+				{
+					munmap((void*) m_data, m_size);
+				}
+				else
+#endif
+				{
+					delete[] m_data;
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Create>
+// Open the bundle if there is one
+//-----------------------------------------------------------------------------
+		void ConfigBundle::Create()
+		{
+			if (s_instance)
+			{
+				return;
+			}
+
+			ConfigBundle* bundle = new ConfigBundle();
+			string filename;
+			Options::Get()->GetOptionAsString("ConfigBundle", &filename);
+			if (filename.empty())
+			{
+				filename = bundle->m_configPath + "config.ozwb";
+			}
+
+			if (!bundle->Open(filename))
+			{
+				delete bundle;
+				return;
+			}
+			Log::Write(LogLevel_Info, "Using the config bundle %s (%d files)", filename.c_str(), bundle->m_count);
+			s_instance = bundle;
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Destroy>
+// Close the bundle
+//-----------------------------------------------------------------------------
+		void ConfigBundle::Destroy()
+		{
+			delete s_instance;
+			s_instance = NULL;
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Open>
+// Map the bundle file and check its header
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::Open(string const& _filename)
+		{
+			struct stat st;
+			if (stat(_filename.c_str(), &st) != 0)
+			{
+				Log::Write(LogLevel_Info, "No config bundle at %s - reading the XML files", _filename.c_str());
+				return false;
+			}
+			if ((st.st_size < (off_t) c_headerSize) || ((uint64) st.st_size > 0x7fffffff))
+			{
+				Log::Write(LogLevel_Warning, "Config bundle %s has an invalid size - reading the XML files", _filename.c_str());
+				return false;
+			}
+			m_size = (uint32) st.st_size;
+			m_mtime = st.st_mtime;
+
+#if !defined _WIN32
+			int fd = open(_filename.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				Log::Write(LogLevel_Warning, "Cannot open the config bundle %s - reading the XML files", _filename.c_str());
+				return false;
+			}
+			void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (data == MAP_FAILED)
+			{
+				Log::Write(LogLevel_Warning, "Cannot map the config bundle %s - reading the XML files", _filename.c_str());
+				return false;
+			}
+			m_data = (uint8 const*) data;
+			m_mapped = true;
+#else
+			FILE* file = fopen(_filename.c_str(), "rb");
+			if (!file)
+			{
+				Log::Write(LogLevel_Warning, "Cannot open the config bundle %s - reading the XML files", _filename.c_str());
+				return false;
+			}
+			uint8* data = new uint8[m_size];
+			size_t read = fread(data, 1, m_size, file);
+			fclose(file);
+			m_data = data;
+			if (read != m_size)
+			{
+				Log::Write(LogLevel_Warning, "Cannot read the config bundle %s - reading the XML files", _filename.c_str());
+				return false;
+			}
+#endif
+
+			if (memcmp(m_data, c_magic, sizeof(c_magic)) != 0 || Get32(8) != c_formatVersion)
+			{
+				Log::Write(LogLevel_Warning, "%s is not a config bundle this version can read - reading the XML files", _filename.c_str());
+				return false;
+			}
+			m_count = Get32(12);
+			m_index = Get32(16);
+			m_strings = Get32(20);
+			m_stringsSize = Get32(24);
+			if ((Get32(28) != m_size) || (m_index > m_size) || (m_count > (m_size - m_index) / c_entrySize) || (m_strings > m_size) || (m_stringsSize == 0) || (m_stringsSize > m_size - m_strings) || (m_data[m_strings + m_stringsSize - 1] != 0))
+			{
+				Log::Write(LogLevel_Warning, "Config bundle %s is damaged - reading the XML files", _filename.c_str());
+				return false;
+			}
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Get32>
+// Read a little endian number from the bundle
+//-----------------------------------------------------------------------------
+		uint32 ConfigBundle::Get32(uint32 _pos) const
+		{
+			return ((uint32) m_data[_pos]) | (((uint32) m_data[_pos + 1]) << 8) | (((uint32) m_data[_pos + 2]) << 16) | (((uint32) m_data[_pos + 3]) << 24);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::GetString>
+// Look up a string in the table
+//-----------------------------------------------------------------------------
+		char const* ConfigBundle::GetString(uint32 _offset) const
+		{
+			// The table ends with a NUL (checked in Open), so any offset inside it is safe
+			if (_offset >= m_stringsSize)
+			{
+				return NULL;
+			}
+			return (char const*) &m_data[m_strings + _offset];
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Find>
+// Binary search the index for a file
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::Find(string const& _name, Entry* _entry) const
+		{
+			uint32 low = 0;
+			uint32 high = m_count;
+			while (low < high)
+			{
+				uint32 mid = low + (high - low) / 2;
+				uint32 pos = m_index + mid * c_entrySize;
+				char const* name = GetString(Get32(pos));
+				if (!name)
+				{
+					return false;
+				}
+				int cmp = strcmp(_name.c_str(), name);
+				if (cmp == 0)
+				{
+					_entry->m_data = Get32(pos + 4);
+					_entry->m_dataSize = Get32(pos + 8);
+					_entry->m_fileSize = Get32(pos + 12);
+					_entry->m_revision = Get32(pos + 16);
+					_entry->m_flags = Get32(pos + 20);
+					return (_entry->m_data <= m_size) && (_entry->m_dataSize <= m_size - _entry->m_data);
+				}
+				if (cmp < 0)
+				{
+					high = mid;
+				}
+				else
+				{
+					low = mid + 1;
+				}
+			}
+			return false;
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::IsCurrent>
+// Check the XML file has not been changed since the bundle was made
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::IsCurrent(string const& _name, Entry const& _entry) const
+		{
+			struct stat st;
+			if (stat((m_configPath + _name).c_str(), &st) != 0)
+			{
+				// Only the bundle was installed
+				return true;
+			}
+			return ((uint64) st.st_size == _entry.m_fileSize) && (st.st_mtime <= m_mtime);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::ReadNodes>
+// Rebuild a list of nodes from the bundle under _parent
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::ReadNodes(uint32* _pos, uint32 _end, TiXmlNode* _parent, uint32 _depth) const
+		{
+			if (_depth > c_maxDepth)
+			{
+				return false;
+			}
+			while (*_pos < _end)
+			{
+				uint8 type = m_data[(*_pos)++];
+				if (type == c_nodeEnd)
+				{
+					return true;
+				}
+				if (type == c_nodeText)
+				{
+					if (_end - *_pos < 4)
+					{
+						return false;
+					}
+					char const* text = GetString(Get32(*_pos));
+					*_pos += 4;
+					if (!text)
+					{
+						return false;
+					}
+					_parent->LinkEndChild(new TiXmlText(text));
+					continue;
+				}
+				if (type != c_nodeElement || _end - *_pos < 8)
+				{
+					return false;
+				}
+
+				char const* name = GetString(Get32(*_pos));
+				uint32 attributes = Get32(*_pos + 4);
+				*_pos += 8;
+				if (!name || (attributes > (_end - *_pos) / 8))
+				{
+					return false;
+				}
+				TiXmlElement* element = new TiXmlElement(name);
+				_parent->LinkEndChild(element);
+				for (uint32 i = 0; i < attributes; ++i)
+				{
+					char const* attrName = GetString(Get32(*_pos));
+					char const* attrValue = GetString(Get32(*_pos + 4));
+					*_pos += 8;
+					if (!attrName || !attrValue)
+					{
+						return false;
+					}
+					element->SetAttribute(attrName, attrValue);
+				}
+				if (!ReadNodes(_pos, _end, element, _depth + 1))
+				{
+					return false;
+				}
+			}
+			return false;
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::LoadXML>
+// Load a config file from the bundle or from disk
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::LoadXML(TiXmlDocument* _doc, string const& _name)
+		{
+			ConfigBundle* bundle = s_instance;
+			Entry entry;
+			if (bundle && bundle->Find(_name, &entry) && bundle->IsCurrent(_name, entry))
+			{
+				uint32 pos = entry.m_data;
+				if (bundle->ReadNodes(&pos, entry.m_data + entry.m_dataSize, _doc, 0) && _doc->RootElement())
+				{
+					return true;
+				}
+				Log::Write(LogLevel_Warning, "The config bundle copy of %s is damaged - reading the XML file", _name.c_str());
+				_doc->Clear();
+			}
+
+			string configPath;
+			if (bundle)
+			{
+				configPath = bundle->m_configPath;
+			}
+			else
+			{
+				Options::Get()->GetOptionAsString("ConfigPath", &configPath);
+			}
+			return _doc->LoadFile((configPath + _name).c_str(), TIXML_ENCODING_UTF8);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::GetProductRevision>
+// Get the Revision of a product config file without reading it
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::GetProductRevision(string const& _name, uint32* _revision)
+		{
+			ConfigBundle* bundle = s_instance;
+			Entry entry;
+			if (!bundle || !bundle->Find(_name, &entry) || !(entry.m_flags & c_flagProductRevision) || !bundle->IsCurrent(_name, entry))
+			{
+				return false;
+			}
+			*_revision = entry.m_revision;
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <AddString>
+// Add a string to the table of a new bundle, if it is not there already
+//-----------------------------------------------------------------------------
+		static uint32 AddString(string* _strings, std::map<string, uint32>* _offsets, char const* _str)
+		{
+			std::map<string, uint32>::iterator it = _offsets->find(_str);
+			if (it != _offsets->end())
+			{
+				return it->second;
+			}
+			uint32 offset = (uint32) _strings->size();
+			_strings->append(_str);
+			_strings->push_back('\0');
+			(*_offsets)[_str] = offset;
+			return offset;
+		}
+
+//-----------------------------------------------------------------------------
+// <WriteNodes>
+// Append the nodes under _parent to the data of a new bundle
+//-----------------------------------------------------------------------------
+		static void WriteNodes(string* _data, string* _strings, std::map<string, uint32>* _offsets, TiXmlNode const* _parent)
+		{
+			for (TiXmlNode const* node = _parent->FirstChild(); node; node = node->NextSibling())
+			{
+				if (TiXmlElement const* element = node->ToElement())
+				{
+					_data->push_back((char) c_nodeElement);
+					Put32(_data, AddString(_strings, _offsets, element->Value()));
+					uint32 countPos = (uint32) _data->size();
+					Put32(_data, 0);
+					uint32 count = 0;
+					for (TiXmlAttribute const* attr = element->FirstAttribute(); attr; attr = attr->Next())
+					{
+						Put32(_data, AddString(_strings, _offsets, attr->Name()));
+						Put32(_data, AddString(_strings, _offsets, attr->Value()));
+						++count;
+					}
+					Set32(_data, countPos, count);
+					WriteNodes(_data, _strings, _offsets, element);
+				}
+				else if (TiXmlText const* text = node->ToText())
+				{
+					_data->push_back((char) c_nodeText);
+					Put32(_data, AddString(_strings, _offsets, text->Value()));
+				}
+				// Comments, declarations and anything unknown are not needed
+			}
+			_data->push_back((char) c_nodeEnd);
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigBundle::Write>
+// Compile a list of XML files into a bundle
+//-----------------------------------------------------------------------------
+		bool ConfigBundle::Write(string const& _configPath, std::vector<string> const& _names, string const& _bundleFile)
+		{
+			std::vector<string> names = _names;
+			std::sort(names.begin(), names.end());
+			names.erase(std::unique(names.begin(), names.end()), names.end());
+
+			string strings;
+			std::map<string, uint32> offsets;
+			string data;
+			string index;
+
+			for (std::vector<string>::iterator it = names.begin(); it != names.end(); ++it)
+			{
+				string path = _configPath + *it;
+				TiXmlDocument doc;
+				if (!doc.LoadFile(path.c_str(), TIXML_ENCODING_UTF8))
+				{
+					Log::Write(LogLevel_Warning, "Unable to load %s: %s - leaving it out of the bundle", path.c_str(), doc.ErrorDesc());
+					continue;
+				}
+				struct stat st;
+				if (stat(path.c_str(), &st) != 0)
+				{
+					continue;
+				}
+
+				// The same checks ManufacturerSpecificDB::LoadConfigFileRevision makes
+				uint32 revision = 0;
+				uint32 flags = 0;
+				TiXmlElement const* root = doc.RootElement();
+				if (root && !strcmp(root->Value(), "Product"))
+				{
+					char const* xmlns = root->Attribute("xmlns");
+					char const* rev = root->Attribute("Revision");
+					if ((!xmlns || !strcmp(xmlns, "https://github.com/OpenZWave/open-zwave")) && rev)
+					{
+						revision = (uint32) atol(rev);
+						flags |= c_flagProductRevision;
+					}
+				}
+
+				uint32 start = (uint32) data.size();
+				WriteNodes(&data, &strings, &offsets, &doc);
+
+				Put32(&index, AddString(&strings, &offsets, it->c_str()));
+				Put32(&index, start);
+				Put32(&index, (uint32) data.size() - start);
+				Put32(&index, (uint32) st.st_size);
+				Put32(&index, revision);
+				Put32(&index, flags);
+			}
+
+			// Data offsets are relative until we know where the data starts
+			uint32 count = (uint32) (index.size() / c_entrySize);
+			uint32 indexPos = c_headerSize;
+			uint32 stringsPos = indexPos + (uint32) index.size();
+			uint32 dataPos = stringsPos + (uint32) strings.size();
+			for (uint32 i = 0; i < count; ++i)
+			{
+				uint32 pos = i * c_entrySize + 4;
+				uint32 offset = ((uint32) (uint8) index[pos]) | (((uint32) (uint8) index[pos + 1]) << 8) | (((uint32) (uint8) index[pos + 2]) << 16) | (((uint32) (uint8) index[pos + 3]) << 24);
+				Set32(&index, pos, offset + dataPos);
+			}
+
+			string header(c_magic, sizeof(c_magic));
+			Put32(&header, c_formatVersion);
+			Put32(&header, count);
+			Put32(&header, indexPos);
+			Put32(&header, stringsPos);
+			Put32(&header, (uint32) strings.size());
+			Put32(&header, dataPos + (uint32) data.size());
+
+			FILE* file = fopen(_bundleFile.c_str(), "wb");
+			if (!file)
+			{
+				Log::Write(LogLevel_Error, "Unable to create %s", _bundleFile.c_str());
+				return false;
+			}
+			bool ok = (fwrite(header.data(), 1, header.size(), file) == header.size()) && (fwrite(index.data(), 1, index.size(), file) == index.size()) && (fwrite(strings.data(), 1, strings.size(), file) == strings.size()) && (fwrite(data.data(), 1, data.size(), file) == data.size());
+			if (fclose(file) != 0 || !ok)
+			{
+				Log::Write(LogLevel_Error, "Unable to write %s", _bundleFile.c_str());
+				remove(_bundleFile.c_str());
+				return false;
+			}
+			Log::Write(LogLevel_Info, "Wrote %d config files to %s (%d bytes)", count, _bundleFile.c_str(), dataPos + (uint32) data.size());
+			return true;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigBundle.h
+//
+//	The config directory compiled into a single file
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigBundle_H
+#define _ConfigBundle_H
+
+#include <string>
+#include <vector>
+#include <time.h>
+#include "Defs.h"
+
+class TiXmlDocument;
+class TiXmlNode;
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief Every XML file in the config directory, already parsed, in one file.
+		 *
+		 * The bundle is made at build time by the ozw_config_bundle tool ("make
+		 * configbundle") and installed next to the XML files as config.ozwb.  It
+		 * holds the element tree of each file, with all the strings in one
+		 * shared table, and an index sorted by file name.  For product config
+		 * files the index also holds the Revision of the file, so the
+		 * ManufacturerSpecificDB does not have to open them at all.
+		 *
+		 * The file is memory mapped and only read.  Any file that is missing
+		 * from the bundle, or that has been changed since the bundle was made
+		 * (by a config update for example), is read from its XML instead.
+		 */
+		class ConfigBundle
+		{
+			public:
+				/**
+				 * Open the bundle named by the ConfigBundle option (config.ozwb in
+				 * the ConfigPath by default), if there is one.
+				 */
+				static void Create();
+				static void Destroy();
+
+				/**
+				 * Load _name (relative to the ConfigPath) into _doc, from the bundle
+				 * if it has an up to date copy and from the XML file otherwise.
+				 * Returns false, like TiXmlDocument::LoadFile, if neither worked.
+				 */
+				static bool LoadXML(TiXmlDocument* _doc, string const& _name);
+
+				/**
+				 * Get the Revision of the product config file _name from the
+				 * index.  Returns false if the bundle cannot answer, in which case
+				 * the file itself has to be read.
+				 */
+				static bool GetProductRevision(string const& _name, uint32* _revision);
+
+				/**
+				 * Compile the XML files _names (relative to _configPath) into the
+				 * bundle _bundleFile.  Used by the ozw_config_bundle tool.
+				 */
+				static bool Write(string const& _configPath, std::vector<string> const& _names, string const& _bundleFile);
+
+			private:
+				struct Entry
+				{
+						uint32 m_data;
+						uint32 m_dataSize;
+						uint32 m_fileSize;
+						uint32 m_revision;
+						uint32 m_flags;
+				};
+
+				ConfigBundle();
+				~ConfigBundle();
+
+				bool Open(string const& _filename);
+				bool Find(string const& _name, Entry* _entry) const;
+				bool IsCurrent(string const& _name, Entry const& _entry) const;
+				bool ReadNodes(uint32* _pos, uint32 _end, TiXmlNode* _parent, uint32 _depth) const;
+				char const* GetString(uint32 _offset) const;
+				uint32 Get32(uint32 _pos) const;
+
+				static ConfigBundle* s_instance;
+
+				string m_configPath;
+				uint8 const* m_data;
+				uint32 m_size;
+				bool m_mapped;					// m_data is a file mapping rather than a copy
+				time_t m_mtime;					// When the bundle was made (or installed)
+				uint32 m_count;
+				uint32 m_index;
+				uint32 m_strings;
+				uint32 m_stringsSize;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigLoader.cpp
+//
+//	Load the global config files in parallel at startup
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "ConfigLoader.h"
+#include "ConfigBundle.h"
+#include "Manager.h"
+#include "Localization.h"
+#include "ManufacturerSpecificDB.h"
+#include "Node.h"
+#include "NotificationCCTypes.h"
+#include "Options.h"
+#include "Scene.h"
+#include "SensorMultiLevelCCTypes.h"
+#include "Utils.h"
+#include "platform/Event.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+#include "platform/TimeStamp.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		static char const* c_phaseNames[] =
+		{ "ManufacturerSpecificDB", "Localization", "NotificationCCTypes", "SensorMultiLevelCCTypes", "DeviceClasses", "Scenes" };
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::ConfigLoader>
+// Constructor
+//-----------------------------------------------------------------------------
+		ConfigLoader::ConfigLoader() :
+				m_mutex(new Platform::Mutex()), m_doneEvent(new Platform::Event()), m_nextPhase(0), m_activeWorkers(0), m_totalTime(0)
+		{
+			memset(m_phaseTime, 0, sizeof(m_phaseTime));
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::~ConfigLoader>
+// Destructor
+//-----------------------------------------------------------------------------
+		ConfigLoader::~ConfigLoader()
+		{
+			m_doneEvent->Release();
+			// Product config files are still read from the bundle during interviews
+			ConfigBundle::Destroy();
+			m_mutex->Release();
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::GetPhaseName>
+// Name of a phase for the log
+//-----------------------------------------------------------------------------
+		char const* ConfigLoader::GetPhaseName(Phase _phase)
+		{
+			if (_phase >= Phase_Count)
+			{
+				return "Unknown";
+			}
+			return c_phaseNames[_phase];
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::Load>
+// Run every phase on the pool and wait for them all to complete
+//-----------------------------------------------------------------------------
+		void ConfigLoader::Load()
+		{
+			Platform::TimeStamp start;
+
+			int32 threads = 4;
+			Options::Get()->GetOptionAsInt("ConfigLoadThreads", &threads);
+			if (threads < 1)
+			{
+				threads = 1;
+			}
+			if (threads > Phase_Count)
+			{
+				threads = Phase_Count;
+			}
+
+			ConfigBundle::Create();
+
+			m_nextPhase = 0;
+			m_activeWorkers = (uint32) threads;
+			m_doneEvent->Reset();
+
+			// This thread is one of the workers
+			std::vector<Platform::Thread*> workers;
+			for (int32 i = 1; i < threads; ++i)
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "config%d", i);
+				Platform::Thread* thread = new Platform::Thread(name);
+				workers.push_back(thread);
+				thread->Start(ConfigLoader::WorkerThreadProc, this);
+			}
+			WorkerThreadProc(NULL, this);
+			Platform::Wait::Single(m_doneEvent);
+
+			// Every phase is done, so the workers are on their way out.  Join them
+			// before they are released, so none is left behind.
+			for (std::vector<Platform::Thread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+			{
+				(*it)->Join();
+				(*it)->Release();
+			}
+
+			m_totalTime = (uint32) (Platform::TimeStamp() - start);
+			Log::Write(LogLevel_Info, "Loaded the config files in %d ms using %d threads", m_totalTime, threads);
+
+			if (m_error)
+			{
+				std::exception_ptr error = m_error;
+				m_error = std::exception_ptr();
+				std::rethrow_exception(error);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::WorkerThreadProc>
+// Entry point for the pool threads
+//-----------------------------------------------------------------------------
+		void ConfigLoader::WorkerThreadProc(Platform::Event* _exitEvent, void* _context)
+		{
+			ConfigLoader* loader = (ConfigLoader*) _context;
+			loader->RunPhases();
+
+			LockGuard LG(loader->m_mutex);
+			if (--loader->m_activeWorkers == 0)
+			{
+				loader->m_doneEvent->Set();
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::RunPhases>
+// Take phases off the list until there are none left
+//-----------------------------------------------------------------------------
+		void ConfigLoader::RunPhases()
+		{
+			while (true)
+			{
+				Phase phase;
+				{
+					LockGuard LG(m_mutex);
+					if (m_nextPhase >= Phase_Count)
+					{
+						return;
+					}
+					phase = (Phase) m_nextPhase++;
+				}
+
+				Platform::TimeStamp start;
+				try
+				{
+					RunPhase(phase);
+				} catch (...)
+				{
+					LockGuard LG(m_mutex);
+					if (!m_error)
+					{
+						m_error = std::current_exception();
+					}
+				}
+				m_phaseTime[phase] = (uint32) (Platform::TimeStamp() - start);
+				Log::Write(LogLevel_Info, "Config load: %s took %d ms", GetPhaseName(phase), m_phaseTime[phase]);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ConfigLoader::RunPhase>
+// Load one of the config files
+//-----------------------------------------------------------------------------
+		void ConfigLoader::RunPhase(Phase _phase)
+		{
+			switch (_phase)
+			{
+				case Phase_NotificationCCTypes:
+				{
+					if (!NotificationCCTypes::Create())
+					{
+						Log::Write(LogLevel_Error, "mgr,     Cannot Create NotificationCCTypes!");
+					}
+					break;
+				}
+				case Phase_SensorMultiLevelCCTypes:
+				{
+					if (!SensorMultiLevelCCTypes::Create())
+					{
+						Log::Write(LogLevel_Error, "mgr,     Cannot Create SensorMultiLevelCCTypes!");
+					}
+					break;
+				}
+				case Phase_ManufacturerSpecificDB:
+				{
+					ManufacturerSpecificDB::Create();
+					break;
+				}
+				case Phase_Localization:
+				{
+					Log::Write(LogLevel_Always, "Using Language Localization %s", Localization::Get()->GetSelectedLang().c_str());
+					break;
+				}
+				case Phase_DeviceClasses:
+				{
+					if (!Node::s_deviceClassesLoaded)
+					{
+						Node::ReadDeviceClasses();
+					}
+					break;
+				}
+				case Phase_Scenes:
+				{
+					Scene::ReadScenes();
+					break;
+				}
+				case Phase_Count:
+				{
+					break;
+				}
+			}
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigLoader.h
+//
+//	Load the global config files in parallel at startup
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigLoader_H
+#define _ConfigLoader_H
+
+#include <exception>
+#include <vector>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Event;
+			class Mutex;
+			class Thread;
+		}
+
+		/** \brief Reads the config files that every network shares.
+		 *
+		 * Localization.xml, the Notification and Sensor type files,
+		 * manufacturer_specific.xml (with the revision of every product file),
+		 * device_classes.xml and the scenes do not depend on each other, so they
+		 * are parsed on a small pool of threads.  Load() only returns once all of
+		 * them are done, so nothing that needs them can run before they are
+		 * ready.  The time each one took is kept for the driver statistics.
+		 */
+		class ConfigLoader
+		{
+			public:
+				// Longest first, so the short ones fill in around them
+				enum Phase
+				{
+					Phase_ManufacturerSpecificDB = 0,
+					Phase_Localization,
+					Phase_NotificationCCTypes,
+					Phase_SensorMultiLevelCCTypes,
+					Phase_DeviceClasses,
+					Phase_Scenes,
+					Phase_Count
+				};
+
+				ConfigLoader();
+				~ConfigLoader();
+
+				/**
+				 * Load all the files and wait for them to finish.  If any of them
+				 * threw an OZWException, the first one is thrown again here.
+				 */
+				void Load();
+
+				static char const* GetPhaseName(Phase _phase);
+
+				/**
+				 * Milliseconds spent on one phase.
+				 */
+				uint32 GetPhaseTime(Phase _phase) const
+				{
+					return m_phaseTime[_phase];
+				}
+
+				/**
+				 * Milliseconds from the start of Load() until every phase was done.
+				 */
+				uint32 GetTotalTime() const
+				{
+					return m_totalTime;
+				}
+
+			private:
+				static void WorkerThreadProc(Platform::Event* _exitEvent, void* _context);
+				void RunPhases();
+				void RunPhase(Phase _phase);
+
+				Platform::Mutex* m_mutex;
+				Platform::Event* m_doneEvent;			// Set when the last worker has finished
+				uint32 m_nextPhase;
+				uint32 m_activeWorkers;
+				std::exception_ptr m_error;				// The first exception thrown by a phase
+				uint32 m_phaseTime[Phase_Count];
+				uint32 m_totalTime;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
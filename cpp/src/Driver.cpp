@@ -31,16 +31,20 @@
 #include "Node.h"
 #include "Msg.h"
 #include "Notification.h"
+#include "ConfigLoader.h"
 #include "Scene.h"
 #include "ZWSecurity.h"
+#include "NoncePool.h"
 #include "DNSThread.h"
 #include "TimerThread.h"
 #include "Http.h"
 #include "ManufacturerSpecificDB.h"
+#include "MetricsExporter.h"
 
 #include "platform/Event.h"
 #include "platform/Mutex.h"
 #include "platform/SerialController.h"
+#include "platform/ReplayController.h"
 #ifdef USE_HID
 #ifdef WINRT
 #include "platform/winRT/HidControllerWinRT.h"
@@ -59,6 +63,8 @@
 #include "command_classes/WakeUp.h"
 #include "command_classes/SwitchAll.h"
 #include "command_classes/ManufacturerSpecific.h"
+#include "command_classes/MultiCmd.h"
+#include "command_classes/MultiInstance.h"
 #include "command_classes/NoOperation.h"
 
 #include "value_classes/ValueID.h"
@@ -68,6 +74,8 @@
 #include "tinyxml.h"
 
 #include "Utils.h"
+#include "AirtimeThrottle.h"
+#include "platform/Trace.h"
 #if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
 # include <unistd.h>
 #elif defined _WIN32
@@ -92,6 +100,17 @@ using namespace OpenZWave;
 // 05: 10-07-2020 - Duration ValueID's changed from Byte to Int. Invalidate Any previous caches. 
 uint32 const c_configVersion = 5;
 
+// How far down the queues to look for a secure message to prefetch a nonce for
+static uint32 const c_noncePrefetchLookahead = 4;
+// How long to wait for the Nonce Report to a prefetch Nonce Get
+static int32 const c_noncePrefetchTimeout = 1000;
+// S0 nodes keep a nonce for at least 3 seconds.  Leave time for the encrypted frame to get there.
+static int32 const c_noncePrefetchLifetime = 2500;
+// Save interview progress at most this often, so a network full of new nodes doesn't rewrite the cache for every stage
+static int32 const c_interviewSaveDelay = 5000;
+// Airtime (ms) charged to the throttled queues for a frame whose transmit time the controller did not report
+static uint32 const c_estimatedAirtime = 20;
+
 static char const* c_libraryTypeNames[] =
 { "Unknown",			// library type 0
 		"Static Controller",		// library type 1
@@ -115,11 +134,11 @@ static char const* c_sendQueueNames[] =
 // Constructor
 //-----------------------------------------------------------------------------
 Driver::Driver(string const& _controllerPath, ControllerInterface const& _interface) :
-		m_driverThread(new Internal::Platform::Thread("driver")), m_dns(new Internal::DNSThread(this)), m_dnsThread(new Internal::Platform::Thread("dns")), m_initMutex(new Internal::Platform::Mutex()), m_exit(false), m_init(false), m_awakeNodesQueried(false), m_allNodesQueried(false), m_notifytransactions(false), m_timer(new Internal::TimerThread(this)), m_timerThread(new Internal::Platform::Thread("timer")), m_controllerInterfaceType(_interface), m_controllerPath(_controllerPath), m_controller(
+		m_driverThread(new Internal::Platform::Thread("driver")), m_dns(new Internal::DNSThread(this)), m_dnsThread(new Internal::Platform::Thread("dns")), m_initMutex(new Internal::Platform::Mutex()), m_exit(false), m_init(false), m_awakeNodesQueried(false), m_allNodesQueried(false), m_notifytransactions(false), m_interviewSavePending(false), m_timer(new Internal::TimerThread(this)), m_timerThread(new Internal::Platform::Thread("timer")), m_controllerInterfaceType(_interface), m_controllerPath(_controllerPath), m_controller(
 				NULL), m_homeId(0), m_libraryVersion(""), m_libraryTypeName(""), m_libraryType(0), m_manufacturerId(0), m_productType(0), m_productId(0), m_initVersion(0), m_initCaps(0), m_controllerCaps(0), m_Controller_nodeId(0), m_nodeMutex(new Internal::Platform::Mutex()), m_controllerReplication( NULL), m_transmitOptions( TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE), m_waitingForAck(false), m_expectedCallbackId(0), m_expectedReply(0), m_expectedCommandClassId(
 				0), m_expectedNodeId(0), m_pollThread(new Internal::Platform::Thread("poll")), m_pollMutex(new Internal::Platform::Mutex()), m_pollInterval(0), m_bIntervalBetweenPolls(false),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
 		m_currentControllerCommand( NULL), m_SUCNodeId(0), m_controllerResetEvent( NULL), m_sendMutex(new Internal::Platform::Mutex()), m_currentMsg( NULL), m_virtualNeighborsReceived(false), m_notificationsEvent(new Internal::Platform::Event()), m_SOFCnt(0), m_ACKWaiting(0), m_readAborts(0), m_badChecksum(0), m_readCnt(0), m_writeCnt(0), m_CANCnt(0), m_NAKCnt(0), m_ACKCnt(0), m_OOFCnt(0), m_dropped(0), m_retries(0), m_callbacks(0), m_badroutes(0), m_noack(0), m_netbusy(0), m_notidle(0), m_txverified(
-				0), m_nondelivery(0), m_routedbusy(0), m_broadcastReadCnt(0), m_broadcastWriteCnt(0), AuthKey(0), EncryptKey(0), m_nonceReportSent(0), m_nonceReportSentAttempt(0), m_queueMsgEvent(new Internal::Platform::Event()), m_eventMutex(new Internal::Platform::Mutex())
+				0), m_nondelivery(0), m_routedbusy(0), m_broadcastReadCnt(0), m_broadcastWriteCnt(0), m_pollCnt(0), m_notificationCnt(0), m_cacheLoadTime(0), m_airtimeThrottle(new Internal::AirtimeThrottle()), m_msgTraceCallback(NULL), m_msgTraceContext(NULL), AuthKey(0), EncryptKey(0), m_noncePool(new Internal::NoncePool()), m_nonceReportSent(0), m_nonceReportSentAttempt(0), m_noncePrefetch(true), m_noncePrefetchNodeId(0), m_noncePrefetchCallbackId(0), m_noncePrefetchDelivered(false), m_noncePrefetchReceived(false), m_queueMsgEvent(new Internal::Platform::Event()), m_eventMutex(new Internal::Platform::Mutex())
 {
 	// set a timestamp to indicate when this driver started
 	Internal::Platform::TimeStamp m_startTime;
@@ -128,6 +147,9 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 	for (int32 i = 0; i < MsgQueue_Count; ++i)
 	{
 		m_queueEvent[i] = new Internal::Platform::Event();
+		m_queueStats[i].m_completed = 0;
+		m_queueStats[i].m_failed = 0;
+		m_queueStats[i].m_retried = 0;
 	}
 
 	// Clear the nodes array
@@ -136,6 +158,8 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 	// Clear the virtual neighbors array
 	memset(m_virtualNeighbors, 0, NUM_NODE_BITFIELD_BYTES);
 
+	memset(m_noncePrefetched, 0, sizeof(m_noncePrefetched));
+
 	// Initialize the Network Keys
 
 	initNetworkKeys(false);
@@ -147,21 +171,50 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 	}
 	else
 #endif
+	if (ControllerInterface_Replay == _interface)
+	{
+		m_controller = new Internal::Platform::ReplayController();
+	}
+	else
 	{
 		m_controller = new Internal::Platform::SerialController();
 	}
 	m_controller->SetSignalThreshold(1);
 
+	string capture;
+	if (Options::Get()->GetOptionAsString("SerialCapture", &capture) && !capture.empty())
+	{
+		m_controller->StartCapture(Internal::ResolveUserPath(capture));
+	}
+
+	m_nodeMutex->SetName("Driver::m_nodeMutex");
+	m_sendMutex->SetName("Driver::m_sendMutex");
+	m_pollMutex->SetName("Driver::m_pollMutex");
+
+	m_multiCmdBatching = true;
+	m_batchedFrame = false;
 	Options::Get()->GetOptionAsBool("NotifyTransactions", &m_notifytransactions);
+	Options::Get()->GetOptionAsBool("MultiCmdBatching", &m_multiCmdBatching);
+	Options::Get()->GetOptionAsBool("NoncePrefetch", &m_noncePrefetch);
 	Options::Get()->GetOptionAsInt("PollInterval", &m_pollInterval);
 	Options::Get()->GetOptionAsBool("IntervalBetweenPolls", &m_bIntervalBetweenPolls);
 
+	int32 throttlePercent = 0;
+	int32 throttleBurst = 0;
+	Options::Get()->GetOptionAsInt("ThrottleAirtimePercent", &throttlePercent);
+	Options::Get()->GetOptionAsInt("ThrottleAirtimeBurst", &throttleBurst);
+	if ((throttlePercent > 0) && (throttleBurst > 0))
+	{
+		m_airtimeThrottle->Configure((uint32) throttlePercent, (uint32) throttleBurst);
+	}
+
 	m_httpClient = new Internal::HttpClient(this);
 
 	m_mfs = Internal::ManufacturerSpecificDB::Create();
 
 	CheckMFSConfigRevision();
 
+	Internal::MetricsExporter::AddDriver(this);
 }
 
 //-----------------------------------------------------------------------------
@@ -170,6 +223,7 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 //-----------------------------------------------------------------------------
 Driver::~Driver()
 {
+	Internal::MetricsExporter::RemoveDriver(this);
 
 	/* Signal that we are going away... so at least Apps know... */
 	Notification* notification = new Notification(Notification::Type_DriverRemoved);
@@ -209,17 +263,17 @@ Driver::~Driver()
 	m_timerThread->Stop();
 	m_timerThread->Release();
 
-	m_sendMutex->Release();
-
 	m_controller->Close();
 	m_controller->Release();
 
 	m_initMutex->Release();
 
+	// Removing the message records its timing, which takes the send mutex
 	if (m_currentMsg != NULL)
 	{
 		RemoveCurrentMsg();
 	}
+	m_sendMutex->Release();
 
 	// Clear the node data
 	{
@@ -293,6 +347,8 @@ Driver::~Driver()
 	m_eventMutex->Release();
 	delete this->AuthKey;
 	delete this->EncryptKey;
+	delete m_noncePool;
+	delete m_airtimeThrottle;
 	delete this->m_httpClient;
 	delete this->m_timer;
 	delete this->m_dns;
@@ -376,6 +432,11 @@ void Driver::DriverThreadProc(Internal::Platform::Event* _exitEvent)
 				{
 					count = 4;
 					timeout = m_waitingForAck ? ACK_TIMEOUT : retryTimeStamp.TimeRemaining();
+					if (IsWaitingForPrefetchedNonce() && (m_noncePrefetchTS.TimeRemaining() < timeout))
+					{
+						// Don't wait the full retry timeout for a Nonce Report that has gone missing
+						timeout = m_noncePrefetchTS.TimeRemaining();
+					}
 					if (timeout < 0)
 					{
 						timeout = 0;
@@ -388,17 +449,50 @@ void Driver::DriverThreadProc(Internal::Platform::Event* _exitEvent)
 				else
 				{
 					Log::QueueClear();							// clear the log queue when starting a new message
+					m_noncePool->TopUp();						// get random data for nonces while nothing else is happening
+					if (m_interviewSavePending)
+					{
+						timeout = m_interviewSaveTS.TimeRemaining();
+						if (timeout <= 0)
+						{
+							WriteCache();
+							timeout = Internal::Platform::Wait::Timeout_Infinite;
+						}
+					}
+
+					// Hold the Query and Poll queues (the last two wait objects)
+					// back while they are over their airtime budget
+					int32 throttleWait = m_airtimeThrottle->GetWait(GetMsgClock());
+					if (throttleWait > 0)
+					{
+						count = WAITOBJECTCOUNT - 2;
+						if ((timeout == Internal::Platform::Wait::Timeout_Infinite) || (throttleWait < timeout))
+						{
+							timeout = throttleWait;
+						}
+					}
+					PrefetchNonce((throttleWait > 0) ? MsgQueue_Query : MsgQueue_Count);
 				}
 
 				// Wait for something to do
-				int32 res = Internal::Platform::Wait::Multiple(waitObjects, count, timeout);
+				int32 res;
+				{
+					Internal::Platform::TraceSpan span("Wait");
+					res = Internal::Platform::Wait::Multiple(waitObjects, count, timeout);
+				}
 
 				switch (res)
 				{
 					case -1:
 					{
-						// Wait has timed out - time to resend
-						if (m_currentMsg != NULL && !m_currentMsg->isResendDuetoCANorNAK())
+						if (!m_waitingForAck && !m_expectedCallbackId && !m_expectedReply)
+						{
+							// Nothing was sent - it is time to save the interview progress
+							break;
+						}
+						// Wait has timed out - time to resend.  A MultiCmd frame is not
+						// retried as such, so its Gets report their own timeouts.
+						if (m_currentMsg != NULL && !m_currentMsg->isResendDuetoCANorNAK() && !m_batchedFrame && !IsWaitingForPrefetchedNonce())
 						{
 							Notification* notification = new Notification(Notification::Type_Notification);
 							notification->SetHomeAndNodeIds(m_homeId, m_currentMsg->GetTargetNodeId());
@@ -734,9 +828,10 @@ bool Driver::ReadCache()
 		nodeElement = nodeElement->NextSiblingElement();
 	}
 
-	LG.Unlock();
-
-	// restore the previous state (for now, polling) for the nodes/values just retrieved
+	// restore the previous state (for now, polling) for the nodes/values just retrieved.
+	// EnablePoll takes the poll mutex before the node mutex, so the values are
+	// collected first rather than polled while walking the value stores.
+	vector<pair<ValueID, uint8> > polled;
 	for (int i = 0; i < 256; i++)
 	{
 		if (m_nodes[i] != NULL)
@@ -746,11 +841,18 @@ bool Driver::ReadCache()
 			{
 				Internal::VC::Value* value = it->second;
 				if (value->m_pollIntensity != 0)
-					EnablePoll(value->GetID(), value->m_pollIntensity);
+					polled.push_back(make_pair(value->GetID(), value->m_pollIntensity));
 			}
 		}
 	}
 
+	LG.Unlock();
+
+	for (vector<pair<ValueID, uint8> >::const_iterator it = polled.begin(); it != polled.end(); ++it)
+	{
+		EnablePoll(it->first, it->second);
+	}
+
 	return true;
 }
 
@@ -760,6 +862,7 @@ bool Driver::ReadCache()
 //-----------------------------------------------------------------------------
 void Driver::WriteCache()
 {
+	Internal::Platform::TraceSpan span("WriteCache");
 	char str[32];
 
 	if (!m_homeId)
@@ -772,6 +875,8 @@ void Driver::WriteCache()
 		return;
 	}
 
+	m_interviewSavePending = false;
+
 	Log::Write(LogLevel_Info, "Saving Cache");
 	// Create a new XML document to contain the driver configuration
 	TiXmlDocument doc;
@@ -818,9 +923,15 @@ void Driver::WriteCache()
 					m_nodes[i]->WriteXML(driverElement);
 					Log::Write(LogLevel_Info, i, "Cache Save for Node %d as its QueryStage_CacheLoad", i);
 				}
+				else if (m_nodes[i]->GetCurrentQueryStage() > Node::QueryStage_ProtocolInfo)
+				{
+					// Keep what we have learnt so far, so the interview can carry on from here after a restart
+					m_nodes[i]->WriteXML(driverElement);
+					Log::Write(LogLevel_Info, i, "Cache Save for Node %d with its interview at %s", i, m_nodes[i]->GetQueryStageName(m_nodes[i]->GetCurrentQueryStage()).c_str());
+				}
 				else
 				{
-					Log::Write(LogLevel_Info, i, "Skipping Cache Save for Node %d as its not past QueryStage_CacheLoad", i);
+					Log::Write(LogLevel_Info, i, "Skipping Cache Save for Node %d as its not past QueryStage_ProtocolInfo", i);
 				}
 			}
 		}
@@ -834,6 +945,25 @@ void Driver::WriteCache()
 	doc.SaveFile(filename.c_str());
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::SavePartialInterview>
+// Schedule a cache save when a node completes one of its interview stages
+//-----------------------------------------------------------------------------
+void Driver::SavePartialInterview(Node* _node, Node::QueryStage _completed)
+{
+	// Stages from CacheLoad on only refresh values that we ask for again after
+	// every restart anyway.  The cache is written when they are all done.
+	if (_completed >= Node::QueryStage_CacheLoad || _node->GetCurrentQueryStage() == _completed)
+	{
+		return;
+	}
+	if (!m_interviewSavePending)
+	{
+		m_interviewSavePending = true;
+		m_interviewSaveTS.SetTime(c_interviewSaveDelay);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //	Controller
 //-----------------------------------------------------------------------------
@@ -952,6 +1082,7 @@ void Driver::SendMsg(Internal::Msg* _msg, MsgQueue const _queue)
 	/* make sure the HomeId is Set on this message */
 	_msg->SetHomeId(m_homeId);
 	_msg->Finalize();
+	_msg->SetStageTime(Internal::Msg::Stage_Queued, GetMsgClock());
 	{
 		Internal::LockGuard LG(m_nodeMutex);
 		if (Node* node = GetNode(_msg->GetTargetNodeId()))
@@ -967,6 +1098,17 @@ void Driver::SendMsg(Internal::Msg* _msg, MsgQueue const _queue)
 				}
 			}
 
+			// Note whether the node accepts MultiCmd frames while we hold the node
+			// lock, so the send queue can batch Gets without looking it up again
+			if (m_multiCmdBatching)
+			{
+				Internal::CC::CommandClass* multiCmd = node->GetCommandClass(Internal::CC::MultiCmd::StaticGetCommandClassId());
+				if ((multiCmd != NULL) && !multiCmd->IsAfterMark() && !multiCmd->IsSecured())
+				{
+					item.m_msg->SetMultiCmd();
+				}
+			}
+
 			// If the message is for a sleeping node, we queue it in the node itself.
 			if (!node->IsListeningDevice())
 			{
@@ -1009,6 +1151,7 @@ void Driver::SendMsg(Internal::Msg* _msg, MsgQueue const _queue)
 //-----------------------------------------------------------------------------
 bool Driver::WriteNextMsg(MsgQueue const _queue)
 {
+	Internal::Platform::TraceSpan span("WriteNextMsg", c_sendQueueNames[_queue]);
 
 	// There are messages to send, so get the one at the front of the queue
 	m_sendMutex->Lock();
@@ -1020,6 +1163,11 @@ bool Driver::WriteNextMsg(MsgQueue const _queue)
 		m_currentMsg = item.m_msg;
 		m_currentMsgQueueSource = _queue;
 		m_msgQueue[_queue].pop_front();
+		if (m_nonceReportSent == 0)
+		{
+			m_currentMsg = BatchGets(_queue, item.m_msg);
+		}
+		SetCurrentMsgStage(Internal::Msg::Stage_Dequeued);
 		if (m_msgQueue[_queue].empty())
 		{
 			m_queueEvent[_queue]->Reset();
@@ -1056,6 +1204,7 @@ bool Driver::WriteNextMsg(MsgQueue const _queue)
 			if (!item.m_retry)
 			{
 				node->QueryStageComplete(stage);
+				SavePartialInterview(node, stage);
 			}
 			node->AdvanceQueries();
 			return true;
@@ -1141,6 +1290,15 @@ bool Driver::WriteMsg(string const &msg)
 		m_waitingForAck = false;
 		return false;
 	}
+	if (m_batchedFrame && m_currentMsg->HasStage(Internal::Msg::Stage_Acked) && (m_nonceReportSent == 0))
+	{
+		// The node did not answer every Get in the MultiCmd frame.  Rather than
+		// repeating the whole frame, send the outstanding ones on their own.  If
+		// the controller never accepted the frame (CAN, NAK or no ACK) it is
+		// simply sent again.
+		UnbatchCurrentMsg();
+		return false;
+	}
 	/* if this is called with m_nonceReportSent > 0 it means that we have
 	 * tried to send a NONCE report and it timed out or was NAK'd
 	 *
@@ -1195,11 +1353,25 @@ bool Driver::WriteMsg(string const &msg)
 	 *
 	 */
 
+	bool waitForNonce = false;
 	if (m_nonceReportSent == 0)
 	{
 		if (m_currentMsg->isEncrypted() && !m_currentMsg->isNonceRecieved())
 		{
-			m_currentMsg->SetSendAttempts(++attempts);
+			if (TakePrefetchedNonce())
+			{
+				m_currentMsg->SetSendAttempts(++attempts);
+			}
+			else if ((m_noncePrefetchNodeId == nodeId) && !m_noncePrefetchReceived)
+			{
+				// The Nonce Get has already gone out.  This is not an attempt
+				// of its own - if the report never arrives we ask again.
+				waitForNonce = true;
+			}
+			else
+			{
+				m_currentMsg->SetSendAttempts(++attempts);
+			}
 		}
 		else if (!m_currentMsg->isEncrypted())
 		{
@@ -1209,7 +1381,7 @@ bool Driver::WriteMsg(string const &msg)
 		m_expectedCommandClassId = m_currentMsg->GetExpectedCommandClassId();
 		m_expectedNodeId = m_currentMsg->GetTargetNodeId();
 		m_expectedReply = m_currentMsg->GetExpectedReply();
-		m_waitingForAck = true;
+		m_waitingForAck = !waitForNonce;
 	}
 	string attemptsstr = "";
 	if (attempts > 1)
@@ -1238,10 +1410,15 @@ bool Driver::WriteMsg(string const &msg)
 			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Encrypted message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str());
 			SendEncryptedMessage();
 		}
+		else if (waitForNonce)
+		{
+			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Encrypted message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - waiting for the prefetched Nonce Report", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply);
+			return true;
+		}
 		else
 		{
 			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Nonce Request message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x)", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply);
-			SendNonceRequest(m_currentMsg->GetLogText());
+			SendNonceRequest(m_currentMsg->GetLogText(), nodeId, 2, m_currentMsgQueueSource);
 		}
 	}
 	else
@@ -1262,6 +1439,7 @@ bool Driver::WriteMsg(string const &msg)
 			m_driverThread->Stop();
 			return false;
 		}
+		SetCurrentMsgStage(Internal::Msg::Stage_Written);
 	}
 	m_writeCnt++;
 
@@ -1297,9 +1475,17 @@ void Driver::RemoveCurrentMsg()
 	Log::Write(LogLevel_Detail, GetNodeNumber(m_currentMsg), "Removing current message");
 	if (m_currentMsg != NULL)
 	{
+		// Anything still expected means the message did not complete
+		FinishMsgTiming((m_expectedCallbackId == 0) && (m_expectedReply == 0));
 		delete m_currentMsg;
 		m_currentMsg = NULL;
 	}
+	while (!m_batchedMsgs.empty())
+	{
+		delete m_batchedMsgs.front();
+		m_batchedMsgs.pop_front();
+	}
+	m_batchedFrame = false;
 
 	m_expectedCallbackId = 0;
 	m_expectedCommandClassId = 0;
@@ -1310,6 +1496,175 @@ void Driver::RemoveCurrentMsg()
 	m_nonceReportSentAttempt = 0;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::BatchGets>
+// Combine queued Gets for the same node into a MultiCmd encapsulated frame
+//-----------------------------------------------------------------------------
+Internal::Msg* Driver::BatchGets(MsgQueue const _queue, Internal::Msg* _msg)
+{
+	if (!m_multiCmdBatching || !_msg->IsBatchable())
+	{
+		return _msg;
+	}
+	uint8 nodeId = _msg->GetTargetNodeId();
+	list<Internal::Msg*> batch;
+	batch.push_back(_msg);
+	uint32 size = 3 + Internal::CC::MultiCmd::EncapsulatedSize(_msg);
+	list<MsgQueueItem>::iterator it = m_msgQueue[_queue].begin();
+	while (it != m_msgQueue[_queue].end())
+	{
+		if (MsgQueueCmd_SendMsg != it->m_command)
+		{
+			// Never move a Get past a query stage change or controller command for this node
+			if ((MsgQueueCmd_QueryStageComplete == it->m_command) && (it->m_nodeId != nodeId))
+			{
+				++it;
+				continue;
+			}
+			break;
+		}
+		Internal::Msg* msg = it->m_msg;
+		if (msg->GetTargetNodeId() != nodeId)
+		{
+			++it;
+			continue;
+		}
+		// Stop at anything else for this node, so Sets and Gets stay in order
+		if (!msg->IsBatchable() || (size + Internal::CC::MultiCmd::EncapsulatedSize(msg) > Internal::CC::MultiCmd::c_maxEncapPayload))
+		{
+			break;
+		}
+		size += Internal::CC::MultiCmd::EncapsulatedSize(msg);
+		batch.push_back(msg);
+		it = m_msgQueue[_queue].erase(it);
+	}
+	if (batch.size() < 2)
+	{
+		return _msg;
+	}
+
+	Log::Write(LogLevel_Detail, nodeId, "Combining %d queued (%s) Gets into one MultiCmd frame", (int) batch.size(), c_sendQueueNames[_queue]);
+	Internal::Msg* msg = Internal::CC::MultiCmd::Encapsulate(batch);
+	msg->SetHomeId(m_homeId);
+	msg->Finalize();
+	// The frame has been waiting as long as the first Get in it
+	msg->SetStageTime(Internal::Msg::Stage_Queued, _msg->GetStageTime(Internal::Msg::Stage_Queued));
+	m_batchedMsgs = batch;
+	m_batchedFrame = true;
+	return msg;
+}
+
+//-----------------------------------------------------------------------------
+// <GetEncapsulatedCommand>
+// Find the endpoint (or instance) and command class of a command, looking
+// inside MultiChannel and MultiInstance encapsulation.  For requests we sent
+// the endpoint is the destination, for reports it is the source.
+//-----------------------------------------------------------------------------
+static bool GetEncapsulatedCommand(uint8 const* _cmd, uint32 const _length, bool const _report, uint8* o_endPoint, uint8* o_commandClassId)
+{
+	if ((_length >= 5) && (_cmd[0] == Internal::CC::MultiInstance::StaticGetCommandClassId()) && (_cmd[1] == Internal::CC::MultiInstance::MultiChannelCmd_Encap))
+	{
+		*o_endPoint = (_report ? _cmd[2] : _cmd[3]) & 0x7F;
+		*o_commandClassId = _cmd[4];
+		return true;
+	}
+	if ((_length >= 4) && (_cmd[0] == Internal::CC::MultiInstance::StaticGetCommandClassId()) && (_cmd[1] == Internal::CC::MultiInstance::MultiInstanceCmd_Encap))
+	{
+		*o_endPoint = _cmd[2];
+		*o_commandClassId = _cmd[3];
+		return true;
+	}
+	if (_length >= 1)
+	{
+		*o_endPoint = 0;
+		*o_commandClassId = _cmd[0];
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::HandleBatchedReply>
+// Tick off the Gets in the current MultiCmd frame that a report answers
+//-----------------------------------------------------------------------------
+bool Driver::HandleBatchedReply(uint8 const* _data)
+{
+	if (_data[3] != m_currentMsg->GetTargetNodeId())
+	{
+		return m_batchedMsgs.empty();
+	}
+
+	// The node can answer with separate reports, or encapsulate them too
+	vector<pair<uint8, uint8> > commands;
+	uint8 endPoint;
+	uint8 commandClassId;
+	if ((_data[5] == Internal::CC::MultiCmd::StaticGetCommandClassId()) && (_data[6] == Internal::CC::MultiCmd::MultiCmdCmd_Encap))
+	{
+		uint32 end = 5 + _data[4];
+		uint32 base = 8;
+		for (uint8 i = 0; (i < _data[7]) && (base + _data[base] < end); ++i)
+		{
+			if (GetEncapsulatedCommand(&_data[base + 1], _data[base], true, &endPoint, &commandClassId))
+			{
+				commands.push_back(pair<uint8, uint8>(endPoint, commandClassId));
+			}
+			base += _data[base] + 1;
+		}
+	}
+	else if (GetEncapsulatedCommand(&_data[5], _data[4], true, &endPoint, &commandClassId))
+	{
+		commands.push_back(pair<uint8, uint8>(endPoint, commandClassId));
+	}
+
+	for (vector<pair<uint8, uint8> >::iterator cit = commands.begin(); cit != commands.end(); ++cit)
+	{
+		for (list<Internal::Msg*>::iterator it = m_batchedMsgs.begin(); it != m_batchedMsgs.end(); ++it)
+		{
+			Internal::Msg* msg = *it;
+			if (!GetEncapsulatedCommand(msg->GetPayload(), msg->GetPayloadLength(), false, &endPoint, &commandClassId))
+			{
+				continue;
+			}
+			if (endPoint == 0)
+			{
+				// Unencapsulated Gets can name a different report command class
+				commandClassId = msg->GetExpectedCommandClassId();
+			}
+			if ((endPoint == cit->first) && (commandClassId == cit->second))
+			{
+				Log::Write(LogLevel_Detail, _data[3], "  Received reply to MultiCmd encapsulated %s", msg->GetLogText().c_str());
+				delete msg;
+				m_batchedMsgs.erase(it);
+				break;
+			}
+		}
+	}
+	return m_batchedMsgs.empty();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::UnbatchCurrentMsg>
+// Requeue the unanswered Gets of the current MultiCmd frame individually
+//-----------------------------------------------------------------------------
+void Driver::UnbatchCurrentMsg()
+{
+	Log::Write(LogLevel_Info, GetNodeNumber(m_currentMsg), "MultiCmd frame not fully answered - sending the remaining %d Get(s) individually", (int) m_batchedMsgs.size());
+	m_sendMutex->Lock();
+	while (!m_batchedMsgs.empty())
+	{
+		MsgQueueItem item;
+		item.m_command = MsgQueueCmd_SendMsg;
+		item.m_msg = m_batchedMsgs.back();
+		item.m_nodeId = item.m_msg->GetTargetNodeId();
+		item.m_msg->SetNoBatch();
+		m_msgQueue[m_currentMsgQueueSource].push_front(item);
+		m_batchedMsgs.pop_back();
+	}
+	m_queueEvent[m_currentMsgQueueSource]->Set();
+	m_sendMutex->Unlock();
+	RemoveCurrentMsg();
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::MoveMessagesToWakeUpQueue>
 // Move messages for a sleeping device to its wake-up queue
@@ -1348,7 +1703,23 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 							// This message is for the unresponsive node
 							// We do not move any "Wake Up No More Information"
 							// commands or NoOperations to the pending queue.
-							if (!m_currentMsg->IsWakeUpNoMoreInformationCommand() && !m_currentMsg->IsNoOperation())
+							if (m_batchedFrame)
+							{
+								// Queue the Gets from the MultiCmd frame, rather than the frame itself
+								while (!m_batchedMsgs.empty())
+								{
+									Log::Write(LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_batchedMsgs.front()->GetAsString().c_str());
+									MsgQueueItem item;
+									item.m_command = MsgQueueCmd_SendMsg;
+									item.m_msg = m_batchedMsgs.front();
+									wakeUp->QueueMsg(item);
+									m_batchedMsgs.pop_front();
+								}
+								m_batchedFrame = false;
+								FinishMsgTiming(false);
+								delete m_currentMsg;
+							}
+							else if (!m_currentMsg->IsWakeUpNoMoreInformationCommand() && !m_currentMsg->IsNoOperation())
 							{
 								Log::Write(LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_currentMsg->GetAsString().c_str());
 								/* reset the sendAttempts */
@@ -1361,6 +1732,7 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 							}
 							else
 							{
+								FinishMsgTiming(false);
 								delete m_currentMsg;
 							}
 
@@ -1467,6 +1839,33 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::HasQueuedMsgs>
+// Check whether anything for a node is still waiting to be sent
+//-----------------------------------------------------------------------------
+bool Driver::HasQueuedMsgs(uint8 const _nodeId)
+{
+	bool queued = false;
+	m_sendMutex->Lock();
+	if (m_currentMsg && (m_currentMsg->GetTargetNodeId() == _nodeId))
+	{
+		queued = true;
+	}
+	for (int32 i = 0; !queued && (i < MsgQueue_Count); ++i)
+	{
+		for (list<MsgQueueItem>::iterator it = m_msgQueue[i].begin(); it != m_msgQueue[i].end(); ++it)
+		{
+			if ((MsgQueueCmd_SendMsg == it->m_command) ? (it->m_msg->GetTargetNodeId() == _nodeId) : (it->m_nodeId == _nodeId))
+			{
+				queued = true;
+				break;
+			}
+		}
+	}
+	m_sendMutex->Unlock();
+	return queued;
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleErrorResponse>
 // For messages that return a ZW_SEND_DATA response, process the results here
@@ -1499,11 +1898,13 @@ bool Driver::HandleErrorResponse(uint8 const _error, uint8 const _nodeId, char c
 	else if (_error == TRANSMIT_COMPLETE_FAIL)
 	{
 		m_netbusy++;
+		m_airtimeThrottle->Backoff(GetMsgClock());
 		Log::Write(LogLevel_Info, _nodeId, "ERROR: %s failed. Network is busy.", _funcStr);
 	}
 	else if (_error == TRANSMIT_COMPLETE_NOT_IDLE)
 	{
 		m_notidle++;
+		m_airtimeThrottle->Backoff(GetMsgClock());
 		Log::Write(LogLevel_Info, _nodeId, "ERROR: %s failed. Network is busy.", _funcStr);
 	}
 	else if (_error == TRANSMIT_COMPLETE_VERIFIED)
@@ -1630,6 +2031,7 @@ bool Driver::IsExpectedReply(const uint8 _nodeId)
 //-----------------------------------------------------------------------------
 bool Driver::ReadMsg()
 {
+	Internal::Platform::TraceSpan span("ReadMsg");
 	uint8 buffer[1024];
 
 	memset(buffer, 0, sizeof(uint8) * 1024);
@@ -1772,6 +2174,7 @@ bool Driver::ReadMsg()
 			else
 			{
 				Log::Write(LogLevel_StreamDetail, GetNodeNumber(m_currentMsg), "  ACK received CallbackId 0x%.2x Reply 0x%.2x", m_expectedCallbackId, m_expectedReply);
+				SetCurrentMsgStage(Internal::Msg::Stage_Acked);
 				if ((0 == m_expectedCallbackId) && (0 == m_expectedReply))
 				{
 					// Remove the message from the queue, now that it has been acknowledged.
@@ -1801,6 +2204,7 @@ bool Driver::ReadMsg()
 //-----------------------------------------------------------------------------
 void Driver::ProcessMsg(uint8* _data, uint8 _length)
 {
+	Internal::Platform::TraceSpan span("ProcessMsg 0x%.2x", _data[1]);
 	bool handleCallback = true;
 	bool wasencrypted = false;
 	//uint8 nodeId = GetNodeNumber( m_currentMsg );
@@ -1812,6 +2216,26 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 		{
 			Log::Write(LogLevel_Info, _data[3], "Received SecurityCmd_NonceReport from node %d", _data[3]);
 
+			if ((m_noncePrefetchNodeId == _data[3]) && m_noncePrefetchDelivered && !m_noncePrefetchReceived)
+			{
+				if (IsWaitingForPrefetchedNonce())
+				{
+					// The message it was requested for is already waiting, so send it now
+					m_noncePrefetchNodeId = 0;
+					m_currentMsg->setNonce(&_data[7]);
+					m_currentMsg->SetSendAttempts(m_currentMsg->GetSendAttempts() + 1);
+					this->SendEncryptedMessage();
+				}
+				else
+				{
+					// Hold on to it until its message reaches the front of the queue
+					memcpy(m_noncePrefetched, &_data[7], 8);
+					m_noncePrefetchReceived = true;
+					m_noncePrefetchTS.SetTime(c_noncePrefetchLifetime);
+				}
+				return;
+			}
+
 			/* handle possible resends of NONCE_REPORT messages.... See Issue #931 */
 			if (!m_currentMsg)
 			{
@@ -1830,7 +2254,7 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 		{
 			Log::Write(LogLevel_Info, _data[3], "Received SecurityCmd_NonceGet from node %d", _data[3]);
 			{
-				uint8 *nonce = NULL;
+				uint8 const* nonce = NULL;
 				Internal::LockGuard LG(m_nodeMutex);
 				Node* node = GetNode(_data[3]);
 				if (node)
@@ -1855,7 +2279,7 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 		{
 			uint8 _newdata[256];
 			uint8 SecurityCmd = _data[6];
-			uint8 *_nonce;
+			uint8 const* _nonce;
 
 			/* clear out NONCE Report tracking */
 			m_nonceReportSent = 0;
@@ -2375,7 +2799,17 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 				if (m_expectedCallbackId == _data[2])
 				{
 					Log::Write(LogLevel_Detail, GetNodeNumber(m_currentMsg), "  Expected callbackId was received");
+					SetCurrentMsgStage(Internal::Msg::Stage_Callback);
 					m_expectedCallbackId = 0;
+					if (m_batchedFrame && m_batchedMsgs.empty())
+					{
+						// The reports for every Get in the MultiCmd frame arrived before its callback
+						Log::Write(LogLevel_Detail, GetNodeNumber(m_currentMsg), "  Expected replies to all MultiCmd encapsulated commands were already received");
+						m_waitingForAck = false;
+						m_expectedReply = 0;
+						m_expectedCommandClassId = 0;
+						m_expectedNodeId = 0;
+					}
 				}
 				else if (_data[2] == 0x02 || _data[2] == 0x01)
 				{
@@ -2387,7 +2821,19 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 			{
 				if (m_expectedReply == _data[1])
 				{
-					if (m_expectedCommandClassId && (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER))
+					if (m_batchedFrame && (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER))
+					{
+						// The transaction is not over until the frame's callback has arrived too
+						if (HandleBatchedReply(_data) && (m_expectedCallbackId == 0))
+						{
+							Log::Write(LogLevel_Detail, _data[3], "  Expected replies to all MultiCmd encapsulated commands were received");
+							m_waitingForAck = false;
+							m_expectedReply = 0;
+							m_expectedCommandClassId = 0;
+							m_expectedNodeId = 0;
+						}
+					}
+					else if (m_expectedCommandClassId && (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER))
 					{
 						if (m_expectedCallbackId == 0 && m_expectedCommandClassId == _data[5] && m_expectedNodeId == _data[3])
 						{
@@ -2742,7 +3188,10 @@ void Driver::HandleSerialAPIGetInitDataResponse(uint8* _data)
 		Manager::Get()->SetDriverReady(this, true);
 
 		// Read the config file first, to get the last known state
+		Internal::Platform::TimeStamp start;
 		ReadCache();
+		m_cacheLoadTime = (uint32) (Internal::Platform::TimeStamp() - start);
+		Log::Write(LogLevel_Info, "Reading the network cache took %d ms", m_cacheLoadTime);
 	}
 	else
 	{
@@ -2779,9 +3228,20 @@ void Driver::HandleSerialAPIGetInitDataResponse(uint8* _data)
 							Log::Write(LogLevel_Info, GetNodeNumber(m_currentMsg), "    Node %.3d - Known", nodeId);
 							if (!m_init)
 							{
-								// The node was read in from the config, so we
-								// only need to get its current state
-								node->SetQueryStage(Node::QueryStage_CacheLoad);
+								Node::QueryStage stage = node->GetCurrentQueryStage();
+								if ((stage > Node::QueryStage_ProtocolInfo) && (stage < Node::QueryStage_CacheLoad))
+								{
+									// The config only holds part of the interview, so
+									// carry on from the stage it was saved at
+									Log::Write(LogLevel_Info, nodeId, "    Node %.3d - Resuming interview at %s", nodeId, node->GetQueryStageName(stage).c_str());
+									node->ResumeQueryStage(stage);
+								}
+								else
+								{
+									// The node was read in from the config, so we
+									// only need to get its current state
+									node->SetQueryStage(Node::QueryStage_CacheLoad);
+								}
 							}
 
 						}
@@ -3079,6 +3539,21 @@ void Driver::HandleGetRoutingInfoResponse(uint8* _data)
 void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replication)
 {
 	uint8 nodeId = GetNodeNumber(m_currentMsg);
+	if (!_replication && (m_noncePrefetchNodeId != 0) && (m_noncePrefetchCallbackId != 0) && (_data[2] == m_noncePrefetchCallbackId))
+	{
+		// The prefetch Nonce Get is a transaction of its own, so it is completed
+		// below like any other message.  Only a delivered one can be answered.
+		m_noncePrefetchCallbackId = 0;
+		if (_data[3] == TRANSMIT_COMPLETE_OK)
+		{
+			m_noncePrefetchDelivered = true;
+		}
+		else
+		{
+			Log::Write(LogLevel_Info, m_noncePrefetchNodeId, "Prefetch Nonce Get was not delivered");
+			m_noncePrefetchNodeId = 0;
+		}
+	}
 	Log::Write(LogLevel_Detail, nodeId, "  %s Request with callback ID 0x%.2x received (expected 0x%.2x)", _replication ? "ZW_REPLICATION_SEND_DATA" : "ZW_SEND_DATA", _data[2], _data[2] < 10 ? _data[2] : m_expectedCallbackId);
 	/* Callback ID's below 10 are reserved for NONCE messages */
 	if ((_data[2] > 10) && (_data[2] != m_expectedCallbackId))
@@ -3089,6 +3564,14 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 	}
 	else
 	{
+		// petergebruers:
+		// because OpenZWave uses "ms" everywhere, and wTransmitTicks
+		// has "10 ms" as unit... multiply by 10. This wil avoid
+		// confusion when people look at stats or log files.
+		// If the controller does not report how long the frame took, it is estimated.
+		// petergebruers, changed test (_length > 7) to >= 23 to avoid extracting non-existent data, highest is _data[22]
+		bool const hasTxStatus = (_length >= 23);
+		uint32 const txTime = hasTxStatus ? (_data[5] + (_data[4] << 8)) * 10 : c_estimatedAirtime;
 		Node* node = GetNodeUnsafe(nodeId);
 		if (node != NULL)
 		{
@@ -3110,19 +3593,17 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 					// if this is the first observed RTT, set the average to this value
 					node->m_averageRequestRTT = node->m_lastRequestRTT;
 				}
+				node->m_requestLatency.Record(node->m_lastRequestRTT);
+				m_requestLatency.Record(node->m_lastRequestRTT);
 				Log::Write(LogLevel_Info, nodeId, "Request RTT %d Average Request RTT %d", node->m_lastRequestRTT, node->m_averageRequestRTT);
 			}
 			/* if the frame has txStatus message, then extract it */
-			// petergebruers, changed test (_length > 7) to >= 23 to avoid extracting non-existent data, highest is _data[22]
-			if (_length >= 23)
+			if (hasTxStatus)
 			{
 				node->m_txStatusReportSupported = true;
-				// petergebruers:
-				// because OpenZWave uses "ms" everywhere, and wTransmitTicks
-				// has "10 ms" as unit... multiply by 10. This wil avoid
-				// confusion when people look at stats or log files.
-				node->m_txTime = (_data[5] + (_data[4] << 8)) * 10;
+				node->m_txTime = (uint16) txTime;
 				node->m_hops = _data[6];
+				RecordAirtime(node, node->m_txTime);
 				// petergebruers: there are 5 rssi values because there are
 				// 4 repeaters + 1 sending node
 				strncpy(node->m_rssi_1, Internal::rssi_to_string(_data[7]), sizeof(node->m_rssi_1) - 1);
@@ -3150,6 +3631,12 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 
 		}
 
+		// Frames from the Query and Poll queues use up their airtime budget
+		if (m_currentMsg && IsThrottled(m_currentMsgQueueSource))
+		{
+			m_airtimeThrottle->Charge(GetMsgClock(), txTime);
+		}
+
 		// We do this here since HandleErrorResponse/MoveMessagesToWakeUpQueue can delete m_currentMsg
 		if (m_currentMsg && m_currentMsg->IsNoOperation())
 		{
@@ -3178,7 +3665,7 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 				if (Internal::CC::WakeUp* wakeUp = static_cast<Internal::CC::WakeUp*>(node->GetCommandClass(Internal::CC::WakeUp::StaticGetCommandClassId())))
 				{
 					// Mark the node as asleep
-					wakeUp->SetAwake(false);
+					wakeUp->NoMoreInformationAcked();
 				}
 			}
 			// If node is not alive, mark it alive now
@@ -3585,6 +4072,7 @@ void Driver::HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted
 	if ((status & RECEIVE_STATUS_ROUTED_BUSY) != 0)
 	{
 		m_routedbusy++;
+		m_airtimeThrottle->Backoff(GetMsgClock());
 	}
 	if ((status & RECEIVE_STATUS_TYPE_BROAD) != 0)
 	{
@@ -3621,6 +4109,8 @@ void Driver::HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted
 				// if this is the first observed RTT, set the average to this value
 				node->m_averageResponseRTT = node->m_lastResponseRTT;
 			}
+			node->m_responseLatency.Record(node->m_lastResponseRTT);
+			m_responseLatency.Record(node->m_lastResponseRTT);
 			Log::Write(LogLevel_Info, nodeId, "Response RTT %d Average Response RTT %d", node->m_lastResponseRTT, node->m_averageResponseRTT);
 		}
 		else
@@ -4327,6 +4817,7 @@ void Driver::PollThreadProc(Internal::Platform::Event* _exitEvent)
 			}
 
 			{
+				Internal::Platform::TraceSpan span("Poll");
 				Internal::LockGuard LG(m_nodeMutex);
 				// Request the state of the value from the node to which it belongs
 				if (Node* node = GetNode(valueId.GetNodeId()))
@@ -4356,6 +4847,7 @@ void Driver::PollThreadProc(Internal::Platform::Event* _exitEvent)
 							uint8_t instance = valueId.GetInstance();
 							Log::Write(LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size());
 							cc->RequestValue(0, index, instance, MsgQueue_Poll);
+							m_pollCnt++;
 						}
 					}
 
@@ -4371,6 +4863,7 @@ void Driver::PollThreadProc(Internal::Platform::Event* _exitEvent)
 			// Wait until the library isn't actively sending messages (or in the midst of a transaction)
 			int i32;
 			int loopCount = 0;
+			Internal::Platform::TraceSpan queueSpan("Wait for the send queues");
 			while (!m_msgQueue[MsgQueue_Poll].empty() || !m_msgQueue[MsgQueue_Send].empty() || !m_msgQueue[MsgQueue_Command].empty() || !m_msgQueue[MsgQueue_Query].empty() || m_currentMsg != NULL)
 			{
 				i32 = Internal::Platform::Wait::Single(_exitEvent, 10);		// test conditions every 10ms
@@ -4389,6 +4882,7 @@ void Driver::PollThreadProc(Internal::Platform::Event* _exitEvent)
 			}
 
 			// ready for next poll...insert the pollInterval delay
+			Internal::Platform::TraceSpan waitSpan("Wait");
 			i32 = Internal::Platform::Wait::Single(_exitEvent, pollInterval);
 			if (i32 == 0)
 			{
@@ -5887,6 +6381,7 @@ void Driver::RemoveAssociation(uint8 const _nodeId, uint8 const _groupIdx, uint8
 void Driver::QueueNotification(Notification* _notification)
 {
 	m_notifications.push_back(_notification);
+	m_notificationCnt++;
 	m_notificationsEvent->Set();
 }
 
@@ -5896,6 +6391,7 @@ void Driver::QueueNotification(Notification* _notification)
 //-----------------------------------------------------------------------------
 void Driver::NotifyWatchers()
 {
+	Internal::Platform::TraceSpan span("NotifyWatchers");
 	list<Notification*>::iterator nit = m_notifications.begin();
 	while (nit != m_notifications.end())
 	{
@@ -6554,6 +7050,28 @@ void Driver::GetDriverStatistics(DriverData* _data)
 	_data->m_routedbusy = m_routedbusy;
 	_data->m_broadcastReadCnt = m_broadcastReadCnt;
 	_data->m_broadcastWriteCnt = m_broadcastWriteCnt;
+	_data->m_pollCnt = m_pollCnt;
+	_data->m_notificationCnt = m_notificationCnt;
+	_data->m_throttled = m_airtimeThrottle->GetExhausted();
+	_data->m_throttleBackoffs = m_airtimeThrottle->GetBackoffs();
+
+	Internal::ConfigLoader const* loader = Manager::Get()->m_configLoader;
+	_data->m_localizationLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_Localization);
+	_data->m_notificationTypesLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_NotificationCCTypes);
+	_data->m_sensorTypesLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_SensorMultiLevelCCTypes);
+	_data->m_productDBLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_ManufacturerSpecificDB);
+	_data->m_deviceClassesLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_DeviceClasses);
+	_data->m_scenesLoadTime = loader->GetPhaseTime(Internal::ConfigLoader::Phase_Scenes);
+	_data->m_configLoadTime = loader->GetTotalTime();
+	_data->m_cacheLoadTime = m_cacheLoadTime;
+	_data->m_requestLatency = m_requestLatency;
+	_data->m_responseLatency = m_responseLatency;
+	_data->m_setValueLatency = m_setValueLatency;
+
+	m_sendMutex->Lock();
+	_data->m_airtime = m_airtime;
+	m_sendMutex->Unlock();
+	_data->m_airtime.Advance(GetMsgClock());
 }
 
 //-----------------------------------------------------------------------------
@@ -6611,9 +7129,419 @@ void Driver::LogDriverStatistics()
 	Log::Write(LogLevel_Always, "Out of frame data flow errors:  . . . . . . . . . . . . . %ld", data.m_OOFCnt);
 	Log::Write(LogLevel_Always, "Messages retransmitted: . . . . . . . . . . . . . . . . . %ld", data.m_retries);
 	Log::Write(LogLevel_Always, "Messages dropped and not delivered: . . . . . . . . . . . %ld", data.m_dropped);
+	Log::Write(LogLevel_Always, "Poll and Query airtime budget used up:  . . . . . . . . . %ld", data.m_throttled);
+	Log::Write(LogLevel_Always, "Airtime budget halved, network busy:  . . . . . . . . . . %ld", data.m_throttleBackoffs);
+	Log::Write(LogLevel_Always, "*** Startup");
+	Log::Write(LogLevel_Always, "Config files loaded in (ms):  . . . . . . . . . . . . . . %ld", data.m_configLoadTime);
+	Log::Write(LogLevel_Always, "Network cache read in (ms): . . . . . . . . . . . . . . . %ld", data.m_cacheLoadTime);
+	Log::Write(LogLevel_Always, "*** Latency (ms)                 count     p50     p90     p99     max");
+	Log::Write(LogLevel_Always, "Request (controller callback): %7d %7d %7d %7d %7d", data.m_requestLatency.GetCount(), data.m_requestLatency.GetP50(), data.m_requestLatency.GetP90(), data.m_requestLatency.GetP99(), data.m_requestLatency.GetMax());
+	Log::Write(LogLevel_Always, "Response (device report):      %7d %7d %7d %7d %7d", data.m_responseLatency.GetCount(), data.m_responseLatency.GetP50(), data.m_responseLatency.GetP90(), data.m_responseLatency.GetP99(), data.m_responseLatency.GetMax());
+	Log::Write(LogLevel_Always, "Set Value (until confirmed):   %7d %7d %7d %7d %7d", data.m_setValueLatency.GetCount(), data.m_setValueLatency.GetP50(), data.m_setValueLatency.GetP90(), data.m_setValueLatency.GetP99(), data.m_setValueLatency.GetMax());
+	Log::Write(LogLevel_Always, "*** Send Queues (p50/p90 ms)     done  failed   queue   write     ack  callback   reply");
+	for (int32 i = 0; i < MsgQueue_Count; ++i)
+	{
+		MsgQueueData queue;
+		GetMsgQueueStatistics((MsgQueue) i, &queue);
+		if (queue.m_completed + queue.m_failed == 0)
+		{
+			continue;
+		}
+		Log::Write(LogLevel_Always, "%-10s                    %7d %7d %3d/%-4d %3d/%-4d %3d/%-4d %3d/%-4d %3d/%-4d", c_sendQueueNames[i], queue.m_completed, queue.m_failed, queue.m_queueWait.GetP50(), queue.m_queueWait.GetP90(), queue.m_writeWait.GetP50(), queue.m_writeWait.GetP90(), queue.m_ackWait.GetP50(), queue.m_ackWait.GetP90(), queue.m_callbackWait.GetP50(), queue.m_callbackWait.GetP90(), queue.m_replyWait.GetP50(), queue.m_replyWait.GetP90());
+	}
+	LogAirtimeStatistics(data.m_airtime);
+	LogHandlerStatistics();
+	LogLockStatistics();
 	Log::Write(LogLevel_Always, "***************************************************************************");
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::LogAirtimeStatistics>
+// Report the airtime used by each queue, command class and the busiest nodes
+//-----------------------------------------------------------------------------
+void Driver::LogAirtimeStatistics(AirtimeCounter const& _network)
+{
+	if (_network.GetFrames() == 0)
+	{
+		// The controller does not report transmit times
+		return;
+	}
+	Log::Write(LogLevel_Always, "*** Airtime (ms)                frames       total  last min last hour");
+	Log::Write(LogLevel_Always, "Network                       %7d %11llu %9d %9d", _network.GetFrames(), (unsigned long long) _network.GetTotal(), _network.GetLastMinute(), _network.GetLastHour());
+	for (int32 i = 0; i < MsgQueue_Count; ++i)
+	{
+		MsgQueueData queue;
+		GetMsgQueueStatistics((MsgQueue) i, &queue);
+		if (queue.m_airtime.GetFrames() != 0)
+		{
+			Log::Write(LogLevel_Always, "  %-10s Queue            %7d %11llu %9d %9d", c_sendQueueNames[i], queue.m_airtime.GetFrames(), (unsigned long long) queue.m_airtime.GetTotal(), queue.m_airtime.GetLastMinute(), queue.m_airtime.GetLastHour());
+		}
+	}
+	for (int32 i = 0; i < 256; ++i)
+	{
+		AirtimeCounter airtime;
+		if (GetCommandClassAirtime((uint8) i, &airtime))
+		{
+			Log::Write(LogLevel_Always, "  %-28s%7d %11llu %9d %9d", Internal::CC::CommandClasses::GetName((uint8) i).c_str(), airtime.GetFrames(), (unsigned long long) airtime.GetTotal(), airtime.GetLastMinute(), airtime.GetLastHour());
+		}
+	}
+
+	// Only the nodes that used the most airtime in the last hour, to keep the log short
+	std::vector<std::pair<uint32, uint8> > nodes;
+	{
+		Internal::LockGuard LG(m_nodeMutex);
+		uint32 now = GetMsgClock();
+		for (int32 i = 1; i < 256; ++i)
+		{
+			if (m_nodes[i] != NULL)
+			{
+				AirtimeCounter airtime = m_nodes[i]->m_airtime;
+				airtime.Advance(now);
+				if (airtime.GetLastHour() != 0)
+				{
+					nodes.push_back(std::make_pair(airtime.GetLastHour(), (uint8) i));
+				}
+			}
+		}
+	}
+	std::sort(nodes.rbegin(), nodes.rend());
+	for (size_t i = 0; (i < nodes.size()) && (i < 5); ++i)
+	{
+		Node::NodeData nodeData;
+		GetNodeStatistics(nodes[i].second, &nodeData);
+		Log::Write(LogLevel_Always, "  Node %3d                    %7d %11llu %9d %9d", nodes[i].second, nodeData.m_airtime.GetFrames(), (unsigned long long) nodeData.m_airtime.GetTotal(), nodeData.m_airtime.GetLastMinute(), nodeData.m_airtime.GetLastHour());
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::LogHandlerStatistics>
+// Report the time each command class spent handling the messages received
+//-----------------------------------------------------------------------------
+void Driver::LogHandlerStatistics()
+{
+	if (!Internal::CC::CommandClass::IsHandlerProfiling())
+	{
+		return;
+	}
+
+	// Summed over the nodes, as it is the handler code that is being measured
+	uint32 calls[256] = { 0 };
+	uint64 time[256] = { 0 };
+	uint32 maxTime[256] = { 0 };
+	{
+		Internal::LockGuard LG(m_nodeMutex);
+		for (int32 i = 1; i < 256; ++i)
+		{
+			if (m_nodes[i] == NULL)
+			{
+				continue;
+			}
+			for (map<uint8, Internal::CC::CommandClass*>::const_iterator it = m_nodes[i]->m_commandClassMap.begin(); it != m_nodes[i]->m_commandClassMap.end(); ++it)
+			{
+				calls[it->first] += it->second->GetHandlerCalls();
+				time[it->first] += it->second->GetHandlerTime();
+				maxTime[it->first] = std::max(maxTime[it->first], it->second->GetHandlerMaxTime());
+			}
+		}
+	}
+
+	std::vector<std::pair<uint64, uint8> > commandClasses;
+	for (int32 i = 0; i < 256; ++i)
+	{
+		if (calls[i] != 0)
+		{
+			commandClasses.push_back(std::make_pair(time[i], (uint8) i));
+		}
+	}
+	if (commandClasses.empty())
+	{
+		return;
+	}
+	std::sort(commandClasses.rbegin(), commandClasses.rend());
+	Log::Write(LogLevel_Always, "*** Message handlers (us)       calls       total      mean       max");
+	for (size_t i = 0; i < commandClasses.size(); ++i)
+	{
+		uint8 id = commandClasses[i].second;
+		Log::Write(LogLevel_Always, "  %-28s%7d %11llu %9d %9d", Internal::CC::CommandClasses::GetName(id).c_str(), calls[id], (unsigned long long) time[id], (int) (time[id] / calls[id]), maxTime[id]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::LogLockStatistics>
+// Report the contention on the mutexes the driver uses
+//-----------------------------------------------------------------------------
+void Driver::LogLockStatistics()
+{
+	std::vector<LockData> locks;
+	if (!GetLockStatistics(&locks))
+	{
+		return;
+	}
+	Log::Write(LogLevel_Always, "*** Locks (us)                      locks  contended   total wait  max wait   max hold");
+	for (std::vector<LockData>::const_iterator it = locks.begin(); it != locks.end(); ++it)
+	{
+		Internal::Platform::Mutex::Statistics const& stats = it->m_statistics;
+		Log::Write(LogLevel_Always, "  %-30s%11llu %10llu %12llu %9llu %10llu", it->m_name, (unsigned long long) stats.m_acquisitions, (unsigned long long) stats.m_contended, (unsigned long long) stats.m_waitTime, (unsigned long long) stats.m_maxWaitTime, (unsigned long long) stats.m_maxHoldTime);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetMsgQueueStatistics>
+// Return the send pipeline timing for one of the queues
+//-----------------------------------------------------------------------------
+bool Driver::GetMsgQueueStatistics(MsgQueue const _queue, MsgQueueData* _data)
+{
+	if ((_queue < 0) || (_queue >= MsgQueue_Count))
+	{
+		return false;
+	}
+	m_sendMutex->Lock();
+	*_data = m_queueStats[_queue];
+	m_sendMutex->Unlock();
+	_data->m_airtime.Advance(GetMsgClock());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetCommandClassAirtime>
+// Return the airtime used by the frames carrying one command class
+//-----------------------------------------------------------------------------
+bool Driver::GetCommandClassAirtime(uint8 const _commandClassId, AirtimeCounter* _data)
+{
+	Internal::LockGuard LG(m_sendMutex);
+	map<uint8, AirtimeCounter>::const_iterator it = m_commandClassAirtime.find(_commandClassId);
+	if (it == m_commandClassAirtime.end())
+	{
+		return false;
+	}
+	*_data = it->second;
+	_data->Advance(GetMsgClock());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetLockStatistics>
+// Return the statistics of the driver's mutexes, and of those it shares with
+// the other drivers
+//-----------------------------------------------------------------------------
+bool Driver::GetLockStatistics(std::vector<LockData>* _data)
+{
+	_data->clear();
+	if (!Internal::Platform::Mutex::IsProfiling())
+	{
+		return false;
+	}
+	Internal::Platform::Mutex* mutexes[] =
+	{ m_nodeMutex, m_sendMutex, m_pollMutex, m_timer->m_timerMutex, Manager::Get()->m_notificationMutex, Log::s_instance ? Log::s_instance->m_logMutex : NULL };
+	for (size_t i = 0; i < sizeof(mutexes) / sizeof(mutexes[0]); ++i)
+	{
+		if (mutexes[i] != NULL)
+		{
+			LockData lock;
+			lock.m_name = mutexes[i]->GetName();
+			mutexes[i]->GetStatistics(&lock.m_statistics);
+			_data->push_back(lock);
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::RecordAirtime>
+// Account the airtime of a frame sent for the current message to its node,
+// command class and queue
+//-----------------------------------------------------------------------------
+void Driver::RecordAirtime(Node* _node, uint32 const _ms)
+{
+	uint32 now = GetMsgClock();
+	_node->m_airtime.Record(now, _ms);
+
+	// Every attempt has its own transmit status, so retries are counted too.
+	// Frames are counted under the outermost command class they carry, so
+	// Multi Channel encapsulated ones are counted under Multi Channel.
+	uint8 commandClassId = 0;
+	if (m_currentMsg != NULL)
+	{
+		commandClassId = m_currentMsg->GetSendingCommandClass();
+		if (Internal::CC::CommandClass* cc = _node->GetCommandClass(commandClassId))
+		{
+			cc->AirtimeAdd(_ms);
+		}
+	}
+
+	Internal::LockGuard LG(m_sendMutex);
+	m_airtime.Record(now, _ms);
+	if (m_currentMsg != NULL)
+	{
+		m_queueStats[m_currentMsgQueueSource].m_airtime.Record(now, _ms);
+		m_commandClassAirtime[commandClassId].Record(now, _ms);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetMsgQueueName>
+// Name of one of the send queues
+//-----------------------------------------------------------------------------
+char const* Driver::GetMsgQueueName(MsgQueue const _queue)
+{
+	if ((_queue < 0) || (_queue >= MsgQueue_Count))
+	{
+		return "Unknown";
+	}
+	return c_sendQueueNames[_queue];
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetMsgTraceCallback>
+// Set (or with NULL, clear) the function that is passed each message's timing
+//-----------------------------------------------------------------------------
+void Driver::SetMsgTraceCallback(pfnOnMsgTrace_t _callback, void* _context)
+{
+	m_sendMutex->Lock();
+	m_msgTraceCallback = _callback;
+	m_msgTraceContext = _context;
+	m_sendMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetMsgClock>
+// Milliseconds since the driver started, for timing messages
+//-----------------------------------------------------------------------------
+uint32 Driver::GetMsgClock()
+{
+	// The clock wraps after 49 days, which unsigned differences survive
+	return (uint32) (-m_startTime.TimeRemaining());
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SetCurrentMsgStage>
+// Record that the current message has reached a stage of the send pipeline
+//-----------------------------------------------------------------------------
+void Driver::SetCurrentMsgStage(Internal::Msg::Stage const _stage)
+{
+	if (m_currentMsg == NULL)
+	{
+		return;
+	}
+	uint32 now = GetMsgClock();
+	switch (_stage)
+	{
+		case Internal::Msg::Stage_Written:
+		{
+			if (!m_currentMsg->HasStage(Internal::Msg::Stage_FirstWritten))
+			{
+				m_currentMsg->SetStageTime(Internal::Msg::Stage_FirstWritten, now);
+			}
+			// Only the ACK and callback of the last attempt count
+			m_currentMsg->ClearStage(Internal::Msg::Stage_Acked);
+			m_currentMsg->ClearStage(Internal::Msg::Stage_Callback);
+			break;
+		}
+		case Internal::Msg::Stage_Acked:
+		case Internal::Msg::Stage_Callback:
+		{
+			// ACKs and callbacks for the Nonce Get of a secure message come
+			// before the message itself has been written, and do not count
+			if (!m_currentMsg->HasStage(Internal::Msg::Stage_Written) || m_currentMsg->HasStage(_stage))
+			{
+				return;
+			}
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+	m_currentMsg->SetStageTime(_stage, now);
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::FinishMsgTiming>
+// Add the timing of the current message, which is being removed, to the queue
+// statistics and pass it to the trace callback
+//-----------------------------------------------------------------------------
+void Driver::FinishMsgTiming(bool const _completed)
+{
+	Internal::Msg* msg = m_currentMsg;
+	if (!msg->HasStage(Internal::Msg::Stage_Queued) || !msg->HasStage(Internal::Msg::Stage_Dequeued))
+	{
+		// Not sent through the queues
+		return;
+	}
+	if (_completed)
+	{
+		msg->SetStageTime(Internal::Msg::Stage_Completed, GetMsgClock());
+	}
+
+	uint32 queued = msg->GetStageTime(Internal::Msg::Stage_Queued);
+	uint32 dequeued = msg->GetStageTime(Internal::Msg::Stage_Dequeued);
+	uint32 written = msg->GetStageTime(Internal::Msg::Stage_Written);
+	uint32 acked = msg->GetStageTime(Internal::Msg::Stage_Acked);
+	uint32 callback = msg->GetStageTime(Internal::Msg::Stage_Callback);
+	uint32 completed = msg->GetStageTime(Internal::Msg::Stage_Completed);
+
+	m_sendMutex->Lock();
+	MsgQueueData& stats = m_queueStats[m_currentMsgQueueSource];
+	if (_completed)
+	{
+		stats.m_completed++;
+		stats.m_total.Record(completed - queued);
+	}
+	else
+	{
+		stats.m_failed++;
+	}
+	stats.m_queueWait.Record(dequeued - queued);
+	if (msg->HasStage(Internal::Msg::Stage_Written))
+	{
+		uint32 firstWritten = msg->GetStageTime(Internal::Msg::Stage_FirstWritten);
+		stats.m_writeWait.Record(firstWritten - dequeued);
+		if (msg->GetSendAttempts() > 1)
+		{
+			stats.m_retried++;
+			stats.m_retryTime.Record(written - firstWritten);
+		}
+
+		uint32 last = written;
+		if (msg->HasStage(Internal::Msg::Stage_Acked))
+		{
+			stats.m_ackWait.Record(acked - last);
+			last = acked;
+		}
+		if (msg->HasStage(Internal::Msg::Stage_Callback))
+		{
+			stats.m_callbackWait.Record(callback - last);
+			last = callback;
+		}
+		if (_completed && (msg->GetExpectedReply() != 0))
+		{
+			stats.m_replyWait.Record(completed - last);
+		}
+	}
+	pfnOnMsgTrace_t traceCallback = m_msgTraceCallback;
+	void* traceContext = m_msgTraceContext;
+	m_sendMutex->Unlock();
+
+	if (traceCallback != NULL)
+	{
+		MsgTrace trace;
+		trace.m_nodeId = msg->GetTargetNodeId();
+		trace.m_callbackId = msg->GetCallbackId();
+		trace.m_function = msg->GetFunction();
+		trace.m_commandClassId = msg->GetSendingCommandClass();
+		trace.m_attempts = msg->GetSendAttempts();
+		trace.m_completed = _completed;
+		trace.m_queue = m_currentMsgQueueSource;
+		for (int32 i = 0; i < Internal::Msg::Stage_Count; ++i)
+		{
+			Internal::Msg::Stage stage = (Internal::Msg::Stage) i;
+			trace.m_stageTime[i] = msg->HasStage(stage) ? (int32) (msg->GetStageTime(stage) - queued) : -1;
+		}
+		traceCallback(&trace, traceContext);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::GetNetworkKey>
 // Get the Network Key we will use for Security Command Class
@@ -6673,11 +7601,16 @@ bool Driver::SendEncryptedMessage()
 
 	m_controller->Write(buffer, length);
 	m_currentMsg->clearNonce();
+	SetCurrentMsgStage(Internal::Msg::Stage_Written);
 
 	return true;
 }
 
-bool Driver::SendNonceRequest(string logmsg)
+//-----------------------------------------------------------------------------
+// <Driver::SendNonceRequest>
+// Ask a node for a nonce to encrypt a message with
+//-----------------------------------------------------------------------------
+bool Driver::SendNonceRequest(string logmsg, uint8 nodeId, uint8 callbackId, MsgQueue queue)
 {
 
 	uint8 m_buffer[11];
@@ -6687,7 +7620,7 @@ bool Driver::SendNonceRequest(string logmsg)
 	m_buffer[1] = 9;					// Length of the entire message
 	m_buffer[2] = REQUEST;
 	m_buffer[3] = FUNC_ID_ZW_SEND_DATA;
-	m_buffer[4] = m_currentMsg->GetTargetNodeId();
+	m_buffer[4] = nodeId;
 	m_buffer[5] = 2; 					// Length of the payload
 	m_buffer[6] = Internal::CC::Security::StaticGetCommandClassId();
 	m_buffer[7] = Internal::CC::SecurityCmd_NonceGet;
@@ -6695,20 +7628,153 @@ bool Driver::SendNonceRequest(string logmsg)
 	m_buffer[8] = TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE;
 	/* this is the same as the Actual Message */
 	//m_buffer[9] = m_expectedCallbackId;
-	m_buffer[9] = 2;
+	m_buffer[9] = callbackId;
 	// Calculate the checksum
 	m_buffer[10] = 0xff;
 	for (uint32 i = 1; i < 10; ++i)
 	{
 		m_buffer[10] ^= m_buffer[i];
 	}
-	Log::Write(LogLevel_Info, m_currentMsg->GetTargetNodeId(), "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Get(%s) - %s:", c_sendQueueNames[m_currentMsgQueueSource], 2, m_expectedReply, logmsg.c_str(), Internal::PktToString(m_buffer, 10).c_str());
+	Log::Write(LogLevel_Info, nodeId, "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Get(%s) - %s:", c_sendQueueNames[queue], callbackId, m_expectedReply, logmsg.c_str(), Internal::PktToString(m_buffer, 10).c_str());
 
 	m_controller->Write(m_buffer, 11);
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::PrefetchNonce>
+// When nothing is in flight and a secure message is queued behind other
+// messages, send its Nonce Get first.  The node prepares the nonce while the
+// messages in front of it are sent, so the encrypted frame can go out as soon
+// as it reaches the front of the queue.
+//-----------------------------------------------------------------------------
+void Driver::PrefetchNonce(MsgQueue const _queueEnd)
+{
+	if (!m_noncePrefetch || m_currentMsg || m_waitingForAck || (m_expectedCallbackId != 0) || (m_expectedReply != 0) || m_nonceReportSent)
+	{
+		return;
+	}
+	if (m_noncePrefetchNodeId != 0)
+	{
+		if (m_noncePrefetchTS.TimeRemaining() > 0)
+		{
+			// Only one nonce in flight (or held) at a time
+			return;
+		}
+		m_noncePrefetchNodeId = 0;
+	}
+
+	// Find a secure message a little way behind the one the driver thread
+	// will send next.  If the next one is secure itself there is nothing to
+	// overlap, and it asks for its own nonce.
+	Internal::LockGuard LG(m_nodeMutex);
+	m_sendMutex->Lock();
+	int32 front = -1;
+	uint8 nodeId = 0;
+	uint32 seen = 0;
+	bool done = false;
+	for (int32 i = 0; (i < _queueEnd) && !done; ++i)
+	{
+		for (list<MsgQueueItem>::const_iterator it = m_msgQueue[i].begin(); (it != m_msgQueue[i].end()) && !done; ++it)
+		{
+			if (front < 0)
+			{
+				front = i;
+			}
+			if (MsgQueueCmd_SendMsg != it->m_command)
+			{
+				continue;
+			}
+			Internal::Msg* msg = it->m_msg;
+			if (msg->isEncrypted() && !msg->isNonceRecieved() && (msg->GetTargetNodeId() != 0xff))
+			{
+				if (seen > 0)
+				{
+					nodeId = msg->GetTargetNodeId();
+				}
+				done = true;
+			}
+			else if (++seen > c_noncePrefetchLookahead)
+			{
+				done = true;
+			}
+		}
+	}
+	// Nodes that can be moved to the Wake-Up queue are left alone, so the Nonce Get never is
+	Node* node = (nodeId != 0) ? GetNode(nodeId) : NULL;
+	if ((node == NULL) || !node->IsNodeAlive() || (!node->IsListeningDevice() && !node->IsFrequentListeningDevice()))
+	{
+		m_sendMutex->Unlock();
+		return;
+	}
+
+	Internal::Msg* msg = new Internal::Msg("SecurityCmd_NonceGet (prefetch)", nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+	msg->Append(nodeId);
+	msg->Append(2);
+	msg->Append(Internal::CC::Security::StaticGetCommandClassId());
+	msg->Append(Internal::CC::SecurityCmd_NonceGet);
+	msg->Append(GetTransmitOptions());
+	msg->SetHomeId(m_homeId);
+	msg->Finalize();
+	// A retry would get a new callback ID, and by then the nonce would be stale anyway
+	msg->SetMaxSendAttempts(1);
+	msg->SetStageTime(Internal::Msg::Stage_Queued, GetMsgClock());
+
+	Log::Write(LogLevel_Detail, nodeId, "Prefetching Nonce for a queued secure message");
+	m_noncePrefetchNodeId = nodeId;
+	m_noncePrefetchCallbackId = msg->GetCallbackId();
+	m_noncePrefetchDelivered = false;
+	m_noncePrefetchReceived = false;
+	m_noncePrefetchTS.SetTime(c_noncePrefetchTimeout);
+
+	MsgQueueItem item;
+	item.m_command = MsgQueueCmd_SendMsg;
+	item.m_nodeId = nodeId;
+	item.m_msg = msg;
+	m_msgQueue[front].push_front(item);
+	m_queueEvent[front]->Set();
+	m_sendMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::TakePrefetchedNonce>
+// Use a prefetched nonce for the current message, if we have a fresh one
+//-----------------------------------------------------------------------------
+bool Driver::TakePrefetchedNonce()
+{
+	if ((m_noncePrefetchNodeId == 0) || (m_noncePrefetchNodeId != m_currentMsg->GetTargetNodeId()))
+	{
+		return false;
+	}
+	if (m_noncePrefetchTS.TimeRemaining() <= 0)
+	{
+		Log::Write(LogLevel_Detail, m_noncePrefetchNodeId, "Prefetched Nonce %s", m_noncePrefetchReceived ? "expired before it could be used" : "Report was not received");
+		m_noncePrefetchNodeId = 0;
+		return false;
+	}
+	if (!m_noncePrefetchReceived)
+	{
+		return false;
+	}
+	Log::Write(LogLevel_Detail, m_noncePrefetchNodeId, "Using prefetched Nonce");
+	m_currentMsg->setNonce(m_noncePrefetched);
+	m_noncePrefetchNodeId = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsWaitingForPrefetchedNonce>
+// Is the current message held back waiting for a prefetched Nonce Report
+//-----------------------------------------------------------------------------
+bool Driver::IsWaitingForPrefetchedNonce()
+{
+	// A message that has already been sent has no callback id outstanding
+	// while it waits for its reply, so it can't be confused with one that
+	// has not been sent yet
+	return m_currentMsg && m_noncePrefetchNodeId && !m_noncePrefetchReceived && m_expectedCallbackId && m_currentMsg->isEncrypted() && !m_currentMsg->isNonceRecieved() && (m_currentMsg->GetTargetNodeId() == m_noncePrefetchNodeId);
+}
+
 bool Driver::initNetworkKeys(bool newnode)
 {
 
@@ -6721,8 +7787,12 @@ bool Driver::initNetworkKeys(bool newnode)
 	{
 	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
 	this->m_inclusionkeySet = newnode;
-	this->AuthKey = new aes_encrypt_ctx;
-	this->EncryptKey = new aes_encrypt_ctx;
+	/* the schedules are expanded here, once per key, and reused for every frame */
+	if (this->AuthKey == NULL)
+	{
+		this->AuthKey = new Internal::AESKey();
+		this->EncryptKey = new Internal::AESKey();
+	}
 
 	Log::Write(LogLevel_Info, GetControllerNodeId(), "Setting Up %s Network Key for Secure Communications", newnode == true ? "Inclusion" : "Provided");
 
@@ -6738,52 +7808,33 @@ bool Driver::initNetworkKeys(bool newnode)
 		return false;
 	}
 
-	if (aes_encrypt_key128(newnode == false ? this->GetNetworkKey() : SecuritySchemes[0], this->EncryptKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Set Initial Network Key for Encryption");
-		return false;
-	}
-
-	if (aes_encrypt_key128(newnode == false ? this->GetNetworkKey() : SecuritySchemes[0], this->AuthKey) == EXIT_FAILURE)
+	Internal::AESKey networkKey;
+	if (!networkKey.SetKey(newnode == false ? this->GetNetworkKey() : SecuritySchemes[0]))
 	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Set Initial Network Key for Authentication");
+		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Set Initial Network Key");
 		return false;
 	}
 
-	uint8 tmpEncKey[32];
-	uint8 tmpAuthKey[32];
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
-
-	if (aes_ecb_encrypt(EncryptPassword, tmpEncKey, 16, this->EncryptKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Generate Encrypted Network Key for Encryption");
-		return false;
-	}
-	if (aes_ecb_encrypt(AuthPassword, tmpAuthKey, 16, this->AuthKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Generate Encrypted Network Key for Authentication");
-		return false;
-	}
+	uint8 tmpEncKey[16];
+	uint8 tmpAuthKey[16];
+	networkKey.EncryptBlock(EncryptPassword, tmpEncKey);
+	networkKey.EncryptBlock(AuthPassword, tmpAuthKey);
 
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
-	if (aes_encrypt_key128(tmpEncKey, this->EncryptKey) == EXIT_FAILURE)
+	if (!this->EncryptKey->SetKey(tmpEncKey))
 	{
 		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to set Encrypted Network Key for Encryption");
 		return false;
 	}
-	if (aes_encrypt_key128(tmpAuthKey, this->AuthKey) == EXIT_FAILURE)
+	if (!this->AuthKey->SetKey(tmpAuthKey))
 	{
 		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to set Encrypted Network Key for Authentication");
 		return false;
 	}
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
+	Log::Write(LogLevel_Info, GetControllerNodeId(), "Using %s AES implementation", Internal::AESKey::GetBackendName());
 	return true;
 }
 
-void Driver::SendNonceKey(uint8 nodeId, uint8 *nonce)
+void Driver::SendNonceKey(uint8 nodeId, uint8 const* nonce)
 {
 
 	uint8 m_buffer[19];
@@ -6816,7 +7867,7 @@ void Driver::SendNonceKey(uint8 nodeId, uint8 *nonce)
 	m_nonceReportSent = nodeId;
 }
 
-aes_encrypt_ctx *Driver::GetAuthKey()
+Internal::AESKey *Driver::GetAuthKey()
 {
 	if (m_currentControllerCommand != NULL && m_currentControllerCommand->m_controllerCommand == ControllerCommand_AddDevice && m_currentControllerCommand->m_controllerState == ControllerState_Completed)
 	{
@@ -6830,7 +7881,7 @@ aes_encrypt_ctx *Driver::GetAuthKey()
 	return this->AuthKey;
 }
 ;
-aes_encrypt_ctx *Driver::GetEncKey()
+Internal::AESKey *Driver::GetEncKey()
 {
 	if (m_currentControllerCommand != NULL && m_currentControllerCommand->m_controllerCommand == ControllerCommand_AddDevice && m_currentControllerCommand->m_controllerState == ControllerState_Completed)
 	{
@@ -31,6 +31,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 
 #include "Defs.h"
 #include "Group.h"
@@ -40,7 +41,8 @@
 #include "platform/Mutex.h"
 #include "platform/Thread.h"
 #include "platform/TimeStamp.h"
-#include "aes/aescpp.h"
+#include "AESKey.h"
+#include "Msg.h"
 
 namespace OpenZWave
 {
@@ -69,11 +71,14 @@ namespace OpenZWave
 		{
 			class Controller;
 		}
+		class AirtimeThrottle;
 		class DNSThread;
+		class NoncePool;
 		struct DNSLookup;
 		class i_HttpClient;
 		struct HttpDownload;
 		class ManufacturerSpecificDB;
+		class MetricsExporter;
 		class Msg;
 		class TimerThread;
 	}
@@ -102,6 +107,7 @@ namespace OpenZWave
 			friend class Internal::CC::Security;
 			friend class Internal::Msg;
 			friend class Internal::ManufacturerSpecificDB;
+			friend class Internal::MetricsExporter;
 			friend class TimerThread;
 
 			//-----------------------------------------------------------------------------
@@ -112,7 +118,8 @@ namespace OpenZWave
 			{
 				ControllerInterface_Unknown = 0,
 				ControllerInterface_Serial,
-				ControllerInterface_Hid
+				ControllerInterface_Hid,
+				ControllerInterface_Replay		// The controller path is a file made with the SerialCapture option, which is played back
 			};
 
 			//-----------------------------------------------------------------------------
@@ -195,6 +202,10 @@ namespace OpenZWave
 			void RequestConfig();							// Get the network configuration from the Z-Wave network
 			bool ReadCache();								// Read the configuration from a file
 			void WriteCache();								// Save the configuration to a file
+			void SavePartialInterview(Node* _node, Node::QueryStage _completed);
+
+			bool m_interviewSavePending;					// A node has made progress with its interview since the last save
+			Internal::Platform::TimeStamp m_interviewSaveTS;	// When to save it
 
 			//-----------------------------------------------------------------------------
 			//	Timer
@@ -700,6 +711,10 @@ namespace OpenZWave
 			bool WriteMsg(string const &str);									// Sends the current message to the Z-Wave network
 			void RemoveCurrentMsg();											// Deletes the current message and cleans up the callback etc states
 			bool MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _move);		// If a node does not respond, and is of a type that can sleep, this method is used to move all its pending messages to another queue ready for when it wakes up next.
+			bool HasQueuedMsgs(uint8 const _nodeId);							// True if a message or query stage for the node is being sent or is waiting in any queue.
+			Internal::Msg* BatchGets(MsgQueue const _queue, Internal::Msg* _msg);	// Combines _msg with other queued Gets for the same node into a MultiCmd frame, if the node supports it.
+			bool HandleBatchedReply(uint8 const* _data);						// Matches a report against the Gets sent in the current MultiCmd frame.  Returns true once all have been answered.
+			void UnbatchCurrentMsg();											// Puts the unanswered Gets of the current MultiCmd frame back on their queue, to be sent one at a time.
 			bool HandleErrorResponse(uint8 const _error, uint8 const _nodeId, char const* _funcStr, bool _sleepCheck = false);									    // Handle data errors and process consistently. If message is moved to wake-up queue, return true.
 			bool IsExpectedReply(uint8 const _nodeId);						// Determine if reply message is the one we are expecting
 			void SendQueryStageComplete(uint8 const _nodeId, Node::QueryStage const _stage);
@@ -795,6 +810,9 @@ namespace OpenZWave
 			Internal::Platform::Mutex* m_sendMutex;						// Serialize access to the queues
 			Internal::Msg* m_currentMsg;
 			MsgQueue m_currentMsgQueueSource;			// identifies which queue held m_currentMsg
+			list<Internal::Msg*> m_batchedMsgs;			// Gets sent inside m_currentMsg (a MultiCmd frame) that have not been answered yet
+			bool m_batchedFrame;						// m_currentMsg is a MultiCmd frame built by BatchGets
+			bool m_multiCmdBatching;					// Combine Gets for nodes that support COMMAND_CLASS_MULTI_CMD
 			Internal::Platform::TimeStamp m_resendTimeStamp;
 
 			//-----------------------------------------------------------------------------
@@ -893,12 +911,92 @@ namespace OpenZWave
 					uint32 m_routedbusy;		// Number of messages received with routed busy status
 					uint32 m_broadcastReadCnt;	// Number of broadcasts read
 					uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+					uint32 m_pollCnt;			// Number of values polled
+					uint32 m_notificationCnt;	// Number of notifications queued for the application
+					uint32 m_throttled;			// Number of times the Poll and Query queues used up their airtime budget
+					uint32 m_throttleBackoffs;	// Number of times the airtime budget was halved because the network was busy
+					uint32 m_localizationLoadTime;		// Milliseconds spent reading Localization.xml at startup
+					uint32 m_notificationTypesLoadTime;	// Milliseconds spent reading NotificationCCTypes.xml at startup
+					uint32 m_sensorTypesLoadTime;		// Milliseconds spent reading SensorMultiLevelCCTypes.xml at startup
+					uint32 m_productDBLoadTime;			// Milliseconds spent reading manufacturer_specific.xml and the product file revisions at startup
+					uint32 m_deviceClassesLoadTime;		// Milliseconds spent reading device_classes.xml at startup
+					uint32 m_scenesLoadTime;			// Milliseconds spent reading the scenes at startup
+					uint32 m_configLoadTime;			// Milliseconds until all of the above were loaded (they are read in parallel)
+					uint32 m_cacheLoadTime;				// Milliseconds spent reading this network's cache file
+					LatencyHistogram m_requestLatency;	// Send Data until the controller's callback, for all nodes (ms)
+					LatencyHistogram m_responseLatency;	// Send Data until the node's report, for all nodes (ms)
+					LatencyHistogram m_setValueLatency;	// Value Set until the device confirmed the new value, for all nodes (ms)
+					AirtimeCounter m_airtime;			// Airtime of the frames sent to all nodes, with retries
+			};
+
+			/** \brief Where the messages sent from one queue spent their time.
+			 *
+			 * Each message is timed as it is queued, taken from the queue, written to
+			 * the controller, ACKed, called back and completed by its reply.  Times
+			 * are in milliseconds.
+			 */
+			struct MsgQueueData
+			{
+					uint32 m_completed;					// Messages that got everything they were waiting for
+					uint32 m_failed;					// Messages dropped or removed before they completed
+					uint32 m_retried;					// Messages that needed more than one attempt
+					LatencyHistogram m_queueWait;		// Queued until taken from the queue
+					LatencyHistogram m_writeWait;		// Taken from the queue until first written (nonce exchanges for secure messages)
+					LatencyHistogram m_retryTime;		// First until last write, for the messages that were retried
+					LatencyHistogram m_ackWait;			// Last write until the controller's ACK
+					LatencyHistogram m_callbackWait;	// ACK until the transmit status callback
+					LatencyHistogram m_replyWait;		// Callback (or ACK) until the reply that completed the message
+					LatencyHistogram m_total;			// Queued until completed
+					AirtimeCounter m_airtime;			// Airtime of the frames sent from the queue, with retries
+			};
+
+			/** \brief The timing of one message, passed to the trace callback when it is removed.
+			 *
+			 * The stage times are milliseconds since the message was queued, or -1 if
+			 * the message never reached that stage.
+			 */
+			struct MsgTrace
+			{
+					uint8 m_nodeId;						// Target node
+					uint8 m_callbackId;					// Callback ID of the last attempt
+					uint8 m_function;					// Serial API function (FUNC_ID_...)
+					uint8 m_commandClassId;				// Command class sent, for Send Data requests
+					uint8 m_attempts;					// Number of times the message was written
+					bool m_completed;					// False if the message was dropped
+					MsgQueue m_queue;					// Queue the message was sent from
+					int32 m_stageTime[Internal::Msg::Stage_Count];	// Indexed by Internal::Msg::Stage
 			};
+			typedef void (*pfnOnMsgTrace_t)(MsgTrace const* _trace, void* _context);
+
+			/** \brief How one of the library's mutexes has been used, with the ProfileLocks option.
+			 */
+			struct LockData
+			{
+					char const* m_name;					// Name of the mutex, such as "Driver::m_nodeMutex"
+					Internal::Platform::Mutex::Statistics m_statistics;
+			};
+
 			void LogDriverStatistics();
 
 		private:
+			void LogAirtimeStatistics(AirtimeCounter const& _network);
+			void LogHandlerStatistics();
+			void LogLockStatistics();
 			void GetDriverStatistics(DriverData* _data);
 			void GetNodeStatistics(uint8 const _nodeId, Node::NodeData* _data);
+			bool GetMsgQueueStatistics(MsgQueue const _queue, MsgQueueData* _data);
+			bool GetCommandClassAirtime(uint8 const _commandClassId, AirtimeCounter* _data);
+			bool GetLockStatistics(std::vector<LockData>* _data);
+			void RecordAirtime(Node* _node, uint32 const _ms);
+			static bool IsThrottled(MsgQueue const _queue)
+			{
+				return (_queue == MsgQueue_Query) || (_queue == MsgQueue_Poll);
+			}
+			static char const* GetMsgQueueName(MsgQueue const _queue);
+			void SetMsgTraceCallback(pfnOnMsgTrace_t _callback, void* _context);
+			uint32 GetMsgClock();
+			void SetCurrentMsgStage(Internal::Msg::Stage const _stage);
+			void FinishMsgTiming(bool const _completed);
 
 			uint32 m_SOFCnt;			// Number of SOF bytes received
 			uint32 m_ACKWaiting;		// Number of unsolicited messages while waiting for an ACK
@@ -922,6 +1020,18 @@ namespace OpenZWave
 			uint32 m_routedbusy;		// Number of messages received with routed busy status
 			uint32 m_broadcastReadCnt;	// Number of broadcasts read
 			uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+			uint32 m_pollCnt;			// Number of values polled
+			uint32 m_notificationCnt;	// Number of notifications queued for the application
+			uint32 m_cacheLoadTime;		// Milliseconds spent reading the cache file
+			LatencyHistogram m_requestLatency;		// Histogram of request RTTs for all nodes
+			LatencyHistogram m_responseLatency;		// Histogram of response RTTs for all nodes
+			LatencyHistogram m_setValueLatency;		// Histogram of Set to confirmation times for all nodes
+			MsgQueueData m_queueStats[MsgQueue_Count];	// Send pipeline timing for each queue
+			AirtimeCounter m_airtime;				// Airtime of the frames sent to all nodes
+			map<uint8, AirtimeCounter> m_commandClassAirtime;	// Airtime of the frames sent, by the command class they carry
+			Internal::AirtimeThrottle* m_airtimeThrottle;	// Airtime budget of the Poll and Query queues
+			pfnOnMsgTrace_t m_msgTraceCallback;		// Called with the timing of each message, if set
+			void* m_msgTraceContext;
 			//time_t m_commandStart;	// Start time of last command
 			//time_t m_timeoutLost;		// Cumulative time lost to timeouts
 
@@ -929,21 +1039,36 @@ namespace OpenZWave
 			//	Security Command Class Related (Version 1.1)
 			//-----------------------------------------------------------------------------
 		public:
-			aes_encrypt_ctx *GetAuthKey();
-			aes_encrypt_ctx *GetEncKey();
+			Internal::AESKey *GetAuthKey();
+			Internal::AESKey *GetEncKey();
 			bool isNetworkKeySet();
+			Internal::NoncePool *GetNoncePool()
+			{
+				return m_noncePool;
+			}
 
 		private:
 			bool initNetworkKeys(bool newnode);
 			uint8 *GetNetworkKey();
 			bool SendEncryptedMessage();
-			bool SendNonceRequest(string logmsg);
-			void SendNonceKey(uint8 nodeId, uint8 *nonce);
-			aes_encrypt_ctx *AuthKey;
-			aes_encrypt_ctx *EncryptKey;
+			bool SendNonceRequest(string logmsg, uint8 nodeId, uint8 callbackId, MsgQueue queue);
+			void SendNonceKey(uint8 nodeId, uint8 const* nonce);
+			void PrefetchNonce(MsgQueue const _queueEnd);			// Request the nonce for a queued secure message so other messages can be sent while the node answers.  Queues from _queueEnd on are being held back.
+			bool TakePrefetchedNonce();								// Give a fresh prefetched nonce to m_currentMsg
+			bool IsWaitingForPrefetchedNonce();						// True if m_currentMsg is waiting on a prefetched nonce that has not arrived yet
+			Internal::AESKey *AuthKey;
+			Internal::AESKey *EncryptKey;
+			Internal::NoncePool *m_noncePool;						// Random data for the nonces we give nodes
 			uint8 m_nonceReportSent;
 			uint8 m_nonceReportSentAttempt;
 			bool m_inclusionkeySet;
+			bool m_noncePrefetch;									// Overlap the Nonce Get/Report exchange with other traffic
+			uint8 m_noncePrefetchNodeId;							// Node we sent a prefetch Nonce Get to, or 0
+			uint8 m_noncePrefetchCallbackId;						// Callback ID of the prefetch Nonce Get
+			bool m_noncePrefetchDelivered;							// The prefetch Nonce Get reached the node, so its Nonce Report can be accepted
+			bool m_noncePrefetchReceived;							// The Nonce Report for m_noncePrefetchNodeId has arrived
+			uint8 m_noncePrefetched[8];
+			Internal::Platform::TimeStamp m_noncePrefetchTS;		// When the prefetch request (or the nonce) expires
 
 			//-----------------------------------------------------------------------------
 			//	Event Signaling for DNS and HTTP Threads
@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+//
+//	LatencyHistogram.cpp
+//
+//	Fixed size histogram of message latencies
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include "LatencyHistogram.h"
+
+namespace OpenZWave
+{
+	static uint32 const c_subBuckets = 1 << LatencyHistogram::c_subBucketBits;
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::LatencyHistogram>
+// Constructor
+//-----------------------------------------------------------------------------
+	LatencyHistogram::LatencyHistogram()
+	{
+		Reset();
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::Reset>
+// Clear all the counts
+//-----------------------------------------------------------------------------
+	void LatencyHistogram::Reset()
+	{
+		memset(m_buckets, 0, sizeof(m_buckets));
+		m_count = 0;
+		m_min = 0;
+		m_max = 0;
+		m_total = 0;
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetBucket>
+// Find the bucket a latency is counted in
+//-----------------------------------------------------------------------------
+	uint32 LatencyHistogram::GetBucket(uint32 _ms)
+	{
+		if (_ms >= (1u << c_maxBits))
+		{
+			return c_bucketCount - 1;
+		}
+		if (_ms < c_subBuckets)
+		{
+			// Below 8ms every value has a bucket of its own
+			return _ms;
+		}
+		uint32 top = c_subBucketBits;
+		while ((_ms >> (top + 1)) != 0)
+		{
+			++top;
+		}
+		// The bits below the top one pick the sub bucket
+		return ((top - c_subBucketBits + 1) << c_subBucketBits) + ((_ms >> (top - c_subBucketBits)) & (c_subBuckets - 1));
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetBucketTop>
+// The largest latency that is counted in a bucket
+//-----------------------------------------------------------------------------
+	uint32 LatencyHistogram::GetBucketTop(uint32 _bucket)
+	{
+		if (_bucket < c_subBuckets)
+		{
+			return _bucket;
+		}
+		uint32 shift = (_bucket >> c_subBucketBits) - 1;
+		uint32 sub = _bucket & (c_subBuckets - 1);
+		return ((c_subBuckets + sub + 1) << shift) - 1;
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::Record>
+// Count one latency
+//-----------------------------------------------------------------------------
+	void LatencyHistogram::Record(uint32 _ms)
+	{
+		++m_buckets[GetBucket(_ms)];
+		if ((m_count == 0) || (_ms < m_min))
+		{
+			m_min = _ms;
+		}
+		if (_ms > m_max)
+		{
+			m_max = _ms;
+		}
+		++m_count;
+		m_total += _ms;
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetMean>
+// Average of the counted latencies
+//-----------------------------------------------------------------------------
+	uint32 LatencyHistogram::GetMean() const
+	{
+		return m_count ? (uint32) (m_total / m_count) : 0;
+	}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetPercentile>
+// Latency below which a given share of the counts lies
+//-----------------------------------------------------------------------------
+	uint32 LatencyHistogram::GetPercentile(double _percent) const
+	{
+		if (m_count == 0)
+		{
+			return 0;
+		}
+		if (_percent < 0.0)
+		{
+			_percent = 0.0;
+		}
+		if (_percent > 100.0)
+		{
+			_percent = 100.0;
+		}
+
+		uint64 rank = (uint64) ((_percent * m_count) / 100.0 + 0.999999);
+		if (rank == 0)
+		{
+			rank = 1;
+		}
+		uint64 seen = 0;
+		for (uint32 i = 0; i < c_bucketCount; ++i)
+		{
+			seen += m_buckets[i];
+			if (seen >= rank)
+			{
+				// Report the top of the bucket, but never more than was actually seen
+				uint32 top = (i == c_bucketCount - 1) ? m_max : GetBucketTop(i);
+				if (top > m_max)
+				{
+					top = m_max;
+				}
+				if (top < m_min)
+				{
+					top = m_min;
+				}
+				return top;
+			}
+		}
+		return m_max;
+	}
+} // namespace OpenZWave
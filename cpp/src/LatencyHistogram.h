@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+//
+//	LatencyHistogram.h
+//
+//	Fixed size histogram of message latencies
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _LatencyHistogram_H
+#define _LatencyHistogram_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief A histogram of latencies in milliseconds, for the node and driver statistics.
+	 *
+	 * Latencies are counted in buckets whose width grows with the value (each
+	 * power of two is split into 8 buckets), so percentiles are accurate to
+	 * about 12% from 1ms up to 17 minutes while the histogram stays a fixed,
+	 * small size.  Unlike a running average, the percentiles show the slow
+	 * tail that a bad route or a busy network causes.
+	 */
+	class OPENZWAVE_EXPORT LatencyHistogram
+	{
+		public:
+			LatencyHistogram();
+
+			/**
+			 * Count one latency.  Values too large for the histogram are counted
+			 * in its last bucket.
+			 */
+			void Record(uint32 _ms);
+
+			/**
+			 * Forget everything that has been counted.
+			 */
+			void Reset();
+
+			uint32 GetCount() const
+			{
+				return m_count;
+			}
+			uint32 GetMin() const
+			{
+				return m_count ? m_min : 0;
+			}
+			uint32 GetMax() const
+			{
+				return m_max;
+			}
+			uint32 GetMean() const;
+			uint64 GetTotal() const
+			{
+				return m_total;
+			}
+
+			/**
+			 * The latency that _percent percent of the counted values do not
+			 * exceed (0 if nothing has been counted).
+			 */
+			uint32 GetPercentile(double _percent) const;
+
+			uint32 GetP50() const
+			{
+				return GetPercentile(50.0);
+			}
+			uint32 GetP90() const
+			{
+				return GetPercentile(90.0);
+			}
+			uint32 GetP99() const
+			{
+				return GetPercentile(99.0);
+			}
+
+			static uint32 const c_subBucketBits = 3;
+			static uint32 const c_maxBits = 20;					// Values up to 2^20ms are kept apart
+			static uint32 const c_bucketCount = (c_maxBits - c_subBucketBits + 1) << c_subBucketBits;
+
+		private:
+			static uint32 GetBucket(uint32 _ms);
+			static uint32 GetBucketTop(uint32 _bucket);
+
+			uint32 m_buckets[c_bucketCount];
+			uint32 m_count;
+			uint32 m_min;
+			uint32 m_max;
+			uint64 m_total;
+	};
+} // namespace OpenZWave
+
+#endif
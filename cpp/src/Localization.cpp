@@ -24,13 +24,17 @@
 //	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
 //
 //-----------------------------------------------------------------------------
+#include <algorithm>
 #include <bitset>
 #include <string.h>
 
 #include "Localization.h"
 #include "tinyxml.h"
 #include "Options.h"
+#include "ConfigBundle.h"
+#include "Utils.h"
 #include "platform/Log.h"
+#include "platform/Mutex.h"
 #include "value_classes/ValueBitSet.h"
 #include "command_classes/Configuration.h"
 #include "command_classes/ThermostatSetpoint.h"
@@ -44,23 +48,61 @@ namespace OpenZWave
 	{
 
 		Localization *Localization::m_instance = NULL;
-		std::map<uint64, std::shared_ptr<ValueLocalizationEntry> > Localization::m_valueLocalizationMap;
-		std::map<uint8, std::shared_ptr<LabelLocalizationEntry> > Localization::m_commandClassLocalizationMap;
-		std::map<std::string, std::shared_ptr<LabelLocalizationEntry> > Localization::m_globalLabelLocalizationMap;
-		std::string Localization::m_selectedLang = "";
+		std::vector<std::pair<uint64, ValueLocalizationEntry> > Localization::m_valueLocalizationMap;
+		std::map<uint8, LabelLocalizationEntry> Localization::m_commandClassLocalizationMap;
+		std::map<std::string, LabelLocalizationEntry> Localization::m_globalLabelLocalizationMap;
+		InternedString Localization::m_selectedLang;
 		uint32 Localization::m_revision = 0;
+		bool Localization::m_singleLanguage = false;
+		bool Localization::m_reloadPending = false;
+		bool Localization::m_reloading = false;
+		Internal::Platform::Mutex* Localization::m_mutex = NULL;
+
+		// Look up the text for a language and item in a sorted table
+		static LocalizedText const* FindText(LocalizedTextTable const& _table, InternedString const& _lang, int32 _item)
+		{
+			LocalizedText key = { _lang, _item, InternedString() };
+			LocalizedTextTable::const_iterator it = std::lower_bound(_table.begin(), _table.end(), key);
+			if ((it != _table.end()) && (it->m_lang == _lang) && (it->m_item == _item))
+			{
+				return &(*it);
+			}
+			return NULL;
+		}
+
+		static void SetText(LocalizedTextTable& _table, string const& _lang, int32 _item, string const& _text)
+		{
+			LocalizedText text = { InternedString(_lang), _item, InternedString(_text) };
+			LocalizedTextTable::iterator it = std::lower_bound(_table.begin(), _table.end(), text);
+			if ((it != _table.end()) && (it->m_lang == text.m_lang) && (it->m_item == _item))
+			{
+				it->m_text = text.m_text;
+			}
+			else
+			{
+				_table.insert(it, text);
+			}
+		}
+
+		static bool IsTranslation(LocalizedText const& _text)
+		{
+			return !_text.m_lang.empty();
+		}
+
+		// Remove everything except the default text
+		static void DropTranslations(LocalizedTextTable& _table)
+		{
+			_table.erase(std::remove_if(_table.begin(), _table.end(), IsTranslation), _table.end());
+		}
 
 		LabelLocalizationEntry::LabelLocalizationEntry(uint16 _index, uint32 _pos) :
 				m_index(_index), m_pos(_pos)
 		{
 		}
 
-		void LabelLocalizationEntry::AddLabel(string label, string lang)
+		void LabelLocalizationEntry::AddLabel(string const& label, string const& lang)
 		{
-			if (lang.empty())
-				m_defaultLabel = label;
-			else
-				m_Label[lang] = label;
+			SetText(m_Label, lang, 0, label);
 		}
 		uint64 LabelLocalizationEntry::GetIdx()
 		{
@@ -68,22 +110,24 @@ namespace OpenZWave
 			return key;
 
 		}
-		std::string LabelLocalizationEntry::GetLabel(string lang)
+		std::string LabelLocalizationEntry::GetLabel(InternedString const& lang) const
 		{
-			if (lang.empty() || (m_Label.find(lang) == m_Label.end()))
-				return m_defaultLabel;
-			else
-				return m_Label[lang];
-
+			LocalizedText const* text = lang.empty() ? NULL : FindText(m_Label, lang, 0);
+			if (!text)
+				text = FindText(m_Label, InternedString(), 0);
+			return text ? text->m_text.str() : string();
 		}
 
-		bool LabelLocalizationEntry::HasLabel(string lang)
+		bool LabelLocalizationEntry::HasLabel(string const& lang) const
 		{
-			if (m_Label.find(lang) == m_Label.end())
+			if (lang.empty())
 				return false;
-			else
-				return true;
+			return FindText(m_Label, InternedString(lang), 0) != NULL;
+		}
 
+		void LabelLocalizationEntry::DropLanguages()
+		{
+			DropTranslations(m_Label);
 		}
 
 		ValueLocalizationEntry::ValueLocalizationEntry(uint8 _commandClass, uint16 _index, uint32 _pos) :
@@ -96,149 +140,110 @@ namespace OpenZWave
 			uint64 key = ((uint64) m_commandClass << 48) | ((uint64) m_index << 32) | ((uint64) m_pos);
 			return key;
 		}
-		std::string ValueLocalizationEntry::GetHelp(string lang)
-
+		std::string ValueLocalizationEntry::GetHelp(InternedString const& lang) const
 		{
-			if (lang.empty() || (m_HelpText.find(lang) == m_HelpText.end()))
-				return m_DefaultHelpText;
-			else
-				return m_HelpText[lang];
+			LocalizedText const* text = lang.empty() ? NULL : FindText(m_HelpText, lang, 0);
+			if (!text)
+				text = FindText(m_HelpText, InternedString(), 0);
+			return text ? text->m_text.str() : string();
 		}
 
-		bool ValueLocalizationEntry::HasHelp(string lang)
-
+		bool ValueLocalizationEntry::HasHelp(string const& lang) const
 		{
-			if (m_HelpText.find(lang) == m_HelpText.end())
+			if (lang.empty())
 				return false;
-			else
-				return true;
+			return FindText(m_HelpText, InternedString(lang), 0) != NULL;
 		}
 
-		void ValueLocalizationEntry::AddHelp(string HelpText, string lang)
+		void ValueLocalizationEntry::AddHelp(string const& HelpText, string const& lang)
 		{
-			if (lang.empty())
-				m_DefaultHelpText = HelpText;
-			else
-				m_HelpText[lang] = HelpText;
-
+			SetText(m_HelpText, lang, 0, HelpText);
 		}
-		std::string ValueLocalizationEntry::GetLabel(string lang)
+		std::string ValueLocalizationEntry::GetLabel(InternedString const& lang) const
 		{
-			if (lang.empty() || (m_LabelText.find(lang) == m_LabelText.end()))
-				return m_DefaultLabelText;
-			else
-				return m_LabelText[lang];
+			LocalizedText const* text = lang.empty() ? NULL : FindText(m_LabelText, lang, 0);
+			if (!text)
+				text = FindText(m_LabelText, InternedString(), 0);
+			return text ? text->m_text.str() : string();
 		}
-		bool ValueLocalizationEntry::HasLabel(string lang)
-
+		bool ValueLocalizationEntry::HasLabel(string const& lang) const
 		{
-			if (m_LabelText.find(lang) == m_LabelText.end())
+			if (lang.empty())
 				return false;
-			else
-				return true;
+			return FindText(m_LabelText, InternedString(lang), 0) != NULL;
 		}
 
-		void ValueLocalizationEntry::AddLabel(string Label, string lang)
+		void ValueLocalizationEntry::AddLabel(string const& Label, string const& lang)
 		{
-			if (lang.empty())
-				m_DefaultLabelText = Label;
-			else
-				m_LabelText[lang] = Label;
+			SetText(m_LabelText, lang, 0, Label);
 		}
 
-		void ValueLocalizationEntry::AddItemLabel(string label, int32 itemindex, string lang)
+		void ValueLocalizationEntry::AddItemLabel(string const& label, int32 itemindex, string const& lang)
 		{
-			if (lang.empty())
-			{
-				m_DefaultItemLabelText[itemindex] = label;
-			}
-			else
-			{
-				m_ItemLabelText[lang][itemindex] = label;
-			}
-
+			SetText(m_ItemLabelText, lang, itemindex, label);
 		}
-		std::string ValueLocalizationEntry::GetItemLabel(string lang, int32 itemindex)
+		std::string ValueLocalizationEntry::GetItemLabel(InternedString const& lang, int32 itemindex) const
 		{
-			if (lang.empty() || (m_ItemLabelText.find(lang) == m_ItemLabelText.end()) || m_ItemLabelText[lang].find(itemindex) == m_ItemLabelText[lang].end())
+			LocalizedText const* text = lang.empty() ? NULL : FindText(m_ItemLabelText, lang, itemindex);
+			if (!text)
 			{
-				if (m_DefaultItemLabelText.find(itemindex) == m_DefaultItemLabelText.end())
+				text = FindText(m_ItemLabelText, InternedString(), itemindex);
+				if (!text)
 				{
-					Log::Write(LogLevel_Warning, "ValueLocalizationEntry::GetItemLabel: Unable to find Default Item Label Text for Index Item %d (%s)", itemindex, m_DefaultLabelText.c_str());
+					Log::Write(LogLevel_Warning, "ValueLocalizationEntry::GetItemLabel: Unable to find Default Item Label Text for Index Item %d (%s)", itemindex, GetLabel(InternedString()).c_str());
 					return "undefined";
 				}
-				return m_DefaultItemLabelText[itemindex];
-			}
-			else
-			{
-				return m_ItemLabelText[lang][itemindex];
 			}
+			return text->m_text;
 		}
 
-		bool ValueLocalizationEntry::HasItemLabel(int32 itemIndex, string lang)
+		bool ValueLocalizationEntry::HasItemLabel(int32 itemIndex, string const& lang) const
 		{
-			if (lang.empty() || (m_ItemLabelText.find(lang) == m_ItemLabelText.end()) || m_ItemLabelText[lang].find(itemIndex) == m_ItemLabelText[lang].end())
+			if (lang.empty())
 				return false;
-			return true;
+			return FindText(m_ItemLabelText, InternedString(lang), itemIndex) != NULL;
 		}
 
-		void ValueLocalizationEntry::AddItemHelp(string label, int32 itemindex, string lang)
+		void ValueLocalizationEntry::AddItemHelp(string const& label, int32 itemindex, string const& lang)
 		{
-
-			if (lang.empty())
-			{
-				m_DefaultItemHelpText[itemindex] = label;
-			}
-			else
-			{
-				m_ItemHelpText[lang][itemindex] = label;
-			}
-
+			SetText(m_ItemHelpText, lang, itemindex, label);
 		}
-		std::string ValueLocalizationEntry::GetItemHelp(string lang, int32 itemindex)
+		std::string ValueLocalizationEntry::GetItemHelp(InternedString const& lang, int32 itemindex) const
 		{
-			if (lang.empty() && (m_DefaultItemHelpText.find(itemindex) != m_DefaultItemHelpText.end()))
-			{
-				return m_DefaultItemHelpText[itemindex];
-			}
-
-			if ((m_ItemHelpText.find(lang) != m_ItemHelpText.end()))
+			LocalizedText const* text = lang.empty() ? NULL : FindText(m_ItemHelpText, lang, itemindex);
+			if (!text)
 			{
-				if ((m_ItemHelpText.at(lang).find(itemindex) != m_ItemHelpText.at(lang).end()))
+				text = FindText(m_ItemHelpText, InternedString(), itemindex);
+				if (!text)
 				{
-					return m_ItemHelpText.at(lang)[itemindex];
+					Log::Write(LogLevel_Warning, "No ItemHelp Entry for Language %s (Index %d)", lang.c_str(), itemindex);
+					return "Undefined";
 				}
 			}
-			if (m_DefaultItemHelpText.find(itemindex) != m_DefaultItemHelpText.end())
-			{
-				return m_DefaultItemHelpText[itemindex];
-			}
-			Log::Write(LogLevel_Warning, "No ItemHelp Entry for Language %s (Index %d)", lang.c_str(), itemindex);
-			return "Undefined";
+			return text->m_text;
 		}
 
-		bool ValueLocalizationEntry::HasItemHelp(int32 itemIndex, string lang)
+		bool ValueLocalizationEntry::HasItemHelp(int32 itemIndex, string const& lang) const
 		{
-			if (lang.empty() && (m_DefaultItemHelpText.find(itemIndex) != m_DefaultItemHelpText.end()))
-			{
-				return true;
-			}
+			return FindText(m_ItemHelpText, InternedString(lang), itemIndex) != NULL;
+		}
 
-			if ((m_ItemHelpText.find(lang) != m_ItemHelpText.end()))
-			{
-				if ((m_ItemHelpText.at(lang).find(itemIndex) != m_ItemHelpText.at(lang).end()))
-				{
-					return true;
-				}
-				return false;
-			}
-			return false;
+		void ValueLocalizationEntry::DropLanguages()
+		{
+			DropTranslations(m_HelpText);
+			DropTranslations(m_LabelText);
+			DropTranslations(m_ItemLabelText);
+			DropTranslations(m_ItemHelpText);
 		}
 
 		Localization::Localization()
 		{
 		}
 
+		Localization::~Localization()
+		{
+		}
+
 		bool Localization::ReadXML()
 		{
 			// Parse the Z-Wave manufacturer and product XML file.
@@ -247,7 +252,7 @@ namespace OpenZWave
 
 			string path = configPath + "Localization.xml";
 			TiXmlDocument* pDoc = new TiXmlDocument();
-			if (!pDoc->LoadFile(path.c_str(), TIXML_ENCODING_UTF8))
+			if (!ConfigBundle::LoadXML(pDoc, "Localization.xml"))
 			{
 				Log::Write(LogLevel_Warning, "Unable to load Localization file %s: %s", path.c_str(), pDoc->ErrorDesc());
 				delete pDoc;
@@ -335,23 +340,26 @@ namespace OpenZWave
 			}
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
-			if (m_globalLabelLocalizationMap.find(str) == m_globalLabelLocalizationMap.end())
+			if (!KeepLanguage(Language))
+				return;
+			map<string, LabelLocalizationEntry>::iterator it = m_globalLabelLocalizationMap.find(str);
+			if (it == m_globalLabelLocalizationMap.end())
 			{
-				m_globalLabelLocalizationMap[str] = std::shared_ptr<LabelLocalizationEntry>(new LabelLocalizationEntry(0));
+				it = m_globalLabelLocalizationMap.insert(std::make_pair(string(str), LabelLocalizationEntry(0))).first;
 			}
-			else if (m_globalLabelLocalizationMap[str]->HasLabel(Language))
+			else if (it->second.HasLabel(Language))
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadGlobalXMLLabel: Error in %s at line %d - Duplicate Entry for GlobalText %s: %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), str, labelElement->GetText(), Language.c_str());
 				return;
 			}
 			if (Language.empty())
 			{
-				m_globalLabelLocalizationMap[str]->AddLabel(labelElement->GetText());
+				it->second.AddLabel(labelElement->GetText());
 
 			}
 			else
 			{
-				m_globalLabelLocalizationMap[str]->AddLabel(labelElement->GetText(), Language);
+				it->second.AddLabel(labelElement->GetText(), Language);
 
 			}
 		}
@@ -362,23 +370,26 @@ namespace OpenZWave
 			string Language;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
+			if (!KeepLanguage(Language))
+				return;
 
-			if (m_commandClassLocalizationMap.find(ccID) == m_commandClassLocalizationMap.end())
+			map<uint8, LabelLocalizationEntry>::iterator it = m_commandClassLocalizationMap.find(ccID);
+			if (it == m_commandClassLocalizationMap.end())
 			{
-				m_commandClassLocalizationMap[ccID] = std::shared_ptr<LabelLocalizationEntry>(new LabelLocalizationEntry(0));
+				it = m_commandClassLocalizationMap.insert(std::make_pair(ccID, LabelLocalizationEntry(0))).first;
 			}
-			else if (m_commandClassLocalizationMap[ccID]->HasLabel(Language))
+			else if (it->second.HasLabel(Language))
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d: %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, labelElement->GetText(), Language.c_str());
 				return;
 			}
 			if (Language.empty())
 			{
-				m_commandClassLocalizationMap[ccID]->AddLabel(labelElement->GetText());
+				it->second.AddLabel(labelElement->GetText());
 			}
 			else
 			{
-				m_commandClassLocalizationMap[ccID]->AddLabel(labelElement->GetText(), Language);
+				it->second.AddLabel(labelElement->GetText(), Language);
 			}
 		}
 
@@ -424,22 +435,26 @@ namespace OpenZWave
 
 		void Localization::ReadXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement)
 		{
+			LockGuard LG(m_mutex);
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
 			string Language;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
+			if (!KeepLanguage(Language))
+				return;
 			if (!labelElement->GetText())
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - No Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
 				return;
 			}
 
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasLabel(Language))
+			else if (entry->HasLabel(Language))
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
 				return;
@@ -447,20 +462,23 @@ namespace OpenZWave
 
 			if (Language.empty())
 			{
-				m_valueLocalizationMap[key]->AddLabel(labelElement->GetText());
+				entry->AddLabel(labelElement->GetText());
 			}
 			else
 			{
-				m_valueLocalizationMap[key]->AddLabel(labelElement->GetText(), Language);
+				entry->AddLabel(labelElement->GetText(), Language);
 			}
 		}
 
 		void Localization::ReadXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement)
 		{
+			LockGuard LG(m_mutex);
 
 			string Language;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
+			if (!KeepLanguage(Language))
+				return;
 			if (!labelElement->GetText())
 			{
 				if (ccID != 112)
@@ -473,22 +491,23 @@ namespace OpenZWave
 			}
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasLabel(Language))
+			else if (entry->HasLabel(Language))
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDHelp: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
 				return;
 			}
 			if (Language.empty())
 			{
-				m_valueLocalizationMap[key]->AddHelp(labelElement->GetText());
+				entry->AddHelp(labelElement->GetText());
 			}
 			else
 			{
-				m_valueLocalizationMap[key]->AddHelp(labelElement->GetText(), Language);
+				entry->AddHelp(labelElement->GetText(), Language);
 			}
 		}
 
@@ -500,6 +519,8 @@ namespace OpenZWave
 			int32 itemIndex;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
+			if (!KeepLanguage(Language))
+				return;
 			if (!labelElement->GetText())
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No ItemIndex Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
@@ -512,12 +533,13 @@ namespace OpenZWave
 				return;
 			}
 
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No Value Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
 				return;
 			}
-			else if (m_valueLocalizationMap[key]->HasItemLabel(itemIndex, Language))
+			else if (entry->HasItemLabel(itemIndex, Language))
 			{
 				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - Duplicate ItemLabel Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
 				return;
@@ -525,11 +547,11 @@ namespace OpenZWave
 
 			if (Language.empty())
 			{
-				m_valueLocalizationMap[key]->AddItemLabel(labelElement->GetText(), itemIndex);
+				entry->AddItemLabel(labelElement->GetText(), itemIndex);
 			}
 			else
 			{
-				m_valueLocalizationMap[key]->AddItemLabel(labelElement->GetText(), itemIndex, Language);
+				entry->AddItemLabel(labelElement->GetText(), itemIndex, Language);
 			}
 		}
 
@@ -561,12 +583,47 @@ namespace OpenZWave
 			return ((uint64) _commandClass << 48) | ((uint64) _index << 32) | ((uint64) _pos);
 		}
 
+		bool Localization::KeepLanguage(string const& _lang)
+		{
+			if (m_reloading)
+			{
+				/* the defaults are still loaded, so only pick up the newly selected language */
+				return !_lang.empty() && (_lang == m_selectedLang);
+			}
+			return !m_singleLanguage || _lang.empty() || (_lang == m_selectedLang);
+		}
+
+		static bool ValueEntryKeyLess(pair<uint64, ValueLocalizationEntry> const& _entry, uint64 _key)
+		{
+			return _entry.first < _key;
+		}
+
+		ValueLocalizationEntry* Localization::FindValueEntry(uint64 _key)
+		{
+			vector<pair<uint64, ValueLocalizationEntry> >::iterator it = std::lower_bound(m_valueLocalizationMap.begin(), m_valueLocalizationMap.end(), _key, ValueEntryKeyLess);
+			if ((it != m_valueLocalizationMap.end()) && (it->first == _key))
+			{
+				return &it->second;
+			}
+			return NULL;
+		}
+
+		ValueLocalizationEntry* Localization::AddValueEntry(uint64 _key, uint8 _commandClass, uint16 _index, uint32 _pos)
+		{
+			/* Localization.xml is sorted by CommandClass and index, so this is nearly always an append */
+			vector<pair<uint64, ValueLocalizationEntry> >::iterator it = std::lower_bound(m_valueLocalizationMap.begin(), m_valueLocalizationMap.end(), _key, ValueEntryKeyLess);
+			it = m_valueLocalizationMap.insert(it, std::make_pair(_key, ValueLocalizationEntry(_commandClass, _index, _pos)));
+			return &it->second;
+		}
+
 		void Localization::SetupCommandClass(Internal::CC::CommandClass *cc)
 		{
+			LockGuard LG(m_mutex);
 			uint8 ccID = cc->GetCommandClassId();
-			if (m_commandClassLocalizationMap.find(ccID) != m_commandClassLocalizationMap.end())
+			map<uint8, LabelLocalizationEntry>::iterator it = m_commandClassLocalizationMap.find(ccID);
+			if (it != m_commandClassLocalizationMap.end())
 			{
-				cc->SetCommandClassLabel(m_commandClassLocalizationMap[ccID]->GetLabel(m_selectedLang));
+				cc->SetCommandClassLabel(it->second.GetLabel(m_selectedLang));
 			}
 			else
 			{
@@ -577,73 +634,86 @@ namespace OpenZWave
 
 		bool Localization::SetValueHelp(uint8 _node, uint8 ccID, uint16 indexId, uint32 pos, string help, string lang)
 		{
+			LockGuard LG(m_mutex);
+			if (!KeepLanguage(lang))
+				return true;
 			uint64 key = GetValueKey(_node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasHelp(lang))
+			else if (entry->HasHelp(lang))
 			{
 				Log::Write(LogLevel_Warning, "Localization::SetValueHelp: Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", ccID, indexId, pos, help.c_str(), lang.c_str());
 			}
 
 			if (lang.empty())
 			{
-				m_valueLocalizationMap[key]->AddHelp(help);
+				entry->AddHelp(help);
 			}
 			else
 			{
-				m_valueLocalizationMap[key]->AddHelp(help, lang);
+				entry->AddHelp(help, lang);
 			}
 			return true;
 		}
 		bool Localization::SetValueLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, string label, string lang)
 		{
+			LockGuard LG(m_mutex);
+			if (!KeepLanguage(lang))
+				return true;
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasLabel(lang))
+			else if (entry->HasLabel(lang))
 			{
 				Log::Write(LogLevel_Warning, "Localization::SetValueLabel: Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", ccID, indexId, pos, label.c_str(), lang.c_str());
 			}
 
 			if (lang.empty())
 			{
-				m_valueLocalizationMap[key]->AddLabel(label);
+				entry->AddLabel(label);
 			}
 			else
 			{
-				m_valueLocalizationMap[key]->AddLabel(label, lang);
+				entry->AddLabel(label, lang);
 			}
 			return true;
 		}
 
 		std::string const Localization::GetValueHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos)
 		{
+			LockGuard LG(m_mutex);
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::GetValueHelp: No Help for CommandClass %xd, ValueID: %d (%d)", ccID, indexId, pos);
 				return "";
 			}
-			return m_valueLocalizationMap[key]->GetHelp(m_selectedLang);
+			return entry->GetHelp(m_selectedLang);
 		}
 
 		std::string const Localization::GetValueLabel(uint8 node, uint8 ccID, uint16 indexId, int32 pos) const
 		{
+			LockGuard LG(m_mutex);
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::GetValueLabel: No Label for CommandClass %xd, ValueID: %d (%d)", ccID, indexId, pos);
 				return "";
 			}
-			return m_valueLocalizationMap[key]->GetLabel(m_selectedLang);
+			return entry->GetLabel(m_selectedLang);
 		}
 
 		std::string const Localization::GetValueItemLabel(uint8 node, uint8 ccID, uint16 indexId, int32 pos, int32 itemIndex) const
 		{
+			LockGuard LG(m_mutex);
 			bool unique = false;
 			if ((ccID == Internal::CC::SoundSwitch::StaticGetCommandClassId()) && (indexId == 1 || indexId == 3))
 			{
@@ -654,16 +724,20 @@ namespace OpenZWave
 				unique = true;
 			}
 			uint64 key = GetValueKey(node, ccID, indexId, pos, unique);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::GetValueItemLabel: No ValueLocalizationMap for CommandClass %xd, ValueID: %d (%d) ItemIndex %d", ccID, indexId, pos, itemIndex);
 				return "";
 			}
-			return m_valueLocalizationMap[key]->GetItemLabel(m_selectedLang, itemIndex);
+			return entry->GetItemLabel(m_selectedLang, itemIndex);
 		}
 
 		bool Localization::SetValueItemLabel(uint8 node, uint8 ccID, uint16 indexId, int32 pos, int32 itemIndex, string label, string lang)
 		{
+			LockGuard LG(m_mutex);
+			if (!KeepLanguage(lang))
+				return true;
 			bool unique = false;
 			if ((ccID == Internal::CC::SoundSwitch::StaticGetCommandClassId()) && (indexId == 1 || indexId == 3))
 			{
@@ -675,20 +749,22 @@ namespace OpenZWave
 			}
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos, unique);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasItemLabel(itemIndex, lang))
+			else if (entry->HasItemLabel(itemIndex, lang))
 			{
 				Log::Write(LogLevel_Warning, "Localization::SetValueItemLabel: Duplicate Item Entry for CommandClass %d, ValueID: %d (%d) itemIndex %d:  %s (Lang: %s)", ccID, indexId, pos, itemIndex, label.c_str(), lang.c_str());
 			}
-			m_valueLocalizationMap[key]->AddItemLabel(label, itemIndex, lang);
+			entry->AddItemLabel(label, itemIndex, lang);
 			return true;
 		}
 
 		std::string const Localization::GetValueItemHelp(uint8 node, uint8 ccID, uint16 indexId, int32 pos, int32 itemIndex) const
 		{
+			LockGuard LG(m_mutex);
 			bool unique = false;
 			if ((ccID == Internal::CC::SoundSwitch::StaticGetCommandClassId()) && (indexId == 1 || indexId == 3))
 			{
@@ -700,16 +776,20 @@ namespace OpenZWave
 			}
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos, unique);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::GetValueItemHelp: No ValueLocalizationMap for CommandClass %xd, ValueID: %d (%d) ItemIndex %d", ccID, indexId, pos, itemIndex);
 				return "";
 			}
-			return m_valueLocalizationMap[key]->GetItemHelp(m_selectedLang, itemIndex);
+			return entry->GetItemHelp(m_selectedLang, itemIndex);
 		}
 
 		bool Localization::SetValueItemHelp(uint8 node, uint8 ccID, uint16 indexId, int32 pos, int32 itemIndex, string label, string lang)
 		{
+			LockGuard LG(m_mutex);
+			if (!KeepLanguage(lang))
+				return true;
 			bool unique = false;
 			if ((ccID == Internal::CC::SoundSwitch::StaticGetCommandClassId()) && (indexId == 1 || indexId == 3))
 			{
@@ -721,47 +801,54 @@ namespace OpenZWave
 			}
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos, unique);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
-				m_valueLocalizationMap[key] = std::shared_ptr<ValueLocalizationEntry> (new ValueLocalizationEntry(ccID, indexId, pos));
+				entry = AddValueEntry(key, ccID, indexId, pos);
 			}
-			else if (m_valueLocalizationMap[key]->HasItemHelp(itemIndex, lang))
+			else if (entry->HasItemHelp(itemIndex, lang))
 			{
 				Log::Write(LogLevel_Warning, "Localization::SetValueItemHelp: Duplicate Item Entry for CommandClass %d, ValueID: %d (%d) ItemIndex %d:  %s (Lang: %s)", ccID, indexId, pos, itemIndex, label.c_str(), lang.c_str());
 			}
-			m_valueLocalizationMap[key]->AddItemHelp(label, itemIndex, lang);
+			entry->AddItemHelp(label, itemIndex, lang);
 			return true;
 		}
 
 		std::string const Localization::GetGlobalLabel(string index)
 		{
-			if (m_globalLabelLocalizationMap.find(index) == m_globalLabelLocalizationMap.end())
+			LockGuard LG(m_mutex);
+			map<string, LabelLocalizationEntry>::iterator it = m_globalLabelLocalizationMap.find(index);
+			if (it == m_globalLabelLocalizationMap.end())
 			{
 				Log::Write(LogLevel_Warning, "Localization::GetGlobalLabel: No globalLabelLocalizationMap for Index %s", index.c_str());
 				return index;
 			}
-			return m_globalLabelLocalizationMap[index]->GetLabel(m_selectedLang);
+			return it->second.GetLabel(m_selectedLang);
 
 		}
 		bool Localization::SetGlobalLabel(string index, string text, string lang)
 		{
-			if (m_globalLabelLocalizationMap.find(index) == m_globalLabelLocalizationMap.end())
+			LockGuard LG(m_mutex);
+			if (!KeepLanguage(lang))
+				return true;
+			map<string, LabelLocalizationEntry>::iterator it = m_globalLabelLocalizationMap.find(index);
+			if (it == m_globalLabelLocalizationMap.end())
 			{
-				m_globalLabelLocalizationMap[index] = std::shared_ptr<LabelLocalizationEntry>(new LabelLocalizationEntry(0));
+				it = m_globalLabelLocalizationMap.insert(std::make_pair(index, LabelLocalizationEntry(0))).first;
 			}
-			else if (m_globalLabelLocalizationMap[index]->HasLabel(lang))
+			else if (it->second.HasLabel(lang))
 			{
 				Log::Write(LogLevel_Warning, "Localization::SetGlobalLabel: Duplicate Entry for GlobalText %s: %s (Lang: %s)", index.c_str(), text.c_str(), lang.c_str());
 				return false;
 			}
 			if (lang.empty())
 			{
-				m_globalLabelLocalizationMap[index]->AddLabel(text);
+				it->second.AddLabel(text);
 
 			}
 			else
 			{
-				m_globalLabelLocalizationMap[index]->AddLabel(text, lang);
+				it->second.AddLabel(text, lang);
 
 			}
 			return true;
@@ -769,8 +856,10 @@ namespace OpenZWave
 
 		bool Localization::WriteXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, TiXmlElement *valueElement)
 		{
+			LockGuard LG(m_mutex);
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
-			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
+			ValueLocalizationEntry* entry = FindValueEntry(key);
+			if (!entry)
 			{
 				Log::Write(LogLevel_Warning, "Localization::WriteXMLVIDHelp: No Help for CommandClass %d, ValueID: %d (%d)", ccID, indexId, pos);
 				return false;
@@ -778,23 +867,91 @@ namespace OpenZWave
 			TiXmlElement* helpElement = new TiXmlElement("Help");
 			valueElement->LinkEndChild(helpElement);
 
-			TiXmlText* textElement = new TiXmlText(m_valueLocalizationMap[key]->GetHelp(m_selectedLang).c_str());
+			TiXmlText* textElement = new TiXmlText(entry->GetHelp(m_selectedLang).c_str());
 			helpElement->LinkEndChild(textElement);
 			return true;
 		}
 
+		std::string Localization::GetSelectedLang()
+		{
+			LockGuard LG(m_mutex);
+			return m_selectedLang;
+		}
+
+		void Localization::SetSelectedLang(string const& _lang)
+		{
+			LockGuard LG(m_mutex);
+			if (m_selectedLang == _lang)
+			{
+				return;
+			}
+			Log::Write(LogLevel_Info, "Localization: Changing Language from \"%s\" to \"%s\"", m_selectedLang.c_str(), _lang.c_str());
+			m_selectedLang = _lang;
+			if (m_singleLanguage)
+			{
+				/* drop the old language now, and load the new one the next time we are used */
+				for (vector<pair<uint64, ValueLocalizationEntry> >::iterator it = m_valueLocalizationMap.begin(); it != m_valueLocalizationMap.end(); ++it)
+				{
+					it->second.DropLanguages();
+				}
+				for (map<uint8, LabelLocalizationEntry>::iterator it = m_commandClassLocalizationMap.begin(); it != m_commandClassLocalizationMap.end(); ++it)
+				{
+					it->second.DropLanguages();
+				}
+				for (map<string, LabelLocalizationEntry>::iterator it = m_globalLabelLocalizationMap.begin(); it != m_globalLabelLocalizationMap.end(); ++it)
+				{
+					it->second.DropLanguages();
+				}
+				m_reloadPending = !_lang.empty();
+			}
+		}
+
 		Localization *Localization::Get()
 		{
 			if (m_instance != NULL)
 			{
+				LockGuard LG(m_mutex);
+				if (m_reloadPending)
+				{
+					m_reloadPending = false;
+					m_reloading = true;
+					ReadXML();
+					m_reloading = false;
+				}
 				return m_instance;
 			}
+			m_mutex = new Internal::Platform::Mutex();
+			LockGuard LG(m_mutex);
 			m_instance = new Localization();
+			/* we need to know the language before loading, so we can skip the others in compact mode */
+			string lang;
+			Options::Get()->GetOptionAsString("Language", &lang);
+			m_selectedLang = lang;
+			Options::Get()->GetOptionAsBool("CompactLocalization", &m_singleLanguage);
 			if (!ReadXML()) {
 				OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Create Localization Class! - Missing/Invalid Config File?");
 			}
-			Options::Get()->GetOptionAsString("Language", &m_selectedLang);
+			if (m_singleLanguage)
+			{
+				m_valueLocalizationMap.shrink_to_fit();
+			}
 			return m_instance;
 		}
+
+		void Localization::Destroy()
+		{
+			delete m_instance;
+			m_instance = NULL;
+			if (m_mutex)
+			{
+				m_mutex->Release();
+				m_mutex = NULL;
+			}
+			vector<pair<uint64, ValueLocalizationEntry> >().swap(m_valueLocalizationMap);
+			m_commandClassLocalizationMap.clear();
+			m_globalLabelLocalizationMap.clear();
+			m_selectedLang = InternedString();
+			m_reloadPending = false;
+		}
 	} // namespace Internal
 } // namespace OpenZWave
@@ -31,68 +31,82 @@
 #include <cstdio>
 #include <string>
 #include <map>
+#include <vector>
 #include "Defs.h"
 #include "Driver.h"
+#include "StringPool.h"
 #include "command_classes/CommandClass.h"
 
 namespace OpenZWave
 {
 	namespace Internal
 	{
+		namespace Platform
+		{
+			class Mutex;
+		}
 
-		class LabelLocalizationEntry: public Internal::Platform::Ref
+		/** \brief One localized string, held in a sorted array.
+		 *
+		 * The default text is stored under the empty language.  m_item is the list
+		 * item index for item labels and help, and 0 otherwise.
+		 */
+		struct LocalizedText
 		{
-			public:
-				LabelLocalizationEntry(uint16 _index, uint32 _pos = -1);
-				~LabelLocalizationEntry()
+				InternedString m_lang;
+				int32 m_item;
+				InternedString m_text;
+
+				bool operator <(LocalizedText const& _other) const
 				{
+					return (m_lang < _other.m_lang) || ((m_lang == _other.m_lang) && (m_item < _other.m_item));
 				}
-				void AddLabel(string label, string lang = "");
-				string GetLabel(string lang);
+		};
+		typedef vector<LocalizedText> LocalizedTextTable;
+
+		class LabelLocalizationEntry
+		{
+			public:
+				LabelLocalizationEntry(uint16 _index, uint32 _pos = -1);
+				void AddLabel(string const& label, string const& lang = "");
+				string GetLabel(InternedString const& lang) const;
 				uint64 GetIdx();
-				bool HasLabel(string lang);
+				bool HasLabel(string const& lang) const;
+				void DropLanguages();
 
 			private:
 				uint16 m_index;
 				uint32 m_pos;
-				map<string, string> m_Label;
-				string m_defaultLabel;
+				LocalizedTextTable m_Label;
 		};
 
-		class ValueLocalizationEntry: public Internal::Platform::Ref
+		class ValueLocalizationEntry
 		{
 			public:
 				ValueLocalizationEntry(uint8 _commandClass, uint16 _index, uint32 _pos = -1);
-				~ValueLocalizationEntry()
-				{
-
-				}
 				uint64 GetIdx();
-				string GetHelp(string lang);
-				void AddHelp(string HelpText, string lang = "");
-				bool HasHelp(string lang);
-				string GetLabel(string lang);
-				void AddLabel(string Label, string lang = "");
-				bool HasLabel(string lang);
-				void AddItemLabel(string label, int32 itemIndex, string lang = "");
-				string GetItemLabel(string lang, int32 itemIndex);
-				bool HasItemLabel(int32 itemIndex, string lang);
-				void AddItemHelp(string label, int32 itemIndex, string lang = "");
-				string GetItemHelp(string lang, int32 itemIndex);
-				bool HasItemHelp(int32 itemIndex, string lang);
+				string GetHelp(InternedString const& lang) const;
+				void AddHelp(string const& HelpText, string const& lang = "");
+				bool HasHelp(string const& lang) const;
+				string GetLabel(InternedString const& lang) const;
+				void AddLabel(string const& Label, string const& lang = "");
+				bool HasLabel(string const& lang) const;
+				void AddItemLabel(string const& label, int32 itemIndex, string const& lang = "");
+				string GetItemLabel(InternedString const& lang, int32 itemIndex) const;
+				bool HasItemLabel(int32 itemIndex, string const& lang) const;
+				void AddItemHelp(string const& label, int32 itemIndex, string const& lang = "");
+				string GetItemHelp(InternedString const& lang, int32 itemIndex) const;
+				bool HasItemHelp(int32 itemIndex, string const& lang) const;
+				void DropLanguages();
 
 			private:
 				uint8 m_commandClass;
 				uint16 m_index;
 				uint32 m_pos;
-				map<string, string> m_HelpText;
-				map<string, string> m_LabelText;
-				map<string, map<int32, string> > m_ItemLabelText;
-				map<string, map<int32, string> > m_ItemHelpText;
-				string m_DefaultHelpText;
-				string m_DefaultLabelText;
-				map<int32, string> m_DefaultItemLabelText;
-				map<int32, string> m_DefaultItemHelpText;
+				LocalizedTextTable m_HelpText;
+				LocalizedTextTable m_LabelText;
+				LocalizedTextTable m_ItemLabelText;
+				LocalizedTextTable m_ItemHelpText;
 		};
 
 		class Localization
@@ -110,14 +124,26 @@ namespace OpenZWave
 				static void ReadXMLVIDItemLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement);
 				static void ReadGlobalXMLLabel(const TiXmlElement *labelElement);
 				static uint64 GetValueKey(uint8 _node, uint8 _commandClass, uint16 _index, uint32 _pos, bool unique = false);
+				static bool KeepLanguage(string const& _lang);
+				static ValueLocalizationEntry* FindValueEntry(uint64 _key);
+				static ValueLocalizationEntry* AddValueEntry(uint64 _key, uint8 _commandClass, uint16 _index, uint32 _pos);
 			public:
 				static Localization* Get();
+				/**
+				 * Free the localization tables.  They are loaded again the next
+				 * time Get is called.
+				 */
+				static void Destroy();
 				void SetupCommandClass(Internal::CC::CommandClass *cc);
-				string GetSelectedLang()
-				{
-					return Localization::m_selectedLang;
-				}
-				;
+				string GetSelectedLang();
+				/**
+				 * Change the language used for labels and help text.  When only the
+				 * selected language is kept in memory (the CompactLocalization option)
+				 * the text of the old language is dropped, and the new one is loaded
+				 * on the next call to Get.  Text for other languages that came from
+				 * device config files is not reloaded until those devices are refreshed.
+				 */
+				void SetSelectedLang(string const& _lang);
 				bool SetValueHelp(uint8 node, uint8 ccID, uint16 indexID, uint32 pos, string help, string lang = "");
 				string const GetValueHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos);
 				bool SetValueLabel(uint8 node, uint8 ccID, uint16 indexID, uint32 pos, string label, string lang = "");
@@ -136,11 +162,15 @@ namespace OpenZWave
 				//-----------------------------------------------------------------------------
 			private:
 				static Localization* m_instance;
-				static map<uint64, std::shared_ptr<ValueLocalizationEntry> > m_valueLocalizationMap;
-				static map<uint8, std::shared_ptr<LabelLocalizationEntry> > m_commandClassLocalizationMap;
-				static map<string, std::shared_ptr<LabelLocalizationEntry> > m_globalLabelLocalizationMap;
-				static string m_selectedLang;
+				static vector<pair<uint64, ValueLocalizationEntry> > m_valueLocalizationMap;		// Sorted by key
+				static map<uint8, LabelLocalizationEntry> m_commandClassLocalizationMap;
+				static map<string, LabelLocalizationEntry> m_globalLabelLocalizationMap;
+				static InternedString m_selectedLang;
 				static uint32 m_revision;
+				static bool m_singleLanguage;		// Only keep the selected language and the defaults
+				static bool m_reloadPending;		// The selected language changed and its text still has to be loaded
+				static bool m_reloading;
+				static Internal::Platform::Mutex* m_mutex;		// Guards the tables, which every driver thread reads and adds to
 
 		};
 	} // namespace Internal
@@ -32,6 +32,8 @@
 
 #include "Defs.h"
 #include "CompatOptionManager.h"
+#include "ConfigLoader.h"
+#include "MetricsExporter.h"
 #include "Manager.h"
 #include "Driver.h"
 #include "Localization.h"
@@ -41,11 +43,13 @@
 #include "Options.h"
 #include "Scene.h"
 #include "SensorMultiLevelCCTypes.h"
+#include "StringPool.h"
 #include "Utils.h"
 
 #include "platform/Mutex.h"
 #include "platform/Event.h"
 #include "platform/Log.h"
+#include "platform/Trace.h"
 
 #include "command_classes/CommandClasses.h"
 #include "command_classes/CommandClass.h"
@@ -88,6 +92,15 @@ Manager* Manager::Create()
 		if ( NULL == s_instance)
 		{
 			s_instance = new Manager();
+			try
+			{
+				s_instance->LoadConfig();
+			} catch (...)
+			{
+				// Tidy up, so a later Create can try again
+				Destroy();
+				throw;
+			}
 		}
 		return s_instance;
 	}
@@ -143,11 +156,17 @@ ozwversion Manager::getVersion()
 // Constructor
 //-----------------------------------------------------------------------------
 Manager::Manager() :
-		m_notificationMutex(new Internal::Platform::Mutex())
+		m_notificationMutex(new Internal::Platform::Mutex()), m_configLoader(new Internal::ConfigLoader())
 {
 	// Ensure the singleton instance is set
 	s_instance = this;
 
+	// Before the first lock is taken, so every lock is counted
+	bool profileLocks = false;
+	Options::Get()->GetOptionAsBool("ProfileLocks", &profileLocks);
+	Internal::Platform::Mutex::SetProfiling(profileLocks);
+	m_notificationMutex->SetName("Manager::m_notificationMutex");
+
 	// Create the log file (if enabled)
 	bool logging = false;
 	Options::Get()->GetOptionAsBool("Logging", &logging);
@@ -189,19 +208,28 @@ Manager::Manager() :
 	Log::SetLoggingState(logging);
 
 	Internal::CC::CommandClasses::RegisterCommandClasses();
-	Internal::Scene::ReadScenes();
+	bool profileHandlers = false;
+	Options::Get()->GetOptionAsBool("ProfileHandlers", &profileHandlers);
+	Internal::CC::CommandClass::SetHandlerProfiling(profileHandlers);
 	// petergebruers replace getVersionAsString() with getVersionLongAsString() because
 	// the latter prints more information, based on the status of the repository
 	// when "make" was run. A Makefile gets this info from git describe --long --tags --dirty
 	Log::Write(LogLevel_Always, "OpenZwave Version %s Starting Up", getVersionLongAsString().c_str());
-	Log::Write(LogLevel_Always, "Using Language Localization %s", Internal::Localization::Get()->GetSelectedLang().c_str());
-	if (!Internal::NotificationCCTypes::Create()) {
-		Log::Write(LogLevel_Error, "mgr,     Cannot Create NotificationCCTypes!");
-	}
-	if (!Internal::SensorMultiLevelCCTypes::Create()) {
-		Log::Write(LogLevel_Error, "mgr,     Cannot Create SensorMultiLevelCCTypes!");
-	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::LoadConfig>
+// Read the global config files.  Kept out of the constructor because it can throw.
+//-----------------------------------------------------------------------------
+void Manager::LoadConfig()
+{
+	// Localization, the Notification and Sensor types, the product database, device
+	// classes and scenes.  Drivers can only be added once they are all loaded.
+	m_configLoader->Load();
 
+	// Serve the statistics of the drivers as they are added, if configured
+	Internal::MetricsExporter::Create();
+	Internal::Platform::Trace::Create();
 }
 
 //-----------------------------------------------------------------------------
@@ -228,6 +256,10 @@ Manager::~Manager()
 	}
 	m_readyDrivers.clear();
 
+	// The driver threads have stopped, so their traces are complete
+	Internal::Platform::Trace::Destroy();
+	Internal::MetricsExporter::Destroy();
+
 	m_notificationMutex->Release();
 
 	// Clear the watchers list
@@ -280,7 +312,14 @@ Manager::~Manager()
 	Node::s_nodeTypes.clear();
 
 	Node::s_deviceClassesLoaded = false;
-	
+
+	delete m_configLoader;
+
+	// Nothing holds interned strings any more, so release them
+	Internal::Localization::Destroy();
+	Internal::VC::ValueList::ClearSharedItems();
+	Internal::StringPool::Clear();
+
 	Log::Destroy();
 }
 
@@ -2693,6 +2732,33 @@ bool Manager::SetValue(ValueID const& _id, uint8 const _value)
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <FloatToDecimalString>
+// Format a float for a ValueDecimal, without any trailing zeros
+//-----------------------------------------------------------------------------
+static string FloatToDecimalString(float const _value)
+{
+	char str[256];
+	snprintf(str, sizeof(str), "%f", _value);
+
+	// remove trailing zeros (and the decimal point, if present)
+	// TODO: better way of figuring out which locale is being used ('.' or ',' to separate decimals)
+	size_t nLen;
+	if ((strchr(str, '.') != NULL) || (strchr(str, ',') != NULL))
+	{
+		for (nLen = strlen(str) - 1; nLen > 0; nLen--)
+		{
+			if (str[nLen] == '0')
+				str[nLen] = 0;
+			else
+				break;
+		}
+		if ((str[nLen] == '.') || (str[nLen] == ','))
+			str[nLen] = 0;
+	}
+	return str;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets the value from a floating point number
@@ -2710,27 +2776,7 @@ bool Manager::SetValue(ValueID const& _id, float const _value)
 				Internal::LockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueDecimal* value = static_cast<Internal::VC::ValueDecimal*>(driver->GetValue(_id)))
 				{
-					char str[256];
-					snprintf(str, sizeof(str), "%f", _value);
-
-					// remove trailing zeros (and the decimal point, if present)
-					// TODO: better way of figuring out which locale is being used ('.' or ',' to separate decimals)
-					size_t nLen;
-					if ((strchr(str, '.') != NULL) || (strchr(str, ',') != NULL))
-					{
-						for (nLen = strlen(str) - 1; nLen > 0; nLen--)
-						{
-							if (str[nLen] == '0')
-								str[nLen] = 0;
-							else
-								break;
-						}
-						if ((str[nLen] == '.') || (str[nLen] == ','))
-							str[nLen] = 0;
-					}
-
-					// now set the value
-					res = value->Set(str);
+					res = value->Set(FloatToDecimalString(_value));
 					value->Release();
 				}
 				else
@@ -3352,6 +3398,455 @@ bool Manager::GetBitSetSize(ValueID const& _id, uint8* o_size)
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// Value Handles
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueHandle>
+// Resolve a ValueID to a handle that can be used for repeated access
+//-----------------------------------------------------------------------------
+ValueHandle* Manager::GetValueHandle(ValueID const& _id)
+{
+	ValueHandle* handle = NULL;
+
+	if (Driver* driver = GetDriver(_id.GetHomeId()))
+	{
+		Internal::LockGuard LG(driver->m_nodeMutex);
+		if (Internal::VC::Value* value = driver->GetValue(_id))
+		{
+			handle = value->GetHandle(driver->m_nodeMutex);
+			value->Release();
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueID passed to GetValueHandle");
+		}
+	}
+
+	return handle;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::ReleaseValueHandle>
+// Release a handle obtained from GetValueHandle
+//-----------------------------------------------------------------------------
+void Manager::ReleaseValueHandle(ValueHandle* _handle)
+{
+	if (_handle)
+	{
+		_handle->Release();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsBool>
+// Gets a value as a bool through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsBool(ValueHandle* _handle, bool* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (ValueID::ValueType_Bool == _handle->m_id.GetType())
+			{
+				*o_value = static_cast<Internal::VC::ValueBool*>(value)->GetValue();
+				res = true;
+			}
+			else if (ValueID::ValueType_Button == _handle->m_id.GetType())
+			{
+				*o_value = static_cast<Internal::VC::ValueButton*>(value)->IsPressed();
+				res = true;
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to GetValueAsBool is not a Bool or Button Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsBool");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsByte>
+// Gets a value as an 8-bit unsigned integer through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsByte(ValueHandle* _handle, uint8* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (ValueID::ValueType_Byte == _handle->m_id.GetType())
+			{
+				*o_value = static_cast<Internal::VC::ValueByte*>(value)->GetValue();
+				res = true;
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to GetValueAsByte is not a Byte Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsByte");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsFloat>
+// Gets a value as a floating point number through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsFloat(ValueHandle* _handle, float* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (ValueID::ValueType_Decimal == _handle->m_id.GetType())
+			{
+				string str = static_cast<Internal::VC::ValueDecimal*>(value)->GetValue();
+				*o_value = (float) atof(str.c_str());
+				res = true;
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to GetValueAsFloat is not a Float Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsFloat");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsInt>
+// Gets a value as a 32-bit signed integer through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsInt(ValueHandle* _handle, int32* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (ValueID::ValueType_Int == _handle->m_id.GetType())
+			{
+				*o_value = static_cast<Internal::VC::ValueInt*>(value)->GetValue();
+				res = true;
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to GetValueAsInt is not a Int Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsInt");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsShort>
+// Gets a value as a 16-bit signed integer through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsShort(ValueHandle* _handle, int16* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (ValueID::ValueType_Short == _handle->m_id.GetType())
+			{
+				*o_value = static_cast<Internal::VC::ValueShort*>(value)->GetValue();
+				res = true;
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to GetValueAsShort is not a Short Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsShort");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueAsString>
+// Gets a value as a string through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::GetValueAsString(ValueHandle* _handle, string* o_value)
+{
+	bool res = false;
+
+	if (_handle && o_value)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			*o_value = value->GetAsString();
+			res = true;
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to GetValueAsString");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::IsControllerValue>
+// The handle overloads refuse the controller node's values, as the ValueID ones
+// do.  Only called for a valid handle, so the driver still exists.
+//-----------------------------------------------------------------------------
+bool Manager::IsControllerValue(ValueHandle const* _handle)
+{
+	Driver* driver = GetDriver(_handle->m_id.GetHomeId());
+	return (!driver || (_handle->m_id.GetNodeId() == driver->GetControllerNodeId()));
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a bool through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, bool const _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else if (ValueID::ValueType_Bool == _handle->m_id.GetType())
+			{
+				res = static_cast<Internal::VC::ValueBool*>(value)->Set(_value);
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to SetValue is not a bool Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a byte through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, uint8 const _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else if (ValueID::ValueType_Byte == _handle->m_id.GetType())
+			{
+				res = static_cast<Internal::VC::ValueByte*>(value)->Set(_value);
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to SetValue is not a Byte Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a floating point number through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, float const _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else if (ValueID::ValueType_Decimal == _handle->m_id.GetType())
+			{
+				res = static_cast<Internal::VC::ValueDecimal*>(value)->Set(FloatToDecimalString(_value));
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to SetValue is not a Decimal Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a 32-bit signed integer through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, int32 const _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else if (ValueID::ValueType_Int == _handle->m_id.GetType())
+			{
+				res = static_cast<Internal::VC::ValueInt*>(value)->Set(_value);
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to SetValue is not a Int Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a 16-bit signed integer through a ValueHandle
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, int16 const _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else if (ValueID::ValueType_Short == _handle->m_id.GetType())
+			{
+				res = static_cast<Internal::VC::ValueShort*>(value)->Set(_value);
+			}
+			else
+			{
+				OZW_ERROR(OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID, "ValueHandle passed to SetValue is not a Short Value");
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValue>
+// Sets the value from a string through a ValueHandle, regardless of type
+//-----------------------------------------------------------------------------
+bool Manager::SetValue(ValueHandle* _handle, string const& _value)
+{
+	bool res = false;
+
+	if (_handle)
+	{
+		Internal::LockGuard LG(_handle->m_mutex);
+		if (Internal::VC::Value* value = _handle->m_value)
+		{
+			if (IsControllerValue(_handle))
+			{
+				Log::Write(LogLevel_Info, "mgr,     SetValue through a ValueHandle refused for a value of the controller node");
+			}
+			else
+			{
+				res = value->SetFromString(_value);
+			}
+		}
+		else
+		{
+			OZW_ERROR(OZWException::OZWEXCEPTION_INVALID_VALUEID, "Invalid ValueHandle passed to SetValue");
+		}
+	}
+
+	return res;
+}
+
 //-----------------------------------------------------------------------------
 // Climate Control Schedules
 //-----------------------------------------------------------------------------
@@ -3777,6 +4272,7 @@ void Manager::NotifyWatchers(Notification* _notification)
 	while (it != m_watchers.end())
 	{
 		Watcher* pWatcher = *(it++);
+		Internal::Platform::TraceSpan span("Watcher callback", _notification->GetType());
 		pWatcher->m_callback(_notification, pWatcher->m_context);
 	}
 	m_watcherIterators.pop_back();
@@ -4765,6 +5261,59 @@ if (Driver* driver = GetDriver(_homeId))
 
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::GetMsgQueueStatistics>
+// Retrieve the send pipeline timing of one of the driver's queues
+//-----------------------------------------------------------------------------
+bool Manager::GetMsgQueueStatistics(uint32 const _homeId, Driver::MsgQueue const _queue, Driver::MsgQueueData* _data)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		return driver->GetMsgQueueStatistics(_queue, _data);
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetCommandClassAirtime>
+// Retrieve the airtime used by one command class
+//-----------------------------------------------------------------------------
+bool Manager::GetCommandClassAirtime(uint32 const _homeId, uint8 const _commandClassId, AirtimeCounter* _data)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		return driver->GetCommandClassAirtime(_commandClassId, _data);
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetLockStatistics>
+// Retrieve the contention on the mutexes a driver uses
+//-----------------------------------------------------------------------------
+bool Manager::GetLockStatistics(uint32 const _homeId, std::vector<Driver::LockData>* _data)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		return driver->GetLockStatistics(_data);
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetMsgTraceCallback>
+// Set the function that is passed the timing of each message
+//-----------------------------------------------------------------------------
+bool Manager::SetMsgTraceCallback(uint32 const _homeId, Driver::pfnOnMsgTrace_t _callback, void* _context)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		driver->SetMsgTraceCallback(_callback, _context);
+		return true;
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::GetNodeRouteScheme>
 // Convert the RouteScheme to a String
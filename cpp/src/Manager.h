@@ -39,6 +39,7 @@
 #include "Driver.h"
 #include "Group.h"
 #include "value_classes/ValueID.h"
+#include "value_classes/ValueHandle.h"
 
 namespace OpenZWave
 {
@@ -54,6 +55,7 @@ namespace OpenZWave
 			class ValueStore;
 		}
 		class Msg;
+		class ConfigLoader;
 	}
 	class Options;
 	class Node;
@@ -178,6 +180,7 @@ namespace OpenZWave
 		private:
 			Manager();															// Constructor, to be called only via the static Create method.
 			virtual ~Manager();													// Destructor, to be called only via the static Destroy method.
+			void LoadConfig();													// Reads the global config files.  Called by Create, as it can throw.
 
 			bool m_exit;										// Flag indicating that program exit is in progress.
 			static Manager* s_instance;									// Pointer to the instance of the Manager singleton.
@@ -1497,6 +1500,172 @@ namespace OpenZWave
 
 			/*@}*/
 
+			//-----------------------------------------------------------------------------
+			// Value Handles
+			//-----------------------------------------------------------------------------
+			/** \name Value Handles
+			 *  Methods for fast, repeated access to values.  A ValueHandle is obtained once for a ValueID
+			 *  and can then be used in place of the ValueID without the Driver, Node and Value lookups that
+			 *  every ValueID based call has to perform.  Handles are invalidated when their value is removed.
+			 *  As with the ValueID overloads, the values of the controller node can not be set through a handle.
+			 */
+			/*@{*/
+		public:
+			/**
+			 * \brief Resolve a ValueID to a ValueHandle.
+			 * Repeated calls for the same ValueID return the same handle.  Every successful call must be matched
+			 * by a call to ReleaseValueHandle.
+			 * \param _id The unique identifier of the value.
+			 * \return the handle, or NULL if the value could not be found.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the ValueID is invalid
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_HOMEID if the Driver cannot be found
+			 * \see ValueHandle, ReleaseValueHandle
+			 */
+			ValueHandle* GetValueHandle(ValueID const& _id);
+
+			/**
+			 * \brief Release a ValueHandle obtained from GetValueHandle.
+			 * The handle must not be used after it has been released.  Handles that have been invalidated
+			 * still have to be released.
+			 * \param _handle The handle to release.
+			 * \see ValueHandle, GetValueHandle
+			 */
+			void ReleaseValueHandle(ValueHandle* _handle);
+
+			/**
+			 * \brief Gets a value as a bool through a ValueHandle.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to a bool that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see GetValueAsBool(ValueID const&, bool*)
+			 */
+			bool GetValueAsBool(ValueHandle* _handle, bool* o_value);
+
+			/**
+			 * \brief Gets a value as an 8-bit unsigned integer through a ValueHandle.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to a uint8 that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see GetValueAsByte(ValueID const&, uint8*)
+			 */
+			bool GetValueAsByte(ValueHandle* _handle, uint8* o_value);
+
+			/**
+			 * \brief Gets a value as a float through a ValueHandle.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to a float that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see GetValueAsFloat(ValueID const&, float*)
+			 */
+			bool GetValueAsFloat(ValueHandle* _handle, float* o_value);
+
+			/**
+			 * \brief Gets a value as a 32-bit signed integer through a ValueHandle.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to an int32 that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see GetValueAsInt(ValueID const&, int32*)
+			 */
+			bool GetValueAsInt(ValueHandle* _handle, int32* o_value);
+
+			/**
+			 * \brief Gets a value as a 16-bit signed integer through a ValueHandle.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to an int16 that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see GetValueAsShort(ValueID const&, int16*)
+			 */
+			bool GetValueAsShort(ValueHandle* _handle, int16* o_value);
+
+			/**
+			 * \brief Gets a value as a string through a ValueHandle, regardless of its type.
+			 * \param _handle The handle of the value.
+			 * \param o_value Pointer to a string that will be filled with the value.
+			 * \return true if the value was obtained.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \see GetValueAsString(ValueID const&, string*)
+			 */
+			bool GetValueAsString(ValueHandle* _handle, string* o_value);
+
+			/**
+			 * \brief Sets the state of a bool through a ValueHandle.
+			 * \param _handle The handle of the bool value.
+			 * \param _value The new value of the bool.
+			 * \return true if the value was set.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see SetValue(ValueID const&, bool const)
+			 */
+			bool SetValue(ValueHandle* _handle, bool const _value);
+
+			/**
+			 * \brief Sets the value of a byte through a ValueHandle.
+			 * \param _handle The handle of the byte value.
+			 * \param _value The new value of the byte.
+			 * \return true if the value was set.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see SetValue(ValueID const&, uint8 const)
+			 */
+			bool SetValue(ValueHandle* _handle, uint8 const _value);
+
+			/**
+			 * \brief Sets the value of a decimal through a ValueHandle.
+			 * \param _handle The handle of the decimal value.
+			 * \param _value The new value of the decimal.
+			 * \return true if the value was set.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see SetValue(ValueID const&, float const)
+			 */
+			bool SetValue(ValueHandle* _handle, float const _value);
+
+			/**
+			 * \brief Sets the value of a 32-bit signed integer through a ValueHandle.
+			 * \param _handle The handle of the integer value.
+			 * \param _value The new value of the integer.
+			 * \return true if the value was set.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see SetValue(ValueID const&, int32 const)
+			 */
+			bool SetValue(ValueHandle* _handle, int32 const _value);
+
+			/**
+			 * \brief Sets the value of a 16-bit signed integer through a ValueHandle.
+			 * \param _handle The handle of the integer value.
+			 * \param _value The new value of the integer.
+			 * \return true if the value was set.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_CANNOT_CONVERT_VALUEID if the Actual Value is off a different type
+			 * \see SetValue(ValueID const&, int16 const)
+			 */
+			bool SetValue(ValueHandle* _handle, int16 const _value);
+
+			/**
+			 * \brief Sets the value from a string through a ValueHandle, regardless of type.
+			 * \param _handle The handle of the value.
+			 * \param _value The new value of the string.
+			 * \return true if the value was set.  Returns false if the value could not be parsed into the correct type for the value.
+			 * \throws OZWException with Type OZWException::OZWEXCEPTION_INVALID_VALUEID if the handle has been invalidated
+			 * \see SetValue(ValueID const&, string const&)
+			 */
+			bool SetValue(ValueHandle* _handle, string const& _value);
+
+		private:
+			bool IsControllerValue(ValueHandle const* _handle);			// Whether the handle is for a value of the controller node, which can not be set
+			/*@}*/
+
 			//-----------------------------------------------------------------------------
 			// Climate Control Schedules
 			//-----------------------------------------------------------------------------
@@ -1831,6 +2000,7 @@ namespace OpenZWave
 			list<Watcher*> m_watchers;							// List of all the registered watchers.
 			list<list<Watcher*>::iterator*> m_watcherIterators;					// Iterators currently operating on the list of watchers
 			Internal::Platform::Mutex* m_notificationMutex;
+			Internal::ConfigLoader* m_configLoader;						// Reads the global config files at startup
 
 			//-----------------------------------------------------------------------------
 			// Controller commands
@@ -2613,6 +2783,48 @@ namespace OpenZWave
 			 */
 			void GetNodeStatistics(uint32 const _homeId, uint8 const _nodeId, Node::NodeData* _data);
 
+			/**
+			 * \brief Retrieve where the messages sent from one of the driver's queues spent their time
+			 * \param _homeId The Home ID of the driver
+			 * \param _queue The queue
+			 * \param _data Pointer to structure MsgQueueData to return values
+			 * \return true if the driver and queue exist
+			 */
+			bool GetMsgQueueStatistics(uint32 const _homeId, Driver::MsgQueue const _queue, Driver::MsgQueueData* _data);
+
+			/**
+			 * \brief Retrieve the airtime used by the frames carrying one command class, for all nodes
+			 * The airtime for each node is returned by GetNodeStatistics, and for each
+			 * queue by GetMsgQueueStatistics.
+			 * \param _homeId The Home ID of the driver
+			 * \param _commandClassId The command class
+			 * \param _data Pointer to the AirtimeCounter to return the airtime in
+			 * \return true if the driver exists and has sent frames of the command class
+			 */
+			bool GetCommandClassAirtime(uint32 const _homeId, uint8 const _commandClassId, AirtimeCounter* _data);
+
+			/**
+			 * \brief Retrieve how much the mutexes a driver uses are contended
+			 * Covers the driver's node, send and poll mutexes, its timer's mutex, and
+			 * the notification and log mutexes it shares with the other drivers.  Only
+			 * kept with the ProfileLocks option.
+			 * \param _homeId The Home ID of the driver
+			 * \param _data Pointer to the vector to return the statistics of each mutex in
+			 * \return true if the driver exists and lock profiling is enabled
+			 */
+			bool GetLockStatistics(uint32 const _homeId, std::vector<Driver::LockData>* _data);
+
+			/**
+			 * \brief Pass the timing of every message the driver sends to a function
+			 * The function is called on the driver thread as each message is removed,
+			 * so it must return quickly and must not call back into the Manager.
+			 * \param _homeId The Home ID of the driver
+			 * \param _callback The function, or NULL to stop tracing
+			 * \param _context Pointer passed back to the function
+			 * \return true if the driver exists
+			 */
+			bool SetMsgTraceCallback(uint32 const _homeId, Driver::pfnOnMsgTrace_t _callback, void* _context);
+
 			/**
 			 * \brief Get a Human Readable String for the RouteScheme in the Extended TX Status Frame
 			 * \param _data Pointer to the structure Node::NodeData return from GetNodeStatistics
@@ -29,6 +29,7 @@
 #include "tinyxml.h"
 
 #include "Options.h"
+#include "ConfigBundle.h"
 #include "Driver.h"
 #include "platform/Log.h"
 #include "platform/FileOps.h"
@@ -51,7 +52,15 @@ namespace OpenZWave
 
 			if ( NULL == s_instance)
 			{
-				s_instance = new ManufacturerSpecificDB();
+				// Only set the instance once the database has loaded, so a bad
+				// config file does not leave s_instance pointing at nothing
+				ManufacturerSpecificDB* mfs = new ManufacturerSpecificDB();
+				if (!s_bXmlLoaded && !mfs->LoadProductXML())
+				{
+					delete mfs;
+					OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Load/Read ManufacturerSpecificDB! - Missing/Invalid Config File?");
+				}
+				s_instance = mfs;
 			}
 			return s_instance;
 
@@ -66,15 +75,6 @@ namespace OpenZWave
 		ManufacturerSpecificDB::ManufacturerSpecificDB() :
 				m_MfsMutex(new Internal::Platform::Mutex()), m_revision(0), m_latestRevision(0), m_initializing(true)
 		{
-			// Ensure the singleton instance is set
-			s_instance = this;
-
-			if (!s_bXmlLoaded) {
-				if (!LoadProductXML()) {
-					OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Load/Read ManufacturerSpecificDB! - Missing/Invalid Config File?");
-				}
-			}
-
 		}
 
 		ManufacturerSpecificDB::~ManufacturerSpecificDB()
@@ -98,6 +98,14 @@ namespace OpenZWave
 
 			if (product->GetConfigPath().size() > 0)
 			{
+				// The bundle index has the revision, which saves parsing the whole file for one attribute
+				uint32 revision;
+				if (ConfigBundle::GetProductRevision(product->GetConfigPath(), &revision))
+				{
+					product->SetConfigRevision(revision);
+					return;
+				}
+
 				string path = configPath + product->GetConfigPath();
 
 				TiXmlDocument* pDoc = new TiXmlDocument();
@@ -148,7 +156,7 @@ namespace OpenZWave
 			string filename = configPath + "manufacturer_specific.xml";
 
 			TiXmlDocument* pDoc = new TiXmlDocument();
-			if (!pDoc->LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+			if (!ConfigBundle::LoadXML(pDoc, "manufacturer_specific.xml"))
 			{
 				delete pDoc;
 				Log::Write(LogLevel_Info, "Unable to load %s", filename.c_str());
@@ -0,0 +1,767 @@
+//-----------------------------------------------------------------------------
+//
+//	MetricsExporter.cpp
+//
+//	Serve the driver and node statistics in the Prometheus text format
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#endif
+
+#include "MetricsExporter.h"
+#include "Driver.h"
+#include "Node.h"
+#include "Options.h"
+#include "LatencyHistogram.h"
+#include "Utils.h"
+#include "command_classes/CommandClasses.h"
+#include "platform/Event.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+#include "platform/TimeStamp.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		MetricsExporter* MetricsExporter::s_instance = NULL;
+
+		// Poll the socket in slices this long (ms), so the thread notices it has to exit
+		static int32 const c_pollSlice = 250;
+		// Longest a client that does not read its metrics can hold up the thread
+		static int32 const c_clientTimeout = 1000;
+
+		struct DriverCounterInfo
+		{
+				char const* m_name;
+				char const* m_help;
+				uint32 Driver::DriverData::* m_field;
+		};
+
+		static DriverCounterInfo const c_driverCounters[] =
+		{
+		{ "ozw_sof_total", "Start of frame bytes received from the controller", &Driver::DriverData::m_SOFCnt },
+		{ "ozw_ack_total", "ACK bytes received from the controller", &Driver::DriverData::m_ACKCnt },
+		{ "ozw_nak_total", "NAK bytes received from the controller", &Driver::DriverData::m_NAKCnt },
+		{ "ozw_can_total", "CAN bytes received from the controller", &Driver::DriverData::m_CANCnt },
+		{ "ozw_out_of_frame_total", "Bytes received out of framing", &Driver::DriverData::m_OOFCnt },
+		{ "ozw_bad_checksum_total", "Frames received with a bad checksum", &Driver::DriverData::m_badChecksum },
+		{ "ozw_read_aborts_total", "Reads aborted because of a timeout", &Driver::DriverData::m_readAborts },
+		{ "ozw_ack_waiting_total", "Unsolicited messages received while waiting for an ACK", &Driver::DriverData::m_ACKWaiting },
+		{ "ozw_messages_read_total", "Messages successfully read from the controller", &Driver::DriverData::m_readCnt },
+		{ "ozw_messages_written_total", "Messages written to the controller", &Driver::DriverData::m_writeCnt },
+		{ "ozw_dropped_total", "Messages dropped and not delivered", &Driver::DriverData::m_dropped },
+		{ "ozw_retries_total", "Messages retransmitted", &Driver::DriverData::m_retries },
+		{ "ozw_unexpected_callbacks_total", "Unexpected callbacks", &Driver::DriverData::m_callbacks },
+		{ "ozw_bad_routes_total", "Messages failed because of a bad route", &Driver::DriverData::m_badroutes },
+		{ "ozw_no_ack_total", "Messages not ACKed by the node", &Driver::DriverData::m_noack },
+		{ "ozw_net_busy_total", "Network busy or failure responses", &Driver::DriverData::m_netbusy },
+		{ "ozw_not_idle_total", "RF network busy responses", &Driver::DriverData::m_notidle },
+		{ "ozw_non_delivery_total", "Messages not delivered to the network", &Driver::DriverData::m_nondelivery },
+		{ "ozw_routed_busy_total", "Messages received with the routed busy status", &Driver::DriverData::m_routedbusy },
+		{ "ozw_broadcasts_read_total", "Broadcasts received", &Driver::DriverData::m_broadcastReadCnt },
+		{ "ozw_polls_total", "Values polled", &Driver::DriverData::m_pollCnt },
+		{ "ozw_notifications_total", "Notifications queued for the application", &Driver::DriverData::m_notificationCnt },
+		{ "ozw_throttled_total", "Times the Poll and Query queues used up their airtime budget", &Driver::DriverData::m_throttled },
+		{ "ozw_throttle_backoffs_total", "Times the airtime budget was halved because the network was busy", &Driver::DriverData::m_throttleBackoffs } };
+
+		struct NodeCounterInfo
+		{
+				char const* m_name;
+				char const* m_help;
+				uint32 Node::NodeData::* m_field;
+		};
+
+		static NodeCounterInfo const c_nodeCounters[] =
+		{
+		{ "ozw_node_sent_total", "Messages sent to the node", &Node::NodeData::m_sentCnt },
+		{ "ozw_node_sent_failed_total", "Messages to the node that failed", &Node::NodeData::m_sentFailed },
+		{ "ozw_node_retries_total", "Messages to the node that were retried", &Node::NodeData::m_retries },
+		{ "ozw_node_received_total", "Messages received from the node", &Node::NodeData::m_receivedCnt },
+		{ "ozw_node_received_duplicates_total", "Duplicate messages received from the node", &Node::NodeData::m_receivedDups },
+		{ "ozw_node_received_unsolicited_total", "Unsolicited messages received from the node", &Node::NodeData::m_receivedUnsolicited } };
+
+		struct LockMetricInfo
+		{
+				char const* m_name;
+				char const* m_type;
+				char const* m_help;
+				uint64 Platform::Mutex::Statistics::* m_field;
+		};
+
+		static LockMetricInfo const c_lockMetrics[] =
+		{
+		{ "ozw_lock_acquisitions_total", "counter", "Times a mutex was locked", &Platform::Mutex::Statistics::m_acquisitions },
+		{ "ozw_lock_contended_total", "counter", "Times a mutex was held by another thread when it was locked", &Platform::Mutex::Statistics::m_contended },
+		{ "ozw_lock_wait_us_total", "counter", "Time spent waiting for a mutex", &Platform::Mutex::Statistics::m_waitTime },
+		{ "ozw_lock_hold_us_total", "counter", "Time a mutex was held", &Platform::Mutex::Statistics::m_holdTime },
+		{ "ozw_lock_max_wait_us", "gauge", "Longest wait for a mutex", &Platform::Mutex::Statistics::m_maxWaitTime },
+		{ "ozw_lock_max_hold_us", "gauge", "Longest a mutex was held", &Platform::Mutex::Statistics::m_maxHoldTime } };
+
+		static uint32 const c_driverCounterCount = sizeof(c_driverCounters) / sizeof(c_driverCounters[0]);
+		static uint32 const c_nodeCounterCount = sizeof(c_nodeCounters) / sizeof(c_nodeCounters[0]);
+		static uint32 const c_lockMetricCount = sizeof(c_lockMetrics) / sizeof(c_lockMetrics[0]);
+
+		// Completed and failed, for each queue
+		static uint32 const c_queueCounterCount = 2 * Driver::MsgQueue_Count;
+
+		struct NodeSnapshot
+		{
+				uint8 m_nodeId;
+				Node::NodeData m_data;
+		};
+
+		struct MetricsExporter::Snapshot
+		{
+				uint32 m_homeId;
+				Driver::DriverData m_data;
+				uint32 m_depth[Driver::MsgQueue_Count];
+				Driver::MsgQueueData m_queues[Driver::MsgQueue_Count];
+				std::list<NodeSnapshot> m_nodes;
+				std::map<uint8, AirtimeCounter> m_commandClassAirtime;
+				std::vector<Driver::LockData> m_locks;			// Empty unless lock profiling is enabled
+				DriverCounters* m_counters;
+		};
+
+//-----------------------------------------------------------------------------
+// <AppendLine>
+// printf to the end of a string
+//-----------------------------------------------------------------------------
+		static void AppendLine(string* _text, char const* _format, ...)
+		{
+			char line[512];
+			va_list args;
+			va_start(args, _format);
+			vsnprintf(line, sizeof(line), _format, args);
+			va_end(args);
+			*_text += line;
+		}
+
+//-----------------------------------------------------------------------------
+// <AppendFamily>
+// The HELP and TYPE lines of a metric
+//-----------------------------------------------------------------------------
+		static void AppendFamily(string* _text, char const* _name, char const* _type, char const* _help)
+		{
+			AppendLine(_text, "# HELP %s %s\n# TYPE %s %s\n", _name, _help, _name, _type);
+		}
+
+//-----------------------------------------------------------------------------
+// <AppendSummary>
+// The samples of a latency summary
+//-----------------------------------------------------------------------------
+		static void AppendSummary(string* _text, char const* _name, string const& _labels, LatencyHistogram const& _histogram)
+		{
+			static double const quantiles[] =
+			{ 0.5, 0.9, 0.99 };
+			for (uint32 i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); ++i)
+			{
+				AppendLine(_text, "%s{%s,quantile=\"%g\"} %u\n", _name, _labels.c_str(), quantiles[i], _histogram.GetPercentile(quantiles[i] * 100.0));
+			}
+			AppendLine(_text, "%s_sum{%s} %llu\n", _name, _labels.c_str(), (unsigned long long) _histogram.GetTotal());
+			AppendLine(_text, "%s_count{%s} %u\n", _name, _labels.c_str(), _histogram.GetCount());
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::Create>
+// Start the exporter if it has been configured
+//-----------------------------------------------------------------------------
+		void MetricsExporter::Create()
+		{
+			if (s_instance)
+			{
+				return;
+			}
+
+			string socketPath;
+			string filePath;
+			int32 interval = 60;
+			Options::Get()->GetOptionAsString("MetricsSocket", &socketPath);
+			Options::Get()->GetOptionAsString("MetricsFile", &filePath);
+			Options::Get()->GetOptionAsInt("MetricsInterval", &interval);
+			if (socketPath.empty() && filePath.empty())
+			{
+				return;
+			}
+			if (interval < 1)
+			{
+				Log::Write(LogLevel_Warning, "MetricsInterval must be at least 1 second");
+				interval = 1;
+			}
+
+			s_instance = new MetricsExporter(ResolveUserPath(socketPath), ResolveUserPath(filePath), (uint32) interval);
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::Destroy>
+// Stop the exporter
+//-----------------------------------------------------------------------------
+		void MetricsExporter::Destroy()
+		{
+			delete s_instance;
+			s_instance = NULL;
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::AddDriver>
+// Start exporting a driver's statistics
+//-----------------------------------------------------------------------------
+		void MetricsExporter::AddDriver(Driver* _driver)
+		{
+			if (s_instance)
+			{
+				LockGuard LG(s_instance->m_mutex);
+				DriverCounters& counters = s_instance->m_drivers[_driver];
+				counters.m_driver.resize(c_driverCounterCount);
+				counters.m_queues.resize(c_queueCounterCount);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::RemoveDriver>
+// Stop exporting a driver's statistics, before it is destroyed
+//-----------------------------------------------------------------------------
+		void MetricsExporter::RemoveDriver(Driver* _driver)
+		{
+			if (s_instance)
+			{
+				LockGuard LG(s_instance->m_mutex);
+				s_instance->m_drivers.erase(_driver);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::MetricsExporter>
+// Constructor
+//-----------------------------------------------------------------------------
+		MetricsExporter::MetricsExporter(string const& _socketPath, string const& _filePath, uint32 _interval) :
+				m_socketPath(_socketPath), m_filePath(_filePath), m_interval(_interval), m_socket(-1), m_mutex(new Platform::Mutex()), m_thread(new Platform::Thread("metrics"))
+		{
+			if (!m_socketPath.empty())
+			{
+				OpenSocket();
+			}
+			if (!m_filePath.empty())
+			{
+				Log::Write(LogLevel_Info, "Writing metrics to %s every %d seconds", m_filePath.c_str(), m_interval);
+			}
+			m_thread->Start(MetricsExporter::ThreadEntryPoint, this);
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::~MetricsExporter>
+// Destructor
+//-----------------------------------------------------------------------------
+		MetricsExporter::~MetricsExporter()
+		{
+			m_thread->Stop();
+			m_thread->Release();
+			CloseSocket();
+			m_mutex->Release();
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::ThreadEntryPoint>
+// Entry point of the exporter thread
+//-----------------------------------------------------------------------------
+		void MetricsExporter::ThreadEntryPoint(Platform::Event* _exitEvent, void* _context)
+		{
+			MetricsExporter* exporter = (MetricsExporter*) _context;
+			if (exporter)
+			{
+				exporter->ThreadProc(_exitEvent);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::ThreadProc>
+// Serve the socket, and sample and write the file every interval
+//-----------------------------------------------------------------------------
+		void MetricsExporter::ThreadProc(Platform::Event* _exitEvent)
+		{
+			Platform::TimeStamp next;
+			while (true)
+			{
+				int32 wait = next.TimeRemaining();
+				if (wait < 0)
+				{
+					wait = 0;
+				}
+#ifndef _WIN32
+				if (m_socket >= 0)
+				{
+					struct pollfd pfd;
+					pfd.fd = m_socket;
+					pfd.events = POLLIN;
+					pfd.revents = 0;
+					if ((poll(&pfd, 1, (wait < c_pollSlice) ? wait : c_pollSlice) > 0) && (pfd.revents & POLLIN))
+					{
+						int fd = accept(m_socket, NULL, NULL);
+						if (fd >= 0)
+						{
+							ServeClient(fd);
+						}
+					}
+					wait = 0;
+				}
+#endif
+				if (Platform::Wait::Single(_exitEvent, wait) >= 0)
+				{
+					break;
+				}
+
+				if (next.TimeRemaining() <= 0)
+				{
+					// Sample even when there is no file to write, so the 32 bit
+					// counters cannot wrap twice between two scrapes
+					string text = Format();
+					if (!m_filePath.empty())
+					{
+						WriteFile(text);
+					}
+					next.SetTime(m_interval * 1000);
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::Sample>
+// Take a copy of a driver's statistics and update the 64 bit counters
+//-----------------------------------------------------------------------------
+		void MetricsExporter::Sample(Driver* _driver, DriverCounters* _counters, Snapshot* _snapshot)
+		{
+			_snapshot->m_homeId = _driver->GetHomeId();
+			_snapshot->m_counters = _counters;
+			_driver->GetDriverStatistics(&_snapshot->m_data);
+			for (uint32 i = 0; i < c_driverCounterCount; ++i)
+			{
+				_counters->m_driver[i].Update(_snapshot->m_data.*(c_driverCounters[i].m_field));
+			}
+
+			_driver->m_sendMutex->Lock();
+			for (int32 i = 0; i < Driver::MsgQueue_Count; ++i)
+			{
+				_snapshot->m_depth[i] = (uint32) _driver->m_msgQueue[i].size();
+			}
+			_driver->m_sendMutex->Unlock();
+			for (int32 i = 0; i < Driver::MsgQueue_Count; ++i)
+			{
+				_driver->GetMsgQueueStatistics((Driver::MsgQueue) i, &_snapshot->m_queues[i]);
+				_counters->m_queues[2 * i].Update(_snapshot->m_queues[i].m_completed);
+				_counters->m_queues[2 * i + 1].Update(_snapshot->m_queues[i].m_failed);
+			}
+			for (int32 i = 0; i < 256; ++i)
+			{
+				AirtimeCounter airtime;
+				if (_driver->GetCommandClassAirtime((uint8) i, &airtime))
+				{
+					_snapshot->m_commandClassAirtime[(uint8) i] = airtime;
+				}
+			}
+			_driver->GetLockStatistics(&_snapshot->m_locks);
+
+			// Forget the nodes that have gone, so a new node with the same id starts from 0
+			std::map<uint8, std::vector<Counter> > nodes;
+			LockGuard LG(_driver->m_nodeMutex);
+			for (int32 nodeId = 1; nodeId < 256; ++nodeId)
+			{
+				if (_driver->m_nodes[nodeId] == NULL)
+				{
+					continue;
+				}
+				_snapshot->m_nodes.push_back(NodeSnapshot());
+				NodeSnapshot& node = _snapshot->m_nodes.back();
+				node.m_nodeId = (uint8) nodeId;
+				_driver->GetNodeStatistics(node.m_nodeId, &node.m_data);
+
+				std::vector<Counter>& counters = nodes[node.m_nodeId];
+				std::map<uint8, std::vector<Counter> >::iterator it = _counters->m_nodes.find(node.m_nodeId);
+				if (it != _counters->m_nodes.end())
+				{
+					counters.swap(it->second);
+				}
+				else
+				{
+					counters.resize(c_nodeCounterCount);
+				}
+				for (uint32 i = 0; i < c_nodeCounterCount; ++i)
+				{
+					counters[i].Update(node.m_data.*(c_nodeCounters[i].m_field));
+				}
+			}
+			_counters->m_nodes.swap(nodes);
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::Format>
+// Sample every driver and return the metrics text
+//-----------------------------------------------------------------------------
+		string MetricsExporter::Format()
+		{
+			string text;
+			LockGuard LG(m_mutex);
+
+			std::list<Snapshot> snapshots;
+			for (std::map<Driver*, DriverCounters>::iterator it = m_drivers.begin(); it != m_drivers.end(); ++it)
+			{
+				snapshots.push_back(Snapshot());
+				Sample(it->first, &it->second, &snapshots.back());
+			}
+
+			// Each metric is written for every driver before the next one starts
+			char label[64];
+			for (uint32 i = 0; i < c_driverCounterCount; ++i)
+			{
+				AppendFamily(&text, c_driverCounters[i].m_name, "counter", c_driverCounters[i].m_help);
+				for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+				{
+					AppendLine(&text, "%s{home_id=\"0x%.8x\"} %llu\n", c_driverCounters[i].m_name, it->m_homeId, (unsigned long long) it->m_counters->m_driver[i].m_total);
+				}
+			}
+
+			AppendFamily(&text, "ozw_queue_depth", "gauge", "Messages waiting in a send queue");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (int32 q = 0; q < Driver::MsgQueue_Count; ++q)
+				{
+					AppendLine(&text, "ozw_queue_depth{home_id=\"0x%.8x\",queue=\"%s\"} %u\n", it->m_homeId, Driver::GetMsgQueueName((Driver::MsgQueue) q), it->m_depth[q]);
+				}
+			}
+			AppendFamily(&text, "ozw_queue_messages_total", "counter", "Messages sent from a send queue, by whether they completed");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (int32 q = 0; q < Driver::MsgQueue_Count; ++q)
+				{
+					AppendLine(&text, "ozw_queue_messages_total{home_id=\"0x%.8x\",queue=\"%s\",result=\"completed\"} %llu\n", it->m_homeId, Driver::GetMsgQueueName((Driver::MsgQueue) q), (unsigned long long) it->m_counters->m_queues[2 * q].m_total);
+					AppendLine(&text, "ozw_queue_messages_total{home_id=\"0x%.8x\",queue=\"%s\",result=\"failed\"} %llu\n", it->m_homeId, Driver::GetMsgQueueName((Driver::MsgQueue) q), (unsigned long long) it->m_counters->m_queues[2 * q + 1].m_total);
+				}
+			}
+			AppendFamily(&text, "ozw_queue_wait_ms", "summary", "Time messages waited in a send queue");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (int32 q = 0; q < Driver::MsgQueue_Count; ++q)
+				{
+					snprintf(label, sizeof(label), "home_id=\"0x%.8x\",queue=\"%s\"", it->m_homeId, Driver::GetMsgQueueName((Driver::MsgQueue) q));
+					AppendSummary(&text, "ozw_queue_wait_ms", label, it->m_queues[q].m_queueWait);
+				}
+			}
+
+			// Airtime is only counted for controllers that report the transmit time
+			AppendFamily(&text, "ozw_airtime_ms_total", "counter", "Airtime of the frames sent to all nodes, with retries");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				AppendLine(&text, "ozw_airtime_ms_total{home_id=\"0x%.8x\"} %llu\n", it->m_homeId, (unsigned long long) it->m_data.m_airtime.GetTotal());
+			}
+			AppendFamily(&text, "ozw_queue_airtime_ms_total", "counter", "Airtime of the frames sent from a send queue");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (int32 q = 0; q < Driver::MsgQueue_Count; ++q)
+				{
+					AppendLine(&text, "ozw_queue_airtime_ms_total{home_id=\"0x%.8x\",queue=\"%s\"} %llu\n", it->m_homeId, Driver::GetMsgQueueName((Driver::MsgQueue) q), (unsigned long long) it->m_queues[q].m_airtime.GetTotal());
+				}
+			}
+			AppendFamily(&text, "ozw_command_class_airtime_ms_total", "counter", "Airtime of the frames carrying a command class");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (std::map<uint8, AirtimeCounter>::iterator cit = it->m_commandClassAirtime.begin(); cit != it->m_commandClassAirtime.end(); ++cit)
+				{
+					AppendLine(&text, "ozw_command_class_airtime_ms_total{home_id=\"0x%.8x\",command_class=\"%s\",command_class_id=\"0x%.2x\"} %llu\n", it->m_homeId, CC::CommandClasses::GetName(cit->first).c_str(), cit->first, (unsigned long long) cit->second.GetTotal());
+				}
+			}
+
+			// Only with the ProfileLocks option
+			if (Platform::Mutex::IsProfiling())
+			{
+				for (uint32 i = 0; i < c_lockMetricCount; ++i)
+				{
+					AppendFamily(&text, c_lockMetrics[i].m_name, c_lockMetrics[i].m_type, c_lockMetrics[i].m_help);
+					for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+					{
+						for (std::vector<Driver::LockData>::iterator lit = it->m_locks.begin(); lit != it->m_locks.end(); ++lit)
+						{
+							AppendLine(&text, "%s{home_id=\"0x%.8x\",lock=\"%s\"} %llu\n", c_lockMetrics[i].m_name, it->m_homeId, lit->m_name, (unsigned long long) (lit->m_statistics.*(c_lockMetrics[i].m_field)));
+						}
+					}
+				}
+			}
+
+			AppendFamily(&text, "ozw_request_latency_ms", "summary", "Send Data until the controller's callback");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				snprintf(label, sizeof(label), "home_id=\"0x%.8x\"", it->m_homeId);
+				AppendSummary(&text, "ozw_request_latency_ms", label, it->m_data.m_requestLatency);
+			}
+			AppendFamily(&text, "ozw_response_latency_ms", "summary", "Send Data until the node's report");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				snprintf(label, sizeof(label), "home_id=\"0x%.8x\"", it->m_homeId);
+				AppendSummary(&text, "ozw_response_latency_ms", label, it->m_data.m_responseLatency);
+			}
+			AppendFamily(&text, "ozw_set_value_latency_ms", "summary", "Value Set until the device confirmed the new value");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				snprintf(label, sizeof(label), "home_id=\"0x%.8x\"", it->m_homeId);
+				AppendSummary(&text, "ozw_set_value_latency_ms", label, it->m_data.m_setValueLatency);
+			}
+
+			for (uint32 i = 0; i < c_nodeCounterCount; ++i)
+			{
+				AppendFamily(&text, c_nodeCounters[i].m_name, "counter", c_nodeCounters[i].m_help);
+				for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+				{
+					for (std::list<NodeSnapshot>::iterator nit = it->m_nodes.begin(); nit != it->m_nodes.end(); ++nit)
+					{
+						AppendLine(&text, "%s{home_id=\"0x%.8x\",node=\"%d\"} %llu\n", c_nodeCounters[i].m_name, it->m_homeId, nit->m_nodeId, (unsigned long long) it->m_counters->m_nodes[nit->m_nodeId][i].m_total);
+					}
+				}
+			}
+			AppendFamily(&text, "ozw_node_quality", "gauge", "Node quality measure");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (std::list<NodeSnapshot>::iterator nit = it->m_nodes.begin(); nit != it->m_nodes.end(); ++nit)
+				{
+					AppendLine(&text, "ozw_node_quality{home_id=\"0x%.8x\",node=\"%d\"} %d\n", it->m_homeId, nit->m_nodeId, nit->m_data.m_quality);
+				}
+			}
+			AppendFamily(&text, "ozw_node_airtime_ms_total", "counter", "Airtime of the frames sent to the node, with retries");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (std::list<NodeSnapshot>::iterator nit = it->m_nodes.begin(); nit != it->m_nodes.end(); ++nit)
+				{
+					AppendLine(&text, "ozw_node_airtime_ms_total{home_id=\"0x%.8x\",node=\"%d\"} %llu\n", it->m_homeId, nit->m_nodeId, (unsigned long long) nit->m_data.m_airtime.GetTotal());
+				}
+			}
+			AppendFamily(&text, "ozw_node_response_latency_ms", "summary", "Send Data until the node's report");
+			for (std::list<Snapshot>::iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+			{
+				for (std::list<NodeSnapshot>::iterator nit = it->m_nodes.begin(); nit != it->m_nodes.end(); ++nit)
+				{
+					snprintf(label, sizeof(label), "home_id=\"0x%.8x\",node=\"%d\"", it->m_homeId, nit->m_nodeId);
+					AppendSummary(&text, "ozw_node_response_latency_ms", label, nit->m_data.m_responseLatency);
+				}
+			}
+
+			return text;
+		}
+
+#ifndef _WIN32
+//-----------------------------------------------------------------------------
+// <IsSocketInUse>
+// Whether something is listening on an existing socket
+//-----------------------------------------------------------------------------
+		static bool IsSocketInUse(struct sockaddr_un const& _addr)
+		{
+			int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd < 0)
+			{
+				// Can not tell, so leave it alone
+				return true;
+			}
+			// A stale socket refuses the connection
+			bool inUse = (connect(fd, (struct sockaddr const*) &_addr, sizeof(_addr)) == 0) || (errno != ECONNREFUSED);
+			close(fd);
+			return inUse;
+		}
+#endif
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::OpenSocket>
+// Listen on the Unix domain socket
+//-----------------------------------------------------------------------------
+		bool MetricsExporter::OpenSocket()
+		{
+#ifdef _WIN32
+			Log::Write(LogLevel_Warning, "MetricsSocket is not supported on this platform, use MetricsFile instead");
+			return false;
+#else
+			struct sockaddr_un addr;
+			memset(&addr, 0, sizeof(addr));
+			if (m_socketPath.size() >= sizeof(addr.sun_path))
+			{
+				Log::Write(LogLevel_Warning, "MetricsSocket path %s is too long", m_socketPath.c_str());
+				return false;
+			}
+			addr.sun_family = AF_UNIX;
+			strncpy(addr.sun_path, m_socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+			// A socket left behind by an earlier run would stop the bind.  Nothing
+			// else at the path is ever removed: not a file the option names by
+			// mistake, and not a socket another process is still listening on.
+			struct stat st;
+			if (lstat(m_socketPath.c_str(), &st) == 0)
+			{
+				if (!S_ISSOCK(st.st_mode))
+				{
+					Log::Write(LogLevel_Warning, "MetricsSocket path %s already exists and is not a socket", m_socketPath.c_str());
+					return false;
+				}
+				if (IsSocketInUse(addr))
+				{
+					Log::Write(LogLevel_Warning, "MetricsSocket %s is in use by another process", m_socketPath.c_str());
+					return false;
+				}
+				unlink(m_socketPath.c_str());
+			}
+
+			m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (m_socket < 0)
+			{
+				Log::Write(LogLevel_Warning, "Could not create the metrics socket: %s", strerror(errno));
+				return false;
+			}
+			if (bind(m_socket, (struct sockaddr*) &addr, sizeof(addr)) != 0)
+			{
+				Log::Write(LogLevel_Warning, "Could not bind the metrics socket %s: %s", m_socketPath.c_str(), strerror(errno));
+				close(m_socket);
+				m_socket = -1;
+				return false;
+			}
+			// Only the user running OpenZWave may connect.  The permissions are set
+			// before listen(), so nobody can connect while the socket is still open.
+			if ((chmod(m_socketPath.c_str(), S_IRUSR | S_IWUSR) != 0) || (listen(m_socket, 4) != 0))
+			{
+				Log::Write(LogLevel_Warning, "Could not listen on the metrics socket %s: %s", m_socketPath.c_str(), strerror(errno));
+				close(m_socket);
+				m_socket = -1;
+				// The bind created the socket at the path, so it is ours to remove
+				unlink(m_socketPath.c_str());
+				return false;
+			}
+			Log::Write(LogLevel_Info, "Serving metrics on %s", m_socketPath.c_str());
+			return true;
+#endif
+		}
+
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::CloseSocket>
+// Stop listening and remove the socket
+//-----------------------------------------------------------------------------
+		void MetricsExporter::CloseSocket()
+		{
+#ifndef _WIN32
+			if (m_socket >= 0)
+			{
+				close(m_socket);
+				m_socket = -1;
+				unlink(m_socketPath.c_str());
+			}
+#endif
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::ServeClient>
+// Write the metrics to a client of the socket and close it
+//-----------------------------------------------------------------------------
+		void MetricsExporter::ServeClient(int _fd)
+		{
+#ifndef _WIN32
+			// A client can send an HTTP request (curl --unix-socket) or nothing at
+			// all (socat, nc -U), so only wait a moment for one
+			char request[1024];
+			ssize_t length = 0;
+			struct pollfd pfd;
+			pfd.fd = _fd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			if ((poll(&pfd, 1, 100) > 0) && (pfd.revents & POLLIN))
+			{
+				length = recv(_fd, request, sizeof(request), 0);
+			}
+
+			string response = Format();
+			if ((length >= 4) && (memcmp(request, "GET ", 4) == 0))
+			{
+				char header[160];
+				snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: %u\r\nConnection: close\r\n\r\n", (uint32) response.size());
+				response = header + response;
+			}
+
+			int flags = 0;
+#ifdef MSG_NOSIGNAL
+			// A client that goes away must not kill the application with SIGPIPE
+			flags = MSG_NOSIGNAL;
+#endif
+			// A client that stops reading gets cut off, rather than stalling the
+			// sampling of the counters
+			struct timeval tv;
+			tv.tv_sec = c_clientTimeout / 1000;
+			tv.tv_usec = (c_clientTimeout % 1000) * 1000;
+			setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+			Platform::TimeStamp deadline;
+			deadline.SetTime(c_clientTimeout);
+
+			size_t sent = 0;
+			while ((sent < response.size()) && (deadline.TimeRemaining() > 0))
+			{
+				ssize_t res = send(_fd, response.data() + sent, response.size() - sent, flags);
+				if (res <= 0)
+				{
+					break;
+				}
+				sent += (size_t) res;
+			}
+			close(_fd);
+#endif
+		}
+
+//-----------------------------------------------------------------------------
+// <MetricsExporter::WriteFile>
+// Replace the metrics file, so readers never see it half written
+//-----------------------------------------------------------------------------
+		bool MetricsExporter::WriteFile(string const& _text)
+		{
+			string tmpPath = m_filePath + ".tmp";
+			FILE* file = fopen(tmpPath.c_str(), "wb");
+			if (!file)
+			{
+				Log::Write(LogLevel_Warning, "Could not write the metrics file %s", tmpPath.c_str());
+				return false;
+			}
+			bool ok = (fwrite(_text.data(), 1, _text.size(), file) == _text.size());
+			ok = (fclose(file) == 0) && ok;
+#ifdef _WIN32
+			// rename does not replace an existing file on Windows
+			remove(m_filePath.c_str());
+#endif
+			if (!ok || (rename(tmpPath.c_str(), m_filePath.c_str()) != 0))
+			{
+				Log::Write(LogLevel_Warning, "Could not write the metrics file %s", m_filePath.c_str());
+				remove(tmpPath.c_str());
+				return false;
+			}
+			return true;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+//
+//	MetricsExporter.h
+//
+//	Serve the driver and node statistics in the Prometheus text format
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _MetricsExporter_H
+#define _MetricsExporter_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Driver;
+
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Event;
+			class Mutex;
+			class Thread;
+		}
+
+		/** \brief Export the statistics of every driver for a metrics collector.
+		 *
+		 * Enabled by the MetricsSocket and MetricsFile options.  The statistics
+		 * are served in the Prometheus text format (version 0.0.4) to each
+		 * client that connects to the Unix domain socket, and/or written to the
+		 * file every MetricsInterval seconds (atomically, for the node_exporter
+		 * textfile collector).  Only the user running OpenZWave can connect to
+		 * the socket.
+		 *
+		 * The driver and node counters are 32 bit and wrap.  They are sampled at
+		 * least every MetricsInterval seconds and accumulated here, so the
+		 * exported counters are 64 bit.
+		 */
+		class MetricsExporter
+		{
+			public:
+				static void Create();
+				static void Destroy();
+
+				/**
+				 * Drivers add themselves when they are created and remove themselves
+				 * before they are destroyed.
+				 */
+				static void AddDriver(Driver* _driver);
+				static void RemoveDriver(Driver* _driver);
+
+			private:
+				/** A 64 bit total of a wrapping 32 bit counter */
+				struct Counter
+				{
+						Counter() :
+								m_last(0), m_total(0)
+						{
+						}
+						void Update(uint32 const _value)
+						{
+							m_total += (uint32) (_value - m_last);
+							m_last = _value;
+						}
+						uint32 m_last;
+						uint64 m_total;
+				};
+
+				struct DriverCounters
+				{
+						std::vector<Counter> m_driver;
+						std::vector<Counter> m_queues;
+						std::map<uint8, std::vector<Counter> > m_nodes;
+				};
+
+				MetricsExporter(string const& _socketPath, string const& _filePath, uint32 _interval);
+				~MetricsExporter();
+
+				static void ThreadEntryPoint(Platform::Event* _exitEvent, void* _context);
+				void ThreadProc(Platform::Event* _exitEvent);
+
+				struct Snapshot;
+				void Sample(Driver* _driver, DriverCounters* _counters, Snapshot* _snapshot);
+				string Format();
+				bool OpenSocket();
+				void CloseSocket();
+				void ServeClient(int _fd);
+				bool WriteFile(string const& _text);
+
+				static MetricsExporter* s_instance;
+
+				string m_socketPath;
+				string m_filePath;
+				uint32 m_interval;						// Seconds between samples and file writes
+				int m_socket;							// Listening socket, or -1
+				Platform::Mutex* m_mutex;				// Protects m_drivers
+				Platform::Thread* m_thread;
+				std::map<Driver*, DriverCounters> m_drivers;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
@@ -53,7 +53,7 @@ namespace OpenZWave
 				uint8 const _expectedReply,			// = 0
 				uint8 const _expectedCommandClassId // = 0
 				) :
-				m_logText(_logText), m_bFinal(false), m_bCallbackRequired(_bCallbackRequired), m_callbackId(0), m_expectedReply(0), m_expectedCommandClassId(_expectedCommandClassId), m_length(4), m_targetNodeId(_targetNodeId), m_sendAttempts(0), m_maxSendAttempts( MAX_TRIES), m_instance(1), m_endPoint(0), m_flags(0), m_encrypted(false), m_noncerecvd(false), m_homeId(0), m_resendDuetoCANorNAK(false)
+				m_logText(_logText), m_bFinal(false), m_bCallbackRequired(_bCallbackRequired), m_callbackId(0), m_expectedReply(0), m_expectedCommandClassId(_expectedCommandClassId), m_length(4), m_targetNodeId(_targetNodeId), m_sendAttempts(0), m_maxSendAttempts( MAX_TRIES), m_instance(1), m_endPoint(0), m_flags(0), m_encrypted(false), m_noncerecvd(false), m_homeId(0), m_resendDuetoCANorNAK(false), m_stages(0)
 		{
 			if (_bReplyRequired)
 			{
@@ -63,6 +63,7 @@ namespace OpenZWave
 
 			memset(m_buffer, 0x00, 256);
 			memset(e_buffer, 0x00, 256);
+			memset(m_stageTime, 0x00, sizeof(m_stageTime));
 
 			m_buffer[0] = SOF;
 			m_buffer[1] = 0;					// Length of the following data, filled in during Finalize.
@@ -113,6 +114,11 @@ namespace OpenZWave
 			{
 				m_supervision_session_id = _supervision_session_id;
 				m_flags |= m_Supervision;
+				if ((m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER) && (m_expectedCommandClassId != Internal::CC::MultiInstance::StaticGetCommandClassId()))
+				{
+					// The node answers with a Supervision Report rather than a report of the encapsulated command class
+					m_expectedCommandClassId = Internal::CC::Supervision::StaticGetCommandClassId();
+				}
 			}
 		}
 
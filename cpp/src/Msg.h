@@ -55,6 +55,22 @@ namespace OpenZWave
 					m_MultiChannel = 0x01,		// Indicate MultiChannel encapsulation
 					m_MultiInstance = 0x02,		// Indicate MultiInstance encapsulation
 					m_Supervision = 0x04,		// Indicate Supervision encapsulation
+					m_NoBatch = 0x08,			// Do not combine this request with others in a MultiCmd frame
+					m_MultiCmd = 0x10,			// The target node accepts MultiCmd encapsulation
+				};
+
+				/** \brief The points in the send pipeline at which a message is timed.
+				 */
+				enum Stage
+				{
+					Stage_Queued = 0,			// Added to one of the driver's send queues
+					Stage_Dequeued,				// Taken from the queue to be sent (WriteNextMsg)
+					Stage_FirstWritten,			// First written to the controller
+					Stage_Written,				// Last written to the controller (differs from the first only on a retry)
+					Stage_Acked,				// ACK received from the controller
+					Stage_Callback,				// Expected callback (usually the SendData transmit status) received
+					Stage_Completed,			// Reply received and the message removed
+					Stage_Count
 				};
 
 				Msg(string const& _logtext, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0);
@@ -182,6 +198,45 @@ namespace OpenZWave
 
 					return false;
 				}
+				/**
+				 * \brief Test whether this is a plain SendData request that expects a report back,
+				 * to a node that accepts Multi Command encapsulation.  Such requests can be combined
+				 * with others for the same node into a single Multi Command encapsulated frame.
+				 */
+				bool IsBatchable() const
+				{
+					return (m_bFinal && m_bCallbackRequired && (m_buffer[3] == FUNC_ID_ZW_SEND_DATA) && (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER) && (m_expectedCommandClassId != 0) && !m_encrypted && ((m_flags & (m_Supervision | m_NoBatch | m_MultiCmd)) == m_MultiCmd) && (m_sendAttempts == 0));
+				}
+				void SetNoBatch()
+				{
+					m_flags |= m_NoBatch;
+				}
+				void SetMultiCmd()
+				{
+					m_flags |= m_MultiCmd;
+				}
+				/**
+				 * \brief The command carried by a SendData request (starting with the command class id)
+				 */
+				uint8 const* GetPayload() const
+				{
+					return &m_buffer[6];
+				}
+				uint8 GetPayloadLength() const
+				{
+					return m_buffer[5];
+				}
+				uint8 GetTransmitOptions() const
+				{
+					return m_buffer[6 + m_buffer[5]];
+				}
+				/**
+				 * \brief The Serial API function (FUNC_ID_...) of the message
+				 */
+				uint8 GetFunction() const
+				{
+					return m_buffer[3];
+				}
 				uint8 GetSendingCommandClass()
 				{
 					if (m_buffer[3] == 0x13)
@@ -226,6 +281,28 @@ namespace OpenZWave
 					return m_resendDuetoCANorNAK;
 				}
 
+				/**
+				 * \brief Record when the message reached a stage of the send pipeline.
+				 * \param _ms the driver's clock, in milliseconds
+				 */
+				void SetStageTime(Stage const _stage, uint32 const _ms)
+				{
+					m_stageTime[_stage] = _ms;
+					m_stages |= (1 << _stage);
+				}
+				void ClearStage(Stage const _stage)
+				{
+					m_stages &= ~(1 << _stage);
+				}
+				bool HasStage(Stage const _stage) const
+				{
+					return ((m_stages & (1 << _stage)) != 0);
+				}
+				uint32 GetStageTime(Stage const _stage) const
+				{
+					return m_stageTime[_stage];
+				}
+
 				/** Returns a pointer to the driver (interface with a Z-Wave controller)
 				 *  associated with this node.
 				 */
@@ -261,6 +338,8 @@ namespace OpenZWave
 				static uint8 s_nextCallbackId;		// counter to get a unique callback id
 				/* we are resending this message due to CAN or NAK messages */
 				bool m_resendDuetoCANorNAK;
+				uint8 m_stages;						// Bit mask of the stages in m_stageTime that have been reached
+				uint32 m_stageTime[Stage_Count];
 		};
 	} // namespace Internal
 } // namespace OpenZWave
@@ -31,6 +31,7 @@
 #include "Defs.h"
 #include "Group.h"
 #include "Options.h"
+#include "ConfigBundle.h"
 #include "Manager.h"
 #include "Driver.h"
 #include "Localization.h"
@@ -38,6 +39,7 @@
 #include "Notification.h"
 #include "Msg.h"
 #include "ZWSecurity.h"
+#include "NoncePool.h"
 #include "platform/Log.h"
 #include "platform/Mutex.h"
 #include "Utils.h"
@@ -104,10 +106,9 @@ Node::Node(uint32 const _homeId, uint8 const _nodeId) :
 		m_listening(true),	// assume we start out listening
 		m_frequentListening(false), m_beaming(false), m_routing(false), m_maxBaudRate(0), m_version(0), m_security(false), m_homeId(_homeId), m_nodeId(_nodeId), m_basic(0), m_generic(0), m_specific(0), m_type(""), m_addingNode(false), m_manufacturerName(""), m_productName(""), m_nodeName(""), m_location(""), m_manufacturerId(0), m_productType(0), m_productId(0), m_deviceType(0), m_role(0), m_nodeType(0), m_secured(false), m_nodeCache( NULL), m_Product( NULL), m_fileConfigRevision(0), m_loadedConfigRevision(
 				0), m_latestConfigRevision(0), m_values(new Internal::VC::ValueStore()), m_sentCnt(0), m_sentFailed(0), m_retries(0), m_receivedCnt(0), m_receivedDups(0), m_receivedUnsolicited(0), m_lastRequestRTT(0), m_lastResponseRTT(0), m_averageRequestRTT(0), m_averageResponseRTT(0), m_quality(0), m_lastReceivedMessage(), m_errors(0), m_txStatusReportSupported(false), m_txTime(0), m_hops(0), m_ackChannel(0), m_lastTxChannel(0), m_routeScheme((TXSTATUS_ROUTING_SCHEME) 0), m_routeUsed
-		{ }, m_routeSpeed((TXSTATUS_ROUTE_SPEED) 0), m_routeTries(0), m_lastFailedLinkFrom(0), m_lastFailedLinkTo(0), m_lastnonce(0)
+		{ }, m_routeSpeed((TXSTATUS_ROUTE_SPEED) 0), m_routeTries(0), m_lastFailedLinkFrom(0), m_lastFailedLinkTo(0), m_pendingSetsMutex(new Internal::Platform::Mutex()), m_nonceTable(NULL)
 {
 	memset(m_neighbors, 0, sizeof(m_neighbors));
-	memset(m_nonces, 0, sizeof(m_nonces));
 	memset(m_rssi_1, 0, sizeof(m_rssi_1));
 	memset(m_rssi_2, 0, sizeof(m_rssi_2));
 	memset(m_rssi_3, 0, sizeof(m_rssi_3));
@@ -127,13 +128,18 @@ Node::~Node()
 	// Remove any messages from queues
 	GetDriver()->RemoveQueues(m_nodeId);
 
-	// Remove the values from the poll list
+	// Remove the values from the poll list.  The ids are copied first, as
+	// DisablePoll must not be called while iterating over the value store.
+	vector<ValueID> valueIds;
 	for (Internal::VC::ValueStore::Iterator it = m_values->Begin(); it != m_values->End(); ++it)
 	{
-		ValueID const& valueId = it->second->GetID();
-		if (GetDriver()->isPolled(valueId))
+		valueIds.push_back(it->second->GetID());
+	}
+	for (vector<ValueID>::const_iterator it = valueIds.begin(); it != valueIds.end(); ++it)
+	{
+		if (GetDriver()->isPolled(*it))
 		{
-			GetDriver()->DisablePoll(valueId);
+			GetDriver()->DisablePoll(*it);
 		}
 	}
 
@@ -165,6 +171,13 @@ Node::~Node()
 		m_buttonMap.erase(it);
 	}
 	delete m_nodeCache;
+	delete m_nonceTable;
+
+	for (map<ValueID, Internal::Platform::TimeStamp*>::iterator it = m_pendingSets.begin(); it != m_pendingSets.end(); ++it)
+	{
+		delete it->second;
+	}
+	m_pendingSetsMutex->Release();
 }
 
 //-----------------------------------------------------------------------------
@@ -754,6 +767,27 @@ void Node::SetQueryStage(QueryStage const _stage, bool const _advance	// = true
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Node::ResumeQueryStage>
+// Set the query stage, even if it is later than the current one
+//-----------------------------------------------------------------------------
+void Node::ResumeQueryStage(QueryStage const _stage, bool const _advance	// = true
+		)
+{
+	m_queryStage = _stage;
+	m_queryPending = false;
+	m_queryRetries = 0;
+
+	if (QueryStage_Configuration == _stage)
+	{
+		m_queryConfiguration = true;
+	}
+	if (_advance)
+	{
+		AdvanceQueries();
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Node::GetQueryStageName>
 // Gets the query stage name
@@ -832,17 +866,13 @@ void Node::ReadXML(TiXmlElement const* _node)
 
 		/* we cant use the SetQueryStage method here, as it only allows us to
 		 * go to a lower QueryStage, and not a higher QueryStage. As QueryStage_Complete is higher than
-		 * QueryStage_None (the default) we manually set it here. Note - in Driver::HandleSerialAPIGetInitDataResponse the
+		 * QueryStage_None (the default) we set it directly here. Note - in Driver::HandleSerialAPIGetInitDataResponse the
 		 * QueryStage is set to CacheLoad (which is less than QueryStage_Associations) if this is a existing node read in via the zw state file.
 		 *
+		 * Nodes that were saved part way through their interview keep the stage they had reached,
+		 * and HandleSerialAPIGetInitDataResponse carries the interview on from there rather than starting again.
 		 */
-		m_queryStage = queryStage;
-		m_queryPending = false;
-
-		if (QueryStage_Configuration == queryStage)
-		{
-			m_queryConfiguration = true;
-		}
+		ResumeQueryStage(queryStage, false);
 	}
 
 	if (m_queryStage != QueryStage_None)
@@ -863,7 +893,7 @@ void Node::ReadXML(TiXmlElement const* _node)
 			m_nodeInfoReceived = true;
 		}
 
-		if (m_queryStage > QueryStage_Static)
+		if (m_queryStage > QueryStage_Instances)
 		{
 			Notification* notification = new Notification(Notification::Type_EssentialNodeQueriesComplete);
 			notification->SetHomeAndNodeIds(m_homeId, m_nodeId);
@@ -1067,7 +1097,11 @@ void Node::ReadXML(TiXmlElement const* _node)
 					Internal::CC::ManufacturerSpecific* cc = static_cast<Internal::CC::ManufacturerSpecific*>(GetCommandClass(Internal::CC::ManufacturerSpecific::StaticGetCommandClassId()));
 					if (cc)
 					{
-						cc->SetProductDetails(manufacturerId, productType, productId);
+						// A partial interview may not have got as far as the product details yet
+						if ((m_queryStage == QueryStage_None) || (m_queryStage > QueryStage_ManufacturerSpecific1))
+						{
+							cc->SetProductDetails(manufacturerId, productType, productId);
+						}
 						cc->setLoadedConfigRevision(m_loadedConfigRevision);
 					}
 					else
@@ -1225,7 +1259,7 @@ void Node::ReadCommandClassesXML(TiXmlElement const* _ccsElement)
 //-----------------------------------------------------------------------------
 void Node::WriteXML(TiXmlElement* _driverElement)
 {
-	if (m_queryStage <= QueryStage_CacheLoad)
+	if (m_nodeCache && (m_queryStage <= QueryStage_CacheLoad))
 	{
 		/* Just return our cached copy of the "Cache" as nothing new should be here */
 		_driverElement->LinkEndChild(m_nodeCache->Clone());
@@ -2063,6 +2097,7 @@ void Node::ApplicationCommandHandler(uint8 const* _data, bool encrypted
 		}
 
 		pCommandClass->ReceivedCntIncr();
+		Internal::CC::HandlerProfile profile(pCommandClass);
 		if (!pCommandClass->IsAfterMark())
 		{
 			if (!pCommandClass->HandleMsg(&_data[6], _data[4]))
@@ -2105,6 +2140,7 @@ void Node::ApplicationCommandHandler(uint8 const* _data, bool encrypted
 			if (Internal::CC::CommandClass* pCommandClass = AddCommandClass(Internal::CC::MultiInstance::StaticGetCommandClassId()))
 			{
 				pCommandClass->ReceivedCntIncr();
+				Internal::CC::HandlerProfile profile(pCommandClass);
 				if (!pCommandClass->IsAfterMark())
 				{
 					if (!pCommandClass->HandleMsg(&_data[6], _data[4]))
@@ -2300,18 +2336,20 @@ bool Node::RequestAllConfigParams(uint32 const _requestFlags)
 	if (Internal::CC::Configuration* cc = static_cast<Internal::CC::Configuration*>(GetCommandClass(Internal::CC::Configuration::StaticGetCommandClassId())))
 	{
 		// Go through all the values in the value store, and request all those which are in the Configuration command class
+		vector<uint16> params;
 		for (Internal::VC::ValueStore::Iterator it = m_values->Begin(); it != m_values->End(); ++it)
 		{
 			Internal::VC::Value* value = it->second;
 			if (value->GetID().GetCommandClassId() == Internal::CC::Configuration::StaticGetCommandClassId() && !value->IsWriteOnly())
 			{
-				/* put the ConfigParams Request into the MsgQueue_Query queue. This is so MsgQueue_Send doesn't get backlogged with a
-				 * lot of ConfigParams requests, and should help speed up any user generated messages being sent out (as the MsgQueue_Send has a higher
-				 * priority than MsgQueue_Query
-				 */
-				res |= cc->RequestValue(_requestFlags, value->GetID().GetIndex(), 1, Driver::MsgQueue_Query);
+				params.push_back(value->GetID().GetIndex());
 			}
 		}
+		/* put the ConfigParams Request into the MsgQueue_Query queue. This is so MsgQueue_Send doesn't get backlogged with a
+		 * lot of ConfigParams requests, and should help speed up any user generated messages being sent out (as the MsgQueue_Send has a higher
+		 * priority than MsgQueue_Query
+		 */
+		res = cc->RequestParams(params, _requestFlags, Driver::MsgQueue_Query);
 	}
 
 	return res;
@@ -3362,7 +3400,7 @@ bool Node::ReadDeviceClasses()
 	string filename = configPath + string("device_classes.xml");
 
 	TiXmlDocument doc;
-	if (!doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+	if (!Internal::ConfigBundle::LoadXML(&doc, "device_classes.xml"))
 	{
 		Log::Write(LogLevel_Warning, "Failed to load device_classes.xml");
 		Log::Write(LogLevel_Warning, "Check that the config path provided when creating the Manager points to the correct location.");
@@ -3459,6 +3497,11 @@ void Node::GetNodeStatistics(NodeData* _data)
 	_data->m_receivedTS = m_receivedTS.GetAsString();
 	_data->m_averageRequestRTT = m_averageRequestRTT;
 	_data->m_averageResponseRTT = m_averageResponseRTT;
+	_data->m_requestLatency = m_requestLatency;
+	_data->m_responseLatency = m_responseLatency;
+	_data->m_setValueLatency = m_setValueLatency;
+	_data->m_airtime = m_airtime;
+	_data->m_airtime.Advance(GetDriver()->GetMsgClock());
 	_data->m_txStatusReportSupported = m_txStatusReportSupported;
 	_data->m_txTime = m_txTime;
 	_data->m_hops = m_hops;
@@ -3491,10 +3534,78 @@ void Node::GetNodeStatistics(NodeData* _data)
 		ccData.m_commandClassId = it->second->GetCommandClassId();
 		ccData.m_sentCnt = it->second->GetSentCnt();
 		ccData.m_receivedCnt = it->second->GetReceivedCnt();
+		ccData.m_airtime = it->second->GetAirtime();
+		ccData.m_handlerCalls = it->second->GetHandlerCalls();
+		ccData.m_handlerTime = it->second->GetHandlerTime();
+		ccData.m_handlerMaxTime = it->second->GetHandlerMaxTime();
 		_data->m_ccData.push_back(ccData);
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Node::SetValueSent>
+// Start timing a Set until the device confirms it
+//-----------------------------------------------------------------------------
+void Node::SetValueSent(ValueID const& _id)
+{
+	Internal::LockGuard LG(m_pendingSetsMutex);
+	ExpirePendingSets();
+	map<ValueID, Internal::Platform::TimeStamp*>::iterator it = m_pendingSets.find(_id);
+	if (it == m_pendingSets.end())
+	{
+		m_pendingSets[_id] = new Internal::Platform::TimeStamp();
+	}
+	else
+	{
+		// A new Set replaces the one still waiting
+		it->second->SetTime();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Node::SetValueConfirmed>
+// The device reported a value, which completes any Set of it
+//-----------------------------------------------------------------------------
+void Node::SetValueConfirmed(ValueID const& _id)
+{
+	Internal::LockGuard LG(m_pendingSetsMutex);
+	ExpirePendingSets();
+	map<ValueID, Internal::Platform::TimeStamp*>::iterator it = m_pendingSets.find(_id);
+	if (it != m_pendingSets.end())
+	{
+		uint32 ms = (uint32) (Internal::Platform::TimeStamp() - *it->second);
+		m_setValueLatency.Record(ms);
+		GetDriver()->m_setValueLatency.Record(ms);
+		delete it->second;
+		m_pendingSets.erase(it);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Node::ExpirePendingSets>
+// Forget Sets the device never confirmed.  Called with m_pendingSetsMutex held.
+//-----------------------------------------------------------------------------
+void Node::ExpirePendingSets()
+{
+	// A report after the retry timeout is not an answer to the Set any more
+	int32 timeout = RETRY_TIMEOUT;
+	Options::Get()->GetOptionAsInt("RetryTimeout", &timeout);
+
+	map<ValueID, Internal::Platform::TimeStamp*>::iterator it = m_pendingSets.begin();
+	while (it != m_pendingSets.end())
+	{
+		if (-it->second->TimeRemaining() > timeout)
+		{
+			delete it->second;
+			m_pendingSets.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <DeviceClass::DeviceClass>
 // Constructor
@@ -3604,69 +3715,33 @@ Node::DeviceClass* Node::GenericDeviceClass::GetSpecificDeviceClass(uint8 const&
 // <Node::GenerateNonceKey>
 // Generate a NONCE key for this node
 //-----------------------------------------------------------------------------
-uint8 *Node::GenerateNonceKey()
+uint8 const* Node::GenerateNonceKey()
 {
-	uint8 idx = this->m_lastnonce;
-
-	/* The first byte must be unique and non-zero.  The others are random.
-	 Per Numerical Recipes in C its best to use the high-order byte.  The
-	 floating point calculation here doesn't assume the size of the random
-	 integer, otherwise we could just shift the high byte over.
-	 */
-	uint8 match = 0;
-	do
+	if (m_nonceTable == NULL)
 	{
-		this->m_nonces[idx][0] = 1 + (uint8) (255.0 * rand() / (RAND_MAX + 1.0));
-		match = 0;
-		for (int i = 0; i < 8; i++)
-		{
-			if (i == idx)
-			{
-				continue;
-			}
-			if (this->m_nonces[idx][0] == this->m_nonces[i][0])
-			{
-				match = 1;
-			}
-		}
-	} while (match);
-
-	/* The other bytes have no restrictions. */
-	for (int i = 1; i < 8; i++)
-	{
-		this->m_nonces[idx][i] = (int) (256.0 * rand() / (RAND_MAX + 1.0));
+		m_nonceTable = new Internal::NonceTable();
 	}
-
-	this->m_lastnonce++;
-	if (this->m_lastnonce >= 8)
-		this->m_lastnonce = 0;
-	for (uint8 i = 0; i < 8; i++)
-	{
-		Internal::PrintHex("NONCES", (const uint8_t*) this->m_nonces[i], 8);
-	}
-	return &this->m_nonces[idx][0];
+	uint8 const* nonce = m_nonceTable->Generate(GetDriver()->GetNoncePool());
+	Log::Write(LogLevel_Detail, m_nodeId, "Generated Nonce with id 0x%.2x", nonce[0]);
+	return nonce;
 }
+
 //-----------------------------------------------------------------------------
 // <Node::GetNonceKey>
 // Get a NONCE key for this node that matches the nonceid.
 //-----------------------------------------------------------------------------
-
-uint8 *Node::GetNonceKey(uint32 nonceid)
+uint8 const* Node::GetNonceKey(uint32 nonceid)
 {
-	for (uint8 i = 0; i < 8; i++)
+	uint8 const* nonce = NULL;
+	if (m_nonceTable != NULL && nonceid <= 0xff)
 	{
-		/* make sure the nonceid matches the first byte of our stored Nonce */
-		if (nonceid == this->m_nonces[i][0])
-		{
-			return &this->m_nonces[i][0];
-		}
+		nonce = m_nonceTable->Take((uint8) nonceid);
 	}
-	Log::Write(LogLevel_Warning, m_nodeId, "A Nonce with id %x does not exist", nonceid);
-	for (uint8 i = 0; i < 8; i++)
+	if (nonce == NULL)
 	{
-		Internal::PrintHex("NONCES", (const uint8_t*) this->m_nonces[i], 8);
+		Log::Write(LogLevel_Warning, m_nodeId, "A Nonce with id %x does not exist or has expired", nonceid);
 	}
-	return NULL;
+	return nonce;
 }
 
 //-----------------------------------------------------------------------------
@@ -4055,7 +4130,7 @@ void Node::WriteMetaDataXML(TiXmlElement *mdElement)
 // <Node::CreateSupervisionSession>
 // Generate a new session id for Supervision encapsulation, if supported
 //-----------------------------------------------------------------------------
-uint8 Node::CreateSupervisionSession(uint8 _command_class_id, uint8 _index)
+uint8 Node::CreateSupervisionSession(uint8 _command_class_id, uint16 _index)
 {
 	if (Internal::CC::CommandClass* cc = GetCommandClass(Internal::CC::Supervision::StaticGetCommandClassId()))
 	{
@@ -33,6 +33,8 @@
 #include <list>
 #include <map>
 #include "Defs.h"
+#include "AirtimeCounter.h"
+#include "LatencyHistogram.h"
 #include "value_classes/ValueID.h"
 #include "value_classes/ValueList.h"
 #include "Msg.h"
@@ -58,6 +60,7 @@ namespace OpenZWave
 			class MultiInstance;
 			class NodeNaming;
 			class Version;
+			class WakeUp;
 			class ZWavePlusInfo;
 		}
 		namespace VC
@@ -71,6 +74,8 @@ namespace OpenZWave
 		}
 		class ProductDescriptor;
 		class ManufacturerSpecificDB;
+		class NonceTable;
+		class ConfigLoader;
 	}
 	class Driver;
 	class Group;
@@ -95,8 +100,10 @@ namespace OpenZWave
 			friend class Internal::CC::MultiChannelAssociation;
 			friend class Internal::CC::NodeNaming;
 			friend class Internal::CC::Version;
+			friend class Internal::CC::WakeUp;
 			friend class Internal::CC::ZWavePlusInfo;
 			friend class Internal::ManufacturerSpecificDB;
+			friend class Internal::ConfigLoader;
 
 			//-----------------------------------------------------------------------------
 			// Construction
@@ -189,6 +196,15 @@ namespace OpenZWave
 			 */
 			void SetQueryStage(QueryStage const _stage, bool const _advance = true);
 
+			/**
+			 * This function puts the node on a query stage, whether it is earlier or later
+			 * than the current one.  It is used to carry on an interview that was saved part
+			 * way through.
+			 * \param _stage The query stage to carry on from.
+			 * \see SetQueryStage
+			 */
+			void ResumeQueryStage(QueryStage const _stage, bool const _advance = true);
+
 			/**
 			 * Returns the current query stage enum.
 			 * \return Enum value with the current query stage.
@@ -762,7 +778,7 @@ namespace OpenZWave
 			bool SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 const _specific);	// Set the device class data for the node
 			bool SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16 const _deviceType);	// Set the device class data for the node based on the Zwave+ info report
 			bool AddMandatoryCommandClasses(uint8 const* _commandClasses);							// Add mandatory command classes as specified in the device_classes.xml to the node.
-			bool ReadDeviceClasses();																	// Read the static device class data from the device_classes.xml file
+			static bool ReadDeviceClasses();																	// Read the static device class data from the device_classes.xml file
 
 			static bool s_deviceClassesLoaded;		// True if the xml file has already been loaded
 			static map<uint8, string> s_basicDeviceClasses;		// Map of basic device classes.
@@ -780,6 +796,10 @@ namespace OpenZWave
 					uint8 m_commandClassId;
 					uint32 m_sentCnt;
 					uint32 m_receivedCnt;
+					uint32 m_airtime;						// Airtime of the frames sent from the command class (ms)
+					uint32 m_handlerCalls;					// Received messages handled (with the ProfileHandlers option)
+					uint64 m_handlerTime;					// Time spent handling them, without the command classes they encapsulate (us)
+					uint32 m_handlerMaxTime;				// Longest time spent handling one of them (us)
 			};
 
 			struct NodeData
@@ -815,10 +835,17 @@ namespace OpenZWave
 					uint8 m_routeTries;
 					uint8 m_lastFailedLinkFrom;
 					uint8 m_lastFailedLinkTo;
+					LatencyHistogram m_requestLatency;		// Send Data until the controller's callback (ms)
+					LatencyHistogram m_responseLatency;		// Send Data until the node's report (ms)
+					LatencyHistogram m_setValueLatency;		// Value Set until the device confirmed the new value (ms)
+					AirtimeCounter m_airtime;				// Airtime of the frames sent to the node, with retries
 			};
 
 		private:
 			void GetNodeStatistics(NodeData* _data);
+			void SetValueSent(ValueID const& _id);
+			void SetValueConfirmed(ValueID const& _id);
+			void ExpirePendingSets();
 
 			uint32 m_sentCnt;					// Number of messages sent from this node.
 			uint32 m_sentFailed;				// Number of sent messages failed
@@ -851,18 +878,23 @@ namespace OpenZWave
 			uint8 m_routeTries;					// The number of attempts to route the last frame
 			uint8 m_lastFailedLinkFrom;			// The last failed link from
 			uint8 m_lastFailedLinkTo;			// The last failed link to
+			LatencyHistogram m_requestLatency;	// Histogram of request RTTs
+			LatencyHistogram m_responseLatency;	// Histogram of response RTTs
+			LatencyHistogram m_setValueLatency;	// Histogram of Set to confirmation times
+			AirtimeCounter m_airtime;			// Airtime of the frames sent to the node
+			map<ValueID, Internal::Platform::TimeStamp*> m_pendingSets;	// When each unconfirmed Set was sent
+			Internal::Platform::Mutex* m_pendingSetsMutex;	// Sets are sent from the application's thread and confirmed from the driver's
 
 			//-----------------------------------------------------------------------------
 			//	Encryption Related
 			//-----------------------------------------------------------------------------
 		public:
 
-			uint8 *GenerateNonceKey();
-			uint8 *GetNonceKey(uint32 nonceid);
+			uint8 const* GenerateNonceKey();
+			uint8 const* GetNonceKey(uint32 nonceid);
 
 		private:
-			uint8 m_lastnonce;
-			uint8 m_nonces[8][8];
+			Internal::NonceTable* m_nonceTable;		// Created when the node first asks us for a nonce
 
 			//-----------------------------------------------------------------------------
 			//	MetaData Related
@@ -913,7 +945,7 @@ namespace OpenZWave
 			map<uint32_t, ChangeLogEntry> m_changeLog;
 
 		public:
-			uint8 CreateSupervisionSession(uint8 _command_class_id, uint8 _index);
+			uint8 CreateSupervisionSession(uint8 _command_class_id, uint16 _index);
 			uint32 GetSupervisionIndex(uint8 _session_id);
 	};
 
@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+//
+//	NoncePool.cpp
+//
+//	Random nonces for Security (S0) encapsulated messages
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#if defined _WIN32
+#define _CRT_RAND_S
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "NoncePool.h"
+#include "platform/Log.h"
+
+#if defined _WIN32
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#define OZW_ARC4RANDOM
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		// S0 nodes must accept a nonce for between 3 and 20 seconds after they receive it
+		static int32 const c_nonceLifetime = 10000;
+
+//-----------------------------------------------------------------------------
+// <FillRandom>
+// Read random bytes from the operating system
+//-----------------------------------------------------------------------------
+		static bool FillRandom(uint8* _buffer, uint32 _length)
+		{
+#if defined _WIN32
+			for (uint32 i = 0; i < _length; i += 4)
+			{
+				unsigned int value;
+				if (rand_s(&value) != 0)
+				{
+					return false;
+				}
+				uint32 count = (_length - i) < 4 ? (_length - i) : 4;
+				memcpy(&_buffer[i], &value, count);
+			}
+			return true;
+#elif defined OZW_ARC4RANDOM
+			arc4random_buf(_buffer, _length);
+			return true;
+#else
+			uint32 filled = 0;
+#if defined(__linux__) && defined(SYS_getrandom)
+			while (filled < _length)
+			{
+				long res = syscall(SYS_getrandom, _buffer + filled, _length - filled, 0);
+				if (res < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+					// Kernels older than 3.17 - use the device instead
+					break;
+				}
+				filled += (uint32) res;
+			}
+			if (filled == _length)
+			{
+				return true;
+			}
+#endif
+			int fd = open("/dev/urandom", O_RDONLY);
+			if (fd < 0)
+			{
+				return false;
+			}
+			while (filled < _length)
+			{
+				ssize_t res = read(fd, _buffer + filled, _length - filled);
+				if (res <= 0)
+				{
+					if (res < 0 && errno == EINTR)
+					{
+						continue;
+					}
+					break;
+				}
+				filled += (uint32) res;
+			}
+			close(fd);
+			return filled == _length;
+#endif
+		}
+
+//-----------------------------------------------------------------------------
+// <NoncePool::NoncePool>
+// Constructor
+//-----------------------------------------------------------------------------
+		NoncePool::NoncePool() :
+				m_next(c_size)
+		{
+			memset(m_pool, 0, sizeof(m_pool));
+		}
+
+//-----------------------------------------------------------------------------
+// <NoncePool::~NoncePool>
+// Destructor
+//-----------------------------------------------------------------------------
+		NoncePool::~NoncePool()
+		{
+			// Don't leave key material lying around in freed memory
+			memset(m_pool, 0, sizeof(m_pool));
+		}
+
+//-----------------------------------------------------------------------------
+// <NoncePool::Get>
+// Take random bytes from the pool
+//-----------------------------------------------------------------------------
+		void NoncePool::Get(uint8* _buffer, uint32 _length)
+		{
+			if (_length > c_size)
+			{
+				FillRandom(_buffer, _length);
+				return;
+			}
+			if (c_size - m_next < _length)
+			{
+				Refill();
+			}
+			memcpy(_buffer, &m_pool[m_next], _length);
+			memset(&m_pool[m_next], 0, _length);
+			m_next += _length;
+		}
+
+//-----------------------------------------------------------------------------
+// <NoncePool::TopUp>
+// Refill the pool ahead of time
+//-----------------------------------------------------------------------------
+		void NoncePool::TopUp()
+		{
+			if (m_next > c_size / 2)
+			{
+				Refill();
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <NoncePool::Refill>
+// Read a new batch of random bytes
+//-----------------------------------------------------------------------------
+		void NoncePool::Refill()
+		{
+			if (!FillRandom(m_pool, c_size))
+			{
+				// Better a weak nonce than none at all - the node would just keep asking
+				Log::Write(LogLevel_Error, "Could not read random data from the operating system. Security nonces will be predictable!");
+				for (uint32 i = 0; i < c_size; ++i)
+				{
+					m_pool[i] = (uint8) (256.0 * rand() / (RAND_MAX + 1.0));
+				}
+			}
+			m_next = 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <NonceTable::NonceTable>
+// Constructor
+//-----------------------------------------------------------------------------
+		NonceTable::NonceTable() :
+				m_next(0)
+		{
+			memset(m_nonces, 0, sizeof(m_nonces));
+			memset(m_index, 0, sizeof(m_index));
+		}
+
+//-----------------------------------------------------------------------------
+// <NonceTable::Generate>
+// Create a nonce with an unused id
+//-----------------------------------------------------------------------------
+		uint8 const* NonceTable::Generate(NoncePool* _pool)
+		{
+			uint8 slot = m_next;
+			m_next = (m_next + 1) % c_slots;
+
+			// Forget the nonce this slot held before
+			uint8 oldId = m_nonces[slot][0];
+			if (m_index[oldId] == slot + 1)
+			{
+				m_index[oldId] = 0;
+			}
+
+			_pool->Get(m_nonces[slot], 8);
+
+			// The first byte is the nonce id.  It must be non-zero and not match any
+			// other nonce the node could still use.
+			while ((m_nonces[slot][0] == 0) || ((m_index[m_nonces[slot][0]] != 0) && (m_expires[m_index[m_nonces[slot][0]] - 1].TimeRemaining() > 0)))
+			{
+				_pool->Get(m_nonces[slot], 1);
+			}
+			m_index[m_nonces[slot][0]] = slot + 1;
+			m_expires[slot].SetTime(c_nonceLifetime);
+			return m_nonces[slot];
+		}
+
+//-----------------------------------------------------------------------------
+// <NonceTable::Take>
+// Find a nonce by id and remove it from the table
+//-----------------------------------------------------------------------------
+		uint8 const* NonceTable::Take(uint8 _id)
+		{
+			uint8 slot = m_index[_id];
+			if (slot == 0)
+			{
+				return NULL;
+			}
+			m_index[_id] = 0;
+			if (m_expires[slot - 1].TimeRemaining() <= 0)
+			{
+				return NULL;
+			}
+			return m_nonces[slot - 1];
+		}
+	} // namespace Internal
+} // namespace OpenZWave
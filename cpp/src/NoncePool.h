@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+//
+//	NoncePool.h
+//
+//	Random nonces for Security (S0) encapsulated messages
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _NoncePool_H
+#define _NoncePool_H
+
+#include "Defs.h"
+#include "platform/TimeStamp.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief Random bytes from the operating system's CSPRNG, fetched in batches.
+		 *
+		 * Reading getrandom() or /dev/urandom for every 8 byte nonce would put a
+		 * system call on the path of every Nonce Report we send, so the bytes are
+		 * read a few hundred nonces at a time.  The Driver tops the pool up when
+		 * it is idle, so a Nonce Get normally only has to copy from it.
+		 */
+		class NoncePool
+		{
+			public:
+				NoncePool();
+				~NoncePool();
+
+				/**
+				 * Copy _length random bytes to _buffer, refilling the pool first if it
+				 * does not hold enough.
+				 */
+				void Get(uint8* _buffer, uint32 _length);
+
+				/**
+				 * Refill the pool if more than half of it has been used.
+				 */
+				void TopUp();
+
+			private:
+				void Refill();
+
+				static uint32 const c_size = 2048;
+
+				uint8 m_pool[c_size];
+				uint32 m_next;						// First unused byte of m_pool
+		};
+
+		/** \brief The nonces we have given one node.
+		 *
+		 * Each nonce is identified by its first byte, which the node sends back in
+		 * the encapsulated message it encrypted with it.  IDs are unique among the
+		 * live nonces so they can be looked up directly.
+		 */
+		class NonceTable
+		{
+			public:
+				NonceTable();
+
+				/**
+				 * Generate a new nonce with an ID that is not in use.
+				 */
+				uint8 const* Generate(NoncePool* _pool);
+
+				/**
+				 * Find the live nonce with _id.  Each nonce can only be used once, so
+				 * it is removed from the table (the returned data stays valid until
+				 * its slot is reused).  Returns NULL if the nonce does not exist or
+				 * has expired.
+				 */
+				uint8 const* Take(uint8 _id);
+
+			private:
+				static uint8 const c_slots = 8;
+
+				uint8 m_nonces[c_slots][8];
+				Platform::TimeStamp m_expires[c_slots];
+				uint8 m_index[256];					// Slot + 1 for each nonce id, or 0
+				uint8 m_next;						// Slot to use for the next nonce
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
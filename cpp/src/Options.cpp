@@ -131,7 +131,23 @@ Options* Options::Create(string const& _configPath, string const& _userPath, str
 		s_instance->AddOptionBool("AutoUpdateConfigFile", true);						// if we should automatically update config files for devices if they are out of date
 		s_instance->AddOptionString("ReloadAfterUpdate", "AWAKE", false);			// Should we automatically Reload Nodes after a update
 		s_instance->AddOptionString("Language", "", false);			// Language we should use
+		s_instance->AddOptionBool("CompactLocalization", false);					// Only keep the selected Language (and the default text) in memory
 		s_instance->AddOptionBool("IncludeInstanceLabel", true);						// Should we include the Instance Label in Value Labels on MultiInstance Devices
+		s_instance->AddOptionBool("MultiCmdBatching", true);						// Combine Get requests for devices that support the Multi Command CC into a single frame
+		s_instance->AddOptionBool("NoncePrefetch", true);							// Request the S0 nonce for the next secure message while waiting for other replies
+		s_instance->AddOptionInt("ConfigLoadThreads", 4);							// Number of threads used to read the config files at startup (1 reads them one after the other)
+		s_instance->AddOptionString("ConfigBundle", "", false);					// Precompiled config bundle to read instead of the XML files (config.ozwb in the ConfigPath if empty)
+		s_instance->AddOptionString("MetricsSocket", "", false);					// Unix domain socket to serve the statistics on in the Prometheus text format (disabled if empty)
+		s_instance->AddOptionString("MetricsFile", "", false);					// File to write the statistics to in the Prometheus text format (disabled if empty)
+		s_instance->AddOptionInt("MetricsInterval", 60);							// Seconds between writes of the MetricsFile
+		s_instance->AddOptionString("SerialCapture", "", false);					// File to record the traffic with the controller to, for replay with ControllerInterface_Replay (disabled if empty)
+		s_instance->AddOptionBool("SerialReplayRealtime", true);					// Replay a capture at the pace it was recorded (false replays it as fast as the driver keeps up)
+		s_instance->AddOptionInt("ThrottleAirtimePercent", 30);					// Share of the airtime the Poll and Query queues may use (0 disables the throttle)
+		s_instance->AddOptionInt("ThrottleAirtimeBurst", 3000);					// Milliseconds of airtime the Poll and Query queues may use at once after being idle
+		s_instance->AddOptionString("TraceFile", "", false);						// File to write a trace of the library's threads to, for chrome://tracing or Perfetto (disabled if empty)
+		s_instance->AddOptionInt("TraceBufferSize", 32768);						// Number of spans kept for each thread in the trace
+		s_instance->AddOptionBool("ProfileHandlers", false);						// Measure the time each command class spends handling the messages it receives
+		s_instance->AddOptionBool("ProfileLocks", false);							// Count and time the waits for, and holds of, the library's main mutexes
 #if defined WINRT
 				s_instance->AddOptionInt( "ThreadTerminateTimeout", -1);						// Since threads cannot be terminated in WinRT, Thread::Terminate will simply wait for them to exit on there own
 #endif
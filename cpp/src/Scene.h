@@ -47,6 +47,7 @@ namespace OpenZWave
 				friend class OpenZWave::Manager;
 				friend class OpenZWave::Driver;
 				friend class OpenZWave::Node;
+				friend class ConfigLoader;
 
 				//-----------------------------------------------------------------------------
 				// Construction
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+//
+//	StringPool.cpp
+//
+//	Shared storage for frequently repeated strings
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <unordered_set>
+#include "StringPool.h"
+#include "Utils.h"
+#include "platform/Mutex.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		// The pool object itself is never destroyed, so that it can still be
+		// used by static objects during process shutdown.  Its contents are
+		// released by StringPool::Clear.
+		static unordered_set<string>& GetPool()
+		{
+			static unordered_set<string>* s_pool = new unordered_set<string>();
+			return *s_pool;
+		}
+
+//-----------------------------------------------------------------------------
+// <StringPool::GetMutex>
+// The mutex protecting the pool
+//-----------------------------------------------------------------------------
+		Platform::Mutex* StringPool::GetMutex()
+		{
+			static Platform::Mutex* s_mutex = new Platform::Mutex();
+			return s_mutex;
+		}
+
+//-----------------------------------------------------------------------------
+// <StringPool::Intern>
+// Find or add a string in the pool
+//-----------------------------------------------------------------------------
+		string const* StringPool::Intern(string const& _str)
+		{
+			if (_str.empty())
+			{
+				return Empty();
+			}
+			LockGuard LG(GetMutex());
+			// Elements of an unordered_set never move, so the address is stable
+			return &(*GetPool().insert(_str).first);
+		}
+
+//-----------------------------------------------------------------------------
+// <StringPool::Empty>
+// The shared empty string
+//-----------------------------------------------------------------------------
+		string const* StringPool::Empty()
+		{
+			static string const* s_empty = new string();
+			return s_empty;
+		}
+
+//-----------------------------------------------------------------------------
+// <StringPool::Clear>
+// Remove every string from the pool
+//-----------------------------------------------------------------------------
+		void StringPool::Clear()
+		{
+			LockGuard LG(GetMutex());
+			unordered_set<string>().swap(GetPool());
+		}
+
+//-----------------------------------------------------------------------------
+// <StringPool::Size>
+// Number of distinct strings in the pool
+//-----------------------------------------------------------------------------
+		size_t StringPool::Size()
+		{
+			LockGuard LG(GetMutex());
+			return GetPool().size();
+		}
+	} // namespace Internal
+} // namespace OpenZWave
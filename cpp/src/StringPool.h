@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+//
+//	StringPool.h
+//
+//	Shared storage for frequently repeated strings
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _StringPool_H
+#define _StringPool_H
+
+#include <string>
+#include <functional>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Mutex;
+		}
+
+		/** \brief Process wide pool of immutable strings.
+		 *
+		 * Units, list item labels and localized text are repeated across every
+		 * node that has the same command classes ("kWh", "Off", "On", thermostat
+		 * mode names...).  Interning them means each distinct string is stored once,
+		 * and copies are just a pointer.  Strings reported by devices (tone names,
+		 * configuration parameter names...) are interned as well, so the pool is
+		 * not bounded by the config database.  Strings stay in the pool until it is
+		 * cleared when the Manager is destroyed.
+		 */
+		class StringPool
+		{
+			public:
+				/**
+				 * Get the pooled copy of a string, adding it to the pool if needed.
+				 * The returned pointer stays valid until the pool is cleared.
+				 */
+				static string const* Intern(string const& _str);
+
+				/**
+				 * Get the shared empty string.  It is not stored in the pool, so
+				 * it stays valid when the pool is cleared.
+				 */
+				static string const* Empty();
+
+				/**
+				 * Remove every string from the pool.  Only call this when nothing
+				 * holds an InternedString other than the empty string.
+				 */
+				static void Clear();
+
+				/**
+				 * The mutex that serializes access to the pool.  Other shared tables
+				 * that are built from interned strings can use it too.
+				 */
+				static Platform::Mutex* GetMutex();
+
+				/**
+				 * The number of distinct strings in the pool.
+				 */
+				static size_t Size();
+		};
+
+		/** \brief A string held in the StringPool.
+		 *
+		 * Behaves like a read only std::string.  Comparing two InternedStrings
+		 * compares pointers, and copying one never allocates.
+		 */
+		class InternedString
+		{
+			public:
+				InternedString() :
+						m_str(StringPool::Empty())
+				{
+				}
+				InternedString(string const& _str) :
+						m_str(StringPool::Intern(_str))
+				{
+				}
+				InternedString(char const* _str) :
+						m_str(_str ? StringPool::Intern(_str) : StringPool::Empty())
+				{
+				}
+
+				operator string const&() const
+				{
+					return *m_str;
+				}
+				string const& str() const
+				{
+					return *m_str;
+				}
+				char const* c_str() const
+				{
+					return m_str->c_str();
+				}
+				size_t size() const
+				{
+					return m_str->size();
+				}
+				size_t length() const
+				{
+					return m_str->length();
+				}
+				bool empty() const
+				{
+					return m_str->empty();
+				}
+
+				bool operator ==(InternedString const& _other) const
+				{
+					return m_str == _other.m_str;
+				}
+				bool operator !=(InternedString const& _other) const
+				{
+					return m_str != _other.m_str;
+				}
+				// Orders by pool address - only meaningful for use as a key
+				bool operator <(InternedString const& _other) const
+				{
+					return std::less<string const*>()(m_str, _other.m_str);
+				}
+
+			private:
+				string const* m_str;
+		};
+
+		inline bool operator ==(InternedString const& _lhs, string const& _rhs)
+		{
+			return _lhs.str() == _rhs;
+		}
+		inline bool operator ==(string const& _lhs, InternedString const& _rhs)
+		{
+			return _lhs == _rhs.str();
+		}
+		inline bool operator !=(InternedString const& _lhs, string const& _rhs)
+		{
+			return _lhs.str() != _rhs;
+		}
+		inline bool operator !=(string const& _lhs, InternedString const& _rhs)
+		{
+			return _lhs != _rhs.str();
+		}
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
@@ -28,6 +28,7 @@
 #include "TimerThread.h"
 #include "Utils.h"
 #include "platform/Log.h"
+#include "platform/Trace.h"
 #include "Driver.h"
 
 namespace OpenZWave
@@ -56,6 +57,7 @@ namespace OpenZWave
 //m_driver( _driver ),
 				m_timerEvent(new Internal::Platform::Event()), m_timerMutex(new Internal::Platform::Mutex()), m_timerTimeout(Internal::Platform::Wait::Timeout_Infinite)
 		{
+			m_timerMutex->SetName("TimerThread::m_timerMutex");
 		}
 
 //-----------------------------------------------------------------------------
@@ -94,7 +96,11 @@ namespace OpenZWave
 			while (1)
 			{
 				Log::Write(LogLevel_Detail, "Timer: waiting with timeout %d ms", m_timerTimeout);
-				int32 res = Internal::Platform::Wait::Multiple(waitObjects, count, m_timerTimeout);
+				int32 res;
+				{
+					Internal::Platform::TraceSpan span("Wait");
+					res = Internal::Platform::Wait::Multiple(waitObjects, count, m_timerTimeout);
+				}
 
 				if (res == 0)
 				{
@@ -118,6 +124,7 @@ namespace OpenZWave
 							// Expired so perform action and remove from list.
 							Log::Write(LogLevel_Info, "Timer: delayed event");
 							TimerEventEntry *te = *(it++);
+							Internal::Platform::TraceSpan span("Timer event");
 							te->instance->TimerFireEvent(te);
 						}
 						else
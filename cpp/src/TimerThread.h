@@ -55,6 +55,7 @@ namespace OpenZWave
 		class OPENZWAVE_EXPORT TimerThread
 		{
 				friend class Timer;
+				friend class OpenZWave::Driver;
 				//-----------------------------------------------------------------------------
 				//  Timer based actions
 				//-----------------------------------------------------------------------------
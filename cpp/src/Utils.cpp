@@ -26,6 +26,7 @@
 //-----------------------------------------------------------------------------
 
 #include "Defs.h"
+#include "Options.h"
 #include "Utils.h"
 #include <functional>
 
@@ -162,6 +163,17 @@ namespace OpenZWave
 			return m_path.substr(0, lastSlash);
 		}
 
+		string ResolveUserPath(string const& _path)
+		{
+			if (_path.empty() || (_path[0] == '/') || (_path[0] == '\\') || ((_path.size() > 1) && (_path[1] == ':')))
+			{
+				return _path;
+			}
+			string userPath;
+			Options::Get()->GetOptionAsString("UserPath", &userPath);
+			return userPath + _path;
+		}
+
 		string intToString(int x)
 		{
 #if __cplusplus==201103L || __APPLE__
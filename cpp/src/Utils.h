@@ -152,6 +152,11 @@ namespace OpenZWave
 
 		string ozwdirname(string);
 
+		/**
+		 * Paths that are not absolute are relative to the UserPath option.
+		 */
+		string ResolveUserPath(string const& _path);
+
 		string intToString(int x);
 
 		const char* rssi_to_string(uint8 _data);
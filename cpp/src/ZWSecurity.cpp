@@ -35,7 +35,7 @@
 #include "platform/Log.h"
 #include "command_classes/MultiInstance.h"
 #include "command_classes/Security.h"
-#include "aes/aescpp.h"
+#include "AESKey.h"
 
 namespace OpenZWave
 {
@@ -69,61 +69,9 @@ namespace OpenZWave
 			Log::Write(LogLevel_Debug, _receivingNode, "Raw Auth (Minus IV) Size: %d (%d)", bufsize, bufsize+16);
 #endif
 
-			aes_mode_reset(driver->GetAuthKey());
-			/* encrypt the IV with ecb */
-			if (aes_ecb_encrypt(iv, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _receivingNode, "Failed Initial ECB Encrypt of Auth Packet");
-				return false;
-			}
-
-			/* our temporary holding var */
-			uint8 encpck[16];
+			/* encrypt the IV with ecb, then chain each (zero padded) block of the buffer through it */
+			driver->GetAuthKey()->CBCMAC(buffer, bufsize, iv, tmpauth);
 
-			int block = 0;
-			/* reset our encpck temp var */
-			memset(encpck, 0, 16);
-			/* now xor the buffer with our encrypted IV */
-			for (int i = 0; i < bufsize; i++)
-			{
-				encpck[block] = buffer[i];
-				block++;
-				/* if we hit a blocksize, then encrypt */
-				if (block == 16)
-				{
-					for (int j = 0; j < 16; j++)
-					{
-						/* here we do our xor */
-						tmpauth[j] = encpck[j] ^ tmpauth[j];
-						/* and reset encpck for good measure */
-						encpck[j] = 0;
-					}
-					/* reset our block counter back to 0 */
-					block = 0;
-					aes_mode_reset(driver->GetAuthKey());
-					if (aes_ecb_encrypt(tmpauth, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-					{
-						Log::Write(LogLevel_Warning, _receivingNode, "Failed Subsequent (%d) ECB Encrypt of Auth Packet", i);
-						return false;
-					}
-				}
-			}
-			/* any left over data that isn't a full block size*/
-			if (block > 0)
-			{
-				for (int i = 0; i < 16; i++)
-				{
-					/* encpck from block to 16 is already guaranteed to be 0
-					 * so its safe to xor it with out tmpmac */
-					tmpauth[i] = encpck[i] ^ tmpauth[i];
-				}
-				aes_mode_reset(driver->GetAuthKey());
-				if (aes_ecb_encrypt(tmpauth, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-				{
-					Log::Write(LogLevel_Warning, _receivingNode, "Failed Final ECB Encrypt of Auth Packet");
-					return false;
-				}
-			}
 			/* we only care about the first 8 bytes of tmpauth as the mac */
 #ifdef DEBUG
 			Internal::PrintHex("Computed Auth", tmpauth, 8);
@@ -172,13 +120,6 @@ namespace OpenZWave
 				initializationVector[8 + i] = m_nonce[i];
 			}
 
-			/* we need a copy b/c aes_ofb_encrypt will overwrite it */
-			uint8 iv_dup[16];
-			for (int i = 0; i < 16; i++)
-			{
-				iv_dup[i] = initializationVector[i];
-			}
-
 			uint8 plaintextmsg[32];
 			/* add the Sequence Flag
 			 * - Since we don't currently handle multipacket encryption
@@ -191,15 +132,10 @@ namespace OpenZWave
 
 			/* now encrypt */
 			uint8 encryptedpayload[30];
-			aes_mode_reset(driver->GetEncKey());
 #ifdef DEBUG
 			Internal::PrintHex("Plain Text Packet:", plaintextmsg, m_length-5-3);
 #endif
-			if (aes_ofb_encrypt(plaintextmsg, encryptedpayload, m_length - 5 - 3, initializationVector, driver->GetEncKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _receivingNode, "Failed to Encrypt Packet");
-				return false;
-			}
+			driver->GetEncKey()->OFB(plaintextmsg, encryptedpayload, m_length - 5 - 3, initializationVector);
 #ifdef DEBUG
 			Internal::PrintHex("Encrypted Packet", encryptedpayload, m_length-5-3);
 #endif
@@ -214,7 +150,7 @@ namespace OpenZWave
 
 			/* now calculate the MAC and append it */
 			uint8 mac[8];
-			GenerateAuthentication(&e_buffer[7], e_buffer[5], driver, _sendingNode, _receivingNode, iv_dup, mac);
+			GenerateAuthentication(&e_buffer[7], e_buffer[5], driver, _sendingNode, _receivingNode, initializationVector, mac);
 			for (int i = 0; i < 8; ++i)
 			{
 				e_buffer[len++] = mac[i];
@@ -314,7 +250,6 @@ namespace OpenZWave
 			/* Mac Starts after Encrypted Packet. */
 			Internal::PrintHex("Auth", &e_buffer[11+encryptedpacketsize], 8);
 #endif
-			aes_mode_reset(driver->GetEncKey());
 #if 0
 			uint8_t iv[16] =
 			{	0x81, 0x42, 0xd1, 0x51, 0xf1, 0x59, 0x3d, 0x70, 0xd5, 0xe3, 0x6c, 0xcb, 0x02, 0xd0, 0x3f, 0x5c, /* */};
@@ -327,17 +262,10 @@ namespace OpenZWave
 			}
 			Internal::PrintHex("Pck", decryptpacket, 19);
 #else
-			if (aes_ofb_decrypt(encyptedpacket, m_buffer, encryptedpacketsize, iv, driver->GetEncKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _sendingNode, "Failed to Decrypt Packet");
-				return false;
-			}
+			driver->GetEncKey()->OFB(encyptedpacket, m_buffer, encryptedpacketsize, iv);
 			Log::Write(LogLevel_Detail, _sendingNode, "Decrypted Packet: %s", Internal::PktToString(m_buffer, encryptedpacketsize).c_str());
 #endif
 			uint8 mac[32];
-			/* we have to regenerate the IV as the ofb decryption routine will alter it. */
-			createIVFromPacket_inbound(&e_buffer[2], m_nonce, iv);
-
 			GenerateAuthentication(&e_buffer[1], e_length - 1, driver, _sendingNode, _receivingNode, iv, mac);
 			if (memcmp(&e_buffer[11 + encryptedpacketsize], mac, 8) != 0)
 			{
@@ -317,6 +317,7 @@ namespace OpenZWave
 						Log::Write(LogLevel_Info, GetNodeId(), "BarrierOperator::Set - Requesting barrier to be %s", position > 0 ? "Open" : "Closed");
 						Msg* msg = new Msg("BarrierOperatorCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 						msg->SetInstance(this, _value.GetID().GetInstance());
+						SuperviseSet(msg, _value.GetID().GetIndex());
 						msg->Append(GetNodeId());
 						msg->Append(3);
 						msg->Append(GetCommandClassId());
@@ -335,6 +336,7 @@ namespace OpenZWave
 						Log::Write(LogLevel_Info, GetNodeId(), "BarrierOperatorSignal::Set - Requesting Audible to be %s", value->GetValue() ? "ON" : "OFF");
 						Msg* msg = new Msg("BarrierOperatorSignalCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 						msg->SetInstance(this, _value.GetID().GetInstance());
+						SuperviseSet(msg, _value.GetID().GetIndex());
 						msg->Append(GetNodeId());
 						msg->Append(4);
 						msg->Append(GetCommandClassId());
@@ -351,6 +353,7 @@ namespace OpenZWave
 						Log::Write(LogLevel_Info, GetNodeId(), "BarrierOperatorSignal::Set - Requesting Visual to be %s", value->GetValue() ? "ON" : "OFF");
 						Msg* msg = new Msg("BarrierOperatorSignalCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 						msg->SetInstance(this, _value.GetID().GetInstance());
+						SuperviseSet(msg, _value.GetID().GetIndex());
 						msg->Append(GetNodeId());
 						msg->Append(4);
 						msg->Append(GetCommandClassId());
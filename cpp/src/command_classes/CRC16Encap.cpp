@@ -89,6 +89,7 @@ namespace OpenZWave
 
 						if (CommandClass* pCommandClass = node->GetCommandClass(commandClassId))
 						{
+							HandlerProfile profile(pCommandClass);
 							if (!pCommandClass->IsAfterMark())
 							{
 								pCommandClass->HandleMsg(&_data[2], _length - 4);
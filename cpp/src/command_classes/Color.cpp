@@ -704,6 +704,7 @@ namespace OpenZWave
 
 					Msg* msg = new Msg("ColorCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, false);
 					msg->SetInstance(this, _value.GetID().GetInstance());
+					SuperviseSet(msg, _value.GetID().GetIndex());
 					msg->Append(GetNodeId());
 					if (GetVersion() > 1)
 						msg->Append(3 + (nocols * 2) + 1); // each color 2 bytes - and 1 byte for duration
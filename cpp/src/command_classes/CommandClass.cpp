@@ -25,6 +25,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <chrono>
 #include <math.h>
 #include <locale.h>
 #include "Defs.h"
@@ -32,6 +33,7 @@
 #include "command_classes/CommandClass.h"
 #include "command_classes/Basic.h"
 #include "command_classes/MultiInstance.h"
+#include "command_classes/Supervision.h"
 #include "command_classes/CommandClasses.h"
 #include "Msg.h"
 #include "Node.h"
@@ -55,12 +57,17 @@ namespace OpenZWave
 			static uint8 const c_precisionMask = 0xe0;
 			static uint8 const c_precisionShift = 0x05;
 
+			bool CommandClass::s_handlerProfiling = false;
+
+			// Each driver thread handles its own messages, so the nesting is per thread
+			static thread_local HandlerProfile* t_currentProfile = NULL;
+
 //-----------------------------------------------------------------------------
 // <CommandClass::CommandClass>
 // Constructor
 //-----------------------------------------------------------------------------
 			CommandClass::CommandClass(uint32 const _homeId, uint8 const _nodeId) :
-					m_com(CompatOptionType_Compatibility, this), m_dom(CompatOptionType_Discovery, this), m_homeId(_homeId), m_nodeId(_nodeId), m_SecureSupport(true), m_sentCnt(0), m_receivedCnt(0)
+					m_com(CompatOptionType_Compatibility, this), m_dom(CompatOptionType_Discovery, this), m_homeId(_homeId), m_nodeId(_nodeId), m_SecureSupport(true), m_supervisedSet(false), m_sentCnt(0), m_receivedCnt(0), m_airtime(0), m_handlerCalls(0), m_handlerTime(0), m_handlerMaxTime(0)
 			{
 				m_com.EnableFlag(COMPAT_FLAG_GETSUPPORTED, true);
 				m_com.EnableFlag(COMPAT_FLAG_OVERRIDEPRECISION, 0);
@@ -132,6 +139,73 @@ namespace OpenZWave
 				return value;
 			}
 
+//-----------------------------------------------------------------------------
+// <CommandClass::SuperviseSet>
+// Ask the node to report the outcome of a Set, if it supports Supervision
+//-----------------------------------------------------------------------------
+			bool CommandClass::SuperviseSet(Msg* _msg, uint16 const _index)
+			{
+				if (Node* node = GetNodeUnsafe())
+				{
+					uint8 sessionId = node->CreateSupervisionSession(GetCommandClassId(), _index);
+					if (sessionId == Supervision::StaticNoSessionId())
+					{
+						Log::Write(LogLevel_Debug, GetNodeId(), "Supervision not supported, fall back to set/get");
+						return false;
+					}
+					_msg->SetSupervision(sessionId);
+					m_supervisedSet = true;
+					return true;
+				}
+				return false;
+			}
+
+//-----------------------------------------------------------------------------
+// <CommandClass::SupervisionSessionSuccess>
+// The device has carried out a supervised Set
+//-----------------------------------------------------------------------------
+			void CommandClass::SupervisionSessionSuccess(uint8 _session_id, uint32 const _instance)
+			{
+				if (Node* node = GetNodeUnsafe())
+				{
+					uint32 index = node->GetSupervisionIndex(_session_id);
+					if (index == Supervision::StaticNoIndex())
+					{
+						Log::Write(LogLevel_Info, GetNodeId(), "Ignore unknown supervision session %d", _session_id);
+						return;
+					}
+					if (Internal::VC::Value* value = GetValue(_instance, index))
+					{
+						if (value->ConfirmNewValue())
+						{
+							Log::Write(LogLevel_Info, GetNodeId(), "Confirmed %s index %d to %s", GetCommandClassName().c_str(), index, value->GetAsString().c_str());
+						}
+						else
+						{
+							RequestValue(0, index, _instance, Driver::MsgQueue_Send);
+						}
+						value->Release();
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <CommandClass::SupervisionSessionFailure>
+// The device did not carry out a supervised Set
+//-----------------------------------------------------------------------------
+			void CommandClass::SupervisionSessionFailure(uint8 _session_id, uint32 const _instance)
+			{
+				if (Node* node = GetNodeUnsafe())
+				{
+					uint32 index = node->GetSupervisionIndex(_session_id);
+					if (index != Supervision::StaticNoIndex())
+					{
+						Log::Write(LogLevel_Warning, GetNodeId(), "%s Set of index %d failed - refreshing the value", GetCommandClassName().c_str(), index);
+						RequestValue(0, index, _instance, Driver::MsgQueue_Send);
+					}
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <CommandClass::RemoveValue>
 // Remove a value by its instance and index
@@ -859,6 +933,48 @@ namespace OpenZWave
 			}
 
 
+//-----------------------------------------------------------------------------
+// <HandlerProfile::HandlerProfile>
+// Start timing a command class handler
+//-----------------------------------------------------------------------------
+			HandlerProfile::HandlerProfile(CommandClass* _commandClass) :
+					m_commandClass(NULL), m_outer(NULL), m_start(0), m_inner(0)
+			{
+				if (CommandClass::IsHandlerProfiling() && (_commandClass != NULL))
+				{
+					m_commandClass = _commandClass;
+					m_outer = t_currentProfile;
+					t_currentProfile = this;
+					m_start = (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <HandlerProfile::~HandlerProfile>
+// Add the time the handler took, less that of the handlers it called, to its
+// command class
+//-----------------------------------------------------------------------------
+			HandlerProfile::~HandlerProfile()
+			{
+				if (m_commandClass == NULL)
+				{
+					return;
+				}
+				uint64 elapsed = (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - m_start;
+				t_currentProfile = m_outer;
+				if (m_outer != NULL)
+				{
+					m_outer->m_inner += elapsed;
+				}
+
+				uint32 self = (uint32) ((elapsed > m_inner) ? elapsed - m_inner : 0);
+				m_commandClass->m_handlerCalls++;
+				m_commandClass->m_handlerTime += self;
+				if (self > m_commandClass->m_handlerMaxTime)
+				{
+					m_commandClass->m_handlerMaxTime = self;
+				}
+			}
 		} // namespace CC
 	} // namespace Internal
 } // namespace OpenZWave
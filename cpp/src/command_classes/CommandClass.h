@@ -149,13 +149,23 @@ namespace OpenZWave
 					virtual bool supportsMultiInstance() {
 						return true;
 					}
-					virtual uint8 CreateSupervisionSession(uint8 _command_class_id, uint8 _index) {
+					virtual uint8 CreateSupervisionSession(uint8 _command_class_id, uint16 _index) {
 						return 0;
 					}
 					virtual uint32 GetSupervisionIndex(uint8 _session_id) {
 						return 0;
 					}
-					virtual void SupervisionSessionSuccess(uint8 _session_id, uint32 const _instance) {};
+					/* Called when a Set wrapped by SuperviseSet has been carried out.  Confirms the value that was Set. */
+					virtual void SupervisionSessionSuccess(uint8 _session_id, uint32 const _instance);
+					/* Called when a supervised Set was rejected.  Requests the value, so we show what the device really has. */
+					virtual void SupervisionSessionFailure(uint8 _session_id, uint32 const _instance);
+					/* Did the last SetValue call send its Set with Supervision encapsulation?  Clears the flag. */
+					bool TakeSupervisedSet()
+					{
+						bool supervised = m_supervisedSet;
+						m_supervisedSet = false;
+						return supervised;
+					}
 
 					void SetInstances(uint8 const _instances);
 					void SetInstance(uint8 const _endPoint);
@@ -235,6 +245,10 @@ namespace OpenZWave
 				protected:
 					virtual void CreateVars(uint8 const _instance);
 					void ReadValueRefreshXML(TiXmlElement const* _ccElement);
+					/* Wrap a Set for the value at _index in Supervision encapsulation, if the node supports it.
+					 * The value is then confirmed by the Supervision Report instead of being requested again
+					 * after the Set.  Call after Msg::SetInstance. */
+					bool SuperviseSet(Msg* _msg, uint16 const _index);
 					CompatOptionManager m_com;
 					CompatOptionManager m_dom;
 
@@ -248,6 +262,7 @@ namespace OpenZWave
 					map<uint8, uint8> m_endPointMap;
 					map<uint8, string> m_instanceLabel;
 					bool m_SecureSupport; 	// Does this commandclass support secure encryption (eg, the Security CC doesn't encrypt itself, so it doesn't support encryption)
+					bool m_supervisedSet;	// The last Set was sent with Supervision encapsulation
 					multimap<uint16, RefreshValue *> m_RefreshClassValues; // what Command Class Values should we refresh ?
 					string m_commandClassLabel;
 					//-----------------------------------------------------------------------------
@@ -288,11 +303,73 @@ namespace OpenZWave
 					{
 						m_receivedCnt++;
 					}
+					uint32 GetAirtime() const
+					{
+						return m_airtime;
+					}
+					void AirtimeAdd(uint32 _ms)
+					{
+						m_airtime += _ms;
+					}
+					uint32 GetHandlerCalls() const
+					{
+						return m_handlerCalls;
+					}
+					uint64 GetHandlerTime() const
+					{
+						return m_handlerTime;
+					}
+					uint32 GetHandlerMaxTime() const
+					{
+						return m_handlerMaxTime;
+					}
+
+					/**
+					 * Time the handling of received messages (the ProfileHandlers option).
+					 */
+					static void SetHandlerProfiling(bool _enabled)
+					{
+						s_handlerProfiling = _enabled;
+					}
+					static bool IsHandlerProfiling()
+					{
+						return s_handlerProfiling;
+					}
 
 				private:
 					uint32 m_sentCnt;				// Number of messages sent from this command class.
 					uint32 m_receivedCnt;				// Number of messages received from this commandclass.
+					uint32 m_airtime;				// Milliseconds of airtime used by the frames sent from this command class.
+					uint32 m_handlerCalls;				// Number of received messages handled, if profiling
+					uint64 m_handlerTime;				// Microseconds spent handling them, not counting the command classes they encapsulate
+					uint32 m_handlerMaxTime;			// Longest time spent handling one of them (us)
+					static bool s_handlerProfiling;
+
+					friend class HandlerProfile;
+			};
+
+			/** \brief Time how long a command class takes to handle a received message.
+			 * \ingroup CommandClass
+			 *
+			 * Put in scope around a call to HandleMsg or HandleIncomingMsg.  Profiles
+			 * nest, so the time spent in a command class that was encapsulated in
+			 * another (Multi Channel, Multi Command, CRC-16) is only counted for the
+			 * inner one.  Does nothing unless the ProfileHandlers option is set.
+			 */
+			class HandlerProfile
+			{
+				public:
+					HandlerProfile(CommandClass* _commandClass);
+					~HandlerProfile();
+
+				private:
+					HandlerProfile(HandlerProfile const&);			// prevent copy
+					HandlerProfile& operator =(HandlerProfile const&);	// prevent assignment
 
+					CommandClass* m_commandClass;				// NULL if not profiling
+					HandlerProfile* m_outer;					// The profile this one is nested in
+					uint64 m_start;
+					uint64 m_inner;								// Time spent in nested profiles
 			};
 //@}
 		}// namespace CC
@@ -25,6 +25,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
 #include "command_classes/CommandClasses.h"
 #include "command_classes/Configuration.h"
 #include "Defs.h"
@@ -32,6 +33,7 @@
 #include "Driver.h"
 #include "Node.h"
 #include "platform/Log.h"
+#include "tinyxml.h"
 #include "value_classes/ValueBitSet.h"
 #include "value_classes/ValueBool.h"
 #include "value_classes/ValueButton.h"
@@ -51,9 +53,141 @@ namespace OpenZWave
 			{
 				ConfigurationCmd_Set = 0x04,
 				ConfigurationCmd_Get = 0x05,
-				ConfigurationCmd_Report = 0x06
+				ConfigurationCmd_Report = 0x06,
+				ConfigurationCmd_BulkSet = 0x07,
+				ConfigurationCmd_BulkGet = 0x08,
+				ConfigurationCmd_BulkReport = 0x09,
+				ConfigurationCmd_NameGet = 0x0A,
+				ConfigurationCmd_NameReport = 0x0B,
+				ConfigurationCmd_InfoGet = 0x0C,
+				ConfigurationCmd_InfoReport = 0x0D,
+				ConfigurationCmd_PropertiesGet = 0x0E,
+				ConfigurationCmd_PropertiesReport = 0x0F
 			};
 
+			enum ConfigurationFormat
+			{
+				ConfigurationFormat_Signed = 0,
+				ConfigurationFormat_Unsigned,
+				ConfigurationFormat_Enumerated,
+				ConfigurationFormat_BitField
+			};
+
+			// Most parameters we ask for in one Bulk Get.  The device splits its answer
+			// over several Bulk Reports if they do not fit in one frame.
+			static uint8 const c_maxBulkParams = 32;
+
+//-----------------------------------------------------------------------------
+// <ReadParam>
+// Extract a big endian parameter value of 1, 2 or 4 bytes
+//-----------------------------------------------------------------------------
+			static int32 ReadParam(uint8 const* _data, uint8 const _size, bool const _signed)
+			{
+				uint32 value = 0;
+				for (uint8 i = 0; i < _size; ++i)
+				{
+					value = (value << 8) | _data[i];
+				}
+				if (_signed && (_size > 0) && (_size < 4) && (value & (0x80 << ((_size - 1) * 8))))
+				{
+					// Sign extend
+					value |= (0xFFFFFFFF << (_size * 8));
+				}
+				return (int32) value;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::Configuration>
+// Constructor
+//-----------------------------------------------------------------------------
+			Configuration::Configuration(uint32 const _homeId, uint8 const _nodeId) :
+					CommandClass(_homeId, _nodeId), m_nextParam(0)
+			{
+				m_dom.EnableFlag(STATE_FLAG_CONFIG_DISCOVERED, false);
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::ReadXML>
+// Read the parameter properties the device reported earlier
+//-----------------------------------------------------------------------------
+			void Configuration::ReadXML(TiXmlElement const* _ccElement)
+			{
+				CommandClass::ReadXML(_ccElement);
+
+				TiXmlElement const* child = _ccElement->FirstChildElement("Parameter");
+				while (child)
+				{
+					int index;
+					int intVal;
+					if (TIXML_SUCCESS == child->QueryIntAttribute("index", &index) && TIXML_SUCCESS == child->QueryIntAttribute("size", &intVal))
+					{
+						Param& param = m_params[(uint16) index];
+						param.m_size = (uint8) intVal;
+						param.m_format = (TIXML_SUCCESS == child->QueryIntAttribute("format", &intVal)) ? (uint8) intVal : ConfigurationFormat_Signed;
+						param.m_min = (TIXML_SUCCESS == child->QueryIntAttribute("min", &intVal)) ? intVal : 0;
+						param.m_max = (TIXML_SUCCESS == child->QueryIntAttribute("max", &intVal)) ? intVal : 0;
+						param.m_default = (TIXML_SUCCESS == child->QueryIntAttribute("default", &intVal)) ? intVal : 0;
+						char const* str = child->Attribute("readonly");
+						param.m_readOnly = str && !strcmp(str, "true");
+						str = child->Attribute("advanced");
+						param.m_advanced = str && !strcmp(str, "true");
+						str = child->Attribute("nobulk");
+						param.m_noBulk = str && !strcmp(str, "true");
+					}
+					child = child->NextSiblingElement("Parameter");
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::WriteXML>
+// Save the parameter properties so they are not requested again
+//-----------------------------------------------------------------------------
+			void Configuration::WriteXML(TiXmlElement* _ccElement)
+			{
+				CommandClass::WriteXML(_ccElement);
+
+				for (map<uint16, Param>::const_iterator it = m_params.begin(); it != m_params.end(); ++it)
+				{
+					TiXmlElement* paramElement = new TiXmlElement("Parameter");
+					_ccElement->LinkEndChild(paramElement);
+
+					paramElement->SetAttribute("index", it->first);
+					paramElement->SetAttribute("size", it->second.m_size);
+					paramElement->SetAttribute("format", it->second.m_format);
+					paramElement->SetAttribute("min", it->second.m_min);
+					paramElement->SetAttribute("max", it->second.m_max);
+					paramElement->SetAttribute("default", it->second.m_default);
+					if (it->second.m_readOnly)
+					{
+						paramElement->SetAttribute("readonly", "true");
+					}
+					if (it->second.m_advanced)
+					{
+						paramElement->SetAttribute("advanced", "true");
+					}
+					if (it->second.m_noBulk)
+					{
+						paramElement->SetAttribute("nobulk", "true");
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::RequestState>
+// Ask a version 3+ device which parameters it has
+//-----------------------------------------------------------------------------
+			bool Configuration::RequestState(uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue)
+			{
+				if ((_requestFlags & RequestFlag_Static) && (_instance == 1) && (GetVersion() >= 3) && !m_dom.GetFlagBool(STATE_FLAG_CONFIG_DISCOVERED))
+				{
+					// Properties Get for parameter 0 returns the first parameter the device has
+					m_params.clear();
+					RequestProperties(0, _queue);
+					return true;
+				}
+				return false;
+			}
+
 //-----------------------------------------------------------------------------
 // <Configuration::HandleMsg>
 // Handle a message from the Z-Wave network
@@ -73,91 +207,419 @@ namespace OpenZWave
 						paramValue |= (int32) _data[i + 3];
 					}
 
-					if (Internal::VC::Value* value = GetValue(1, parameter))
+					HandleParamValue(parameter, size, paramValue, _instance);
+					Log::Write(LogLevel_Info, GetNodeId(), "Received Configuration report: Parameter=%d, Value=%d", parameter, paramValue);
+					return true;
+				}
+
+				if (ConfigurationCmd_BulkReport == (ConfigurationCmd) _data[0])
+				{
+					uint16 offset;
+					uint8 size;
+					vector<int32> values;
+					if (!ParseBulkReport(_data, _length, &offset, &size, &values))
+					{
+						Log::Write(LogLevel_Warning, GetNodeId(), "Invalid Configuration bulk report");
+						return false;
+					}
+					Log::Write(LogLevel_Info, GetNodeId(), "Received Configuration bulk report: Parameters %d to %d, %d reports to follow", offset, offset + (int) values.size() - 1, _data[4]);
+					for (size_t i = 0; i < values.size(); ++i)
+					{
+						HandleParamValue(offset + i, size, values[i], _instance);
+					}
+					return true;
+				}
+
+				if (ConfigurationCmd_PropertiesReport == (ConfigurationCmd) _data[0])
+				{
+					uint16 parameter;
+					uint16 nextParam;
+					Param param;
+					if (!ParseProperties(_data, _length, &parameter, &param, &nextParam))
 					{
-						switch (value->GetID().GetType())
+						Log::Write(LogLevel_Warning, GetNodeId(), "Invalid Configuration properties report");
+						return false;
+					}
+					m_nextParam = nextParam;
+					uint8 size = param.m_size;
+
+					if (size == 0)
+					{
+						if (parameter != 0)
 						{
-							case ValueID::ValueType_BitSet:
-							{
-								Internal::VC::ValueBitSet* vbs = static_cast<Internal::VC::ValueBitSet*>(value);
-								vbs->OnValueRefreshed(paramValue);
-								break;
-							}
-							case ValueID::ValueType_Bool:
-							{
-								Internal::VC::ValueBool* valueBool = static_cast<Internal::VC::ValueBool*>(value);
-								valueBool->OnValueRefreshed(paramValue != 0);
-								break;
-							}
-							case ValueID::ValueType_Byte:
-							{
-								Internal::VC::ValueByte* valueByte = static_cast<Internal::VC::ValueByte*>(value);
-								valueByte->OnValueRefreshed((uint8) paramValue);
-								break;
-							}
-							case ValueID::ValueType_Short:
+							Log::Write(LogLevel_Info, GetNodeId(), "Configuration parameter %d is not supported", parameter);
+						}
+						DiscoverNext(parameter);
+						return true;
+					}
+
+					Log::Write(LogLevel_Info, GetNodeId(), "Received Configuration properties: Parameter=%d, Size=%d, Format=%d, Min=%d, Max=%d, Default=%d", parameter, size, param.m_format, param.m_min, param.m_max, param.m_default);
+					m_params[parameter] = param;
+					RequestText(ConfigurationCmd_NameGet, parameter);
+					return true;
+				}
+
+				if ((ConfigurationCmd_NameReport == (ConfigurationCmd) _data[0]) || (ConfigurationCmd_InfoReport == (ConfigurationCmd) _data[0]))
+				{
+					if (_length < 5)
+					{
+						return false;
+					}
+					uint16 parameter = (_data[1] << 8) | _data[2];
+					map<uint16, Param>::iterator it = m_params.find(parameter);
+					if (it == m_params.end())
+					{
+						return true;
+					}
+					// Long texts are split over several reports
+					string text((char const*) &_data[4], _length - 5);
+					bool last = (_data[3] == 0);
+					if (ConfigurationCmd_NameReport == (ConfigurationCmd) _data[0])
+					{
+						it->second.m_name += text;
+						if (last)
+						{
+							RequestText(ConfigurationCmd_InfoGet, parameter);
+						}
+					}
+					else
+					{
+						it->second.m_info += text;
+						if (last)
+						{
+							CreateParamValue(parameter);
+							DiscoverNext(parameter);
+						}
+					}
+					return true;
+				}
+
+				return false;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::ParseProperties>
+// Decode a Properties Report
+//-----------------------------------------------------------------------------
+			bool Configuration::ParseProperties(uint8 const* _data, uint32 const _length, uint16* o_param, Param* o_props, uint16* o_nextParam)
+			{
+				if (_length < 6)
+				{
+					return false;
+				}
+				uint8 size = _data[3] & 0x07;
+				uint32 pos = 4;
+				if ((size != 0) && (size != 1) && (size != 2) && (size != 4))
+				{
+					return false;
+				}
+				if (pos + 3 * size + 2 > _length - 1)
+				{
+					return false;
+				}
+
+				*o_param = (_data[1] << 8) | _data[2];
+				o_props->m_size = size;
+				o_props->m_format = (_data[3] >> 3) & 0x07;
+				o_props->m_readOnly = ((_data[3] & 0x40) != 0);
+				bool isSigned = (o_props->m_format == ConfigurationFormat_Signed);
+				o_props->m_min = ReadParam(&_data[pos], size, isSigned);
+				pos += size;
+				o_props->m_max = ReadParam(&_data[pos], size, isSigned);
+				pos += size;
+				o_props->m_default = ReadParam(&_data[pos], size, isSigned);
+				pos += size;
+				*o_nextParam = (_data[pos] << 8) | _data[pos + 1];
+				pos += 2;
+				// Version 4 adds the advanced and no bulk support flags
+				o_props->m_advanced = (pos < _length - 1) && ((_data[pos] & 0x01) != 0);
+				o_props->m_noBulk = (pos < _length - 1) && ((_data[pos] & 0x02) != 0);
+
+				if ((size == 4) && ((o_props->m_format == ConfigurationFormat_Unsigned) || (o_props->m_format == ConfigurationFormat_Enumerated)))
+				{
+					// The values are held in a (signed) ValueInt, so keep the range
+					// from wrapping round.  Bit fields keep all 32 bits as their mask.
+					if (o_props->m_min < 0)
+					{
+						o_props->m_min = INT32_MAX;
+					}
+					if (o_props->m_max < 0)
+					{
+						o_props->m_max = INT32_MAX;
+					}
+					if (o_props->m_default < 0)
+					{
+						o_props->m_default = INT32_MAX;
+					}
+				}
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::ParseBulkReport>
+// Decode a Bulk Report
+//-----------------------------------------------------------------------------
+			bool Configuration::ParseBulkReport(uint8 const* _data, uint32 const _length, uint16* o_offset, uint8* o_size, vector<int32>* o_values)
+			{
+				if (_length < 7)
+				{
+					return false;
+				}
+				uint8 size = _data[5] & 0x07;
+				if ((size != 1) && (size != 2) && (size != 4))
+				{
+					return false;
+				}
+				uint8 count = _data[3];
+				if (count > (_length - 7) / size)
+				{
+					// Only take the values that are really there
+					count = (uint8) ((_length - 7) / size);
+				}
+
+				*o_offset = (_data[1] << 8) | _data[2];
+				*o_size = size;
+				o_values->clear();
+				for (uint8 i = 0; i < count; ++i)
+				{
+					o_values->push_back(ReadParam(&_data[6 + i * size], size, false));
+				}
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::HandleParamValue>
+// Store a parameter value reported by the device
+//-----------------------------------------------------------------------------
+			void Configuration::HandleParamValue(uint16 const _param, uint8 const _size, int32 _paramValue, uint32 const _instance)
+			{
+				map<uint16, Param>::const_iterator it = m_params.find(_param);
+				if ((it != m_params.end()) && (it->second.m_format == ConfigurationFormat_Signed) && (_size > 0) && (_size < 4) && (_paramValue & (0x80 << ((_size - 1) * 8))))
+				{
+					_paramValue = (int32) ((uint32) _paramValue | (0xFFFFFFFF << (_size * 8)));
+				}
+
+				if (Internal::VC::Value* value = GetValue(1, _param))
+				{
+					switch (value->GetID().GetType())
+					{
+						case ValueID::ValueType_BitSet:
+						{
+							Internal::VC::ValueBitSet* vbs = static_cast<Internal::VC::ValueBitSet*>(value);
+							vbs->OnValueRefreshed(_paramValue);
+							break;
+						}
+						case ValueID::ValueType_Bool:
+						{
+							Internal::VC::ValueBool* valueBool = static_cast<Internal::VC::ValueBool*>(value);
+							valueBool->OnValueRefreshed(_paramValue != 0);
+							break;
+						}
+						case ValueID::ValueType_Byte:
+						{
+							Internal::VC::ValueByte* valueByte = static_cast<Internal::VC::ValueByte*>(value);
+							valueByte->OnValueRefreshed((uint8) _paramValue);
+							break;
+						}
+						case ValueID::ValueType_Short:
+						{
+							Internal::VC::ValueShort* valueShort = static_cast<Internal::VC::ValueShort*>(value);
+							valueShort->OnValueRefreshed((int16) _paramValue);
+							break;
+						}
+						case ValueID::ValueType_Int:
+						{
+							Internal::VC::ValueInt* valueInt = static_cast<Internal::VC::ValueInt*>(value);
+							valueInt->OnValueRefreshed(_paramValue);
+							break;
+						}
+						case ValueID::ValueType_List:
+						{
+							Internal::VC::ValueList* valueList = static_cast<Internal::VC::ValueList*>(value);
+							valueList->OnValueRefreshed(_paramValue);
+							break;
+						}
+						default:
+						{
+							Log::Write(LogLevel_Info, GetNodeId(), "Invalid type (%d) for configuration parameter %d", value->GetID().GetType(), _param);
+						}
+					}
+					value->Release();
+				}
+				else
+				{
+					char label[16];
+					snprintf(label, 16, "Parameter #%hu", _param);
+
+					// Create a new value
+					if (Node* node = GetNodeUnsafe())
+					{
+						switch (_size)
+						{
+							case 1:
 							{
-								Internal::VC::ValueShort* valueShort = static_cast<Internal::VC::ValueShort*>(value);
-								valueShort->OnValueRefreshed((int16) paramValue);
+								node->CreateValueByte(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, _param, label, "", false, false, (uint8) _paramValue, 0);
 								break;
 							}
-							case ValueID::ValueType_Int:
+							case 2:
 							{
-								Internal::VC::ValueInt* valueInt = static_cast<Internal::VC::ValueInt*>(value);
-								valueInt->OnValueRefreshed(paramValue);
+								node->CreateValueShort(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, _param, label, "", false, false, (int16) _paramValue, 0);
 								break;
 							}
-							case ValueID::ValueType_List:
+							case 4:
 							{
-								Internal::VC::ValueList* valueList = static_cast<Internal::VC::ValueList*>(value);
-								valueList->OnValueRefreshed(paramValue);
+								node->CreateValueInt(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, _param, label, "", false, false, (int32) _paramValue, 0);
 								break;
 							}
 							default:
 							{
-								Log::Write(LogLevel_Info, GetNodeId(), "Invalid type (%d) for configuration parameter %d", value->GetID().GetType(), parameter);
+								Log::Write(LogLevel_Info, GetNodeId(), "Invalid size of %d bytes for configuration parameter %d", _size, _param);
 							}
 						}
-						value->Release();
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::CreateParamValue>
+// Create a value for a discovered parameter the device config file does not have
+//-----------------------------------------------------------------------------
+			void Configuration::CreateParamValue(uint16 const _param)
+			{
+				Param const& param = m_params[_param];
+				Log::Write(LogLevel_Info, GetNodeId(), "Configuration parameter %d is \"%s\"", _param, param.m_name.c_str());
+
+				if (Internal::VC::Value* value = GetValue(1, _param))
+				{
+					// Already described by the device config file
+					value->Release();
+					return;
+				}
+				Node* node = GetNodeUnsafe();
+				if (!node)
+				{
+					return;
+				}
+
+				char label[16];
+				snprintf(label, 16, "Parameter #%hu", _param);
+				string name = param.m_name.empty() ? string(label) : param.m_name;
+				if (param.m_format == ConfigurationFormat_BitField)
+				{
+					node->CreateValueBitSet(ValueID::ValueGenre_Config, GetCommandClassId(), 1, _param, name, "", param.m_readOnly, false, param.m_default, 0);
+				}
+				else
+				{
+					node->CreateValueInt(ValueID::ValueGenre_Config, GetCommandClassId(), 1, _param, name, "", param.m_readOnly, false, param.m_default, 0);
+				}
+
+				if (Internal::VC::Value* value = GetValue(1, _param))
+				{
+					if (value->GetID().GetType() == ValueID::ValueType_BitSet)
+					{
+						Internal::VC::ValueBitSet* vbs = static_cast<Internal::VC::ValueBitSet*>(value);
+						vbs->SetSize(param.m_size);
+						// The maximum of a bit field is the mask of the bits it uses
+						vbs->SetBitMask((uint32) param.m_max);
 					}
 					else
 					{
-						char label[16];
-						snprintf(label, 16, "Parameter #%hhu", parameter);
-
-						// Create a new value
-						if (Node* node = GetNodeUnsafe())
-						{
-							switch (size)
-							{
-								case 1:
-								{
-									node->CreateValueByte(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, parameter, label, "", false, false, (uint8) paramValue, 0);
-									break;
-								}
-								case 2:
-								{
-									node->CreateValueShort(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, parameter, label, "", false, false, (int16) paramValue, 0);
-									break;
-								}
-								case 4:
-								{
-									node->CreateValueInt(ValueID::ValueGenre_Config, GetCommandClassId(), _instance, parameter, label, "", false, false, (int32) paramValue, 0);
-									break;
-								}
-								default:
-								{
-									Log::Write(LogLevel_Info, GetNodeId(), "Invalid size of %d bytes for configuration parameter %d", size, parameter);
-								}
-							}
-						}
+						value->SetMin(param.m_min);
+						value->SetMax(param.m_max);
+					}
+					if (!param.m_info.empty())
+					{
+						value->SetHelp(param.m_info);
 					}
+					value->Release();
+				}
+			}
 
-					Log::Write(LogLevel_Info, GetNodeId(), "Received Configuration report: Parameter=%d, Value=%d", parameter, paramValue);
-					return true;
+//-----------------------------------------------------------------------------
+// <Configuration::DiscoverNext>
+// Move on to the next parameter, or finish the discovery
+//-----------------------------------------------------------------------------
+			void Configuration::DiscoverNext(uint16 const _param)
+			{
+				// The device lists its parameters in increasing order, and 0 marks the end
+				if (m_nextParam > _param)
+				{
+					RequestProperties(m_nextParam, Driver::MsgQueue_Send);
+					return;
 				}
 
-				return false;
+				Log::Write(LogLevel_Info, GetNodeId(), "Found %d configuration parameters", (int) m_params.size());
+				m_dom.SetFlagBool(STATE_FLAG_CONFIG_DISCOVERED, true);
+
+				// Values of parameters we have just created are only defaults so far
+				vector<uint16> params;
+				for (map<uint16, Param>::const_iterator it = m_params.begin(); it != m_params.end(); ++it)
+				{
+					params.push_back(it->first);
+				}
+				RequestParams(params, 0, Driver::MsgQueue_Query);
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::RequestProperties>
+// Ask a version 3+ device to describe a parameter
+//-----------------------------------------------------------------------------
+			void Configuration::RequestProperties(uint16 const _param, Driver::MsgQueue const _queue)
+			{
+				Msg* msg = new Msg("ConfigurationCmd_PropertiesGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+				msg->Append(GetNodeId());
+				msg->Append(4);
+				msg->Append(GetCommandClassId());
+				msg->Append(ConfigurationCmd_PropertiesGet);
+				msg->Append((_param >> 8) & 0xFF);
+				msg->Append(_param & 0xFF);
+				msg->Append(GetDriver()->GetTransmitOptions());
+				GetDriver()->SendMsg(msg, _queue);
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::RequestText>
+// Ask for the name or description of a parameter
+//-----------------------------------------------------------------------------
+			void Configuration::RequestText(uint8 const _command, uint16 const _param)
+			{
+				Msg* msg = new Msg(_command == ConfigurationCmd_NameGet ? "ConfigurationCmd_NameGet" : "ConfigurationCmd_InfoGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+				msg->Append(GetNodeId());
+				msg->Append(4);
+				msg->Append(GetCommandClassId());
+				msg->Append(_command);
+				msg->Append((_param >> 8) & 0xFF);
+				msg->Append(_param & 0xFF);
+				msg->Append(GetDriver()->GetTransmitOptions());
+				GetDriver()->SendMsg(msg, Driver::MsgQueue_Send);
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::GetParamSize>
+// The size the device uses for a parameter, if it has told us
+//-----------------------------------------------------------------------------
+			uint8 Configuration::GetParamSize(uint16 const _param, uint8 const _default) const
+			{
+				map<uint16, Param>::const_iterator it = m_params.find(_param);
+				if (it != m_params.end())
+				{
+					return it->second.m_size;
+				}
+				return _default;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::GetBulkSize>
+// The size of a parameter that can be read with Bulk Get, or 0
+//-----------------------------------------------------------------------------
+			uint8 Configuration::GetBulkSize(uint16 const _param) const
+			{
+				map<uint16, Param>::const_iterator it = m_params.find(_param);
+				if ((it != m_params.end()) && !it->second.m_noBulk)
+				{
+					return it->second.m_size;
+				}
+				return 0;
 			}
 
 //-----------------------------------------------------------------------------
@@ -172,44 +634,44 @@ namespace OpenZWave
 					case ValueID::ValueType_BitSet:
 					{
 						Internal::VC::ValueBitSet const& vbs = static_cast<Internal::VC::ValueBitSet const&>(_value);
-						Set(param, (int32) vbs.GetValue(), vbs.GetSize());
+						Set(param, (int32) vbs.GetValue(), GetParamSize(param, vbs.GetSize()));
 						return true;
 					}
 					case ValueID::ValueType_Bool:
 					{
 						Internal::VC::ValueBool const& valueBool = static_cast<Internal::VC::ValueBool const&>(_value);
-						Set(param, (int32) valueBool.GetValue(), 1);
+						Set(param, (int32) valueBool.GetValue(), GetParamSize(param, 1));
 						return true;
 					}
 					case ValueID::ValueType_Byte:
 					{
 						Internal::VC::ValueByte const& valueByte = static_cast<Internal::VC::ValueByte const&>(_value);
-						Set(param, (int32) valueByte.GetValue(), 1);
+						Set(param, (int32) valueByte.GetValue(), GetParamSize(param, 1));
 						return true;
 					}
 					case ValueID::ValueType_Short:
 					{
 						Internal::VC::ValueShort const& valueShort = static_cast<Internal::VC::ValueShort const&>(_value);
-						Set(param, (int32) valueShort.GetValue(), 2);
+						Set(param, (int32) valueShort.GetValue(), GetParamSize(param, 2));
 						return true;
 					}
 					case ValueID::ValueType_Int:
 					{
 						Internal::VC::ValueInt const& valueInt = static_cast<Internal::VC::ValueInt const&>(_value);
-						Set(param, valueInt.GetValue(), 4);
+						Set(param, valueInt.GetValue(), GetParamSize(param, 4));
 						return true;
 					}
 					case ValueID::ValueType_List:
 					{
 						Internal::VC::ValueList const& valueList = static_cast<Internal::VC::ValueList const&>(_value);
 						if (valueList.GetItem() != NULL)
-							Set(param, valueList.GetItem()->m_value, valueList.GetSize());
+							Set(param, valueList.GetItem()->m_value, GetParamSize(param, valueList.GetSize()));
 						return true;
 					}
 					case ValueID::ValueType_Button:
 					{
 						Internal::VC::ValueButton const& valueButton = static_cast<Internal::VC::ValueButton const&>(_value);
-						Set(param, valueButton.IsPressed(), 1);
+						Set(param, valueButton.IsPressed(), GetParamSize(param, 1));
 						return true;
 					}
 					default:
@@ -235,6 +697,17 @@ namespace OpenZWave
 				}
 				if (m_com.GetFlagBool(COMPAT_FLAG_GETSUPPORTED))
 				{
+					if (_parameter > 0xFF)
+					{
+						// Configuration Get only has room for an 8 bit parameter number
+						if (GetVersion() < 2)
+						{
+							Log::Write(LogLevel_Warning, GetNodeId(), "Configuration parameter %d can only be read with Bulk Get, which version %d devices do not support", _parameter, GetVersion());
+							return false;
+						}
+						RequestBulk(_parameter, 1, _queue);
+						return true;
+					}
 					Msg* msg = new Msg("ConfigurationCmd_Get", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
 					msg->Append(GetNodeId());
 					msg->Append(3);
@@ -251,6 +724,69 @@ namespace OpenZWave
 				}
 				return false;
 			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::RequestParams>
+// Request several parameters, using Bulk Get for runs of same sized parameters
+//-----------------------------------------------------------------------------
+			bool Configuration::RequestParams(vector<uint16> const& _params, uint32 const _requestFlags, Driver::MsgQueue const _queue)
+			{
+				if (!m_com.GetFlagBool(COMPAT_FLAG_GETSUPPORTED))
+				{
+					Log::Write(LogLevel_Info, GetNodeId(), "ConfigurationCmd_Get Not Supported on this node");
+					return false;
+				}
+
+				vector<uint16> params(_params);
+				sort(params.begin(), params.end());
+
+				bool res = false;
+				size_t i = 0;
+				while (i < params.size())
+				{
+					uint16 first = params[i];
+					uint8 size = (GetVersion() >= 3) ? GetBulkSize(first) : 0;
+					uint8 count = 1;
+					if (size != 0)
+					{
+						while ((count < c_maxBulkParams) && (i + count < params.size()) && (params[i + count] == first + count) && (GetBulkSize(params[i + count]) == size))
+						{
+							++count;
+						}
+					}
+
+					if (count == 1)
+					{
+						res |= RequestValue(_requestFlags, first, 1, _queue);
+					}
+					else
+					{
+						RequestBulk(first, count, _queue);
+						res = true;
+					}
+					i += count;
+				}
+				return res;
+			}
+
+//-----------------------------------------------------------------------------
+// <Configuration::RequestBulk>
+// Request a run of consecutive parameters with one Bulk Get
+//-----------------------------------------------------------------------------
+			void Configuration::RequestBulk(uint16 const _first, uint8 const _count, Driver::MsgQueue const _queue)
+			{
+				Msg* msg = new Msg("ConfigurationCmd_BulkGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+				msg->Append(GetNodeId());
+				msg->Append(5);
+				msg->Append(GetCommandClassId());
+				msg->Append(ConfigurationCmd_BulkGet);
+				msg->Append((_first >> 8) & 0xFF);
+				msg->Append(_first & 0xFF);
+				msg->Append(_count);
+				msg->Append(GetDriver()->GetTransmitOptions());
+				GetDriver()->SendMsg(msg, _queue);
+			}
+
 //-----------------------------------------------------------------------------
 // <Configuration::Set>
 // Set the device's
@@ -259,12 +795,34 @@ namespace OpenZWave
 			{
 				Log::Write(LogLevel_Info, GetNodeId(), "Configuration::Set - Parameter=%d, Value=%d Size=%d", _parameter, _value, _size);
 
-				Msg* msg = new Msg("ConfigurationCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+				// Configuration Set only has room for an 8 bit parameter number
+				bool bulk = (_parameter > 0xFF);
+				if (bulk && (GetVersion() < 2))
+				{
+					Log::Write(LogLevel_Warning, GetNodeId(), "Configuration parameter %d can only be set with Bulk Set, which version %d devices do not support", _parameter, GetVersion());
+					return;
+				}
+
+				Msg* msg = new Msg(bulk ? "ConfigurationCmd_BulkSet" : "ConfigurationCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+				SuperviseSet(msg, _parameter);
 				msg->Append(GetNodeId());
-				msg->Append(4 + _size);
-				msg->Append(GetCommandClassId());
-				msg->Append(ConfigurationCmd_Set);
-				msg->Append((_parameter & 0xFF));
+				if (bulk)
+				{
+					msg->Append(6 + _size);
+					msg->Append(GetCommandClassId());
+					msg->Append(ConfigurationCmd_BulkSet);
+					msg->Append((_parameter >> 8) & 0xFF);
+					msg->Append(_parameter & 0xFF);
+					msg->Append(1);
+				}
+				else
+				{
+					msg->Append(4 + _size);
+					msg->Append(GetCommandClassId());
+					msg->Append(ConfigurationCmd_Set);
+					msg->Append((_parameter & 0xFF));
+				}
+				// For Bulk Set the Default and Handshake flags share this byte, and are left clear
 				msg->Append(_size);
 				if (_size > 2)
 				{
@@ -29,6 +29,8 @@
 #define _Configuration_H
 
 #include <list>
+#include <map>
+#include <vector>
 #include "command_classes/CommandClass.h"
 
 namespace OpenZWave
@@ -63,7 +65,11 @@ namespace OpenZWave
 						return "COMMAND_CLASS_CONFIGURATION";
 					}
 
+					virtual void ReadXML(TiXmlElement const* _ccElement) override;
+					virtual void WriteXML(TiXmlElement* _ccElement) override;
+					virtual bool RequestState(uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue) override;
 					virtual bool RequestValue(uint32 const _requestFlags, uint16 const _parameter, uint8 const _index, Driver::MsgQueue const _queue) override;
+					bool RequestParams(vector<uint16> const& _params, uint32 const _requestFlags, Driver::MsgQueue const _queue);
 					void Set(uint16 const _parameter, int32 const _value, uint8 const _size);
 
 					// From CommandClass
@@ -77,12 +83,53 @@ namespace OpenZWave
 					}
 					virtual bool HandleMsg(uint8 const* _data, uint32 const _length, uint32 const _instance = 1) override;
 					virtual bool SetValue(Internal::VC::Value const& _value) override;
-
-				private:
-					Configuration(uint32 const _homeId, uint8 const _nodeId) :
-							CommandClass(_homeId, _nodeId)
+					virtual uint8 GetMaxVersion() override
 					{
+						return 4;
 					}
+
+					/** What a version 3+ device told us about one of its parameters */
+					struct Param
+					{
+							uint8 m_size;
+							uint8 m_format;
+							int32 m_min;
+							int32 m_max;
+							int32 m_default;
+							bool m_readOnly;
+							bool m_advanced;
+							bool m_noBulk;
+							string m_name;
+							string m_info;
+					};
+
+					/**
+					 * Decode a Properties Report.  Unsigned 4 byte ranges are clamped to
+					 * what a ValueInt can hold.  Returns false if the report is truncated
+					 * or has an invalid size.
+					 */
+					static bool ParseProperties(uint8 const* _data, uint32 const _length, uint16* o_param, Param* o_props, uint16* o_nextParam);
+					/**
+					 * Decode a Bulk Report into the first parameter, the size of the
+					 * parameters and their (not sign extended) values.  Returns false if
+					 * the size is invalid.
+					 */
+					static bool ParseBulkReport(uint8 const* _data, uint32 const _length, uint16* o_offset, uint8* o_size, vector<int32>* o_values);
+
+				private:
+					Configuration(uint32 const _homeId, uint8 const _nodeId);
+
+					void RequestBulk(uint16 const _first, uint8 const _count, Driver::MsgQueue const _queue);
+					void RequestProperties(uint16 const _param, Driver::MsgQueue const _queue);
+					void RequestText(uint8 const _command, uint16 const _param);
+					void CreateParamValue(uint16 const _param);
+					void DiscoverNext(uint16 const _param);
+					void HandleParamValue(uint16 const _param, uint8 const _size, int32 _paramValue, uint32 const _instance);
+					uint8 GetParamSize(uint16 const _param, uint8 const _default) const;
+					uint8 GetBulkSize(uint16 const _param) const;
+
+					map<uint16, Param> m_params;		// Parameters found by asking the device for their properties
+					uint16 m_nextParam;					// The parameter to ask about once the current one is done
 			};
 		} // namespace CC
 	} // namespace Internal
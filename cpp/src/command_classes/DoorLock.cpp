@@ -256,6 +256,7 @@ namespace OpenZWave
 					Log::Write(LogLevel_Info, GetNodeId(), "ValueID_Index_DoorLock::Lock::Set - Requesting lock to be %s", value->GetValue() ? "Locked" : "Unlocked");
 					Msg* msg = new Msg("DoorLockCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
 					msg->SetInstance(this, _value.GetID().GetInstance());
+					SuperviseSet(msg, _value.GetID().GetIndex());
 					msg->Append(GetNodeId());
 					msg->Append(3);
 					msg->Append(GetCommandClassId());
@@ -275,6 +276,7 @@ namespace OpenZWave
 					Log::Write(LogLevel_Info, GetNodeId(), "ValueID_Index_DoorLock::Lock_Mode::Set - Requesting lock to be %s", item->m_label.c_str());
 					Msg* msg = new Msg("DoorLockCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
 					msg->SetInstance(this, _value.GetID().GetInstance());
+					SuperviseSet(msg, _value.GetID().GetIndex());
 					msg->Append(GetNodeId());
 					msg->Append(3);
 					msg->Append(GetCommandClassId());
@@ -461,6 +461,7 @@ enum Indicator_Property_offset {
 					Log::Write(LogLevel_Info, GetNodeId(), "Indicator::SetValue - Setting indicator to %d", value->GetValue());
 					Msg* msg = new Msg("IndicatorCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 					msg->SetInstance(this, _value.GetID().GetInstance());
+					SuperviseSet(msg, _value.GetID().GetIndex());
 					msg->Append(GetNodeId());
 					msg->Append(3);
 					msg->Append(GetCommandClassId());
@@ -485,6 +486,7 @@ enum Indicator_Property_offset {
 								/* turn off any indicator */
 								Msg* msg = new Msg("IndicatorCmd_Set_v2", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 								msg->SetInstance(this, _value.GetID().GetInstance());
+								SuperviseSet(msg, index);
 								msg->Append(GetNodeId());
 								msg->Append(3);
 								msg->Append(GetCommandClassId());
@@ -591,6 +593,7 @@ enum Indicator_Property_offset {
 					}
 					Msg* msg = new Msg("IndicatorCmd_Set_v2", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 					msg->SetInstance(this, _value.GetID().GetInstance());
+					SuperviseSet(msg, index);
 					msg->Append(GetNodeId());
 					msg->Append(3 + payload.size());
 					msg->Append(GetCommandClassId());
@@ -33,6 +33,7 @@
 #include "Msg.h"
 #include "Node.h"
 #include "Options.h"
+#include "ConfigBundle.h"
 #include "Manager.h"
 #include "Driver.h"
 #include "ManufacturerSpecificDB.h"
@@ -274,7 +275,7 @@ namespace OpenZWave
 
 				TiXmlDocument* doc = new TiXmlDocument();
 				Log::Write(LogLevel_Info, GetNodeId(), "  Opening config param file %s", filename.c_str());
-				if (!doc->LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+				if (!ConfigBundle::LoadXML(doc, GetNodeUnsafe()->getConfigPath()))
 				{
 					delete doc;
 					Log::Write(LogLevel_Info, GetNodeId(), "Unable to find or load Config Param file %s", filename.c_str());
@@ -93,6 +93,7 @@ namespace OpenZWave
 
 							if (CommandClass *pCommandClass = node->GetCommandClass(commandClassId))
 							{
+								HandlerProfile profile(pCommandClass);
 								if (!pCommandClass->IsAfterMark())
 									pCommandClass->HandleMsg(&_data[base + 2], length - 1);
 								else
@@ -108,6 +109,45 @@ namespace OpenZWave
 				}
 				return false;
 			}
+
+//-----------------------------------------------------------------------------
+// <MultiCmd::EncapsulatedSize>
+// Length byte plus the command itself
+//-----------------------------------------------------------------------------
+			uint32 MultiCmd::EncapsulatedSize(Msg const* _msg)
+			{
+				return 1 + _msg->GetPayloadLength();
+			}
+
+//-----------------------------------------------------------------------------
+// <MultiCmd::Encapsulate>
+// Combine the commands of several requests into one Multi Command frame
+//-----------------------------------------------------------------------------
+			Msg* MultiCmd::Encapsulate(std::list<Msg*> const& _msgs)
+			{
+				Msg const* first = _msgs.front();
+				uint32 length = 3;
+				for (std::list<Msg*>::const_iterator it = _msgs.begin(); it != _msgs.end(); ++it)
+				{
+					length += EncapsulatedSize(*it);
+				}
+
+				char str[64];
+				snprintf(str, sizeof(str), "MultiCmd Encapsulated (%d commands)", (int) _msgs.size());
+				Msg* msg = new Msg(str, first->GetTargetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, StaticGetCommandClassId());
+				msg->Append(first->GetTargetNodeId());
+				msg->Append((uint8) length);
+				msg->Append(StaticGetCommandClassId());
+				msg->Append(MultiCmdCmd_Encap);
+				msg->Append((uint8) _msgs.size());
+				for (std::list<Msg*>::const_iterator it = _msgs.begin(); it != _msgs.end(); ++it)
+				{
+					msg->Append((*it)->GetPayloadLength());
+					msg->AppendArray((*it)->GetPayload(), (*it)->GetPayloadLength());
+				}
+				msg->Append(first->GetTransmitOptions());
+				return msg;
+			}
 		} // namespace CC
 	} // namespace Internal
 } // namespace OpenZWave
@@ -28,6 +28,7 @@
 #ifndef _MultiCmd_H
 #define _MultiCmd_H
 
+#include <list>
 #include "command_classes/CommandClass.h"
 
 namespace OpenZWave
@@ -48,6 +49,9 @@ namespace OpenZWave
 						MultiCmdCmd_Encap = 0x01
 					};
 
+					// Largest payload we put in a single encapsulated frame (the singlecast limit without Security)
+					static uint8 const c_maxEncapPayload = 46;
+
 					static CommandClass* Create(uint32 const _homeId, uint8 const _nodeId)
 					{
 						return new MultiCmd(_homeId, _nodeId);
@@ -76,6 +80,18 @@ namespace OpenZWave
 					}
 					virtual bool HandleMsg(uint8 const* _data, uint32 const _length, uint32 const _instance = 1) override;
 
+					/**
+					 * Build a single Multi Command encapsulated frame carrying the commands of
+					 * several SendData requests to the same node.  The requests themselves are
+					 * left untouched, so they can still be sent on their own if the node does
+					 * not answer the combined frame.
+					 */
+					static Msg* Encapsulate(std::list<Msg*> const& _msgs);
+					/**
+					 * The size the encapsulated frame grows by when a request is added to it.
+					 */
+					static uint32 EncapsulatedSize(Msg const* _msg);
+
 				private:
 					MultiCmd(uint32 const _homeId, uint8 const _nodeId) :
 							CommandClass(_homeId, _nodeId)
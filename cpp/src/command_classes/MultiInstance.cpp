@@ -236,6 +236,7 @@ namespace OpenZWave
 					{
 						Log::Write(LogLevel_Info, GetNodeId(), "Received a MultiInstanceEncap from node %d, instance %d, for Command Class %s", GetNodeId(), instance, pCommandClass->GetCommandClassName().c_str());
 						pCommandClass->ReceivedCntIncr();
+						HandlerProfile profile(pCommandClass);
 						pCommandClass->HandleMsg(&_data[3], _length - 3, instance);
 					}
 					else
@@ -604,6 +605,7 @@ namespace OpenZWave
 					uint8 commandClassId = _data[3];
 					if (CommandClass* pCommandClass = node->GetCommandClass(commandClassId))
 					{
+						HandlerProfile profile(pCommandClass);
 						/* 4.85.13 - If the Root Device is originating a command to an End Point in another node, the Source End Point MUST be set to 0.
 						 *
 						 */
@@ -254,6 +254,7 @@ namespace OpenZWave
 							return false;
 						Msg* msg = new Msg("SoundSwitchCmd_Tones_Play_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
 						msg->SetInstance(this, instance);
+						SuperviseSet(msg, index);
 						msg->Append(GetNodeId());
 						msg->Append(3);
 						msg->Append(GetCommandClassId());
@@ -276,6 +277,7 @@ namespace OpenZWave
 					}
 					Msg* msg = new Msg("SoundSwitchCmd_Tones_Config_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 					msg->SetInstance(this, instance);
+					SuperviseSet(msg, index);
 					msg->Append(GetNodeId());
 					msg->Append(4);
 					msg->Append(GetCommandClassId());
@@ -300,6 +302,7 @@ namespace OpenZWave
 					}
 					Msg* msg = new Msg("SoundSwitchCmd_Tones_Config_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 					msg->SetInstance(this, instance);
+					SuperviseSet(msg, index);
 					msg->Append(GetNodeId());
 					msg->Append(4);
 					msg->Append(GetCommandClassId());
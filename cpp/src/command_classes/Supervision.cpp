@@ -41,7 +41,7 @@ namespace OpenZWave
 	{
 		namespace CC
 		{
-			uint8 Supervision::CreateSupervisionSession(uint8 _command_class_id, uint8 _index)
+			uint8 Supervision::CreateSupervisionSession(uint8 _command_class_id, uint16 _index)
 			{
 				m_last_session_id++;
 				m_last_session_id &= 0x3f;
@@ -113,6 +113,10 @@ namespace OpenZWave
 									{
 										pCommandClass->SupervisionSessionSuccess(session_id, _instance);
 									}
+									else if ((status == SupervisionStatus::SupervisionStatus_Fail) || (status == SupervisionStatus::SupervisionStatus_NoSupport))
+									{
+										pCommandClass->SupervisionSessionFailure(session_id, _instance);
+									}
 								}
 								else
 								{
@@ -79,7 +79,7 @@ namespace OpenZWave
 						return "COMMAND_CLASS_SUPERVISION";
 					}
 
-					uint8 CreateSupervisionSession(uint8 _command_class_id, uint8 _index);
+					uint8 CreateSupervisionSession(uint8 _command_class_id, uint16 _index);
 					static uint8 const StaticNoSessionId()
 					{
 						return 0xff; // As sessions are only 5 bits, this value will never match
@@ -112,7 +112,7 @@ namespace OpenZWave
 					struct s_Session {
 						uint8 session_id;
 						uint8 command_class_id;
-						uint8 index;
+						uint16 index;
 					};
 					std::deque<s_Session> m_sessions;
 					uint8 m_last_session_id;
@@ -30,7 +30,6 @@
 #include "command_classes/CommandClasses.h"
 #include "command_classes/SwitchBinary.h"
 #include "command_classes/WakeUp.h"
-#include "command_classes/Supervision.h"
 #include "Defs.h"
 #include "Msg.h"
 #include "Driver.h"
@@ -140,29 +139,6 @@ namespace OpenZWave
 
 				return false;
 			}
-			
-			void SwitchBinary::SupervisionSessionSuccess(uint8 _session_id, uint32 const _instance)
-			{
-				if (Node* node = GetNodeUnsafe())
-				{			
-					uint32 index = node->GetSupervisionIndex(_session_id);
-
-					if (index != Internal::CC::Supervision::StaticNoIndex())
-					{
-						if (Internal::VC::ValueBool* value = static_cast<Internal::VC::ValueBool*>(GetValue(_instance, index)))
-						{
-							value->ConfirmNewValue();
-
-							Log::Write(LogLevel_Info, GetNodeId(), "Confirmed switch binary index %d to value=%s",
-								index, value->GetValue() ? "On" : "Off");
-						}
-					}
-					else
-					{
-						Log::Write(LogLevel_Info, GetNodeId(), "Ignore unknown supervision session %d", _session_id);
-					}
-				}
-			}
 
 //-----------------------------------------------------------------------------
 // <SwitchBinary::SetValue>
@@ -237,20 +213,12 @@ namespace OpenZWave
 				uint8 const nodeId = GetNodeId();
 				uint8 const targetValue = _state ? 0xff : 0;
 				
-				if (Node* node = GetNodeUnsafe())
+				if (GetNodeUnsafe())
 				{
-					//add supervision encapsulation if supported
-					uint8 index = ValueID_Index_SwitchBinary::Level;
-					uint8 supervision_session_id = node->CreateSupervisionSession(StaticGetCommandClassId(), index);
-					if (supervision_session_id == Internal::CC::Supervision::StaticNoSessionId())
-					{
-						Log::Write(LogLevel_Debug, GetNodeId(), "Supervision not supported, fall back to setpoint set/get");
-					}
-
 					Log::Write(LogLevel_Info, nodeId, "SwitchBinary::Set - Setting to %s", _state ? "On" : "Off");
 					Msg* msg = new Msg("SwitchBinaryCmd_Set", nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 					msg->SetInstance(this, _instance);
-					msg->SetSupervision(supervision_session_id);
+					SuperviseSet(msg, ValueID_Index_SwitchBinary::Level);
 					msg->Append(nodeId);
 
 					if (GetVersion() >= 2)
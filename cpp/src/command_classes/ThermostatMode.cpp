@@ -26,7 +26,6 @@
 //-----------------------------------------------------------------------------
 
 #include "command_classes/CommandClasses.h"
-#include "command_classes/Supervision.h"
 #include "command_classes/ThermostatMode.h"
 #include "Defs.h"
 #include "Msg.h"
@@ -345,30 +344,14 @@ namespace OpenZWave
 
 			void ThermostatMode::SupervisionSessionSuccess(uint8 _session_id, uint32 const _instance)
 			{
-				if (Node* node = GetNodeUnsafe())
+				CommandClass::SupervisionSessionSuccess(_session_id, _instance);
+				if (Internal::VC::ValueList* valueList = static_cast<Internal::VC::ValueList*>(GetValue(_instance, ValueID_Index_ThermostatMode::Mode)))
 				{
-					uint32 index = node->GetSupervisionIndex(_session_id);
-
-					if (index != Internal::CC::Supervision::StaticNoIndex())
-					{
-						// We have received the confirmation for the thermostat mode from the Z-Wave device
-						if (Internal::VC::ValueList* valueList = static_cast<Internal::VC::ValueList*>(GetValue(_instance, ValueID_Index_ThermostatMode::Mode)))
-						{
-							valueList->ConfirmNewValue();
-							if (valueList->GetItem())
-							{
-								Log::Write(LogLevel_Info, GetNodeId(), "Confirmed thermostat mode: %s", valueList->GetItem()->m_label.c_str());
-								m_currentMode = valueList->GetItem()->m_value;
-							}
-							else
-								Log::Write(LogLevel_Warning, GetNodeId(), "Confirmed thermostat mode (No Item)");
-							valueList->Release();
-						}
-					}
-					else
+					if (valueList->GetItem())
 					{
-						Log::Write(LogLevel_Info, GetNodeId(), "Ignore unknown supervision session %d", _session_id);
+						m_currentMode = valueList->GetItem()->m_value;
 					}
+					valueList->Release();
 				}
 			}
 
@@ -379,7 +362,7 @@ namespace OpenZWave
 			bool ThermostatMode::SetValue(Internal::VC::Value const& _value)
 			{
 
-				if (Node* node = GetNodeUnsafe())
+				if (GetNodeUnsafe())
 				{
 					if (ValueID::ValueType_List == _value.GetID().GetType())
 					{
@@ -388,16 +371,9 @@ namespace OpenZWave
 							return false;
 						uint8 state = (uint8)value->GetItem()->m_value;
 
-						uint8 index = value->GetID().GetIndex() & 0xFF;
-						uint8 supervision_session_id = node->CreateSupervisionSession(StaticGetCommandClassId(), index);
-						if (supervision_session_id == Internal::CC::Supervision::StaticNoSessionId())
-						{
-							Log::Write(LogLevel_Debug, GetNodeId(), "Supervision not supported, fall back to setpoint set/get");
-						}
-
 						Msg* msg = new Msg("ThermostatModeCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true);
 						msg->SetInstance(this, _value.GetID().GetInstance());
-						msg->SetSupervision(supervision_session_id);
+						SuperviseSet(msg, value->GetID().GetIndex());
 						msg->Append(GetNodeId());
 						msg->Append(3);
 						msg->Append(GetCommandClassId());
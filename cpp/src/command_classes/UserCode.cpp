@@ -50,9 +50,18 @@ namespace OpenZWave
 				UserCodeCmd_Get = 0x02,
 				UserCodeCmd_Report = 0x03,
 				UserNumberCmd_Get = 0x04,
-				UserNumberCmd_Report = 0x05
+				UserNumberCmd_Report = 0x05,
+				UserCodeCmd_CapabilitiesGet = 0x06,
+				UserCodeCmd_CapabilitiesReport = 0x07,
+				UserCodeCmd_ExtendedGet = 0x0C,
+				UserCodeCmd_ExtendedReport = 0x0D,
+				UserCodeCmd_ChecksumGet = 0x11,
+				UserCodeCmd_ChecksumReport = 0x12
 			};
 
+			// Slots above this would clash with the Refresh, RemoveCode and Count value indexes
+			static uint16 const c_maxUserCodes = ValueID_Index_UserCode::Refresh - 1;
+
 //-----------------------------------------------------------------------------
 // <UserCode::UserCode>
 // Constructor
@@ -62,14 +71,76 @@ namespace OpenZWave
 			{
 				m_com.EnableFlag(COMPAT_FLAG_UC_EXPOSERAWVALUE, false);
 				m_dom.EnableFlag(STATE_FLAG_USERCODE_COUNT, 0);
+				m_dom.EnableFlag(STATE_FLAG_USERCODE_CHECKSUM, false);
 				SetStaticRequest(StaticRequest_Values);
 				Options::Get()->GetOptionAsBool("RefreshAllUserCodes", &m_refreshUserCodes);
 
 			}
 
+//-----------------------------------------------------------------------------
+// <UserCode::ReadXML>
+// Read the cached user code table
+//-----------------------------------------------------------------------------
+			void UserCode::ReadXML(TiXmlElement const* _ccElement)
+			{
+				CommandClass::ReadXML(_ccElement);
+
+				TiXmlElement const* child = _ccElement->FirstChildElement("Slot");
+				while (child)
+				{
+					int index;
+					int status;
+					if (TIXML_SUCCESS == child->QueryIntAttribute("index", &index) && TIXML_SUCCESS == child->QueryIntAttribute("status", &status))
+					{
+						UserCodeEntry& entry = m_userCode[(uint16) index];
+						memset(&entry, 0, sizeof(entry));
+						entry.status = (UserCodeStatus) status;
+						// The code is stored as hex, as it does not have to be printable
+						if (char const* code = child->Attribute("code"))
+						{
+							for (size_t i = 0; (i < 10) && code[2 * i] && code[2 * i + 1]; ++i)
+							{
+								char hex[3] = { code[2 * i], code[2 * i + 1], 0 };
+								entry.usercode[i] = (uint8) strtol(hex, NULL, 16);
+								entry.length = (uint8) (i + 1);
+							}
+						}
+					}
+					child = child->NextSiblingElement("Slot");
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <UserCode::WriteXML>
+// Save the slots that are in use, so the table can be checked against the lock's checksum
+//-----------------------------------------------------------------------------
+			void UserCode::WriteXML(TiXmlElement* _ccElement)
+			{
+				CommandClass::WriteXML(_ccElement);
+
+				for (std::map<uint16, UserCodeEntry>::const_iterator it = m_userCode.begin(); it != m_userCode.end(); ++it)
+				{
+					if ((it->first == 0) || (it->second.status == UserCode_Available))
+					{
+						continue;
+					}
+					TiXmlElement* slotElement = new TiXmlElement("Slot");
+					_ccElement->LinkEndChild(slotElement);
+					slotElement->SetAttribute("index", it->first);
+					slotElement->SetAttribute("status", it->second.status);
+					char code[21];
+					code[0] = 0;
+					for (uint8 i = 0; (i < it->second.length) && (i < 10); ++i)
+					{
+						snprintf(&code[2 * i], 3, "%.2x", it->second.usercode[i]);
+					}
+					slotElement->SetAttribute("code", code);
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <UserCode::RequestState>
-// Nothing to do for UserCode
+// Request the number of codes, and the codes themselves
 //-----------------------------------------------------------------------------
 			bool UserCode::RequestState(uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue)
 			{
@@ -77,21 +148,181 @@ namespace OpenZWave
 				if ((_requestFlags & RequestFlag_Static) && HasStaticRequest(StaticRequest_Values))
 				{
 					requests |= RequestValue(_requestFlags, ValueID_Index_UserCode::Count, _instance, _queue);
+					if ((GetVersion() >= 2) && m_com.GetFlagBool(COMPAT_FLAG_GETSUPPORTED))
+					{
+						// Find out if the lock can give us a checksum of its codes
+						Msg* msg = new Msg("UserCodeCmd_CapabilitiesGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+						msg->Append(GetNodeId());
+						msg->Append(2);
+						msg->Append(GetCommandClassId());
+						msg->Append(UserCodeCmd_CapabilitiesGet);
+						msg->Append(GetDriver()->GetTransmitOptions());
+						GetDriver()->SendMsg(msg, _queue);
+					}
 				}
 
 				if (_requestFlags & RequestFlag_Session)
 				{
 					if (m_dom.GetFlagByte(STATE_FLAG_USERCODE_COUNT) > 0)
 					{
-						m_queryAll = true;
-						m_currentCode = 1;
-						requests |= RequestValue(_requestFlags, m_currentCode, _instance, _queue);
+						if (m_dom.GetFlagBool(STATE_FLAG_USERCODE_CHECKSUM) && m_com.GetFlagBool(COMPAT_FLAG_GETSUPPORTED))
+						{
+							// Only read the codes if they differ from the ones we have
+							Msg* msg = new Msg("UserCodeCmd_ChecksumGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+							msg->Append(GetNodeId());
+							msg->Append(2);
+							msg->Append(GetCommandClassId());
+							msg->Append(UserCodeCmd_ChecksumGet);
+							msg->Append(GetDriver()->GetTransmitOptions());
+							GetDriver()->SendMsg(msg, _queue);
+							requests = true;
+						}
+						else
+						{
+							requests |= RefreshCodes(_instance, _queue);
+						}
 					}
 				}
 
 				return requests;
 			}
 
+//-----------------------------------------------------------------------------
+// <UserCode::RefreshCodes>
+// Start reading all the codes from the lock
+//-----------------------------------------------------------------------------
+			bool UserCode::RefreshCodes(uint8 const _instance, Driver::MsgQueue const _queue)
+			{
+				m_queryAll = true;
+				m_currentCode = 1;
+				if (GetVersion() >= 2)
+				{
+					return RequestCodes(m_currentCode, _instance, _queue);
+				}
+				return RequestValue(0, m_currentCode, _instance, _queue);
+			}
+
+//-----------------------------------------------------------------------------
+// <UserCode::RequestCodes>
+// Ask for as many codes as fit in a frame, starting at _first
+//-----------------------------------------------------------------------------
+			bool UserCode::RequestCodes(uint16 const _first, uint8 const _instance, Driver::MsgQueue const _queue)
+			{
+				if (_instance != 1)
+				{
+					// This command class doesn't work with multiple instances
+					return false;
+				}
+				if (!m_com.GetFlagBool(COMPAT_FLAG_GETSUPPORTED))
+				{
+					Log::Write(LogLevel_Info, GetNodeId(), "UserCodeCmd_ExtendedGet Not Supported on this node");
+					return false;
+				}
+				Msg* msg = new Msg("UserCodeCmd_ExtendedGet", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId());
+				msg->Append(GetNodeId());
+				msg->Append(5);
+				msg->Append(GetCommandClassId());
+				msg->Append(UserCodeCmd_ExtendedGet);
+				msg->Append((_first >> 8) & 0xFF);
+				msg->Append(_first & 0xFF);
+				msg->Append(0x01);		// Report More
+				msg->Append(GetDriver()->GetTransmitOptions());
+				GetDriver()->SendMsg(msg, _queue);
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+// <UserCode::StoreCode>
+// Update our copy of a slot and its value
+//-----------------------------------------------------------------------------
+			void UserCode::StoreCode(uint16 const _index, uint8 const _status, uint8 const* _code, uint8 const _length, uint32 const _instance)
+			{
+				uint8 size = _length;
+				if (size > 10)
+				{
+					Log::Write(LogLevel_Warning, GetNodeId(), "User Code length %d is larger then maximum 10", size);
+					size = 10;
+				}
+				m_userCode[_index].status = (UserCodeStatus) _status;
+				memset(&m_userCode[_index].usercode, 0, sizeof(m_userCode[_index].usercode));
+				memcpy(&m_userCode[_index].usercode, _code, size);
+				m_userCode[_index].length = size;
+				if (Internal::VC::ValueString* value = static_cast<Internal::VC::ValueString*>(GetValue(_instance, _index)))
+				{
+					string data;
+					/* Max UserCode Length is 10 */
+					Log::Write(LogLevel_Info, GetNodeId(), "User Code Packet is %d", size);
+					data.assign((const char*) _code, size);
+					value->OnValueRefreshed(data);
+					value->Release();
+				}
+				if (m_com.GetFlagBool(COMPAT_FLAG_UC_EXPOSERAWVALUE))
+				{
+					if (Internal::VC::ValueShort* value = static_cast<Internal::VC::ValueShort*>(GetValue(_instance, ValueID_Index_UserCode::RawValueIndex)))
+					{
+						value->OnValueRefreshed(_index);
+						value->Release();
+					}
+					if (Internal::VC::ValueRaw* value = static_cast<Internal::VC::ValueRaw*>(GetValue(_instance, ValueID_Index_UserCode::RawValue)))
+					{
+						value->OnValueRefreshed(_code, _length);
+						value->Release();
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <UserCode::ClearCode>
+// A slot the lock skipped over is not in use
+//-----------------------------------------------------------------------------
+			void UserCode::ClearCode(uint16 const _index, uint32 const _instance)
+			{
+				std::map<uint16, UserCodeEntry>::iterator it = m_userCode.find(_index);
+				if ((it == m_userCode.end()) || (it->second.status == UserCode_Available))
+				{
+					return;
+				}
+				memset(&it->second, 0, sizeof(it->second));
+				it->second.status = UserCode_Available;
+				if (Internal::VC::ValueString* value = static_cast<Internal::VC::ValueString*>(GetValue(_instance, _index)))
+				{
+					value->OnValueRefreshed("");
+					value->Release();
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <UserCode::Checksum>
+// CRC-CCITT of the slots in use, as the lock calculates it for User Code Checksum Report
+//-----------------------------------------------------------------------------
+			uint16 UserCode::Checksum()
+			{
+				bool used = false;
+				uint16 crc = 0x1D0F;
+				for (std::map<uint16, UserCodeEntry>::const_iterator it = m_userCode.begin(); it != m_userCode.end(); ++it)
+				{
+					UserCodeStatus status = it->second.status;
+					if ((it->first == 0) || (status == UserCode_Available) || (status == UserCode_NotAvailable) || (status == UserCode_Unset))
+					{
+						continue;
+					}
+					used = true;
+					uint8 data[13];
+					data[0] = (uint8) (it->first >> 8);
+					data[1] = (uint8) (it->first & 0xFF);
+					data[2] = (uint8) status;
+					memcpy(&data[3], it->second.usercode, it->second.length);
+					for (uint8 i = 0; i < 3 + it->second.length; ++i)
+					{
+						uint8 x = (crc >> 8) ^ data[i];
+						x ^= x >> 4;
+						crc = (crc << 8) ^ ((uint16) (x << 12)) ^ ((uint16) (x << 5)) ^ ((uint16) x);
+					}
+				}
+				// The checksum of an empty table is defined as 0
+				return used ? crc : 0;
+			}
+
 //-----------------------------------------------------------------------------
 // <UserCode::RequestValue>
 // Nothing to do for UserCode
@@ -150,20 +381,35 @@ namespace OpenZWave
 			{
 				if (UserNumberCmd_Report == (UserCodeCmd) _data[0])
 				{
-					m_dom.SetFlagByte(STATE_FLAG_USERCODE_COUNT, _data[1]);
+					uint16 count = _data[1];
+					if (_length >= 5)
+					{
+						// Version 2 adds a 16 bit count
+						uint16 extended = (_data[2] << 8) | _data[3];
+						if (extended > count)
+						{
+							count = extended;
+						}
+					}
+					if (count > c_maxUserCodes)
+					{
+						Log::Write(LogLevel_Warning, GetNodeId(), "Node supports %d User Codes, only the first %d are used", count, c_maxUserCodes);
+						count = c_maxUserCodes;
+					}
+					m_dom.SetFlagByte(STATE_FLAG_USERCODE_COUNT, (uint8) count);
 					ClearStaticRequest(StaticRequest_Values);
-					if (_data[1] == 0)
+					if (count == 0)
 					{
 						Log::Write(LogLevel_Info, GetNodeId(), "Received User Number report from node %d: Not supported", GetNodeId());
 					}
 					else
 					{
-						Log::Write(LogLevel_Info, GetNodeId(), "Received User Number report from node %d: Supported Codes %d (%d)", GetNodeId(), _data[1], _data[1]);
+						Log::Write(LogLevel_Info, GetNodeId(), "Received User Number report from node %d: Supported Codes %d (%d)", GetNodeId(), count, count);
 					}
 
 					if (Internal::VC::ValueShort* value = static_cast<Internal::VC::ValueShort*>(GetValue(_instance, ValueID_Index_UserCode::Count)))
 					{
-						value->OnValueRefreshed(_data[1]);
+						value->OnValueRefreshed(count);
 						value->Release();
 					}
 
@@ -185,6 +431,7 @@ namespace OpenZWave
 								node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, i, str, "", false, false, data, 0);
 							}
 							m_userCode[i].status = UserCode_Available;
+							m_userCode[i].length = 0;
 							/* silly compilers */
 							for (int j = 0; j < 10; j++)
 								m_userCode[i].usercode[j] = 0;
@@ -202,36 +449,7 @@ namespace OpenZWave
 					int i = _data[1];
 					Log::Write(LogLevel_Info, GetNodeId(), "Received User Code Report from node %d for User Code %d (%s)", GetNodeId(), i, CodeStatus(_data[2]).c_str());
 
-					int8 size = _length - 4;
-					if (size > 10)
-					{
-						Log::Write(LogLevel_Warning, GetNodeId(), "User Code length %d is larger then maximum 10", size);
-						size = 10;
-					}
-					m_userCode[i].status = (UserCodeStatus) _data[2];
-					memcpy(&m_userCode[i].usercode, &_data[3], size);
-					if (Internal::VC::ValueString* value = static_cast<Internal::VC::ValueString*>(GetValue(_instance, i)))
-					{
-						string data;
-						/* Max UserCode Length is 10 */
-						Log::Write(LogLevel_Info, GetNodeId(), "User Code Packet is %d", size);
-						data.assign((const char*) &_data[3], size);
-						value->OnValueRefreshed(data);
-						value->Release();
-					}
-					if (m_com.GetFlagBool(COMPAT_FLAG_UC_EXPOSERAWVALUE))
-					{
-						if (Internal::VC::ValueShort* value = static_cast<Internal::VC::ValueShort*>(GetValue(_instance, ValueID_Index_UserCode::RawValueIndex)))
-						{
-							value->OnValueRefreshed(i);
-							value->Release();
-						}
-						if (Internal::VC::ValueRaw* value = static_cast<Internal::VC::ValueRaw*>(GetValue(_instance, ValueID_Index_UserCode::RawValue)))
-						{
-							value->OnValueRefreshed(&_data[3], (_length - 4));
-							value->Release();
-						}
-					}
+					StoreCode(i, _data[2], &_data[3], _length - 4, _instance);
 
 					if (m_queryAll && i == m_currentCode)
 					{
@@ -258,6 +476,95 @@ namespace OpenZWave
 					}
 					return true;
 				}
+				else if (UserCodeCmd_ExtendedReport == (UserCodeCmd) _data[0])
+				{
+					uint8 count = _data[1];
+					uint32 pos = 2;
+					uint16 expected = m_currentCode;
+					uint16 last = 0;
+					for (uint8 c = 0; c < count; ++c)
+					{
+						if (pos + 4 > _length - 1)
+						{
+							break;
+						}
+						uint16 index = (_data[pos] << 8) | _data[pos + 1];
+						uint8 length = _data[pos + 3] & 0x0F;
+						if ((pos + 4 + length > _length - 1) || (index == 0) || (index > c_maxUserCodes))
+						{
+							break;
+						}
+						Log::Write(LogLevel_Info, GetNodeId(), "Received Extended User Code Report from node %d for User Code %d (%s)", GetNodeId(), index, CodeStatus(_data[pos + 2]).c_str());
+						if (m_queryAll)
+						{
+							// The lock only reports the slots that are in use
+							for (; expected < index; ++expected)
+							{
+								ClearCode(expected, _instance);
+							}
+							expected = index + 1;
+						}
+						StoreCode(index, _data[pos + 2], &_data[pos + 4], length, _instance);
+						last = index;
+						pos += 4 + length;
+					}
+					uint16 next = (pos + 2 <= _length - 1) ? ((_data[pos] << 8) | _data[pos + 1]) : 0;
+
+					if (m_queryAll)
+					{
+						uint16 max = m_dom.GetFlagByte(STATE_FLAG_USERCODE_COUNT);
+						if ((next > last) && (next <= max))
+						{
+							for (; expected < next; ++expected)
+							{
+								ClearCode(expected, _instance);
+							}
+							m_currentCode = next;
+							RequestCodes(m_currentCode, _instance, Driver::MsgQueue_Query);
+						}
+						else
+						{
+							for (; expected <= max; ++expected)
+							{
+								ClearCode(expected, _instance);
+							}
+							m_queryAll = false;
+							Options::Get()->GetOptionAsBool("RefreshAllUserCodes", &m_refreshUserCodes);
+						}
+					}
+					return true;
+				}
+				else if (UserCodeCmd_CapabilitiesReport == (UserCodeCmd) _data[0])
+				{
+					// Skip the supported status bit mask to get to the checksum support flag
+					uint32 pos = 2 + (_data[1] & 0x1F);
+					if (pos < _length - 1)
+					{
+						bool checksum = ((_data[pos] & 0x80) != 0);
+						m_dom.SetFlagBool(STATE_FLAG_USERCODE_CHECKSUM, checksum);
+						Log::Write(LogLevel_Info, GetNodeId(), "Received User Code Capabilities report from node %d: Checksum %s", GetNodeId(), checksum ? "supported" : "not supported");
+					}
+					return true;
+				}
+				else if (UserCodeCmd_ChecksumReport == (UserCodeCmd) _data[0])
+				{
+					if (_length < 4)
+					{
+						return false;
+					}
+					uint16 checksum = (_data[1] << 8) | _data[2];
+					uint16 ours = Checksum();
+					if (checksum == ours)
+					{
+						Log::Write(LogLevel_Info, GetNodeId(), "User Code checksum 0x%.4x matches our copy, not refreshing User Codes", checksum);
+					}
+					else
+					{
+						Log::Write(LogLevel_Info, GetNodeId(), "User Code checksum 0x%.4x does not match our copy (0x%.4x), refreshing User Codes", checksum, ours);
+						RefreshCodes((uint8) _instance, Driver::MsgQueue_Query);
+					}
+					return true;
+				}
 
 				return false;
 			}
@@ -309,9 +616,7 @@ namespace OpenZWave
 				if ((ValueID::ValueType_Button == _value.GetID().GetType()) && (_value.GetID().GetIndex() == ValueID_Index_UserCode::Refresh))
 				{
 					m_refreshUserCodes = true;
-					m_currentCode = 1;
-					m_queryAll = true;
-					RequestValue(0, m_currentCode, _value.GetID().GetInstance(), Driver::MsgQueue_Query);
+					RefreshCodes(_value.GetID().GetInstance(), Driver::MsgQueue_Query);
 					return true;
 				}
 				if ((ValueID::ValueType_Short == _value.GetID().GetType()) && (_value.GetID().GetIndex() == ValueID_Index_UserCode::RemoveCode))
@@ -47,6 +47,8 @@ namespace OpenZWave
 						UserCode_Available = 0x00,
 						UserCode_Occupied = 0x01,
 						UserCode_Reserved = 0x02,
+						UserCode_Messaging = 0x03,
+						UserCode_PassageMode = 0x04,
 						UserCode_NotAvailable = 0xfe,
 						UserCode_Unset = 0xff
 					};
@@ -54,6 +56,7 @@ namespace OpenZWave
 					{
 							UserCodeStatus status;
 							uint8 usercode[10];
+							uint8 length;
 					};
 				public:
 					static CommandClass* Create(uint32 const _homeId, uint8 const _nodeId)
@@ -74,6 +77,8 @@ namespace OpenZWave
 					}
 
 					// From CommandClass
+					virtual void ReadXML(TiXmlElement const* _ccElement) override;
+					virtual void WriteXML(TiXmlElement* _ccElement) override;
 					virtual bool RequestState(uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue) override;
 					virtual bool RequestValue(uint32 const _requestFlags, uint16 const _index, uint8 const _instance, Driver::MsgQueue const _queue) override;
 					virtual uint8 const GetCommandClassId() const override
@@ -86,6 +91,10 @@ namespace OpenZWave
 					}
 					virtual bool HandleMsg(uint8 const* _data, uint32 const _length, uint32 const _instance = 1) override;
 					virtual bool SetValue(Internal::VC::Value const& _value) override;
+					virtual uint8 GetMaxVersion() override
+					{
+						return 2;
+					}
 
 				protected:
 					virtual void CreateVars(uint8 const _instance) override;
@@ -93,6 +102,12 @@ namespace OpenZWave
 				private:
 					UserCode(uint32 const _homeId, uint8 const _nodeId);
 
+					bool RefreshCodes(uint8 const _instance, Driver::MsgQueue const _queue);
+					bool RequestCodes(uint16 const _first, uint8 const _instance, Driver::MsgQueue const _queue);
+					void StoreCode(uint16 const _index, uint8 const _status, uint8 const* _code, uint8 const _length, uint32 const _instance);
+					void ClearCode(uint16 const _index, uint32 const _instance);
+					uint16 Checksum();
+
 					string CodeStatus(uint8 const _byte)
 					{
 						switch (_byte)
@@ -109,6 +124,14 @@ namespace OpenZWave
 							{
 								return "Reserved";
 							}
+							case UserCode_Messaging:
+							{
+								return "Messaging";
+							}
+							case UserCode_PassageMode:
+							{
+								return "Passage Mode";
+							}
 							case UserCode_NotAvailable:
 							{
 								return "Not Available";
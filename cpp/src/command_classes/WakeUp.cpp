@@ -41,6 +41,8 @@
 
 #include "tinyxml.h"
 
+#include <algorithm>
+
 namespace OpenZWave
 {
 	namespace Internal
@@ -59,12 +61,23 @@ namespace OpenZWave
 				WakeUpCmd_IntervalCapabilitiesReport = 0x0A
 			};
 
+			// Time to allow for each message until the node has statistics of its own
+			static uint32 const c_defaultMsgTime = 250;
+			// Always send at least this many messages in a wake up, so a short window cannot starve the queue
+			static uint32 const c_minWakeBudget = 4;
+			// How often to check whether everything for the node has been sent
+			static int32 const c_sleepCheckInterval = 100;
+			// Longest we wait for the queues to empty before sending No More Information
+			static int32 const c_maxSleepWait = 10000;
+			// Longer "windows" are devices that were woken by hand, or that we lost track of
+			static uint32 const c_maxAwakeWindow = 60000;
+
 //-----------------------------------------------------------------------------
 // <WakeUp::WakeUp>
 // Constructor
 //-----------------------------------------------------------------------------
 			WakeUp::WakeUp(uint32 const _homeId, uint8 const _nodeId) :
-					CommandClass(_homeId, _nodeId), m_mutex(new Internal::Platform::Mutex()), m_awake(true), m_pollRequired(false), m_interval(0)
+					CommandClass(_homeId, _nodeId), m_mutex(new Internal::Platform::Mutex()), m_awake(true), m_pollRequired(false), m_interval(0), m_timingWake(false), m_awakeWindow(0), m_sleepPending(false)
 			{
 				Timer::SetDriver(GetDriver());
 				Options::Get()->GetOptionAsBool("AssumeAwake", &m_awake);
@@ -94,6 +107,37 @@ namespace OpenZWave
 				}
 			}
 
+//-----------------------------------------------------------------------------
+// <WakeUp::ReadXML>
+// Read the learnt awake window
+//-----------------------------------------------------------------------------
+			void WakeUp::ReadXML(TiXmlElement const* _ccElement)
+			{
+				CommandClass::ReadXML(_ccElement);
+
+				int window;
+				if (TIXML_SUCCESS == _ccElement->QueryIntAttribute("awake_window", &window) && (window > 0) && ((uint32) window <= c_maxAwakeWindow))
+				{
+					m_awakeWindow = (uint32) window;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <WakeUp::WriteXML>
+// Save the learnt awake window
+//-----------------------------------------------------------------------------
+			void WakeUp::WriteXML(TiXmlElement* _ccElement)
+			{
+				CommandClass::WriteXML(_ccElement);
+
+				if (m_awakeWindow)
+				{
+					char str[16];
+					snprintf(str, sizeof(str), "%d", m_awakeWindow);
+					_ccElement->SetAttribute("awake_window", str);
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <WakeUp::Init>
 // Starts the process of requesting node state from a sleeping device
@@ -232,6 +276,8 @@ namespace OpenZWave
 				{
 					// The device is awake.
 					Log::Write(LogLevel_Info, GetNodeId(), "Received Wakeup Notification from node %d", GetNodeId());
+					m_wakeTime.SetTime();
+					m_timingWake = true;
 					SetAwake(true);
 					return true;
 				}
@@ -326,8 +372,32 @@ namespace OpenZWave
 						if (node)
 							node->RefreshValuesOnWakeup();
 					}
+					else
+					{
+						m_mutex->Lock();
+						m_sleepPending = false;
+						m_mutex->Unlock();
+						TimerDelEvent(1);
+						if (m_timingWake)
+						{
+							// We were not done with the device when it went back to sleep.  Learn
+							// from the last time it answered, as when we noticed it had gone
+							// depends on our retries and timeouts rather than on the device.
+							m_timingWake = false;
+							Node* node = GetNodeUnsafe();
+							int32 awake = node ? (node->m_receivedTS - m_wakeTime) : 0;
+							if ((awake > 0) && ((uint32) awake <= c_maxAwakeWindow))
+							{
+								m_awakeWindow = m_awakeWindow ? (3 * m_awakeWindow + (uint32) awake) / 4 : (uint32) awake;
+								Log::Write(LogLevel_Info, GetNodeId(), "  Node %d last answered %dms after waking up, expecting it to stay awake for %dms", GetNodeId(), awake, m_awakeWindow);
+							}
+						}
+					}
 
+					// CheckSleep reads this on the timer thread
+					m_mutex->Lock();
 					m_awake = _state;
+					m_mutex->Unlock();
 					Log::Write(LogLevel_Info, GetNodeId(), "  Node %d has been marked as %s", GetNodeId(), m_awake ? "awake" : "asleep");
 					Notification* notification = new Notification(Notification::Type_Notification);
 					notification->SetHomeAndNodeIds(GetHomeId(), GetNodeId());
@@ -342,11 +412,23 @@ namespace OpenZWave
 					Node* node = GetNodeUnsafe();
 					if (m_pollRequired)
 					{
-						if (node != NULL)
+						// Don't start a refresh the device will fall asleep in the middle of
+						uint32 budget = GetWakeBudget();
+						m_mutex->Lock();
+						uint32 pending = (uint32) m_pendingQueue.size();
+						m_mutex->Unlock();
+						if (budget && (pending >= budget))
+						{
+							Log::Write(LogLevel_Info, GetNodeId(), "  Node %d has %d messages pending, leaving the poll for the next wake up", GetNodeId(), pending);
+						}
+						else
 						{
-							node->SetQueryStage(Node::QueryStage_Dynamic);
+							if (node != NULL)
+							{
+								node->SetQueryStage(Node::QueryStage_Dynamic);
+							}
+							m_pollRequired = false;
 						}
-						m_pollRequired = false;
 					}
 					// Send all pending messages
 					SendPending();
@@ -403,19 +485,33 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void WakeUp::SendPending()
 			{
-				m_awake = true;
 				bool reloading = false;
 				m_mutex->Lock();
+				m_awake = true;
+				PlanWakeWindow();
+				uint32 budget = GetWakeBudget();
+				uint32 sent = 0;
 				list<Driver::MsgQueueItem>::iterator it = m_pendingQueue.begin();
 				while (it != m_pendingQueue.end())
 				{
 					Driver::MsgQueueItem const& item = *it;
 					if (Driver::MsgQueueCmd_SendMsg == item.m_command)
 					{
+						// Sets are always sent.  Gets only while they are likely to fit, and
+						// the rest stay queued for the next wake up.
+						if (budget && (sent >= budget) && (item.m_msg->GetExpectedReply() == FUNC_ID_APPLICATION_COMMAND_HANDLER))
+						{
+							++it;
+							continue;
+						}
 						GetDriver()->SendMsg(item.m_msg, Driver::MsgQueue_WakeUp);
+						++sent;
 					}
 					else if (Driver::MsgQueueCmd_QueryStageComplete == item.m_command)
 					{
+						// Always let the interview move on, or the node never finishes its
+						// queries and is never sent back to sleep.  A Get held back above
+						// still updates its value when it is sent next time.
 						GetDriver()->SendQueryStageComplete(item.m_nodeId, item.m_queryStage);
 					}
 					else if (Driver::MsgQueueCmd_Controller == item.m_command)
@@ -430,6 +526,10 @@ namespace OpenZWave
 					}
 					it = m_pendingQueue.erase(it);
 				}
+				if (!m_pendingQueue.empty())
+				{
+					Log::Write(LogLevel_Info, GetNodeId(), "  Node %d is expected to sleep in %dms, keeping %d messages for the next wake up", GetNodeId(), m_awakeWindow - std::min(m_awakeWindow, (uint32) (Internal::Platform::TimeStamp() - m_wakeTime)), (int) m_pendingQueue.size());
+				}
 				m_mutex->Unlock();
 
 				// Send the device back to sleep, unless we have outstanding queries.
@@ -446,20 +546,168 @@ namespace OpenZWave
 				/* if we are reloading, the QueryStage_Complete will take care of sending the device back to sleep */
 				if (sendToSleep && !reloading)
 				{
-					if (m_com.GetFlagInt(COMPAT_FLAG_WAKEUP_DELAYNMI) == 0)
+					// No More Information goes out once everything queued for the device
+					// (here or by the refresh on wake up) has been sent, but not before
+					// the delay the device needs, and not after it has surely gone to sleep.
+					int32 deadline = c_maxSleepWait;
+					if (m_timingWake && m_awakeWindow)
 					{
-						SendNoMoreInfo(1);
+						uint32 elapsed = (uint32) (Internal::Platform::TimeStamp() - m_wakeTime);
+						deadline = (elapsed < m_awakeWindow) ? (int32) (m_awakeWindow - elapsed) : 0;
+					}
+					m_mutex->Lock();
+					m_sleepDeadline.SetTime(deadline);
+					m_sleepPending = true;
+					m_mutex->Unlock();
+					TimerDelEvent(1);
 
+					if (m_com.GetFlagInt(COMPAT_FLAG_WAKEUP_DELAYNMI) == 0)
+					{
+						CheckSleep(1);
 					}
 					else
 					{
 						Log::Write(LogLevel_Info, GetNodeId(), "  Node %d has delayed sleep of %dms", GetNodeId(), m_com.GetFlagInt(COMPAT_FLAG_WAKEUP_DELAYNMI));
-						TimerThread::TimerCallback callback = bind(&WakeUp::SendNoMoreInfo, this, 1);
+						TimerThread::TimerCallback callback = bind(&WakeUp::CheckSleep, this, 1);
 						TimerSetEvent(m_com.GetFlagInt(COMPAT_FLAG_WAKEUP_DELAYNMI), callback, 1);
 					}
 				}
 			}
 
+//-----------------------------------------------------------------------------
+// <WakeUp::PlanWakeWindow>
+// Order the pending messages to make the best use of the wake up
+//-----------------------------------------------------------------------------
+			void WakeUp::PlanWakeWindow()
+			{
+				// Sets move ahead of the Gets (and query stages) around them, so they
+				// are not lost if the device falls asleep, and so a Get that follows a
+				// Set reports the new state.  The Gets end up next to each other, which
+				// lets the Driver combine them into Multi Command frames.  Controller
+				// commands and reloads stay where they are, and nothing moves past them.
+				list<Driver::MsgQueueItem>::iterator start = m_pendingQueue.begin();
+				while (start != m_pendingQueue.end())
+				{
+					list<Driver::MsgQueueItem>::iterator end = start;
+					while ((end != m_pendingQueue.end()) && ((Driver::MsgQueueCmd_SendMsg == end->m_command) || (Driver::MsgQueueCmd_QueryStageComplete == end->m_command)))
+					{
+						++end;
+					}
+
+					list<Driver::MsgQueueItem> gets;
+					list<Driver::MsgQueueItem>::iterator it = start;
+					while (it != end)
+					{
+						if ((Driver::MsgQueueCmd_SendMsg == it->m_command) && (it->m_msg->GetExpectedReply() != FUNC_ID_APPLICATION_COMMAND_HANDLER))
+						{
+							++it;
+						}
+						else
+						{
+							list<Driver::MsgQueueItem>::iterator next = it;
+							++next;
+							gets.splice(gets.end(), m_pendingQueue, it);
+							it = next;
+						}
+					}
+					m_pendingQueue.splice(end, gets);
+
+					if (end == m_pendingQueue.end())
+					{
+						break;
+					}
+					start = ++end;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <WakeUp::GetWakeBudget>
+// How many messages are likely to fit in what is left of the wake up
+//-----------------------------------------------------------------------------
+			uint32 WakeUp::GetWakeBudget()
+			{
+				// 0 means no limit
+				if (!m_timingWake || !m_awakeWindow)
+				{
+					return 0;
+				}
+
+				uint32 msgTime = c_defaultMsgTime;
+				if (Node* node = GetNodeUnsafe())
+				{
+					// A Get is only done when the report arrives
+					if (node->m_averageResponseRTT)
+					{
+						msgTime = node->m_averageResponseRTT;
+					}
+					else if (node->m_averageRequestRTT)
+					{
+						msgTime = node->m_averageRequestRTT;
+					}
+				}
+
+				uint32 used = (uint32) (Internal::Platform::TimeStamp() - m_wakeTime) + m_com.GetFlagInt(COMPAT_FLAG_WAKEUP_DELAYNMI);
+				uint32 budget = (used < m_awakeWindow) ? (m_awakeWindow - used) / std::max(msgTime, (uint32) 1) : 0;
+				return std::max(budget, c_minWakeBudget);
+			}
+
+//-----------------------------------------------------------------------------
+// <WakeUp::CheckSleep>
+// Send No More Information once there is nothing else to send to the device
+//-----------------------------------------------------------------------------
+			void WakeUp::CheckSleep(uint32 id)
+			{
+				// This runs on the timer thread, while the driver thread can mark the
+				// device asleep.  HasQueuedMsgs takes the Driver's send lock, so it is
+				// not called with ours held.
+				m_mutex->Lock();
+				bool pending = m_awake && m_sleepPending;
+				m_mutex->Unlock();
+				if (!pending)
+				{
+					return;
+				}
+				bool queued = GetDriver()->HasQueuedMsgs(GetNodeId());
+
+				m_mutex->Lock();
+				if (!m_awake || !m_sleepPending)
+				{
+					m_mutex->Unlock();
+					return;
+				}
+				if (queued && (m_sleepDeadline.TimeRemaining() > 0))
+				{
+					m_mutex->Unlock();
+					TimerThread::TimerCallback callback = bind(&WakeUp::CheckSleep, this, 1);
+					TimerSetEvent(c_sleepCheckInterval, callback, 1);
+					return;
+				}
+				m_sleepPending = false;
+				m_mutex->Unlock();
+				SendNoMoreInfo(id);
+			}
+
+//-----------------------------------------------------------------------------
+// <WakeUp::NoMoreInformationAcked>
+// The device has gone to sleep because we told it to
+//-----------------------------------------------------------------------------
+			void WakeUp::NoMoreInformationAcked()
+			{
+				if (m_timingWake)
+				{
+					// It stayed awake at least this long.  If we needed most of the
+					// window we think it has, try a slightly longer one next time.
+					uint32 awake = (uint32) (Internal::Platform::TimeStamp() - m_wakeTime);
+					m_timingWake = false;
+					if (m_awakeWindow && (awake <= c_maxAwakeWindow) && (awake + awake / 8 > m_awakeWindow))
+					{
+						m_awakeWindow = std::min(awake + awake / 8, c_maxAwakeWindow);
+						Log::Write(LogLevel_Info, GetNodeId(), "  Node %d was still awake after %dms, expecting it to stay awake for %dms", GetNodeId(), awake, m_awakeWindow);
+					}
+				}
+				SetAwake(false);
+			}
+
 //-----------------------------------------------------------------------------
 // <WakeUp::SendNoMoreInfo>
 // Send a no more information message
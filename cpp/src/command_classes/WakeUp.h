@@ -32,6 +32,7 @@
 #include "command_classes/CommandClass.h"
 #include "Driver.h"
 #include "TimerThread.h"
+#include "platform/TimeStamp.h"
 
 namespace OpenZWave
 {
@@ -47,6 +48,15 @@ namespace OpenZWave
 
 			/** \brief Implements COMMAND_CLASS_WAKE_UP (0x84), a Z-Wave device command class.
 			 * \ingroup CommandClass
+			 *
+			 * A sleeping device only listens for a few seconds after it sends a
+			 * Wake Up Notification, so the messages held for it are planned to fit
+			 * that window: Sets go first, then the Gets (kept together so the
+			 * Driver can combine them with Multi Command), and No More Information
+			 * is sent as soon as nothing else for the node is queued.  How long the
+			 * device stays awake is learnt from its last reply when it fell asleep
+			 * before we were done, and Gets that would not fit are kept for the next
+			 * wake up.
 			 */
 			class WakeUp: public CommandClass, private Timer
 			{
@@ -75,6 +85,15 @@ namespace OpenZWave
 					/** \brief Send a no more information message. */
 					void SendNoMoreInfo(uint32 id);
 
+					/** \brief The device acknowledged No More Information and has gone back to sleep. */
+					void NoMoreInformationAcked();
+
+					/** \brief How long the device is expected to stay awake, in ms (0 if not known yet). */
+					uint32 GetAwakeWindow() const
+					{
+						return m_awakeWindow;
+					}
+
 					bool IsAwake() const
 					{
 						return m_awake;
@@ -86,6 +105,8 @@ namespace OpenZWave
 					}
 
 					// From CommandClass
+					virtual void ReadXML(TiXmlElement const* _ccElement) override;
+					virtual void WriteXML(TiXmlElement* _ccElement) override;
 					virtual bool RequestState(uint32 const _requestFlags, uint8 const _instance, Driver::MsgQueue const _queue) override;
 					virtual bool RequestValue(uint32 const _requestFlags, uint16 const _index, uint8 const _instance, Driver::MsgQueue const _queue) override;
 					virtual uint8 const GetCommandClassId() const override
@@ -113,12 +134,21 @@ namespace OpenZWave
 				private:
 					WakeUp(uint32 const _homeId, uint8 const _nodeId);
 
-					Internal::Platform::Mutex* m_mutex;			// Serialize access to the pending queue
+					void PlanWakeWindow();
+					uint32 GetWakeBudget();
+					void CheckSleep(uint32 id);
+
+					Internal::Platform::Mutex* m_mutex;			// Serialize access to the pending queue, m_awake and the sleep check
 					list<Driver::MsgQueueItem> m_pendingQueue;		// Messages waiting to be sent when the device wakes up
 					bool m_awake;
 					bool m_pollRequired;
 					uint32 m_interval;
-					
+
+					Internal::Platform::TimeStamp m_wakeTime;		// When the last Wake Up Notification arrived
+					bool m_timingWake;					// m_wakeTime belongs to the current wake up
+					uint32 m_awakeWindow;					// Learnt time the device stays awake for, from the replies it sent (ms)
+					bool m_sleepPending;					// No More Information is waiting for the queues to empty
+					Internal::Platform::TimeStamp m_sleepDeadline;		// Send No More Information by then regardless
 			};
 		} // namespace CC
 	} // namespace Internal
@@ -27,6 +27,7 @@
 #include "Defs.h"
 #include "Driver.h"
 #include "platform/Controller.h"
+#include "platform/Trace.h"
 
 namespace OpenZWave
 {
@@ -49,6 +50,41 @@ namespace OpenZWave
 
 				return 0;
 			}
+
+//-----------------------------------------------------------------------------
+//	<Controller::StartCapture>
+//	Record the traffic with the controller to a file
+//-----------------------------------------------------------------------------
+			bool Controller::StartCapture(string const& _filename)
+			{
+				StopCapture();
+				m_capture = SerialCapture::Create(_filename);
+				return (m_capture != NULL);
+			}
+
+//-----------------------------------------------------------------------------
+//	<Controller::StopCapture>
+//	Close the capture file
+//-----------------------------------------------------------------------------
+			void Controller::StopCapture()
+			{
+				delete m_capture;
+				m_capture = NULL;
+			}
+
+//-----------------------------------------------------------------------------
+//	<Controller::Put>
+//	Capture the data received from the controller before it is buffered
+//-----------------------------------------------------------------------------
+			bool Controller::Put(uint8* _buffer, uint32 _size)
+			{
+				TraceSpan span("Serial read", (int32) _size);
+				if (m_capture)
+				{
+					m_capture->Write(SerialCapture::Direction_In, _buffer, _size);
+				}
+				return Stream::Put(_buffer, _size);
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
@@ -33,6 +33,7 @@
 #include "Defs.h"
 #include "Driver.h"
 #include "platform/Stream.h"
+#include "platform/SerialCapture.h"
 
 namespace OpenZWave
 {
@@ -64,7 +65,7 @@ namespace OpenZWave
 					 * Creates the controller object.
 					 */
 					Controller() :
-							Stream(2048)
+							Stream(2048), m_capture(NULL)
 					{
 					}
 
@@ -74,6 +75,7 @@ namespace OpenZWave
 					 */
 					virtual ~Controller()
 					{
+						StopCapture();
 					}
 
 					/**
@@ -111,6 +113,45 @@ namespace OpenZWave
 					 * @see Write, Open, Close
 					 */
 					uint32 Read(uint8* _buffer, uint32 _length);
+
+					/**
+					 * Record every byte read from and written to the controller.
+					 * Call before the controller is opened.
+					 * @param _filename The capture file to create.
+					 * @return True if the capture file was created.
+					 * @see SerialCapture, StopCapture
+					 */
+					bool StartCapture(string const& _filename);
+
+					/**
+					 * Stop recording, and close the capture file.
+					 * @see StartCapture
+					 */
+					void StopCapture();
+
+					/**
+					 * Add data received from the controller to the stream.
+					 * Overrides Stream::Put to capture the received data, so every
+					 * read path is recorded whether it holds a Controller or a Stream.
+					 * @see Stream::Put
+					 */
+					virtual bool Put(uint8* _buffer, uint32 _size);
+
+				protected:
+					/**
+					 * Record data that is being written to the controller.
+					 * Every Write implementation calls this.
+					 */
+					void CaptureWrite(uint8 const* _buffer, uint32 _length)
+					{
+						if (m_capture)
+						{
+							m_capture->Write(SerialCapture::Direction_Out, _buffer, _length);
+						}
+					}
+
+				private:
+					SerialCapture* m_capture;
 			};
 		} // namespace Platform
 	} // namespace Internal
@@ -492,6 +492,7 @@ namespace OpenZWave
 
 				Log::Write( LogLevel_Debug, "      HidController::Write (sent to controller)" );
 				LogData(_buffer, _length, "      Write: ");
+				CaptureWrite(_buffer, _length);
 
 				int bytesSent = SendFeatureReport(FEATURE_REPORT_LENGTH, hidBuffer);
 				if (bytesSent < 2)
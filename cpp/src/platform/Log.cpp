@@ -285,6 +285,7 @@ void Log::SetLogFileName(const string &_filename)
 Log::Log(string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger) :
 		m_logMutex(new Internal::Platform::Mutex())
 {
+	m_logMutex->SetName("Log::m_logMutex");
 	if (m_pImpls.size() == 0)
 	{
 		m_pImpls.push_back(new Internal::Platform::LogImpl(_filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger));
@@ -204,6 +204,8 @@ namespace OpenZWave
 			static void QueueClear();
 
 		private:
+			friend class Driver;
+
 			Log(string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger);
 			~Log();
 
@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 #include "Defs.h"
 #include "platform/Mutex.h"
+#include "platform/Trace.h"
 
 #ifdef WIN32
 #include "platform/windows/MutexImpl.h"	// Platform-specific implementation of a mutex
@@ -42,14 +43,24 @@ namespace OpenZWave
 	{
 		namespace Platform
 		{
+			// Holds of a named mutex at least this long (us) are shown in traces
+			static uint64 const c_traceHoldTime = 1000;
+
+			bool Mutex::s_profiling = false;
 
 //-----------------------------------------------------------------------------
 //	<Mutex::Mutex>
 //	Constructor
 //-----------------------------------------------------------------------------
 			Mutex::Mutex() :
-					m_pImpl(new MutexImpl())
+					m_pImpl(new MutexImpl()), m_name(NULL), m_depth(0), m_lockTime(0)
 			{
+				m_statistics.m_acquisitions = 0;
+				m_statistics.m_contended = 0;
+				m_statistics.m_waitTime = 0;
+				m_statistics.m_maxWaitTime = 0;
+				m_statistics.m_holdTime = 0;
+				m_statistics.m_maxHoldTime = 0;
 			}
 
 //-----------------------------------------------------------------------------
@@ -68,7 +79,52 @@ namespace OpenZWave
 			bool Mutex::Lock(bool const _bWait // = true;
 					)
 			{
-				return m_pImpl->Lock(_bWait);
+				if ((m_name == NULL) || !(s_profiling || Trace::IsEnabled()))
+				{
+					if (!m_pImpl->Lock(_bWait))
+					{
+						return false;
+					}
+					++m_depth;
+					return true;
+				}
+
+				// Only the waits are traced, not the locks that were free
+				uint64 waitStart = 0;
+				if (!m_pImpl->Lock(false))
+				{
+					if (!_bWait)
+					{
+						return false;
+					}
+					waitStart = Trace::GetTime();
+					TraceSpan span("Lock wait", m_name);
+					if (!m_pImpl->Lock(true))
+					{
+						return false;
+					}
+				}
+				if (m_depth++ != 0)
+				{
+					return true;
+				}
+
+				m_lockTime = Trace::GetTime();
+				if (s_profiling)
+				{
+					++m_statistics.m_acquisitions;
+					if (waitStart != 0)
+					{
+						uint64 wait = m_lockTime - waitStart;
+						++m_statistics.m_contended;
+						m_statistics.m_waitTime += wait;
+						if (wait > m_statistics.m_maxWaitTime)
+						{
+							m_statistics.m_maxWaitTime = wait;
+						}
+					}
+				}
+				return true;
 			}
 
 //-----------------------------------------------------------------------------
@@ -77,6 +133,25 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void Mutex::Unlock()
 			{
+				// Still held, so the statistics can be updated
+				if ((m_depth > 0) && (--m_depth == 0) && (m_lockTime != 0))
+				{
+					uint64 now = Trace::GetTime();
+					uint64 hold = now - m_lockTime;
+					if (s_profiling)
+					{
+						m_statistics.m_holdTime += hold;
+						if (hold > m_statistics.m_maxHoldTime)
+						{
+							m_statistics.m_maxHoldTime = hold;
+						}
+					}
+					if ((hold >= c_traceHoldTime) && Trace::IsEnabled())
+					{
+						Trace::Complete("Lock held", m_name, -1, m_lockTime, now);
+					}
+					m_lockTime = 0;
+				}
 				m_pImpl->Unlock();
 
 				if (IsSignalled())
@@ -86,6 +161,22 @@ namespace OpenZWave
 				}
 			}
 
+//-----------------------------------------------------------------------------
+//	<Mutex::GetStatistics>
+//	Copy the statistics, without counting the lock that protects them
+//-----------------------------------------------------------------------------
+			void Mutex::GetStatistics(Statistics* _data)
+			{
+				m_pImpl->Lock(true);
+				*_data = m_statistics;
+				m_pImpl->Unlock();
+
+				if (IsSignalled())
+				{
+					Notify();
+				}
+			}
+
 //-----------------------------------------------------------------------------
 //	<Mutex::IsSignalled>
 //	Test whether the event is set
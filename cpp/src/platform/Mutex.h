@@ -44,6 +44,21 @@ namespace OpenZWave
 			class Mutex: public Wait
 			{
 				public:
+					/** \brief How a named mutex has been used, with the ProfileLocks option.
+					 *
+					 * Only the outermost lock of a thread counts, as the mutex is
+					 * recursive.  Times are in microseconds.
+					 */
+					struct Statistics
+					{
+							uint64 m_acquisitions;			// Times the mutex was locked
+							uint64 m_contended;				// Times it was held by another thread when it was locked
+							uint64 m_waitTime;				// Time spent waiting for it
+							uint64 m_maxWaitTime;			// Longest wait for it
+							uint64 m_holdTime;				// Time it was held
+							uint64 m_maxHoldTime;			// Longest it was held
+					};
+
 					/**
 					 * Constructor.
 					 * Creates a mutex object that can be used to serialize access to a shared resource.
@@ -72,6 +87,38 @@ namespace OpenZWave
 					 * Used by the Wait class to test whether the mutex is free.
 					 */
 					virtual bool IsSignalled();
+
+					/**
+					 * Name the mutex.  Waits to lock a named mutex are shown in traces.
+					 * \param _name A static string.
+					 */
+					void SetName(char const* _name)
+					{
+						m_name = _name;
+					}
+					char const* GetName() const
+					{
+						return m_name;
+					}
+
+					/**
+					 * Copy the statistics of the mutex, which are only kept if it is
+					 * named and lock profiling is enabled.
+					 */
+					void GetStatistics(Statistics* _data);
+
+					/**
+					 * Count and time the locks of the named mutexes (the ProfileLocks
+					 * option).  Set before the mutexes are used.
+					 */
+					static void SetProfiling(bool _enabled)
+					{
+						s_profiling = _enabled;
+					}
+					static bool IsProfiling()
+					{
+						return s_profiling;
+					}
 				protected:
 
 					/**
@@ -85,6 +132,11 @@ namespace OpenZWave
 					Mutex& operator =(Mutex const&);		// prevent assignment
 
 					MutexImpl* m_pImpl;					// Pointer to an object that encapsulates the platform-specific implementation of a mutex.
+					char const* m_name;					// Name shown in traces, or NULL
+					int32 m_depth;						// Locks held by the owning thread
+					uint64 m_lockTime;					// When the owning thread took its first lock, if timed
+					Statistics m_statistics;			// Only updated while the mutex is held
+					static bool s_profiling;
 			};
 		} // namespace Platform
 	} // namespace Internal
@@ -0,0 +1,259 @@
+//-----------------------------------------------------------------------------
+//
+//	ReplayController.cpp
+//
+//	A controller that plays back a serial capture file
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "Defs.h"
+#include "Options.h"
+#include "Utils.h"
+#include "platform/ReplayController.h"
+#include "platform/Event.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			// How long to wait for the driver to make a write the capture expects
+			static int32 const c_writeTimeout = 10000;
+
+			// The size of the stream the controller buffers received data in
+			static uint32 const c_bufferSize = 2048;
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayController>
+//	Constructor
+//-----------------------------------------------------------------------------
+			ReplayController::ReplayController() :
+					m_thread(new Thread("replay")), m_writeMutex(new Mutex()), m_writeEvent(new Event()), m_bOpen(false), m_realtime(true)
+			{
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::~ReplayController>
+//	Destructor
+//-----------------------------------------------------------------------------
+			ReplayController::~ReplayController()
+			{
+				Close();
+				m_thread->Release();
+				m_writeEvent->Release();
+				m_writeMutex->Release();
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Open>
+//	Load the capture and start playing it
+//-----------------------------------------------------------------------------
+			bool ReplayController::Open(string const& _captureFile)
+			{
+				if (m_bOpen)
+				{
+					return false;
+				}
+				if (!SerialCapture::Load(_captureFile, &m_records))
+				{
+					return false;
+				}
+				m_captureFile = _captureFile;
+				Options::Get()->GetOptionAsBool("SerialReplayRealtime", &m_realtime);
+				Log::Write(LogLevel_Info, "Replaying %d records from %s %s", (int) m_records.size(), _captureFile.c_str(), m_realtime ? "at the recorded pace" : "as fast as possible");
+
+				m_bOpen = true;
+				m_thread->Start(ReplayThreadEntryPoint, this);
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Close>
+//	Stop playing the capture
+//-----------------------------------------------------------------------------
+			bool ReplayController::Close()
+			{
+				if (!m_bOpen)
+				{
+					return false;
+				}
+				m_thread->Stop();
+				m_bOpen = false;
+
+				LockGuard LG(m_writeMutex);
+				m_written.clear();
+				m_writeEvent->Reset();
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::Write>
+//	Queue the driver's data to be checked against the capture
+//-----------------------------------------------------------------------------
+			uint32 ReplayController::Write(uint8* _buffer, uint32 _length)
+			{
+				if (!m_bOpen)
+				{
+					return 0;
+				}
+				CaptureWrite(_buffer, _length);
+
+				LockGuard LG(m_writeMutex);
+				m_written.push_back(std::vector<uint8>(_buffer, _buffer + _length));
+				m_writeEvent->Set();
+				return _length;
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::WaitForWrite>
+//	Take the oldest write the driver has made
+//-----------------------------------------------------------------------------
+			ReplayController::WriteWait ReplayController::WaitForWrite(Event* _exitEvent, std::vector<uint8>* _data)
+			{
+				Wait* waitObjects[2] =
+				{ m_writeEvent, _exitEvent };
+				while (true)
+				{
+					{
+						LockGuard LG(m_writeMutex);
+						if (!m_written.empty())
+						{
+							_data->swap(m_written.front());
+							m_written.pop_front();
+							if (m_written.empty())
+							{
+								m_writeEvent->Reset();
+							}
+							return WriteWait_Written;
+						}
+					}
+					int32 res = Wait::Multiple(waitObjects, 2, c_writeTimeout);
+					if (res == 1)
+					{
+						return WriteWait_Exit;
+					}
+					if (res < 0)
+					{
+						return WriteWait_Timeout;
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayThreadEntryPoint>
+//	Entry point of the replay thread
+//-----------------------------------------------------------------------------
+			void ReplayController::ReplayThreadEntryPoint(Event* _exitEvent, void* _context)
+			{
+				ReplayController* controller = (ReplayController*) _context;
+				if (controller)
+				{
+					controller->ReplayThreadProc(_exitEvent);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<ReplayController::ReplayThreadProc>
+//	Play the capture back, in step with the driver's writes
+//-----------------------------------------------------------------------------
+			void ReplayController::ReplayThreadProc(Event* _exitEvent)
+			{
+				uint32 received = 0;
+				uint32 matched = 0;
+				uint32 differed = 0;
+				uint32 missing = 0;
+
+				// Received data is paced from the last write the driver made, so a
+				// driver that is slower or faster than the original is not
+				// overtaken or left waiting
+				uint64 const start = SerialCapture::GetMonotonicTime();
+				uint64 syncTime = start;
+				uint64 syncRecordTime = m_records.empty() ? 0 : m_records[0].m_time;
+
+				for (std::vector<SerialCapture::Record>::const_iterator it = m_records.begin(); it != m_records.end(); ++it)
+				{
+					if (it->m_data.empty())
+					{
+						continue;
+					}
+					if (it->m_direction == SerialCapture::Direction_In)
+					{
+						if (m_realtime)
+						{
+							uint64 due = syncTime + (it->m_time - syncRecordTime);
+							uint64 now = SerialCapture::GetMonotonicTime();
+							if ((due > now) && (Wait::Single(_exitEvent, (int32) ((due - now + 999) / 1000)) == 0))
+							{
+								return;
+							}
+						}
+						// Wait for the driver to make room, rather than lose data it was sent
+						while (GetDataSize() + it->m_data.size() > c_bufferSize)
+						{
+							if (Wait::Single(_exitEvent, 1) == 0)
+							{
+								return;
+							}
+						}
+						if (Wait::Single(_exitEvent, 0) == 0)
+						{
+							return;
+						}
+						Put(const_cast<uint8*>(&it->m_data[0]), (uint32) it->m_data.size());
+						++received;
+						continue;
+					}
+
+					std::vector<uint8> written;
+					WriteWait res = WaitForWrite(_exitEvent, &written);
+					if (res == WriteWait_Exit)
+					{
+						return;
+					}
+					if (res == WriteWait_Timeout)
+					{
+						Log::Write(LogLevel_Warning, "Replay: the driver did not send %s within %dms", PktToString(&it->m_data[0], (uint32) it->m_data.size()).c_str(), c_writeTimeout);
+						++missing;
+					}
+					else if (written != it->m_data)
+					{
+						Log::Write(LogLevel_Warning, "Replay: the driver sent %s where the capture has %s", PktToString(&written[0], (uint32) written.size()).c_str(), PktToString(&it->m_data[0], (uint32) it->m_data.size()).c_str());
+						++differed;
+					}
+					else
+					{
+						++matched;
+					}
+					syncTime = SerialCapture::GetMonotonicTime();
+					syncRecordTime = it->m_time;
+				}
+
+				uint64 elapsed = SerialCapture::GetMonotonicTime() - start;
+				Log::Write(LogLevel_Always, "Replay of %s finished in %d.%03ds: %d records received, %d writes as captured, %d differed, %d not made", m_captureFile.c_str(), (int) (elapsed / 1000000), (int) ((elapsed / 1000) % 1000), received, matched, differed, missing);
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+//
+//	ReplayController.h
+//
+//	A controller that plays back a serial capture file
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ReplayController_H
+#define _ReplayController_H
+
+#include <list>
+#include <string>
+#include <vector>
+#include "Defs.h"
+#include "platform/Controller.h"
+#include "platform/SerialCapture.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Event;
+			class Mutex;
+			class Thread;
+
+			/** \brief Feed a driver the traffic recorded by a serial capture.
+			 * \ingroup Platform
+			 *
+			 * Used by adding a driver with ControllerInterface_Replay and the path
+			 * of a capture file (see the SerialCapture option).  The data received
+			 * from the controller is played back, either at the pace it was
+			 * recorded or as fast as possible (SerialReplayRealtime option).  Data
+			 * that followed a write in the capture is only played back once the
+			 * driver has made that write, and every write is checked against the
+			 * capture.  A summary is logged when the capture has been played.
+			 *
+			 * Security (S0) traffic can not be replayed.  The driver's nonces are
+			 * random, so its encrypted writes differ from the capture, and the
+			 * captured frames were encrypted with nonces the driver never sent.
+			 */
+			class ReplayController: public Controller
+			{
+				public:
+					ReplayController();
+					virtual ~ReplayController();
+
+					/**
+					 * Load a capture file and start playing it back.
+					 * @param _captureFile The capture file to play.
+					 */
+					bool Open(string const& _captureFile);
+					bool Close();
+
+					/**
+					 * Check data written by the driver against the capture.
+					 */
+					uint32 Write(uint8* _buffer, uint32 _length);
+
+				private:
+					enum WriteWait
+					{
+						WriteWait_Written,
+						WriteWait_Timeout,
+						WriteWait_Exit
+					};
+
+					static void ReplayThreadEntryPoint(Event* _exitEvent, void* _context);
+					void ReplayThreadProc(Event* _exitEvent);
+					WriteWait WaitForWrite(Event* _exitEvent, std::vector<uint8>* _data);
+
+					string m_captureFile;
+					std::vector<SerialCapture::Record> m_records;
+					std::list<std::vector<uint8> > m_written;	// Writes the replay thread has not checked yet
+					Thread* m_thread;
+					Mutex* m_writeMutex;						// Protects m_written
+					Event* m_writeEvent;						// Set while m_written is not empty
+					bool m_bOpen;
+					bool m_realtime;							// Play back at the recorded pace
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_ReplayController_H
@@ -0,0 +1,211 @@
+//-----------------------------------------------------------------------------
+//
+//	SerialCapture.cpp
+//
+//	Record and read back the bytes exchanged with a controller
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include <string.h>
+#include "Utils.h"
+#include "platform/SerialCapture.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			static char const c_magic[4] =
+			{ 'O', 'Z', 'W', 'C' };
+			static uint8 const c_version = 1;
+
+//-----------------------------------------------------------------------------
+//	<PutVarint>
+//	Append an unsigned LEB128 value
+//-----------------------------------------------------------------------------
+			static uint32 PutVarint(uint8* _buffer, uint64 _value)
+			{
+				uint32 length = 0;
+				while (_value >= 0x80)
+				{
+					_buffer[length++] = (uint8) (_value | 0x80);
+					_value >>= 7;
+				}
+				_buffer[length++] = (uint8) _value;
+				return length;
+			}
+
+//-----------------------------------------------------------------------------
+//	<GetVarint>
+//	Read an unsigned LEB128 value
+//-----------------------------------------------------------------------------
+			static bool GetVarint(FILE* _file, uint64* _value)
+			{
+				*_value = 0;
+				for (uint32 shift = 0; shift < 64; shift += 7)
+				{
+					int c = fgetc(_file);
+					if (c == EOF)
+					{
+						return false;
+					}
+					*_value |= ((uint64) (c & 0x7f)) << shift;
+					if ((c & 0x80) == 0)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::GetMonotonicTime>
+//	Microseconds on a clock that never goes backwards
+//-----------------------------------------------------------------------------
+			uint64 SerialCapture::GetMonotonicTime()
+			{
+				return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::Create>
+//	Start a new capture file
+//-----------------------------------------------------------------------------
+			SerialCapture* SerialCapture::Create(string const& _filename)
+			{
+				FILE* file = fopen(_filename.c_str(), "wb");
+				if (!file)
+				{
+					Log::Write(LogLevel_Warning, "Unable to create the serial capture file %s", _filename.c_str());
+					return NULL;
+				}
+				uint8 header[5];
+				memcpy(header, c_magic, 4);
+				header[4] = c_version;
+				if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+				{
+					Log::Write(LogLevel_Warning, "Unable to write the serial capture file %s", _filename.c_str());
+					fclose(file);
+					return NULL;
+				}
+				Log::Write(LogLevel_Info, "Capturing the serial traffic to %s", _filename.c_str());
+				return new SerialCapture(file);
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::SerialCapture>
+//	Constructor
+//-----------------------------------------------------------------------------
+			SerialCapture::SerialCapture(FILE* _file) :
+					m_file(_file), m_mutex(new Mutex()), m_lastTime(0), m_first(true)
+			{
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::~SerialCapture>
+//	Destructor
+//-----------------------------------------------------------------------------
+			SerialCapture::~SerialCapture()
+			{
+				fclose(m_file);
+				m_mutex->Release();
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::Write>
+//	Append a record to the file
+//-----------------------------------------------------------------------------
+			void SerialCapture::Write(Direction _direction, uint8 const* _data, uint32 _length)
+			{
+				LockGuard LG(m_mutex);
+
+				uint64 now = GetMonotonicTime();
+				uint64 delta = m_first ? 0 : now - m_lastTime;
+				m_first = false;
+				m_lastTime = now;
+
+				uint8 header[1 + 10 + 5];
+				uint32 length = 0;
+				header[length++] = (uint8) _direction;
+				length += PutVarint(&header[length], delta);
+				length += PutVarint(&header[length], _length);
+				fwrite(header, 1, length, m_file);
+				fwrite(_data, 1, _length, m_file);
+
+				// Flushed every time, so a capture survives the crash it was made to catch
+				fflush(m_file);
+			}
+
+//-----------------------------------------------------------------------------
+//	<SerialCapture::Load>
+//	Read all the records of a capture file
+//-----------------------------------------------------------------------------
+			bool SerialCapture::Load(string const& _filename, std::vector<Record>* _records)
+			{
+				FILE* file = fopen(_filename.c_str(), "rb");
+				if (!file)
+				{
+					Log::Write(LogLevel_Warning, "Unable to open the serial capture file %s", _filename.c_str());
+					return false;
+				}
+				uint8 header[5];
+				if ((fread(header, 1, sizeof(header), file) != sizeof(header)) || memcmp(header, c_magic, 4) || (header[4] != c_version))
+				{
+					Log::Write(LogLevel_Warning, "%s is not a serial capture file", _filename.c_str());
+					fclose(file);
+					return false;
+				}
+
+				_records->clear();
+				uint64 time = 0;
+				int c;
+				while ((c = fgetc(file)) != EOF)
+				{
+					uint64 delta, length;
+					if ((c > Direction_Out) || !GetVarint(file, &delta) || !GetVarint(file, &length) || (length > 0xffff))
+					{
+						Log::Write(LogLevel_Warning, "Serial capture file %s is corrupt after %d records", _filename.c_str(), (int) _records->size());
+						break;
+					}
+					Record record;
+					record.m_direction = (Direction) c;
+					time += delta;
+					record.m_time = time;
+					record.m_data.resize((size_t) length);
+					if (length && (fread(&record.m_data[0], 1, (size_t) length, file) != length))
+					{
+						// The last record of a capture that was cut short
+						Log::Write(LogLevel_Warning, "Serial capture file %s ends in the middle of a record", _filename.c_str());
+						break;
+					}
+					_records->push_back(record);
+				}
+				fclose(file);
+				return true;
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//	SerialCapture.h
+//
+//	Record and read back the bytes exchanged with a controller
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _SerialCapture_H
+#define _SerialCapture_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Mutex;
+
+			/** \brief A capture file of the raw bytes exchanged with a controller.
+			 * \ingroup Platform
+			 *
+			 * The file starts with the magic "OZWC" and a version byte, followed by
+			 * one record per read from, or write to, the controller:
+			 *  - direction byte (Direction_In or Direction_Out)
+			 *  - microseconds since the previous record (LEB128 varint)
+			 *  - length of the data (LEB128 varint)
+			 *  - the data
+			 *
+			 * The times come from a monotonic clock, so they are not disturbed by
+			 * changes to the system time.
+			 */
+			class SerialCapture
+			{
+				public:
+					enum Direction
+					{
+						Direction_In = 0,				// Received from the controller
+						Direction_Out					// Sent to the controller
+					};
+
+					struct Record
+					{
+							Direction m_direction;
+							uint64 m_time;				// Microseconds since the first record
+							std::vector<uint8> m_data;
+					};
+
+					/**
+					 * Start a new capture file.
+					 * \return the capture, or NULL if the file could not be created.
+					 */
+					static SerialCapture* Create(string const& _filename);
+					~SerialCapture();
+
+					/**
+					 * Append a record, timestamped now.  Safe to call from the
+					 * controller's read thread and the driver thread at once.
+					 */
+					void Write(Direction _direction, uint8 const* _data, uint32 _length);
+
+					/**
+					 * Read every record of a capture file.
+					 * \return false if the file cannot be read or is not a capture.
+					 */
+					static bool Load(string const& _filename, std::vector<Record>* _records);
+
+					/** Microseconds from an arbitrary (but fixed) point, that never go backwards */
+					static uint64 GetMonotonicTime();
+
+				private:
+					SerialCapture(FILE* _file);
+
+					FILE* m_file;
+					Mutex* m_mutex;					// Serializes Write
+					uint64 m_lastTime;
+					bool m_first;
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_SerialCapture_H
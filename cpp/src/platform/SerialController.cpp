@@ -158,6 +158,7 @@ namespace OpenZWave
 
 				Log::Write(LogLevel_StreamDetail, "      SerialController::Write (sent to controller)");
 				LogData(_buffer, _length, "      Write: ");
+				CaptureWrite(_buffer, _length);
 
 				return (m_pImpl->Write(_buffer, _length));
 			}
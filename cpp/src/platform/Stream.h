@@ -82,9 +82,10 @@ namespace OpenZWave
 					 * \param _size the amount of data in bytes to copy to the stream.
 					 * \return true if all the requested data has been copied.  False if there was not enough space in
 					 * the stream's circular buffer.
-					 * \see Get, GetDataSize
+					 * Virtual so that a Controller can see all the data it receives.
+					 * \see Get, GetDataSize, Controller::Put
 					 */
-					bool Put(uint8* _buffer, uint32 _size);
+					virtual bool Put(uint8* _buffer, uint32 _size);
 
 					/**
 					 * Returns the amount of data in bytes that is stored in the stream.
@@ -92,6 +92,15 @@ namespace OpenZWave
 				return true;
 			}
 
+//-----------------------------------------------------------------------------
+//	<Thread::Join>
+//	Wait for the function running on this thread to return
+//-----------------------------------------------------------------------------
+			bool Thread::Join()
+			{
+				return (m_pImpl->Join());
+			}
+
 //-----------------------------------------------------------------------------
 //	<Thread::Sleep>
 //	Causes the thread to sleep for the specified number of milliseconds.
@@ -77,6 +77,14 @@ namespace OpenZWave
 					 */
 					bool Stop();
 
+					/**
+					 * Wait for the function running on this thread to return, and free
+					 * the thread.  Only for functions that finish by themselves.
+					 * \return True if there was a thread to wait for.
+					 * \see Start, Stop
+					 */
+					bool Join();
+
 					/**
 					 * Causes the thread to sleep for the specified number of milliseconds.
 					 * \param _millisecs Number of milliseconds to sleep.
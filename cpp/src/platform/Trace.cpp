@@ -0,0 +1,256 @@
+//-----------------------------------------------------------------------------
+//
+//	Trace.cpp
+//
+//	Spans of what the library threads are doing, for chrome://tracing and Perfetto
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include <list>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "Options.h"
+#include "Utils.h"
+#include "platform/Trace.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			struct TraceEvent
+			{
+					char const* m_name;
+					char const* m_detail;
+					int32 m_arg;
+					uint32 m_duration;				// Microseconds
+					uint64 m_start;					// Microseconds, from Trace::GetTime
+			};
+
+			// The spans of one thread.  Only that thread writes to it.
+			struct TraceThreadBuffer
+			{
+					string m_name;
+					uint32 m_id;
+					std::vector<TraceEvent> m_events;
+					std::atomic<uint64> m_count;	// Spans recorded, of which the last m_events.size() are kept
+			};
+
+			std::atomic<bool> Trace::s_enabled(false);
+
+			static Mutex* s_mutex = NULL;						// Protects s_buffers
+			static std::list<TraceThreadBuffer*> s_buffers;
+			static string s_filename;
+			static uint32 s_capacity = 0;
+			static uint64 s_startTime = 0;
+
+			// Each start of tracing is a new generation, so a thread's buffer from an
+			// earlier one is never used
+			static std::atomic<uint32> s_generation(0);
+			static thread_local TraceThreadBuffer* t_buffer = NULL;
+			static thread_local uint32 t_generation = 0;
+
+//-----------------------------------------------------------------------------
+//	<Trace::GetTime>
+//	Microseconds on a clock that never goes backwards
+//-----------------------------------------------------------------------------
+			uint64 Trace::GetTime()
+			{
+				return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::Create>
+//	Start tracing if it has been configured
+//-----------------------------------------------------------------------------
+			void Trace::Create()
+			{
+				if (IsEnabled())
+				{
+					return;
+				}
+				string filename;
+				int32 capacity = 32768;
+				Options::Get()->GetOptionAsString("TraceFile", &filename);
+				Options::Get()->GetOptionAsInt("TraceBufferSize", &capacity);
+				if (filename.empty())
+				{
+					return;
+				}
+				if (capacity < 1024)
+				{
+					Log::Write(LogLevel_Warning, "TraceBufferSize must be at least 1024 spans");
+					capacity = 1024;
+				}
+
+				s_mutex = new Mutex();
+				s_filename = ResolveUserPath(filename);
+				s_capacity = (uint32) capacity;
+				s_startTime = GetTime();
+				++s_generation;
+				s_enabled.store(true);
+				Log::Write(LogLevel_Info, "Tracing the last %d spans of each thread to %s", capacity, s_filename.c_str());
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::Destroy>
+//	Write the trace file and stop tracing
+//-----------------------------------------------------------------------------
+			void Trace::Destroy()
+			{
+				if (!IsEnabled())
+				{
+					return;
+				}
+				s_enabled.store(false);
+				Write(s_filename);
+
+				s_mutex->Lock();
+				for (std::list<TraceThreadBuffer*>::iterator it = s_buffers.begin(); it != s_buffers.end(); ++it)
+				{
+					delete *it;
+				}
+				s_buffers.clear();
+				s_mutex->Unlock();
+				s_mutex->Release();
+				s_mutex = NULL;
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::GetThreadBuffer>
+//	The calling thread's buffer, created the first time it records a span
+//-----------------------------------------------------------------------------
+			TraceThreadBuffer* Trace::GetThreadBuffer()
+			{
+				uint32 generation = s_generation.load();
+				if ((t_buffer != NULL) && (t_generation == generation))
+				{
+					return t_buffer;
+				}
+
+				TraceThreadBuffer* buffer = new TraceThreadBuffer();
+				buffer->m_events.resize(s_capacity);
+				buffer->m_count.store(0);
+				{
+					LockGuard LG(s_mutex);
+					buffer->m_id = (uint32) s_buffers.size() + 1;
+					s_buffers.push_back(buffer);
+				}
+				t_buffer = buffer;
+				t_generation = generation;
+				return buffer;
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::SetThreadName>
+//	Name the calling thread in the trace
+//-----------------------------------------------------------------------------
+			void Trace::SetThreadName(string const& _name)
+			{
+				if (IsEnabled())
+				{
+					GetThreadBuffer()->m_name = _name;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::Complete>
+//	Record a span in the calling thread's buffer
+//-----------------------------------------------------------------------------
+			void Trace::Complete(char const* _name, char const* _detail, int32 _arg, uint64 _start, uint64 _end)
+			{
+				if (!IsEnabled())
+				{
+					return;
+				}
+				TraceThreadBuffer* buffer = GetThreadBuffer();
+				uint64 count = buffer->m_count.load(std::memory_order_relaxed);
+				TraceEvent& event = buffer->m_events[count % buffer->m_events.size()];
+				event.m_name = _name;
+				event.m_detail = _detail;
+				event.m_arg = _arg;
+				event.m_start = _start;
+				event.m_duration = (uint32) (_end - _start);
+				buffer->m_count.store(count + 1, std::memory_order_release);
+			}
+
+//-----------------------------------------------------------------------------
+//	<Trace::Write>
+//	Write the spans in the Chrome trace event format
+//-----------------------------------------------------------------------------
+			void Trace::Write(string const& _filename)
+			{
+				FILE* file = fopen(_filename.c_str(), "w");
+				if (!file)
+				{
+					Log::Write(LogLevel_Warning, "Unable to write the trace file %s", _filename.c_str());
+					return;
+				}
+
+				LockGuard LG(s_mutex);
+				uint64 written = 0;
+				fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+				fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"OpenZWave\"}}");
+				for (std::list<TraceThreadBuffer*>::const_iterator it = s_buffers.begin(); it != s_buffers.end(); ++it)
+				{
+					TraceThreadBuffer const* buffer = *it;
+					fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", buffer->m_id, buffer->m_name.empty() ? "application" : buffer->m_name.c_str());
+
+					uint64 count = buffer->m_count.load(std::memory_order_acquire);
+					uint64 size = buffer->m_events.size();
+					for (uint64 i = (count > size) ? count - size : 0; i < count; ++i)
+					{
+						TraceEvent const& event = buffer->m_events[i % size];
+						char name[128];
+						if ((event.m_arg >= 0) && strchr(event.m_name, '%'))
+						{
+							snprintf(name, sizeof(name), event.m_name, event.m_arg);
+						}
+						else
+						{
+							snprintf(name, sizeof(name), "%s", event.m_name);
+						}
+						fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"dur\":%u", name, buffer->m_id, (unsigned long long) (event.m_start - s_startTime), event.m_duration);
+						if (event.m_detail != NULL)
+						{
+							fprintf(file, ",\"args\":{\"detail\":\"%s\"}", event.m_detail);
+						}
+						else if (event.m_arg >= 0)
+						{
+							fprintf(file, ",\"args\":{\"value\":%d}", event.m_arg);
+						}
+						fprintf(file, "}");
+						++written;
+					}
+				}
+				fprintf(file, "\n]}\n");
+				fclose(file);
+				Log::Write(LogLevel_Info, "Wrote %llu trace spans to %s", (unsigned long long) written, _filename.c_str());
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------
+//
+//	Trace.h
+//
+//	Spans of what the library threads are doing, for chrome://tracing and Perfetto
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Trace_H
+#define _Trace_H
+
+#include <atomic>
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			struct TraceThreadBuffer;
+
+			/** \brief Record what the library's threads spend their time on.
+			 * \ingroup Platform
+			 *
+			 * Enabled with the TraceFile option.  Each thread records spans (a name,
+			 * a start and a duration) in a ring buffer of its own, so recording a
+			 * span takes no lock, and the last TraceBufferSize spans of each thread
+			 * are kept.  When the Manager is destroyed the spans are written to the
+			 * TraceFile in the Chrome trace event JSON format, which
+			 * chrome://tracing and ui.perfetto.dev open.  When tracing is disabled,
+			 * a span costs a single test of a flag.
+			 */
+			class Trace
+			{
+				public:
+					/**
+					 * Start tracing, if the TraceFile option is set.
+					 */
+					static void Create();
+
+					/**
+					 * Write the trace file and stop tracing.  Must only be called once
+					 * the threads that were traced have stopped.
+					 */
+					static void Destroy();
+
+					static bool IsEnabled()
+					{
+						return s_enabled.load(std::memory_order_relaxed);
+					}
+
+					/**
+					 * Name the calling thread in the trace.
+					 */
+					static void SetThreadName(string const& _name);
+
+					/**
+					 * Record a span of the calling thread.
+					 * \param _name Static string naming the span.  It may contain one
+					 * printf conversion, which _arg is formatted with.
+					 * \param _detail Static string shown with the span, or NULL.
+					 * \param _arg Number shown with the span, or -1 for none.
+					 * \param _start Start time, from GetTime.
+					 * \param _end End time, from GetTime.
+					 */
+					static void Complete(char const* _name, char const* _detail, int32 _arg, uint64 _start, uint64 _end);
+
+					/** Microseconds on a clock that never goes backwards */
+					static uint64 GetTime();
+
+				private:
+					static TraceThreadBuffer* GetThreadBuffer();
+					static void Write(string const& _filename);
+
+					static std::atomic<bool> s_enabled;
+			};
+
+			/** \brief Trace the time from its construction until it goes out of scope.
+			 * \ingroup Platform
+			 */
+			class TraceSpan
+			{
+				public:
+					TraceSpan(char const* _name, char const* _detail = NULL) :
+							m_name(_name), m_detail(_detail), m_arg(-1), m_start(Trace::IsEnabled() ? Trace::GetTime() : 0)
+					{
+					}
+					TraceSpan(char const* _name, int32 _arg) :
+							m_name(_name), m_detail(NULL), m_arg(_arg), m_start(Trace::IsEnabled() ? Trace::GetTime() : 0)
+					{
+					}
+					~TraceSpan()
+					{
+						if (m_start != 0)
+						{
+							Trace::Complete(m_name, m_detail, m_arg, m_start, Trace::GetTime());
+						}
+					}
+
+					/**
+					 * Set the number shown with the span, once it is known.
+					 */
+					void SetArg(int32 _arg)
+					{
+						m_arg = _arg;
+					}
+
+				private:
+					TraceSpan(TraceSpan const&);			// prevent copy
+					TraceSpan& operator =(TraceSpan const&);	// prevent assignment
+
+					char const* m_name;
+					char const* m_detail;
+					int32 m_arg;
+					uint64 m_start;							// 0 if tracing was disabled when the span started
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_Trace_H
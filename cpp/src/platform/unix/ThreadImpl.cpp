@@ -29,6 +29,7 @@
 #include "Defs.h"
 #include "platform/Event.h"
 #include "platform/Thread.h"
+#include "platform/Trace.h"
 #include "ThreadImpl.h"
 
 #ifdef __ANDROID__
@@ -53,7 +54,7 @@ namespace OpenZWave
 			ThreadImpl::ThreadImpl(Thread* _owner, string const& _tname) :
 					m_owner(_owner),
 //	m_hThread( NULL ),  /* p_thread_t isn't a pointer in Linux, so can't do this */
-					m_bIsRunning(false), m_name(_tname)
+					m_bIsRunning(false), m_bJoinable(false), m_name(_tname)
 			{
 			}
 
@@ -83,7 +84,7 @@ namespace OpenZWave
 				m_exitEvent = _exitEvent;
 				m_exitEvent->Reset();
 
-				pthread_create(&m_hThread, &ta, ThreadImpl::ThreadProc, this);
+				m_bJoinable = (pthread_create(&m_hThread, &ta, ThreadImpl::ThreadProc, this) == 0);
 				string threadname("OZW-");
 				threadname.append(m_name);
 #if !defined(__APPLE_CC__) && !defined(__FreeBSD__) && !defined(__NetBSD__)
@@ -123,10 +124,27 @@ namespace OpenZWave
 				m_bIsRunning = false;
 				pthread_cancel(m_hThread);
 				pthread_join(m_hThread, &data);
+				m_bJoinable = false;
 
 				return true;
 			}
 
+//-----------------------------------------------------------------------------
+//	<ThreadImpl::Join>
+//	Wait for this thread to end
+//-----------------------------------------------------------------------------
+			bool ThreadImpl::Join()
+			{
+				if (!m_bJoinable)
+				{
+					return false;
+				}
+
+				pthread_join(m_hThread, NULL);
+				m_bJoinable = false;
+				return true;
+			}
+
 //-----------------------------------------------------------------------------
 //	<ThreadImpl::msSleep>
 //	Cause thread to sleep for the specified number of milliseconds
@@ -167,6 +185,7 @@ namespace OpenZWave
 			void ThreadImpl::Run()
 			{
 				m_bIsRunning = true;
+				Trace::SetThreadName(m_name);
 				m_pfnThreadProc(m_exitEvent, m_pContext);
 				m_bIsRunning = false;
 
@@ -55,6 +55,7 @@ namespace OpenZWave
 					void Sleep(uint32 _millisecs);
 					bool IsSignalled();
 					bool Terminate();
+					bool Join();
 
 					void Run();
 					static void* ThreadProc(void *parg);
@@ -65,6 +66,7 @@ namespace OpenZWave
 					Thread::pfnThreadProc_t m_pfnThreadProc;
 					void* m_pContext;
 					bool m_bIsRunning;
+					bool m_bJoinable;					// Started, and not joined yet
 					string m_name;
 			};
 		} // namespace Platform
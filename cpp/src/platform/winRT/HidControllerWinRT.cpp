@@ -238,6 +238,7 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 		uint32 HidController::Write(uint8* _buffer, uint32 _length)
 		{
+			CaptureWrite(_buffer, _length);
 			// report Id 0x04 is tx feature report
 			return SendFeatureReport(_buffer, _length, 0x04);
 		}
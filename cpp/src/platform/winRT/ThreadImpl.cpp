@@ -28,6 +28,7 @@
 #include "Defs.h"
 #include "platform/Event.h"
 #include "platform/Thread.h"
+#include "platform/Trace.h"
 #include "ThreadImpl.h"
 #include "Options.h"
 
@@ -84,6 +85,7 @@ namespace OpenZWave
 				create_task([this]()
 				{
 					m_bIsRunning = true;
+					Trace::SetThreadName(m_name);
 					try
 					{
 						m_pfnThreadProc(m_exitEvent, m_context);
@@ -127,6 +129,16 @@ namespace OpenZWave
 				return true;
 			}
 
+//-----------------------------------------------------------------------------
+//	<ThreadImpl::Join>
+//	Wait for this thread to end
+//-----------------------------------------------------------------------------
+			bool ThreadImpl::Join()
+			{
+				// The task belongs to the thread pool, so all we can do is wait for it
+				return (Wait::Single(m_owner) >= 0);
+			}
+
 //-----------------------------------------------------------------------------
 //	<ThreadImpl::IsSignalled>
 //	Test whether the thread has completed
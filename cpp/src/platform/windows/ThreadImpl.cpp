@@ -28,6 +28,7 @@
 #include "Defs.h"
 #include "platform/Event.h"
 #include "platform/Thread.h"
+#include "platform/Trace.h"
 #include "ThreadImpl.h"
 
 namespace OpenZWave
@@ -100,6 +101,23 @@ namespace OpenZWave
 				return true;
 			}
 
+//-----------------------------------------------------------------------------
+//	<ThreadImpl::Join>
+//	Wait for this thread to end
+//-----------------------------------------------------------------------------
+			bool ThreadImpl::Join()
+			{
+				if (m_hThread == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+
+				::WaitForSingleObject(m_hThread, INFINITE);
+				::CloseHandle(m_hThread);
+				m_hThread = INVALID_HANDLE_VALUE;
+				return true;
+			}
+
 //-----------------------------------------------------------------------------
 //	<ThreadImpl::IsSignalled>
 //	Test whether the thread has completed
@@ -127,6 +145,7 @@ namespace OpenZWave
 			void ThreadImpl::Run()
 			{
 				m_bIsRunning = true;
+				Trace::SetThreadName(m_name);
 				m_pfnThreadProc(m_exitEvent, m_context);
 				m_bIsRunning = false;
 
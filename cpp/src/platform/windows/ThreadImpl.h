@@ -55,6 +55,7 @@ namespace OpenZWave
 					bool Start(Thread::pfnThreadProc_t _pfnThreadProc, Event* _exitEvent, void* _context);
 					void Sleep(uint32 _milliseconds);
 					bool Terminate();
+					bool Join();
 
 					bool IsSignalled();
 
@@ -34,10 +34,11 @@
 #include "Msg.h"
 #include "Bitfield.h"
 #include "value_classes/Value.h"
+#include "value_classes/ValueHandle.h"
 #include "platform/Log.h"
 #include "command_classes/CommandClass.h"
-#include "command_classes/Supervision.h"
 #include <ctime>
+#include <string.h>
 #include "Options.h"
 
 namespace OpenZWave
@@ -58,7 +59,7 @@ namespace OpenZWave
 // Constructor
 //-----------------------------------------------------------------------------
 			Value::Value(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, ValueID::ValueType const _type, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, bool const _isSet, uint8 const _pollIntensity) :
-					m_min(0), m_max(0), m_refreshTime(0), m_verifyChanges(false), m_refreshAfterSet(true), m_id(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, _type), m_targetValueSet(false), m_duration(0), m_units(_units), m_readOnly(_readOnly), m_writeOnly(_writeOnly), m_isSet(_isSet), m_affectsLength(0), m_affects(), m_affectsAll(false), m_checkChange(false), m_pollIntensity(_pollIntensity)
+					m_min(0), m_max(0), m_refreshTime(0), m_verifyChanges(false), m_refreshAfterSet(true), m_id(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, _type), m_targetValueSet(false), m_duration(0), m_units(_units), m_readOnly(_readOnly), m_writeOnly(_writeOnly), m_isSet(_isSet), m_affectsLength(0), m_affects(), m_affectsAll(false), m_checkChange(false), m_pollIntensity(_pollIntensity), m_handle(NULL)
 			{
 				SetLabel(_label);
 				if (Driver* driver = Manager::Get()->GetDriver(m_id.GetHomeId()))
@@ -72,16 +73,32 @@ namespace OpenZWave
 // Constructor (from XML)
 //-----------------------------------------------------------------------------
 			Value::Value() :
-					m_min(0), m_max(0), m_refreshTime(0), m_verifyChanges(false), m_refreshAfterSet(true), m_targetValueSet(false), m_duration(0), m_readOnly(false), m_writeOnly(false), m_isSet(false), m_affectsLength(0), m_affects(), m_affectsAll(false), m_checkChange(false), m_pollIntensity(0)
+					m_min(0), m_max(0), m_refreshTime(0), m_verifyChanges(false), m_refreshAfterSet(true), m_targetValueSet(false), m_duration(0), m_readOnly(false), m_writeOnly(false), m_isSet(false), m_affectsLength(0), m_affects(), m_affectsAll(false), m_checkChange(false), m_pollIntensity(0), m_handle(NULL)
 			{
 			}
 
+//-----------------------------------------------------------------------------
+// <Value::Value>
+// Copy constructor, for the temporary copies made by the Set methods.  The
+// copy does not share the handle, which belongs to the value in the store.
+//-----------------------------------------------------------------------------
+			Value::Value(Value const& _other) :
+					Ref(_other), Timer(_other), m_min(_other.m_min), m_max(_other.m_max), m_refreshTime(_other.m_refreshTime), m_verifyChanges(_other.m_verifyChanges), m_refreshAfterSet(_other.m_refreshAfterSet), m_id(_other.m_id), m_targetValueSet(_other.m_targetValueSet), m_duration(_other.m_duration), m_units(_other.m_units), m_readOnly(_other.m_readOnly), m_writeOnly(_other.m_writeOnly), m_isSet(_other.m_isSet), m_affectsLength(_other.m_affectsLength), m_affects(NULL), m_affectsAll(_other.m_affectsAll), m_checkChange(_other.m_checkChange), m_pollIntensity(_other.m_pollIntensity), m_handle(NULL)
+			{
+				if (m_affectsLength > 0)
+				{
+					m_affects = new uint8[m_affectsLength];
+					memcpy(m_affects, _other.m_affects, m_affectsLength);
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <Value::~Value>
 // Destructor
 //-----------------------------------------------------------------------------
 			Value::~Value()
 			{
+				InvalidateHandle();
 				if (m_affectsLength > 0)
 				{
 					delete[] m_affects;
@@ -307,19 +324,22 @@ namespace OpenZWave
 						{
 							Log::Write(LogLevel_Info, m_id.GetNodeId(), "Value::Set - %s - %s - %d - %d - %s", cc->GetCommandClassName().c_str(), this->GetLabel().c_str(), m_id.GetIndex(), m_id.GetInstance(), this->GetAsString().c_str());
 							// flag value as set and queue a "Set Value" message for transmission to the device
+							// (clearing any flag left by a Set that was sent from inside the command class)
+							cc->TakeSupervisedSet();
 							res = cc->SetValue(*this);
+							bool supervised = cc->TakeSupervisedSet();
 
 							if (res)
 							{
 								if (!IsWriteOnly())
 								{
-									if (m_refreshAfterSet)
+									node->SetValueSent(m_id);
+
+									// A supervised Set is confirmed by the Supervision Report instead
+									if (m_refreshAfterSet && !supervised)
 									{
-										if (!node->GetCommandClass(Internal::CC::Supervision::StaticGetCommandClassId()))
-										{
-											// queue a "RequestValue" message to update the value
-											cc->RequestValue( 0, m_id.GetIndex(), m_id.GetInstance(), Driver::MsgQueue_Send );
-										}
+										// queue a "RequestValue" message to update the value
+										cc->RequestValue( 0, m_id.GetIndex(), m_id.GetInstance(), Driver::MsgQueue_Send );
 									}
 								}
 								else
@@ -363,6 +383,11 @@ namespace OpenZWave
 				if (Driver* driver = Manager::Get()->GetDriver(m_id.GetHomeId()))
 				{
 					m_isSet = true;
+					if (Node* node = driver->GetNodeUnsafe(m_id.GetNodeId()))
+					{
+						// Any report of the value completes a Set of it
+						node->SetValueConfirmed(m_id);
+					}
 
 					bool bSuppress;
 					Options::Get()->GetOptionAsBool("SuppressValueRefresh", &bSuppress);
@@ -390,6 +415,11 @@ namespace OpenZWave
 				if (Driver* driver = Manager::Get()->GetDriver(m_id.GetHomeId()))
 				{
 					m_isSet = true;
+					if (Node* node = driver->GetNodeUnsafe(m_id.GetNodeId()))
+					{
+						// Any report of the value completes a Set of it
+						node->SetValueConfirmed(m_id);
+					}
 
 					// Notify the watchers
 					Notification* notification = new Notification(Notification::Type_ValueChanged);
@@ -837,6 +867,34 @@ namespace OpenZWave
 				}
 			}
 
+//-----------------------------------------------------------------------------
+// <Value::GetHandle>
+// Get the handle for this value, creating it on first use.  The caller must
+// hold the node mutex and release the handle when done with it.
+//-----------------------------------------------------------------------------
+			ValueHandle* Value::GetHandle(Internal::Platform::Mutex* _mutex)
+			{
+				if (!m_handle)
+				{
+					m_handle = new ValueHandle(this, _mutex);
+				}
+				m_handle->AddRef();
+				return m_handle;
+			}
+
+//-----------------------------------------------------------------------------
+// <Value::InvalidateHandle>
+// Detach the handle from this value, as the value is no longer reachable
+//-----------------------------------------------------------------------------
+			void Value::InvalidateHandle()
+			{
+				if (m_handle)
+				{
+					ValueHandle* handle = m_handle;
+					m_handle = NULL;
+					handle->Invalidate();
+				}
+			}
 
 		} // namespace VC
 	} // namespace Internal
@@ -37,14 +37,20 @@
 #include "platform/Ref.h"
 #include "value_classes/ValueID.h"
 #include "platform/Log.h"
+#include "StringPool.h"
 
 class TiXmlElement;
 
 namespace OpenZWave
 {
 	class Driver;
+	class ValueHandle;
 	namespace Internal
 	{
+		namespace Platform
+		{
+			class Mutex;
+		}
 		namespace VC
 		{
 
@@ -59,6 +65,7 @@ namespace OpenZWave
 				public:
 					Value(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, ValueID::ValueType const _type, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, bool const _isset, uint8 const _pollIntensity);
 					Value();
+					Value(Value const& _other);
 
 					virtual void ReadXML(uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement);
 					virtual void WriteXML(TiXmlElement* _valueElement);
@@ -116,6 +123,14 @@ namespace OpenZWave
 					{
 						return m_max;
 					}
+					void SetMin(int32 const _min)
+					{
+						m_min = _min;
+					}
+					void SetMax(int32 const _max)
+					{
+						m_max = _max;
+					}
 
 					void SetChangeVerified(bool _verify)
 					{
@@ -146,6 +161,16 @@ namespace OpenZWave
 
 					bool Set();							// For the user to change a value in a device
 
+					/**
+					 * Store the value that was last Set, now the device has confirmed it
+					 * (from a Supervision Report).  Returns false for value types that
+					 * don't keep track of what was Set - they have to be requested again.
+					 */
+					virtual bool ConfirmNewValue()
+					{
+						return false;
+					}
+
 					// Helpers
 					static OpenZWave::ValueID::ValueGenre GetGenreEnumFromName(char const* _name);
 					static char const* GetGenreNameFromEnum(ValueID::ValueGenre _genre);
@@ -165,6 +190,9 @@ namespace OpenZWave
 #endif
 					void sendValueRefresh(uint32 _unused);
 
+					ValueHandle* GetHandle(Internal::Platform::Mutex* _mutex);	// Returns the handle for this value with a reference added
+					void InvalidateHandle();			// The value is leaving its ValueStore
+
 				protected:
 					virtual ~Value();
 
@@ -197,7 +225,7 @@ namespace OpenZWave
 					uint32 m_duration;			// The Duration, if the CC supports it
 
 				private:
-					string m_units;
+					InternedString m_units;
 					bool m_readOnly;
 					bool m_writeOnly;
 					bool m_isSet;
@@ -206,6 +234,7 @@ namespace OpenZWave
 					bool m_affectsAll;
 					bool m_checkChange;
 					uint8 m_pollIntensity;
+					ValueHandle* m_handle;
 			};
 		} // namespace VC
 	} // namespace Internal
@@ -217,6 +217,7 @@ namespace OpenZWave
 				ValueBitSet* tempValue = new ValueBitSet(*this);
 
 				tempValue->m_value.SetValue(_value);
+				m_newValue = tempValue->m_value;
 
 				// Set the value in the device.
 				bool ret = ((Value*) tempValue)->Set();
@@ -240,6 +241,7 @@ namespace OpenZWave
 				ValueBitSet* tempValue = new ValueBitSet(*this);
 
 				tempValue->m_value.Set(_idx - 1);
+				m_newValue = tempValue->m_value;
 
 				// Set the value in the device.
 				bool ret = ((Value*) tempValue)->Set();
@@ -262,6 +264,7 @@ namespace OpenZWave
 				// create a temporary copy of this value to be submitted to the Set() call and set its value to the function param
 				ValueBitSet* tempValue = new ValueBitSet(*this);
 				tempValue->m_value.Clear(_idx - 1);
+				m_newValue = tempValue->m_value;
 
 				// Set the value in the device.
 				bool ret = ((Value*) tempValue)->Set();
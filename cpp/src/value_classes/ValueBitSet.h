@@ -70,6 +70,11 @@ namespace OpenZWave
 					uint32 GetBitMask() const;
 
 					void OnValueRefreshed(uint32 const _value);
+					virtual bool ConfirmNewValue()
+					{
+						OnValueRefreshed(m_newValue.GetValue());
+						return true;
+					}
 
 					// From Value
 					virtual string const GetAsString() const;
@@ -57,10 +57,11 @@ namespace OpenZWave
 
 					bool Set(bool const _value);
 					void OnValueRefreshed(bool const _value);
-					void ConfirmNewValue()
+					virtual bool ConfirmNewValue()
 					{
 						OnValueRefreshed(m_newValue != 0);
-					};
+						return true;
+					}
 					void SetTargetValue(bool const _target, uint32 _duration = 0);
 
 
@@ -55,10 +55,11 @@ namespace OpenZWave
 
 					bool Set(uint8 const _value);
 					void OnValueRefreshed(uint8 const _value);
-					void ConfirmNewValue()
+					virtual bool ConfirmNewValue()
 					{
 						OnValueRefreshed(m_newValue);
-					};
+						return true;
+					}
 					void SetTargetValue(uint8 const _target, uint32 _duration = 0);
 
 					// From Value
@@ -59,10 +59,11 @@ namespace OpenZWave
 
 					bool Set(string const& _value);
 					void OnValueRefreshed(string const& _value);
-					void ConfirmNewValue()
+					virtual bool ConfirmNewValue()
 					{
 						OnValueRefreshed(m_newValue);
-					};
+						return true;
+					}
 					void SetTargetValue(string const _target, uint32 _duration = 0);
 
 					// From Value
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueHandle.cpp
+//
+//	Pre-resolved reference to a Value object
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "value_classes/ValueHandle.h"
+#include "value_classes/Value.h"
+#include "platform/Mutex.h"
+
+namespace OpenZWave
+{
+
+//-----------------------------------------------------------------------------
+// <ValueHandle::ValueHandle>
+// Constructor.  The initial reference belongs to the Value itself.
+//-----------------------------------------------------------------------------
+	ValueHandle::ValueHandle(Internal::VC::Value* _value, Internal::Platform::Mutex* _mutex) :
+			m_id(_value->GetID()), m_value(_value), m_mutex(_mutex), m_refs(1)
+	{
+		// Hold on to the mutex so that it outlives the Driver if the
+		// application keeps the handle around after the driver is removed
+		m_mutex->AddRef();
+	}
+
+//-----------------------------------------------------------------------------
+// <ValueHandle::~ValueHandle>
+// Destructor
+//-----------------------------------------------------------------------------
+	ValueHandle::~ValueHandle()
+	{
+		m_mutex->Release();
+	}
+
+//-----------------------------------------------------------------------------
+// <ValueHandle::AddRef>
+// Add a reference to the handle
+//-----------------------------------------------------------------------------
+	void ValueHandle::AddRef()
+	{
+		m_mutex->Lock();
+		++m_refs;
+		m_mutex->Unlock();
+	}
+
+//-----------------------------------------------------------------------------
+// <ValueHandle::Release>
+// Remove a reference to the handle, deleting it if it was the last one
+//-----------------------------------------------------------------------------
+	void ValueHandle::Release()
+	{
+		// Keep the mutex alive until we are done with it, as deleting the
+		// handle may drop the last reference to it.
+		Internal::Platform::Mutex* mutex = m_mutex;
+		mutex->AddRef();
+		mutex->Lock();
+		bool last = (--m_refs <= 0);
+		mutex->Unlock();
+		if (last)
+		{
+			delete this;
+		}
+		mutex->Release();
+	}
+
+//-----------------------------------------------------------------------------
+// <ValueHandle::Invalidate>
+// Called with the node mutex held when the Value leaves its ValueStore
+//-----------------------------------------------------------------------------
+	void ValueHandle::Invalidate()
+	{
+		m_value = NULL;
+		Release();
+	}
+
+} // namespace OpenZWave
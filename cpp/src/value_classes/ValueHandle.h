@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueHandle.h
+//
+//	Pre-resolved reference to a Value object
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueHandle_H
+#define _ValueHandle_H
+
+#include "Defs.h"
+#include "value_classes/ValueID.h"
+
+namespace OpenZWave
+{
+	class Manager;
+
+	namespace Internal
+	{
+		namespace VC
+		{
+			class Value;
+		}
+		namespace Platform
+		{
+			class Mutex;
+		}
+	}
+
+	/** \brief A ValueID that has already been resolved to the Value it refers to.
+	 * \ingroup ValueID
+	 *
+	 * Every Manager call that takes a ValueID has to look up the Driver, the Node
+	 * and finally the Value before it can do any work.  Applications that access
+	 * the same values repeatedly can instead obtain a ValueHandle once with
+	 * Manager::GetValueHandle and pass it to the ValueHandle overloads of the
+	 * GetValueAs and SetValue methods, which skip those lookups entirely.
+	 * <p>
+	 * There is only ever one ValueHandle per Value, and it is reference counted.
+	 * Each successful call to Manager::GetValueHandle must be matched by a call
+	 * to Manager::ReleaseValueHandle.  If the Value is removed (because the node
+	 * or command class went away) the handle is invalidated, IsValid will return
+	 * false and the handle can only be released.
+	 */
+	class OPENZWAVE_EXPORT ValueHandle
+	{
+			friend class Manager;
+			friend class Internal::VC::Value;
+
+		public:
+			/**
+			 * \brief Get the ValueID this handle was resolved from.
+			 * \return the ValueID of the Value
+			 */
+			ValueID const& GetID() const
+			{
+				return m_id;
+			}
+
+			/**
+			 * \brief Test whether the Value behind this handle still exists.
+			 * \return false once the Value has been removed from its node.
+			 */
+			bool IsValid() const
+			{
+				return m_value != NULL;
+			}
+
+		private:
+			ValueHandle(Internal::VC::Value* _value, Internal::Platform::Mutex* _mutex);
+			~ValueHandle();
+			ValueHandle(ValueHandle const&);					// prevent copy
+			ValueHandle& operator =(ValueHandle const&);		// prevent assignment
+
+			void AddRef();
+			void Release();
+			void Invalidate();
+
+			ValueID m_id;
+			Internal::VC::Value* m_value;				// NULL once the Value has left its ValueStore
+			Internal::Platform::Mutex* m_mutex;			// The node mutex of the Driver that owns the Value
+			int32 m_refs;
+	};
+
+} // namespace OpenZWave
+
+#endif
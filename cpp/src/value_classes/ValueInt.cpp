@@ -46,7 +46,7 @@ namespace OpenZWave
 // Constructor
 //-----------------------------------------------------------------------------
 			ValueInt::ValueInt(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, int32 const _value, uint8 const _pollIntensity) :
-					Value(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_Int, _label, _units, _readOnly, _writeOnly, false, _pollIntensity), m_value(_value), m_valueCheck(0), m_targetValue(0)
+					Value(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_Int, _label, _units, _readOnly, _writeOnly, false, _pollIntensity), m_value(_value), m_valueCheck(0), m_newValue(0), m_targetValue(0)
 			{
 				m_min = INT_MIN;
 				m_max = INT_MAX;
@@ -57,7 +57,7 @@ namespace OpenZWave
 // Constructor (from XML)
 //-----------------------------------------------------------------------------
 			ValueInt::ValueInt() :
-					Value(), m_value(0), m_valueCheck(0)
+					Value(), m_value(0), m_valueCheck(0), m_newValue(0)
 
 			{
 				m_min = INT_MIN;
@@ -119,6 +119,9 @@ namespace OpenZWave
 				ValueInt* tempValue = new ValueInt(*this);
 				tempValue->m_value = _value;
 
+				// Save the new value to be stored when the device confirms the value was set successfully
+				m_newValue = _value;
+
 				// Set the value in the device.
 				bool ret = ((Value*) tempValue)->Set();
 
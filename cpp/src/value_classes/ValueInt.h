@@ -55,6 +55,11 @@ namespace OpenZWave
 
 					bool Set(int32 const _value);
 					void OnValueRefreshed(int32 const _value);
+					virtual bool ConfirmNewValue()
+					{
+						OnValueRefreshed(m_newValue);
+						return true;
+					}
 					void SetTargetValue(int32 const _target, uint32 _duration = 0);
 
 
@@ -72,6 +77,7 @@ namespace OpenZWave
 				private:
 					int32 m_value;				// the current value
 					int32 m_valueCheck;			// the previous value (used for double-checking spurious value reads)
+					int32 m_newValue;				// a new value to be set on the device (used by Supervision CC)
 					int32 m_targetValue;		// Target Value 
 			};
 		} // namespace VC
@@ -31,7 +31,9 @@
 #include "platform/Log.h"
 #include "Manager.h"
 #include "Localization.h"
+#include "Utils.h"
 #include <ctime>
+#include <set>
 
 namespace OpenZWave
 {
@@ -46,15 +48,24 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			ValueList::ValueList(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, vector<Item> const& _items, int32 const _valueIdx, uint8 const _pollIntensity, uint8 const _size	// = 4
 					) :
-					Value(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_List, _label, _units, _readOnly, _writeOnly, false, _pollIntensity), m_items(_items), m_valueIdx(_valueIdx), m_valueIdxCheck(0), m_size(_size), m_targetValue(0)
+					Value(_homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_List, _label, _units, _readOnly, _writeOnly, false, _pollIntensity), m_items(NULL), m_valueIdx(_valueIdx), m_valueIdxCheck(0), m_size(_size), m_targetValue(0)
 			{
-				for (vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+				vector<Item> items = _items;
+				for (vector<Item>::iterator it = items.begin(); it != items.end(); ++it)
 				{
 					/* first what is currently in m_label is the default text for a Item, so set it */
 					Localization::Get()->SetValueItemLabel(m_id.GetNodeId(), _commandClassId, _index, -1, it->m_value, it->m_label, "");
 					/* now set to the Localized Value */
 					it->m_label = Localization::Get()->GetValueItemLabel(m_id.GetNodeId(), _commandClassId, _index, -1, it->m_value);
 				}
+				m_items = ShareItems(items);
+			}
+
+			// The set of shared item tables, protected by the StringPool mutex
+			static set<vector<ValueList::Item> >& GetSharedItems()
+			{
+				static set<vector<ValueList::Item> >* s_tables = new set<vector<ValueList::Item> >();
+				return *s_tables;
 			}
 
 //-----------------------------------------------------------------------------
@@ -62,11 +73,33 @@ namespace OpenZWave
 // Constructor
 //-----------------------------------------------------------------------------
 			ValueList::ValueList() :
-					Value(), m_items(), m_valueIdx(), m_valueIdxCheck(0), m_size(0)
+					Value(), m_items(ShareItems(vector<Item>())), m_valueIdx(), m_valueIdxCheck(0), m_size(0)
 			{
 
 			}
 
+//-----------------------------------------------------------------------------
+// <ValueList::ShareItems>
+// Get the shared copy of an item table.  Lists for the same command class
+// (and the same config file entry) on different nodes end up with identical
+// tables, so only one copy of each is kept.
+//-----------------------------------------------------------------------------
+			vector<ValueList::Item> const* ValueList::ShareItems(vector<Item> const& _items)
+			{
+				LockGuard LG(StringPool::GetMutex());
+				return &(*GetSharedItems().insert(_items).first);
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueList::ClearSharedItems>
+// Free the shared item tables
+//-----------------------------------------------------------------------------
+			void ValueList::ClearSharedItems()
+			{
+				LockGuard LG(StringPool::GetMutex());
+				GetSharedItems().clear();
+			}
+
 //-----------------------------------------------------------------------------
 // <ValueList::ReadXML>
 // Apply settings from XML
@@ -93,6 +126,7 @@ namespace OpenZWave
 					Log::Write(LogLevel_Warning, "Value list size is not set, assuming 4 bytes for node %d, class 0x%02x, instance %d, index %d - %s", _nodeId, _commandClassId, GetID().GetInstance(), GetID().GetIndex(), GetID().GetAsString().c_str());
 				}
 
+				vector<Item> items = *m_items;
 				TiXmlElement const* itemElement = _valueElement->FirstChildElement();
 
 				bool shouldclearlist = true;
@@ -106,7 +140,7 @@ namespace OpenZWave
 						 */
 						if (shouldclearlist)
 						{
-							m_items.clear();
+							items.clear();
 							shouldclearlist = false;
 						}
 
@@ -139,7 +173,7 @@ namespace OpenZWave
 								Item item;
 								item.m_label = labelStr;
 								item.m_value = value;
-								m_items.push_back(item);
+								items.push_back(item);
 							}
 						}
 					}
@@ -147,10 +181,11 @@ namespace OpenZWave
 					itemElement = itemElement->NextSiblingElement();
 				}
 				/* setup any Localization now as we should have read all available languages already */
-				for (vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+				for (vector<Item>::iterator it = items.begin(); it != items.end(); ++it)
 				{
 					it->m_label = Localization::Get()->GetValueItemLabel(m_id.GetNodeId(), m_id.GetCommandClassId(), m_id.GetIndex(), -1, it->m_value);
 				}
+				m_items = ShareItems(items);
 
 				// Set the value
 				bool valSet = false;
@@ -176,7 +211,7 @@ namespace OpenZWave
 				if (TIXML_SUCCESS == _valueElement->QueryIntAttribute("vindex", &intInd))
 				{
 					indSet = true;
-					if (intInd >= 0 && intInd < (int32) m_items.size())
+					if (intInd >= 0 && intInd < (int32) m_items->size())
 					{
 						m_valueIdx = (int32) intInd;
 					}
@@ -207,7 +242,7 @@ namespace OpenZWave
 				snprintf(str, sizeof(str), "%d", m_size);
 				_valueElement->SetAttribute("size", str);
 
-				for (vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+				for (vector<Item>::const_iterator it = m_items->begin(); it != m_items->end(); ++it)
 				{
 					TiXmlElement* pItemElement = new TiXmlElement("Item");
 					pItemElement->SetAttribute("label", (*it).m_label.c_str());
@@ -306,9 +341,9 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			int32 ValueList::GetItemIdxByLabel(string const& _label) const
 			{
-				for (int32 i = 0; i < (int32) m_items.size(); ++i)
+				for (int32 i = 0; i < (int32) m_items->size(); ++i)
 				{
-					if (_label == m_items[i].m_label)
+					if (_label == (*m_items)[i].m_label)
 					{
 						return i;
 					}
@@ -323,9 +358,9 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			int32 ValueList::GetItemIdxByValue(int32 const _value) const
 			{
-				for (int32 i = 0; i < (int32) m_items.size(); ++i)
+				for (int32 i = 0; i < (int32) m_items->size(); ++i)
 				{
-					if (_value == m_items[i].m_value)
+					if (_value == (*m_items)[i].m_value)
 					{
 						return i;
 					}
@@ -342,7 +377,7 @@ namespace OpenZWave
 			{
 				if (o_items)
 				{
-					for (vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+					for (vector<Item>::const_iterator it = m_items->begin(); it != m_items->end(); ++it)
 					{
 						o_items->push_back((*it).m_label);
 					}
@@ -361,7 +396,7 @@ namespace OpenZWave
 			{
 				if (o_values)
 				{
-					for (vector<Item>::iterator it = m_items.begin(); it != m_items.end(); ++it)
+					for (vector<Item>::const_iterator it = m_items->begin(); it != m_items->end(); ++it)
 					{
 						o_values->push_back((*it).m_value);
 					}
@@ -381,12 +416,12 @@ namespace OpenZWave
 				try
 				{
 					/* very strange - We throw a exception if its out of range, but its not caught? */
-					if (m_items.size() < (uint32)m_valueIdx)
+					if (m_items->size() < (uint32)m_valueIdx)
 					{
 						Log::Write(LogLevel_Warning, "Invalid Index Set on ValueList %s: %d", GetID().GetAsString().c_str(), m_valueIdx);
 						return NULL;
 					}
-					return &m_items.at(m_valueIdx);
+					return &m_items->at(m_valueIdx);
 				}
 				catch (std::out_of_range const& oor)
 				{
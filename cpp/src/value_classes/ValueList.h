@@ -32,6 +32,7 @@
 #include <vector>
 #include "Defs.h"
 #include "value_classes/Value.h"
+#include "StringPool.h"
 
 class TiXmlElement;
 
@@ -52,8 +53,13 @@ namespace OpenZWave
 					 */
 					struct Item
 					{
-							string m_label;
+							InternedString m_label;
 							int32 m_value;
+
+							bool operator <(Item const& _other) const
+							{
+								return (m_value != _other.m_value) ? (m_value < _other.m_value) : (m_label < _other.m_label);
+							}
 					};
 
 					ValueList(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, vector<Item> const& _items, int32 const _valueIdx, uint8 const _pollIntensity, uint8 const _size = 4);
@@ -66,10 +72,11 @@ namespace OpenZWave
 					bool SetByValue(int32 const _value);
 
 					void OnValueRefreshed(int32 const _valueIdx);
-					void ConfirmNewValue()
+					virtual bool ConfirmNewValue()
 					{
-						OnValueRefreshed(m_items[m_newValue].m_value);
-					};
+						OnValueRefreshed((*m_items)[m_newValue].m_value);
+						return true;
+					}
 
 					// From Value
 					virtual string const GetAsString() const
@@ -98,8 +105,16 @@ namespace OpenZWave
 						return m_size;
 					}
 
+					/**
+					 * Free the item tables shared between lists.  Only call this once
+					 * every ValueList has been destroyed.
+					 */
+					static void ClearSharedItems();
+
 				private:
-					vector<Item> m_items;
+					static vector<Item> const* ShareItems(vector<Item> const& _items);
+
+					vector<Item> const* m_items;		// Item table shared by all lists with the same items
 					int32 m_valueIdx;					// the current index in the m_items vector
 					int32 m_valueIdxCheck;			// the previous index in the m_items vector (used for double-checking spurious value reads)
 					int32 m_newValue;			// a new index to be set on the appropriate device (used by Supervision CC)
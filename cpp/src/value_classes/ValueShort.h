@@ -55,6 +55,11 @@ namespace OpenZWave
 
 					bool Set(int16 const _value);
 					void OnValueRefreshed(int16 const _value);
+					virtual bool ConfirmNewValue()
+					{
+						OnValueRefreshed(m_newValue);
+						return true;
+					}
 					void SetTargetValue(int16 const _target, uint32 _duration = 0);
 
 					// From Value
@@ -71,6 +76,7 @@ namespace OpenZWave
 				private:
 					int16 m_value;				// the current value
 					int16 m_valueCheck;			// the previous value (used for double-checking spurious value reads)
+					int16 m_newValue;				// a new value to be set on the device (used by Supervision CC)
 					int16 m_targetValue;		// Target Value 
 			};
 		} // namespace VC
@@ -25,6 +25,7 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
 #include "value_classes/ValueStore.h"
 #include "value_classes/Value.h"
 #include "Manager.h"
@@ -38,6 +39,19 @@ namespace OpenZWave
 	{
 		namespace VC
 		{
+			// Stores with at least this many values get a hash index
+			static uint32 const c_indexThreshold = 16;
+
+			static bool KeyLess(pair<uint32, Value*> const& _entry, uint32 const _key)
+			{
+				return _entry.first < _key;
+			}
+
+			// Fibonacci hashing - spreads the packed genre/cc/instance/index bits of the key
+			static inline uint32 HashKey(uint32 const _key, uint32 const _shift)
+			{
+				return (uint32) ((_key * 2654435769u) >> _shift);
+			}
 
 //-----------------------------------------------------------------------------
 // <ValueStore::ValueStore>
@@ -45,12 +59,10 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			ValueStore::~ValueStore()
 			{
-				map<uint32, Value*>::iterator it = m_values.begin();
 				while (!m_values.empty())
 				{
-					ValueID const& valueId = it->second->GetID();
+					ValueID const& valueId = m_values.back().second->GetID();
 					RemoveValue(valueId.GetValueStoreKey());
-					it = m_values.begin();
 				}
 			}
 
@@ -66,14 +78,15 @@ namespace OpenZWave
 				}
 
 				uint32 key = _value->GetID().GetValueStoreKey();
-				map<uint32, Value*>::iterator it = m_values.find(key);
-				if (it != m_values.end())
+				vector<pair<uint32, Value*> >::iterator it = lower_bound(m_values.begin(), m_values.end(), key, KeyLess);
+				if (it != m_values.end() && it->first == key)
 				{
 					// There is already a value in the store with this key, so we give up.
 					return false;
 				}
 
-				m_values[key] = _value;
+				m_values.insert(it, pair<uint32, Value*>(key, _value));
+				IndexInsert(key, _value);
 				_value->AddRef();
 
 				// Notify the watchers of the new value and Check our GetChangeVerified Flag
@@ -107,8 +120,8 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			bool ValueStore::RemoveValue(uint32 const& _key)
 			{
-				map<uint32, Value*>::iterator it = m_values.find(_key);
-				if (it != m_values.end())
+				vector<pair<uint32, Value*> >::iterator it = lower_bound(m_values.begin(), m_values.end(), _key, KeyLess);
+				if (it != m_values.end() && it->first == _key)
 				{
 					Value* value = it->second;
 					ValueID const& valueId = value->GetID();
@@ -122,12 +135,14 @@ namespace OpenZWave
 					}
 
 					// Now release and remove the value from the store
+					value->InvalidateHandle();
 					int32 references = value->Release();
 					if (references > 0)
 						Log::Write(LogLevel_Warning, "Value Not Deleted - Still in use %d times: CC: %d - %s - %s - %d", references, valueId.GetCommandClassId(), valueId.GetTypeAsString().c_str(), value->GetLabel().c_str(), value->GetID());
 					else
 						Log::Write(LogLevel_Debug, "Value Deleted");
 					m_values.erase(it);
+					IndexRemove(_key);
 
 					return true;
 				}
@@ -151,8 +166,9 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void ValueStore::RemoveCommandClassValues(uint8 const _commandClassId)
 			{
-				map<uint32, Value*>::iterator it = m_values.begin();
-				while (it != m_values.end())
+				vector<pair<uint32, Value*> >::iterator it = m_values.begin();
+				vector<pair<uint32, Value*> >::iterator keep = m_values.begin();
+				for (; it != m_values.end(); ++it)
 				{
 					Value* value = it->second;
 					ValueID const& valueId = value->GetID();
@@ -169,14 +185,19 @@ namespace OpenZWave
 						}
 
 						// Now release and remove the value from the store
+						value->InvalidateHandle();
 						value->Release();
-						it = m_values.erase(it);
 					}
 					else
 					{
-						++it;
+						*keep++ = *it;
 					}
 				}
+				if (keep != m_values.end())
+				{
+					m_values.erase(keep, m_values.end());
+					RebuildIndex();
+				}
 			}
 
 //-----------------------------------------------------------------------------
@@ -185,21 +206,149 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			Value* ValueStore::GetValue(uint32 const& _key) const
 			{
-				Value* value = NULL;
+				Value* value = Find(_key);
+				if (value)
+				{
+					// Add a reference to the value.  The caller must
+					// call Release on the value when they are done with it.
+					value->AddRef();
+				}
+
+				return value;
+			}
 
-				map<uint32, Value*>::const_iterator it = m_values.find(_key);
-				if (it != m_values.end())
+//-----------------------------------------------------------------------------
+// <ValueStore::Find>
+// Locate a value without adding a reference to it
+//-----------------------------------------------------------------------------
+			Value* ValueStore::Find(uint32 const _key) const
+			{
+				if (!m_index.empty())
 				{
-					value = it->second;
-					if (value)
+					uint32 mask = (uint32) m_index.size() - 1;
+					uint32 slot = HashKey(_key, m_indexShift);
+					while (m_index[slot].m_value)
 					{
-						// Add a reference to the value.  The caller must
-						// call Release on the value when they are done with it.
-						value->AddRef();
+						if (m_index[slot].m_key == _key)
+						{
+							return m_index[slot].m_value;
+						}
+						slot = (slot + 1) & mask;
 					}
+					return NULL;
 				}
 
-				return value;
+				vector<pair<uint32, Value*> >::const_iterator it = lower_bound(m_values.begin(), m_values.end(), _key, KeyLess);
+				if (it != m_values.end() && it->first == _key)
+				{
+					return it->second;
+				}
+				return NULL;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::IndexInsert>
+// Add a value that has just been put in m_values to the hash index
+//-----------------------------------------------------------------------------
+			void ValueStore::IndexInsert(uint32 const _key, Value* _value)
+			{
+				// Kept at most half full, so it doubles when it has to grow
+				if (m_values.size() * 2 > m_index.size())
+				{
+					RebuildIndex();
+					return;
+				}
+
+				uint32 mask = (uint32) m_index.size() - 1;
+				uint32 slot = HashKey(_key, m_indexShift);
+				while (m_index[slot].m_value)
+				{
+					slot = (slot + 1) & mask;
+				}
+				m_index[slot].m_key = _key;
+				m_index[slot].m_value = _value;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::IndexRemove>
+// Remove a value that has just been taken out of m_values from the hash index.
+// The entries after it are shifted back rather than leaving a tombstone, so
+// the probe sequences of the remaining keys are not broken.
+//-----------------------------------------------------------------------------
+			void ValueStore::IndexRemove(uint32 const _key)
+			{
+				if (m_index.empty())
+				{
+					return;
+				}
+				if (m_values.size() < c_indexThreshold)
+				{
+					m_index.clear();
+					m_indexShift = 32;
+					return;
+				}
+
+				uint32 mask = (uint32) m_index.size() - 1;
+				uint32 slot = HashKey(_key, m_indexShift);
+				while (m_index[slot].m_value && (m_index[slot].m_key != _key))
+				{
+					slot = (slot + 1) & mask;
+				}
+				if (!m_index[slot].m_value)
+				{
+					return;
+				}
+
+				uint32 next = (slot + 1) & mask;
+				while (m_index[next].m_value)
+				{
+					// An entry can fill the hole unless its home slot lies after the hole
+					uint32 home = HashKey(m_index[next].m_key, m_indexShift);
+					if (((next - home) & mask) >= ((next - slot) & mask))
+					{
+						m_index[slot] = m_index[next];
+						slot = next;
+					}
+					next = (next + 1) & mask;
+				}
+				m_index[slot].m_key = 0;
+				m_index[slot].m_value = NULL;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::RebuildIndex>
+// Regenerate the hash index after the set of values has changed.  The table
+// is kept at most half full, so probe sequences stay short.
+//-----------------------------------------------------------------------------
+			void ValueStore::RebuildIndex()
+			{
+				m_index.clear();
+				m_indexShift = 32;
+				if (m_values.size() < c_indexThreshold)
+				{
+					return;
+				}
+
+				uint32 bits = 1;
+				while (((size_t) 1 << bits) < m_values.size() * 2)
+				{
+					++bits;
+				}
+				m_indexShift = 32 - bits;
+
+				IndexEntry empty = { 0, NULL };
+				m_index.assign((size_t) 1 << bits, empty);
+				uint32 mask = (uint32) m_index.size() - 1;
+				for (vector<pair<uint32, Value*> >::const_iterator it = m_values.begin(); it != m_values.end(); ++it)
+				{
+					uint32 slot = HashKey(it->first, m_indexShift);
+					while (m_index[slot].m_value)
+					{
+						slot = (slot + 1) & mask;
+					}
+					m_index[slot].m_key = it->first;
+					m_index[slot].m_value = it->second;
+				}
 			}
 
 		} // namespace VC
@@ -28,7 +28,7 @@
 #ifndef _ValueStore_H
 #define _ValueStore_H
 
-#include <map>
+#include <vector>
 #include "Defs.h"
 #include "value_classes/ValueID.h"
 
@@ -45,12 +45,23 @@ namespace OpenZWave
 
 			/** \brief Container that holds all of the values associated with a given node.
 			 * \ingroup ValueID
+			 *
+			 * Values are kept in a vector sorted by their ValueStore key, which is what
+			 * Begin() and End() iterate over.  Small stores are searched with a binary
+			 * search.  Once a store grows past a few entries, a flat open-addressing
+			 * hash table of the keys is built next to the vector, so that the lookups
+			 * done for every incoming report stay at one or two probes into contiguous
+			 * memory.  Adding or removing a value updates the hash index in place; it
+			 * is only rebuilt when it has to grow, or after RemoveCommandClassValues.
+			 *
+			 * As with any vector, adding or removing a value invalidates the iterators,
+			 * so loops over Begin() and End() must not call anything that may do so.
 			 */
 			class ValueStore
 			{
 				public:
 
-					typedef map<uint32, Value*>::const_iterator Iterator;
+					typedef vector<pair<uint32, Value*> >::const_iterator Iterator;
 
 					Iterator Begin()
 					{
@@ -61,7 +72,8 @@ namespace OpenZWave
 						return m_values.end();
 					}
 
-					ValueStore()
+					ValueStore() :
+							m_indexShift(32)
 					{
 					}
 					~ValueStore();
@@ -73,7 +85,20 @@ namespace OpenZWave
 					void RemoveCommandClassValues(uint8 const _commandClassId);		// Remove all the values associated with a command class
 
 				private:
-					map<uint32, Value*> m_values;
+					struct IndexEntry
+					{
+						uint32 m_key;
+						Value* m_value;						// NULL marks an empty slot
+					};
+
+					Value* Find(uint32 const _key) const;
+					void IndexInsert(uint32 const _key, Value* _value);
+					void IndexRemove(uint32 const _key);
+					void RebuildIndex();
+
+					vector<pair<uint32, Value*> > m_values;		// Sorted by key
+					vector<IndexEntry> m_index;					// Hash index of m_values, empty for small stores
+					uint32 m_indexShift;						// 32 - log2(m_index.size())
 			};
 		} // namespace VC
 	} // namespace Internal
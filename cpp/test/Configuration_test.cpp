@@ -0,0 +1,143 @@
+//-----------------------------------------------------------------------------
+//
+//	Configuration_test.cpp
+//
+//	Test Framework for the Configuration Command Class report parsing
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+#include "command_classes/Configuration.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+using Internal::CC::Configuration;
+
+// The lengths passed in include the trailing checksum byte, as in HandleMsg
+TEST(Configuration, PropertiesReportSigned)
+{
+	uint8 const data[] =
+	{ 0x0F, 0x01, 0x02, 0x02, 0xFF, 0x38, 0x00, 0x64, 0x00, 0x0A, 0x01, 0x03, 0x03, 0x00 };
+	uint16 param = 0, next = 0;
+	Configuration::Param props;
+	ASSERT_TRUE(Configuration::ParseProperties(data, sizeof(data), &param, &props, &next));
+	EXPECT_EQ(0x0102, param);
+	EXPECT_EQ(2, props.m_size);
+	EXPECT_EQ(0, props.m_format);
+	EXPECT_FALSE(props.m_readOnly);
+	EXPECT_EQ(-200, props.m_min);
+	EXPECT_EQ(100, props.m_max);
+	EXPECT_EQ(10, props.m_default);
+	EXPECT_EQ(0x0103, next);
+	EXPECT_TRUE(props.m_advanced);
+	EXPECT_TRUE(props.m_noBulk);
+}
+
+TEST(Configuration, PropertiesReportVersion3)
+{
+	// Read only, unsigned, one byte and no version 4 flags byte
+	uint8 const data[] =
+	{ 0x0F, 0x00, 0x05, 0x49, 0x00, 0xFF, 0x80, 0x00, 0x00, 0x00 };
+	uint16 param = 0, next = 1;
+	Configuration::Param props;
+	ASSERT_TRUE(Configuration::ParseProperties(data, sizeof(data), &param, &props, &next));
+	EXPECT_EQ(5, param);
+	EXPECT_EQ(1, props.m_format);
+	EXPECT_TRUE(props.m_readOnly);
+	EXPECT_EQ(0, props.m_min);
+	EXPECT_EQ(255, props.m_max);
+	EXPECT_EQ(128, props.m_default);
+	EXPECT_EQ(0, next);
+	EXPECT_FALSE(props.m_advanced);
+	EXPECT_FALSE(props.m_noBulk);
+}
+
+TEST(Configuration, PropertiesReportUnsignedClamp)
+{
+	uint8 const data[] =
+	{ 0x0F, 0x00, 0x01, 0x0C, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	uint16 param = 0, next = 0;
+	Configuration::Param props;
+	ASSERT_TRUE(Configuration::ParseProperties(data, sizeof(data), &param, &props, &next));
+	EXPECT_EQ(4, props.m_size);
+	EXPECT_EQ(0, props.m_min);
+	EXPECT_EQ(INT32_MAX, props.m_max);
+	EXPECT_EQ(INT32_MAX, props.m_default);
+
+	// A bit field keeps all 32 bits of its mask
+	uint8 bitfield[sizeof(data)];
+	memcpy(bitfield, data, sizeof(data));
+	bitfield[3] = 0x1C;
+	ASSERT_TRUE(Configuration::ParseProperties(bitfield, sizeof(bitfield), &param, &props, &next));
+	EXPECT_EQ(3, props.m_format);
+	EXPECT_EQ(-1, props.m_max);
+}
+
+TEST(Configuration, PropertiesReportInvalid)
+{
+	uint16 param = 0, next = 0;
+	Configuration::Param props;
+	// Three byte parameters do not exist
+	uint8 const badSize[] =
+	{ 0x0F, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	EXPECT_FALSE(Configuration::ParseProperties(badSize, sizeof(badSize), &param, &props, &next));
+	// Next parameter missing
+	uint8 const truncated[] =
+	{ 0x0F, 0x00, 0x01, 0x01, 0x00, 0x0A, 0x05, 0x00, 0x00 };
+	EXPECT_FALSE(Configuration::ParseProperties(truncated, sizeof(truncated), &param, &props, &next));
+}
+
+TEST(Configuration, BulkReport)
+{
+	uint8 const data[] =
+	{ 0x09, 0x01, 0x00, 0x03, 0x00, 0x02, 0x00, 0x01, 0xFF, 0xFE, 0x12, 0x34, 0x00 };
+	uint16 offset = 0;
+	uint8 size = 0;
+	std::vector<int32> values;
+	ASSERT_TRUE(Configuration::ParseBulkReport(data, sizeof(data), &offset, &size, &values));
+	EXPECT_EQ(0x0100, offset);
+	EXPECT_EQ(2, size);
+	ASSERT_EQ(3u, values.size());
+	EXPECT_EQ(1, values[0]);
+	EXPECT_EQ(0xFFFE, values[1]);
+	EXPECT_EQ(0x1234, values[2]);
+}
+
+TEST(Configuration, BulkReportTruncated)
+{
+	// Claims four values but only carries one and a half
+	uint8 const data[] =
+	{ 0x09, 0x00, 0x10, 0x04, 0x00, 0x02, 0x00, 0x07, 0x00, 0x00 };
+	uint16 offset = 0;
+	uint8 size = 0;
+	std::vector<int32> values;
+	ASSERT_TRUE(Configuration::ParseBulkReport(data, sizeof(data), &offset, &size, &values));
+	ASSERT_EQ(1u, values.size());
+	EXPECT_EQ(7, values[0]);
+
+	uint8 const badSize[] =
+	{ 0x09, 0x00, 0x10, 0x01, 0x00, 0x03, 0x00, 0x00, 0x07, 0x00 };
+	EXPECT_FALSE(Configuration::ParseBulkReport(badSize, sizeof(badSize), &offset, &size, &values));
+}
+} // namespace Testing
+} // namespace OpenZWave
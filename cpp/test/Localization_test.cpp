@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------------------
+//
+//	Localization_test.cpp
+//
+//	Test Framework for changing the language of the Localization tables
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "Localization.h"
+#include "Options.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+using Internal::Localization;
+
+// A switch label and a global label, each in English, French and German
+static char const* const c_localizationXML =
+	"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+	"<Localization xmlns=\"https://github.com/OpenZWave/open-zwave\" Revision=\"1\">\n"
+	"\t<CommandClass id=\"37\">\n"
+	"\t\t<Label>COMMAND_CLASS_SWITCH_BINARY</Label>\n"
+	"\t\t<Value index=\"0\">\n"
+	"\t\t\t<Label>Switch</Label>\n"
+	"\t\t\t<Label lang=\"fr\">Interrupteur</Label>\n"
+	"\t\t\t<Label lang=\"de\">Schalter</Label>\n"
+	"\t\t</Value>\n"
+	"\t</CommandClass>\n"
+	"\t<GlobalText>\n"
+	"\t\t<Label name=\"Instance\">Instance</Label>\n"
+	"\t\t<Label name=\"Instance\" lang=\"fr\">Exemple</Label>\n"
+	"\t\t<Label name=\"Instance\" lang=\"de\">Instanz</Label>\n"
+	"\t</GlobalText>\n"
+	"</Localization>\n";
+
+TEST(Localization, CompactSwitchLanguageReloads)
+{
+	char dir[] = "/tmp/ozw-localization-XXXXXX";
+	ASSERT_TRUE(mkdtemp(dir) != NULL);
+	std::string path = std::string(dir) + "/";
+	FILE* file = fopen((path + "Localization.xml").c_str(), "w");
+	ASSERT_TRUE(file != NULL);
+	fputs(c_localizationXML, file);
+	fclose(file);
+
+	Options::Create(path, path, "");
+	Options::Get()->AddOptionString("Language", "fr", false);
+	Options::Get()->AddOptionBool("CompactLocalization", true);
+	Options::Get()->Lock();
+
+	EXPECT_EQ("Interrupteur", Localization::Get()->GetValueLabel(0, 37, 0, -1));
+	EXPECT_EQ("Exemple", Localization::Get()->GetGlobalLabel("Instance"));
+
+	// Only French was kept, so German has to be read from the file again
+	Localization::Get()->SetSelectedLang("de");
+	EXPECT_EQ("de", Localization::Get()->GetSelectedLang());
+	EXPECT_EQ("Schalter", Localization::Get()->GetValueLabel(0, 37, 0, -1));
+	EXPECT_EQ("Instanz", Localization::Get()->GetGlobalLabel("Instance"));
+
+	// And back again, now that French has been dropped
+	Localization::Get()->SetSelectedLang("fr");
+	EXPECT_EQ("Interrupteur", Localization::Get()->GetValueLabel(0, 37, 0, -1));
+
+	// The defaults are always kept
+	Localization::Get()->SetSelectedLang("");
+	EXPECT_EQ("Switch", Localization::Get()->GetValueLabel(0, 37, 0, -1));
+	EXPECT_EQ("Instance", Localization::Get()->GetGlobalLabel("Instance"));
+
+	Localization::Destroy();
+	Options::Destroy();
+	unlink((path + "Localization.xml").c_str());
+	rmdir(dir);
+}
+} // namespace Testing
+} // namespace OpenZWave
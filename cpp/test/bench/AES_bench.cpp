@@ -0,0 +1,165 @@
+//-----------------------------------------------------------------------------
+//
+//	AES_bench.cpp
+//
+//	Compare the AES implementations used for S0 Security
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Bench.h"
+#include "AESKey.h"
+
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	// FIPS-197 Appendix C.1
+	uint8 const c_key[16] =
+	{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+	uint8 const c_plain[16] =
+	{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+	uint8 const c_cipher[16] =
+	{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+	// A typical S0 frame: 20 bytes of payload, encrypted and then authenticated
+	uint32 const c_payload = 20;
+
+	// The way ZWSecurity used the portable code before AESKey: mode resets and one call per block
+	void LegacyFrame(aes_encrypt_ctx* _encKey, aes_encrypt_ctx* _authKey, uint8 const* _payload, uint8* _out, uint8* _mac)
+	{
+		uint8 iv[16];
+		memset(iv, 0x42, 16);
+		aes_mode_reset(_encKey);
+		aes_ofb_encrypt(_payload, _out, c_payload, iv, _encKey);
+
+		memset(iv, 0x42, 16);
+		aes_mode_reset(_authKey);
+		aes_ecb_encrypt(iv, _mac, 16, _authKey);
+		for (uint32 pos = 0; pos < c_payload; pos += 16)
+		{
+			for (uint32 i = 0; (i < 16) && (pos + i < c_payload); ++i)
+			{
+				_mac[i] ^= _out[pos + i];
+			}
+			aes_mode_reset(_authKey);
+			aes_ecb_encrypt(_mac, _mac, 16, _authKey);
+		}
+	}
+
+	void KeyFrame(AESKey const& _encKey, AESKey const& _authKey, uint8 const* _payload, uint8* _out, uint8* _mac)
+	{
+		uint8 iv[16];
+		memset(iv, 0x42, 16);
+		_encKey.OFB(_payload, _out, c_payload, iv);
+		_authKey.CBCMAC(_out, c_payload, iv, _mac);
+	}
+
+	struct Keys
+	{
+			aes_encrypt_ctx m_legacy;
+			AESKey m_portable;
+			AESKey m_hardware;
+			uint8 m_payload[32];
+	};
+
+//-----------------------------------------------------------------------------
+// <GetKeys>
+// Set up the keys, and check the implementations agree before timing them
+//-----------------------------------------------------------------------------
+	Keys& GetKeys()
+	{
+		static Keys* s_keys = NULL;
+		if (s_keys)
+		{
+			return *s_keys;
+		}
+		s_keys = new Keys();
+		aes_init();
+		for (uint32 i = 0; i < sizeof(s_keys->m_payload); ++i)
+		{
+			s_keys->m_payload[i] = (uint8) i;
+		}
+		aes_encrypt_key128(c_key, &s_keys->m_legacy);
+		AESKey::SetHardwareEnabled(false);
+		s_keys->m_portable.SetKey(c_key);
+		AESKey::SetHardwareEnabled(true);
+		s_keys->m_hardware.SetKey(c_key);
+
+		char const* hardwareName = AESKey::GetBackendName();
+		uint8 block[16];
+		s_keys->m_hardware.EncryptBlock(c_plain, block);
+		if (memcmp(block, c_cipher, 16) != 0)
+		{
+			fprintf(stderr, "%s AES does not match the FIPS-197 test vector\n", hardwareName);
+			exit(1);
+		}
+		uint8 legacyOut[32], legacyMac[16], keyOut[32], keyMac[16];
+		LegacyFrame(&s_keys->m_legacy, &s_keys->m_legacy, s_keys->m_payload, legacyOut, legacyMac);
+		KeyFrame(s_keys->m_hardware, s_keys->m_hardware, s_keys->m_payload, keyOut, keyMac);
+		if (memcmp(legacyOut, keyOut, c_payload) || memcmp(legacyMac, keyMac, 16))
+		{
+			fprintf(stderr, "%s AES frame does not match the portable implementation\n", hardwareName);
+			exit(1);
+		}
+		return *s_keys;
+	}
+}
+
+OZW_BENCH(AES_S0Frame_Legacy)
+{
+	Keys& keys = GetKeys();
+	uint8 out[32], mac[16];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		keys.m_payload[0] = (uint8) i;
+		LegacyFrame(&keys.m_legacy, &keys.m_legacy, keys.m_payload, out, mac);
+		OpenZWave::Bench::DoNotOptimize(mac);
+	}
+}
+
+OZW_BENCH(AES_S0Frame_Portable)
+{
+	Keys& keys = GetKeys();
+	uint8 out[32], mac[16];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		keys.m_payload[0] = (uint8) i;
+		KeyFrame(keys.m_portable, keys.m_portable, keys.m_payload, out, mac);
+		OpenZWave::Bench::DoNotOptimize(mac);
+	}
+}
+
+OZW_BENCH(AES_S0Frame_Hardware)
+{
+	// Hardware is whatever AESKey::GetBackendName() picked on this machine
+	Keys& keys = GetKeys();
+	uint8 out[32], mac[16];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		keys.m_payload[0] = (uint8) i;
+		KeyFrame(keys.m_hardware, keys.m_hardware, keys.m_payload, out, mac);
+		OpenZWave::Bench::DoNotOptimize(mac);
+	}
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+//
+//	Bench.h
+//
+//	A small micro-benchmark harness for the OpenZWave hot paths
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Bench_H
+#define _Bench_H
+
+#include <string>
+#include <vector>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Driver;
+	class Node;
+
+	namespace Bench
+	{
+		/**
+		 * A benchmark runs its body _iterations times.  Work that must not be
+		 * timed is done once, outside the loop, or in a static that the first
+		 * (untimed) warm up run sets up.
+		 */
+		typedef void (*pfnBenchmark_t)(uint64 _iterations);
+
+		struct Benchmark
+		{
+				char const* m_name;
+				pfnBenchmark_t m_fn;
+		};
+
+		/** Every benchmark, in the order they were registered */
+		std::vector<Benchmark>& GetBenchmarks();
+
+		struct Registrar
+		{
+				Registrar(char const* _name, pfnBenchmark_t _fn)
+				{
+					Benchmark b =
+					{ _name, _fn };
+					GetBenchmarks().push_back(b);
+				}
+		};
+
+		/** Stop the compiler optimising away a result the benchmark does not otherwise use */
+		template<typename T> inline void DoNotOptimize(T const& _value)
+		{
+#if defined(__GNUC__)
+			asm volatile("" : : "g"(&_value) : "memory");
+#else
+			static volatile char const* s_sink;
+			s_sink = reinterpret_cast<char const volatile*>(&_value);
+#endif
+		}
+
+		/** Somewhere the benchmarks can write scratch files */
+		std::string const& GetUserPath();
+
+		/** The home id of the network the driver started by StartDriver is on */
+		uint32 const c_homeId = 0x0b0b0b0b;
+
+		/**
+		 * Add a driver, through the Manager, on a replayed controller that reports
+		 * nodes 1 to _nodeCount, and wait until the driver has added them all.  A
+		 * driver already started for _nodeCount nodes is left running, and one
+		 * started for any other number is removed first.  The replay ends once
+		 * the driver has read its cache, so nothing answers the driver after that.
+		 * \return false if the nodes were not all added within a few seconds.
+		 */
+		bool StartDriver(uint32 _nodeCount);
+
+		/** Remove the driver StartDriver added, if there is one */
+		void StopDriver();
+
+		/**
+		 * The running driver, found through the Manager as a message or command
+		 * class would find it.  A driver with only the controller node is started
+		 * if none is running.
+		 */
+		Driver* GetDriver();
+	} // namespace Bench
+} // namespace OpenZWave
+
+#define OZW_BENCH(name) \
+	static void name(uint64 _iterations); \
+	static OpenZWave::Bench::Registrar s_register_##name(#name, name); \
+	static void name(uint64 _iterations)
+
+#endif
@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+//
+//	CommandClass_bench.cpp
+//
+//	Benchmark decoding and encoding the values in command class reports
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "Bench.h"
+#include "Msg.h"
+#include "command_classes/CommandClass.h"
+#include "command_classes/CommandClasses.h"
+
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	// Any command class will do: ExtractValue and AppendValue are shared by all of them
+	CC::CommandClass* GetCommandClass()
+	{
+		static CC::CommandClass* s_cc = CC::CommandClasses::CreateCommandClass(0x31, OpenZWave::Bench::c_homeId, 5);
+		return s_cc;
+	}
+}
+
+OZW_BENCH(CommandClass_ExtractValue)
+{
+	CC::CommandClass* cc = GetCommandClass();
+	// A SensorMultilevel temperature of 21.5: precision 1, scale 0, two bytes
+	uint8 data[3] =
+	{ 0x22, 0x00, 0xd7 };
+	uint8 scale, precision;
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		data[2] = (uint8) i;
+		std::string value = cc->ExtractValue(data, &scale, &precision);
+		OpenZWave::Bench::DoNotOptimize(value);
+	}
+}
+
+OZW_BENCH(CommandClass_ExtractValueNegative)
+{
+	CC::CommandClass* cc = GetCommandClass();
+	// A four byte reading of -1234.567, which takes the sign extension path
+	uint8 data[5] =
+	{ 0x64, 0xff, 0xed, 0x29, 0x79 };
+	uint8 scale, precision;
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		data[4] = (uint8) i;
+		std::string value = cc->ExtractValue(data, &scale, &precision);
+		OpenZWave::Bench::DoNotOptimize(value);
+	}
+}
+
+OZW_BENCH(CommandClass_AppendValue)
+{
+	CC::CommandClass* cc = GetCommandClass();
+	std::string const value = "21.5";
+	Msg msg("ThermostatSetpointCmd_Set", 5, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		// Reuse the message: keep its length well inside the buffer
+		if ((i & 15) == 0)
+		{
+			msg = Msg("ThermostatSetpointCmd_Set", 5, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+		}
+		cc->AppendValue(&msg, value, 0);
+	}
+	OpenZWave::Bench::DoNotOptimize(msg);
+}
@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+//
+//	Driver_bench.cpp
+//
+//	Benchmark loading and saving the network cache of a full network
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "Bench.h"
+#include "Manager.h"
+
+using namespace OpenZWave;
+
+namespace
+{
+	// The largest network Z-Wave allows
+	uint32 const c_nodeCount = 232;
+
+	// A metering switch with a temperature sensor and some configuration, as the driver saves it
+	char const* const c_nodeXML =
+		"\t<Node id=\"%u\" name=\"Node %u\" location=\"Room %u\" basic=\"4\" generic=\"16\" specific=\"1\" type=\"Binary Power Switch\" listening=\"true\" frequentListening=\"false\" beaming=\"true\" routing=\"true\" max_baud_rate=\"40000\" version=\"4\" query_stage=\"Complete\">\n"
+		"\t\t<Neighbors>1,%u,%u</Neighbors>\n"
+		"\t\t<Manufacturer id=\"86\" name=\"AEON Labs\">\n"
+		"\t\t\t<Product type=\"3\" id=\"6\" name=\"Smart Energy Switch\" />\n"
+		"\t\t</Manufacturer>\n"
+		"\t\t<CommandClasses>\n"
+		"\t\t\t<CommandClass id=\"32\" name=\"COMMAND_CLASS_BASIC\" version=\"1\" request_flags=\"4\" mapping=\"37\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"37\" name=\"COMMAND_CLASS_SWITCH_BINARY\" version=\"1\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Value type=\"bool\" genre=\"user\" instance=\"1\" index=\"0\" label=\"Switch\" units=\"\" read_only=\"false\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"True\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"49\" name=\"COMMAND_CLASS_SENSOR_MULTILEVEL\" version=\"5\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Value type=\"decimal\" genre=\"user\" instance=\"1\" index=\"1\" label=\"Air Temperature\" units=\"C\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"21.5\" />\n"
+		"\t\t\t\t<Value type=\"decimal\" genre=\"user\" instance=\"1\" index=\"4\" label=\"Power\" units=\"W\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"%u.2\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"50\" name=\"COMMAND_CLASS_METER\" version=\"3\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Value type=\"decimal\" genre=\"user\" instance=\"1\" index=\"0\" label=\"Electric - kWh\" units=\"kWh\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"1234.567\" />\n"
+		"\t\t\t\t<Value type=\"decimal\" genre=\"user\" instance=\"1\" index=\"2\" label=\"Electric - W\" units=\"W\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"%u.2\" />\n"
+		"\t\t\t\t<Value type=\"button\" genre=\"system\" instance=\"1\" index=\"256\" label=\"Reset\" units=\"\" read_only=\"false\" write_only=\"true\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"112\" name=\"COMMAND_CLASS_CONFIGURATION\" version=\"1\" request_flags=\"4\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Value type=\"list\" genre=\"config\" instance=\"1\" index=\"1\" label=\"Current Overload Protection\" units=\"\" read_only=\"false\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"1\" vindex=\"0\" size=\"1\">\n"
+		"\t\t\t\t\t<Help>Load will be closed when the Current overruns (US 15.5A, Others 16.2A) for more than 2 minutes</Help>\n"
+		"\t\t\t\t\t<Item label=\"Disabled\" value=\"0\" />\n"
+		"\t\t\t\t\t<Item label=\"Enabled\" value=\"1\" />\n"
+		"\t\t\t\t</Value>\n"
+		"\t\t\t\t<Value type=\"byte\" genre=\"config\" instance=\"1\" index=\"3\" label=\"Report Type\" units=\"\" read_only=\"false\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"255\" value=\"0\" />\n"
+		"\t\t\t\t<Value type=\"short\" genre=\"config\" instance=\"1\" index=\"90\" label=\"Power Threshold\" units=\"W\" read_only=\"false\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"60000\" value=\"25\" />\n"
+		"\t\t\t\t<Value type=\"int\" genre=\"config\" instance=\"1\" index=\"111\" label=\"Report Interval\" units=\"seconds\" read_only=\"false\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"2147483647\" value=\"720\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"114\" name=\"COMMAND_CLASS_MANUFACTURER_SPECIFIC\" version=\"1\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"133\" name=\"COMMAND_CLASS_ASSOCIATION\" version=\"1\" request_flags=\"1\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Associations num_groups=\"1\">\n"
+		"\t\t\t\t\t<Group index=\"1\" max_associations=\"5\" label=\"Lifeline\" auto=\"true\">\n"
+		"\t\t\t\t\t\t<Node id=\"1\" />\n"
+		"\t\t\t\t\t</Group>\n"
+		"\t\t\t\t</Associations>\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t\t<CommandClass id=\"134\" name=\"COMMAND_CLASS_VERSION\" version=\"1\" request_flags=\"4\">\n"
+		"\t\t\t\t<Instance index=\"1\" />\n"
+		"\t\t\t\t<Value type=\"string\" genre=\"system\" instance=\"1\" index=\"0\" label=\"Library Version\" units=\"\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"3\" />\n"
+		"\t\t\t\t<Value type=\"string\" genre=\"system\" instance=\"1\" index=\"1\" label=\"Protocol Version\" units=\"\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"3.67\" />\n"
+		"\t\t\t\t<Value type=\"string\" genre=\"system\" instance=\"1\" index=\"2\" label=\"Application Version\" units=\"\" read_only=\"true\" write_only=\"false\" verify_changes=\"false\" poll_intensity=\"0\" min=\"0\" max=\"0\" value=\"1.17\" />\n"
+		"\t\t\t</CommandClass>\n"
+		"\t\t</CommandClasses>\n"
+		"\t</Node>\n";
+
+//-----------------------------------------------------------------------------
+// <WriteSyntheticCache>
+// Write the cache of a network of c_nodeCount identical nodes for the driver to read
+//-----------------------------------------------------------------------------
+	void WriteSyntheticCache()
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "ozwcache_0x%08x.xml", Bench::c_homeId);
+		std::string filename = Bench::GetUserPath() + name;
+		FILE* file = fopen(filename.c_str(), "w");
+		if (!file)
+		{
+			fprintf(stderr, "Unable to write %s\n", filename.c_str());
+			exit(1);
+		}
+		fprintf(file, "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n");
+		fprintf(file, "<Driver xmlns=\"https://github.com/OpenZWave/open-zwave\" version=\"5\" home_id=\"0x%08x\" node_id=\"1\" api_capabilities=\"8\" controller_capabilities=\"28\" poll_interval=\"30000\" poll_interval_between=\"false\">\n", Bench::c_homeId);
+		for (uint32 id = 1; id <= c_nodeCount; ++id)
+		{
+			uint32 next = (id % c_nodeCount) + 1;
+			uint32 prev = ((id + c_nodeCount - 2) % c_nodeCount) + 1;
+			fprintf(file, c_nodeXML, id, id, id % 20, prev, next, id, id);
+		}
+		fprintf(file, "</Driver>\n");
+		fclose(file);
+	}
+
+//-----------------------------------------------------------------------------
+// <LoadNetwork>
+// Make sure the driver is running with the whole synthetic network loaded
+//-----------------------------------------------------------------------------
+	void LoadNetwork()
+	{
+		static bool s_written = false;
+		if (!s_written)
+		{
+			WriteSyntheticCache();
+			s_written = true;
+		}
+		if (!Bench::StartDriver(c_nodeCount))
+		{
+			fprintf(stderr, "The driver did not load the synthetic %u node cache\n", c_nodeCount);
+			exit(1);
+		}
+	}
+}
+
+OZW_BENCH(Driver_Restart232)
+{
+	// Remove the driver and add it again, as an application restarting would,
+	// until it has loaded every node from the cache and the controller's init data
+	LoadNetwork();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		Bench::StopDriver();
+		LoadNetwork();
+	}
+}
+
+OZW_BENCH(Driver_WriteCache232)
+{
+	// The nodes have not answered since the restart, so this is the save the
+	// driver makes before their interviews have moved on from the cache.  The
+	// Manager saves the (empty) scenes with it.
+	LoadNetwork();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		// Deprecated for applications, as the driver saves the cache by itself
+		OPENZWAVE_DEPRECATED_WARNINGS_OFF
+		Manager::Get()->WriteConfig(Bench::c_homeId);
+		OPENZWAVE_DEPRECATED_WARNINGS_ON
+	}
+}
@@ -0,0 +1,43 @@
+//-----------------------------------------------------------------------------
+//
+//	ManufacturerSpecificDB_bench.cpp
+//
+//	Benchmark loading the manufacturer and product database
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "Bench.h"
+#include "ManufacturerSpecificDB.h"
+
+using namespace OpenZWave::Internal;
+
+OZW_BENCH(ManufacturerSpecificDB_Load)
+{
+	// The Manager loaded it at startup; drop it and load it again from the config directory (or bundle)
+	ManufacturerSpecificDB* mfs = ManufacturerSpecificDB::Create();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		mfs->UnloadProductXML();
+		mfs->LoadProductXML();
+	}
+}
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+//
+//	Msg_bench.cpp
+//
+//	Benchmark building the messages sent to the controller
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "Bench.h"
+#include "Defs.h"
+#include "Msg.h"
+
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	uint8 const c_nodeId = 5;
+
+	// A COMMAND_CLASS_SWITCH_BINARY Set, as SwitchBinary::SetState builds it
+	Msg* BuildSet(uint8 _value)
+	{
+		Msg* msg = new Msg("SwitchBinaryCmd_Set", c_nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+		msg->Append(c_nodeId);
+		msg->Append(3);
+		msg->Append(0x25);
+		msg->Append(0x01);
+		msg->Append(_value);
+		msg->Append(TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE);
+		return msg;
+	}
+}
+
+OZW_BENCH(Msg_Construct)
+{
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		Msg* msg = BuildSet((uint8) i);
+		OpenZWave::Bench::DoNotOptimize(msg);
+		delete msg;
+	}
+}
+
+OZW_BENCH(Msg_ConstructFinalize)
+{
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		Msg* msg = BuildSet((uint8) i);
+		msg->Finalize();
+		OpenZWave::Bench::DoNotOptimize(msg->GetCallbackId());
+		delete msg;
+	}
+}
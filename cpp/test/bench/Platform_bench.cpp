@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+//
+//	Platform_bench.cpp
+//
+//	Benchmark the platform primitives the driver thread uses for every frame
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "Bench.h"
+#include "platform/Event.h"
+#include "platform/Log.h"
+#include "platform/Stream.h"
+#include "platform/Wait.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	// The driver thread waits on its exit event, the controller and one event per send queue
+	uint32 const c_waitCount = 9;
+
+	Platform::Wait** GetWaits()
+	{
+		static Platform::Wait* s_waits[c_waitCount] =
+		{ NULL };
+		if (!s_waits[0])
+		{
+			for (uint32 i = 0; i < c_waitCount; ++i)
+			{
+				s_waits[i] = new Platform::Event();
+			}
+		}
+		return s_waits;
+	}
+}
+
+OZW_BENCH(Stream_PutGet)
+{
+	// A typical SendData callback frame, as the serial controller queues it and the driver reads it
+	static Platform::Stream* s_stream = new Platform::Stream(256);
+	uint8 frame[7] =
+	{ 0x01, 0x05, 0x00, 0x13, 0x01, 0x00, 0xe8 };
+	uint8 out[7];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		frame[4] = (uint8) i;
+		s_stream->Put(frame, sizeof(frame));
+		s_stream->Get(out, sizeof(out));
+	}
+	Bench::DoNotOptimize(out);
+}
+
+OZW_BENCH(Wait_MultipleSignalled)
+{
+	Platform::Wait** waits = GetWaits();
+	Platform::Event* last = static_cast<Platform::Event*>(waits[c_waitCount - 1]);
+	last->Set();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		int32 res = Platform::Wait::Multiple(waits, c_waitCount, 0);
+		Bench::DoNotOptimize(res);
+	}
+	last->Reset();
+}
+
+OZW_BENCH(Wait_MultipleTimeout)
+{
+	// Nothing is signalled, so this is the cost of polling the objects
+	Platform::Wait** waits = GetWaits();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		int32 res = Platform::Wait::Multiple(waits, c_waitCount, 0);
+		Bench::DoNotOptimize(res);
+	}
+}
+
+OZW_BENCH(Log_WriteDisabled)
+{
+	// ozw-bench only saves warnings, so this level is filtered out
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		Log::Write(LogLevel_Detail, 5, "Received: 0x%.2x, 0x%.2x, 0x%.2x", 0x01, (uint32) (i & 0xff), 0x13);
+	}
+}
+
+OZW_BENCH(Log_WriteDisabledString)
+{
+	// Callers often build a string for the log before it is filtered out
+	std::string const text = "SwitchBinaryCmd_Set (Node=5): 0x01, 0x0a, 0x00, 0x13, 0x05, 0x03, 0x25, 0x01, 0xff, 0x25, 0x0c, 0x2e";
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		Log::Write(LogLevel_Info, 5, "Sending (%s) message (Callback ID=0x%.2x): %s", "Send", (uint32) (i & 0xff), text.c_str());
+	}
+}
@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueStore_bench.cpp
+//
+//	Benchmark adding values to, and finding them in, a node's value store
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <map>
+#include "Bench.h"
+#include "value_classes/ValueStore.h"
+#include "value_classes/ValueByte.h"
+#include "value_classes/ValueDecimal.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	// Not one of the nodes of the synthetic network Driver_bench loads
+	uint8 const c_nodeId = 240;
+
+	// About what a multi sensor with a few configuration parameters has
+	uint32 const c_valueCount = 64;
+
+	void AddValues(VC::ValueStore* _store)
+	{
+		// Values notify the driver when they are added to a store
+		Bench::GetDriver();
+		for (uint16 i = 0; i < c_valueCount / 2; ++i)
+		{
+			VC::Value* value = new VC::ValueDecimal(Bench::c_homeId, c_nodeId, ValueID::ValueGenre_User, 0x31, 1, i, "Sensor", "C", true, false, "21.5", 0);
+			_store->AddValue(value);
+			value->Release();
+			value = new VC::ValueByte(Bench::c_homeId, c_nodeId, ValueID::ValueGenre_Config, 0x70, 1, i, "Parameter", "", false, false, 0, 0);
+			_store->AddValue(value);
+			value->Release();
+		}
+	}
+
+	VC::ValueStore* GetFullStore()
+	{
+		static VC::ValueStore* s_store = NULL;
+		if (!s_store)
+		{
+			s_store = new VC::ValueStore();
+			AddValues(s_store);
+		}
+		return s_store;
+	}
+}
+
+OZW_BENCH(ValueStore_AddRemove64)
+{
+	// Every node creates and fills a store as it is interviewed or loaded, and empties it when it goes
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		VC::ValueStore* store = new VC::ValueStore();
+		AddValues(store);
+		delete store;
+	}
+}
+
+OZW_BENCH(ValueStore_GetValue)
+{
+	VC::ValueStore* store = GetFullStore();
+	uint32 keys[c_valueCount];
+	uint32 count = 0;
+	for (VC::ValueStore::Iterator it = store->Begin(); it != store->End(); ++it)
+	{
+		keys[count++] = it->first;
+	}
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		VC::Value* value = store->GetValue(keys[i % c_valueCount]);
+		Bench::DoNotOptimize(value);
+	}
+}
+
+OZW_BENCH(ValueStore_GetValue_StdMap)
+{
+	// The std::map the ValueStore used to be, holding the same values, as the baseline for ValueStore_GetValue
+	VC::ValueStore* store = GetFullStore();
+	std::map<uint32, VC::Value*> map;
+	uint32 keys[c_valueCount];
+	uint32 count = 0;
+	for (VC::ValueStore::Iterator it = store->Begin(); it != store->End(); ++it)
+	{
+		map[it->first] = it->second;
+		keys[count++] = it->first;
+	}
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		VC::Value* value = NULL;
+		std::map<uint32, VC::Value*>::const_iterator it = map.find(keys[i % c_valueCount]);
+		if (it != map.end())
+		{
+			value = it->second;
+			value->AddRef();
+		}
+		Bench::DoNotOptimize(value);
+	}
+}
+
+OZW_BENCH(ValueStore_GetValueMissing)
+{
+	// Command classes look for values that may not have been created yet
+	VC::ValueStore* store = GetFullStore();
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		VC::Value* value = store->GetValue(ValueID::GetValueStoreKey(0x25, 1, (uint16) (i & 0xff)));
+		Bench::DoNotOptimize(value);
+	}
+}
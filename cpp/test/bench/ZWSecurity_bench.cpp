@@ -0,0 +1,128 @@
+//-----------------------------------------------------------------------------
+//
+//	ZWSecurity_bench.cpp
+//
+//	Benchmark encrypting, decrypting and authenticating S0 frames
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Bench.h"
+#include "Defs.h"
+#include "Driver.h"
+#include "Msg.h"
+#include "ZWSecurity.h"
+
+using namespace OpenZWave;
+using namespace OpenZWave::Internal;
+
+namespace
+{
+	uint8 const c_controllerId = 1;
+	uint8 const c_nodeId = 9;
+	uint8 const c_nonce[8] =
+	{ 0x09, 0x0d, 0x93, 0xd3, 0x61, 0x61, 0x1d, 0xd6 };
+
+	struct Frame
+	{
+			uint8 m_plain[256];
+			uint8 m_plainLength;
+			uint8 m_encrypted[256];
+	};
+
+//-----------------------------------------------------------------------------
+// <GetFrame>
+// A finalized ConfigurationCmd_Set and its encrypted form, checked to decrypt
+//-----------------------------------------------------------------------------
+	Frame& GetFrame()
+	{
+		static Frame* s_frame = NULL;
+		if (s_frame)
+		{
+			return *s_frame;
+		}
+		s_frame = new Frame();
+
+		Msg msg("ConfigurationCmd_Set", c_nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true);
+		uint8 const payload[] =
+		{ c_nodeId, 8, 0x70, 0x04, 0x05, 0x04, 0x00, 0x00, 0x0e, 0x10 };
+		msg.AppendArray(payload, sizeof(payload));
+		msg.Append(TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE);
+		msg.Finalize();
+		s_frame->m_plainLength = (uint8) msg.GetLength();
+		memcpy(s_frame->m_plain, msg.GetBuffer(), s_frame->m_plainLength);
+
+		Driver* driver = Bench::GetDriver();
+		EncryptBuffer(s_frame->m_plain, s_frame->m_plainLength, driver, c_controllerId, c_nodeId, c_nonce, s_frame->m_encrypted);
+
+		// Decrypting must give back the command, or the benchmarks would time the failure path
+		uint8 decrypted[32];
+		if (!DecryptBuffer(&s_frame->m_encrypted[6], s_frame->m_encrypted[5] + 1, driver, c_controllerId, c_nodeId, c_nonce, decrypted) || memcmp(&decrypted[1], &payload[2], payload[1]) != 0)
+		{
+			fprintf(stderr, "S0 frame did not decrypt to the original command\n");
+			exit(1);
+		}
+		return *s_frame;
+	}
+}
+
+OZW_BENCH(ZWSecurity_EncryptBuffer)
+{
+	Frame& frame = GetFrame();
+	Driver* driver = Bench::GetDriver();
+	uint8 encrypted[256];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		EncryptBuffer(frame.m_plain, frame.m_plainLength, driver, c_controllerId, c_nodeId, c_nonce, encrypted);
+		Bench::DoNotOptimize(encrypted);
+	}
+}
+
+OZW_BENCH(ZWSecurity_DecryptBuffer)
+{
+	Frame& frame = GetFrame();
+	Driver* driver = Bench::GetDriver();
+	uint8 decrypted[32];
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		bool ok = DecryptBuffer(&frame.m_encrypted[6], frame.m_encrypted[5] + 1, driver, c_controllerId, c_nodeId, c_nonce, decrypted);
+		Bench::DoNotOptimize(ok);
+	}
+}
+
+OZW_BENCH(ZWSecurity_GenerateAuthentication)
+{
+	Frame& frame = GetFrame();
+	Driver* driver = Bench::GetDriver();
+	uint8 iv[16];
+	uint8 mac[8];
+	memcpy(iv, &frame.m_encrypted[8], 8);
+	memcpy(&iv[8], c_nonce, 8);
+	for (uint64 i = 0; i < _iterations; ++i)
+	{
+		GenerateAuthentication(&frame.m_encrypted[7], frame.m_encrypted[5], driver, c_controllerId, c_nodeId, iv, mac);
+		Bench::DoNotOptimize(mac);
+	}
+}
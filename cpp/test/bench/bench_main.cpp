@@ -0,0 +1,420 @@
+//-----------------------------------------------------------------------------
+//
+//	bench_main.cpp
+//
+//	Run the micro-benchmarks and report the time per operation
+//
+//	Copyright (c) 2020
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+//
+// Usage: ozw-bench [--json] [--filter <substring>] [--min-time <ms>]
+//                  [--config <config directory>] [--user <user directory>]
+//
+// Each benchmark is run once to warm up, then sized so one run takes at least
+// --min-time milliseconds (default 200), then run five times.  The median, min
+// and max time per operation are reported, as a table or (with --json) as a
+// JSON document that can be kept and compared with the results of another
+// commit.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include "Bench.h"
+#include "Driver.h"
+#include "Manager.h"
+#include "Msg.h"
+#include "Notification.h"
+#include "Options.h"
+#include "platform/Log.h"
+#include "platform/SerialCapture.h"
+
+using namespace OpenZWave;
+
+namespace
+{
+	uint32 const c_repeats = 5;
+
+	struct Result
+	{
+			char const* m_name;
+			uint64 m_iterations;
+			double m_median;
+			double m_min;
+			double m_max;
+	};
+
+	std::string s_userPath = "./";
+
+	// How long StartDriver waits for the driver to add the nodes
+	std::chrono::seconds const c_startTimeout(10);
+
+	// The captures written so far, by the number of nodes they report
+	std::map<uint32, std::string> s_captures;
+
+	// The capture the driver is replaying, and how many nodes it reports
+	std::string s_controllerPath;
+	uint32 s_driverNodes = 0;
+
+	// The nodes the driver has added, counted by OnNotification
+	std::mutex s_nodesMutex;
+	std::condition_variable s_nodesAdded;
+	uint32 s_nodesAddedCount = 0;
+
+//-----------------------------------------------------------------------------
+// <TimeRun>
+// Time one run of a benchmark, in nanoseconds
+//-----------------------------------------------------------------------------
+	double TimeRun(Bench::pfnBenchmark_t _fn, uint64 _iterations)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		_fn(_iterations);
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+//-----------------------------------------------------------------------------
+// <Run>
+// Size a benchmark for the minimum run time and time it
+//-----------------------------------------------------------------------------
+	Result Run(Bench::Benchmark const& _bench, double _minTime)
+	{
+		// The first run also does any lazy setup, so it is never counted
+		TimeRun(_bench.m_fn, 1);
+
+		uint64 n = 1;
+		double ns = TimeRun(_bench.m_fn, n);
+		while (ns < 10e6 && n < (1ull << 40))
+		{
+			n *= 10;
+			ns = TimeRun(_bench.m_fn, n);
+		}
+		if (ns < _minTime)
+		{
+			n = (uint64) ((double) n * _minTime / ns) + 1;
+		}
+
+		double perOp[c_repeats];
+		for (uint32 i = 0; i < c_repeats; ++i)
+		{
+			perOp[i] = TimeRun(_bench.m_fn, n) / (double) n;
+		}
+		std::sort(perOp, perOp + c_repeats);
+
+		Result result =
+		{ _bench.m_name, n, perOp[c_repeats / 2], perOp[0], perOp[c_repeats - 1] };
+		return result;
+	}
+
+	void PrintJSON(std::vector<Result> const& _results)
+	{
+		printf("{\n  \"version\": \"%s\",\n  \"benchmarks\": [\n", Manager::getVersionLongAsString().c_str());
+		for (size_t i = 0; i < _results.size(); ++i)
+		{
+			Result const& r = _results[i];
+			printf("    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.2f, \"min_ns\": %.2f, \"max_ns\": %.2f}%s\n", r.m_name, (unsigned long long) r.m_iterations, r.m_median, r.m_min, r.m_max, (i + 1 < _results.size()) ? "," : "");
+		}
+		printf("  ]\n}\n");
+	}
+
+	void PrintTable(Result const& _result)
+	{
+		printf("%-40s %12llu %14.1f %14.1f %14.1f\n", _result.m_name, (unsigned long long) _result.m_iterations, _result.m_median, _result.m_min, _result.m_max);
+		fflush(stdout);
+	}
+
+//-----------------------------------------------------------------------------
+// <OnNotification>
+// Count the nodes the bench driver adds
+//-----------------------------------------------------------------------------
+	void OnNotification(Notification const* _notification, void* _context)
+	{
+		if ((_notification->GetType() == Notification::Type_NodeAdded) && (_notification->GetHomeId() == Bench::c_homeId))
+		{
+			std::lock_guard<std::mutex> lock(s_nodesMutex);
+			++s_nodesAddedCount;
+			s_nodesAdded.notify_all();
+		}
+	}
+
+//-----------------------------------------------------------------------------
+// <WriteFrame>
+// Append a serial API frame, with its length and checksum, to a capture
+//-----------------------------------------------------------------------------
+	void WriteFrame(Internal::Platform::SerialCapture* _capture, Internal::Platform::SerialCapture::Direction _direction, uint8 _type, uint8 _function, std::vector<uint8> const& _data)
+	{
+		std::vector<uint8> frame;
+		frame.push_back(SOF);
+		frame.push_back((uint8) (_data.size() + 3));
+		frame.push_back(_type);
+		frame.push_back(_function);
+		frame.insert(frame.end(), _data.begin(), _data.end());
+		uint8 checksum = 0xff;
+		for (size_t i = 1; i < frame.size(); ++i)
+		{
+			checksum ^= frame[i];
+		}
+		frame.push_back(checksum);
+		_capture->Write(_direction, &frame[0], (uint32) frame.size());
+	}
+
+//-----------------------------------------------------------------------------
+// <WriteExchange>
+// Append a request from the driver, and the controller's ACK and response
+//-----------------------------------------------------------------------------
+	void WriteExchange(Internal::Platform::SerialCapture* _capture, uint8 _function, std::vector<uint8> const& _response)
+	{
+		uint8 const ack = ACK;
+		WriteFrame(_capture, Internal::Platform::SerialCapture::Direction_Out, REQUEST, _function, std::vector<uint8>());
+		_capture->Write(Internal::Platform::SerialCapture::Direction_In, &ack, 1);
+		WriteFrame(_capture, Internal::Platform::SerialCapture::Direction_In, RESPONSE, _function, _response);
+		_capture->Write(Internal::Platform::SerialCapture::Direction_Out, &ack, 1);
+	}
+
+//-----------------------------------------------------------------------------
+// <WriteCapture>
+// Write a capture of a controller on c_homeId with nodes 1 to _nodeCount, up
+// to the point where the driver reads its cache
+//-----------------------------------------------------------------------------
+	std::string WriteCapture(uint32 _nodeCount)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "ozw-bench-%u.cap", _nodeCount);
+		std::string path = s_userPath + name;
+		Internal::Platform::SerialCapture* capture = Internal::Platform::SerialCapture::Create(path);
+		if (!capture)
+		{
+			return "";
+		}
+
+		// The driver NAKs anything the controller sent before it was opened
+		uint8 const nak = NAK;
+		capture->Write(Internal::Platform::SerialCapture::Direction_Out, &nak, 1);
+
+		char const version[] = "Z-Wave 4.05";
+		std::vector<uint8> data(version, version + sizeof(version));
+		data.push_back(0x01);
+		WriteExchange(capture, FUNC_ID_ZW_GET_VERSION, data);
+
+		uint8 const memoryId[] =
+		{ (uint8) (Bench::c_homeId >> 24), (uint8) (Bench::c_homeId >> 16), (uint8) (Bench::c_homeId >> 8), (uint8) Bench::c_homeId, 1 };
+		WriteExchange(capture, FUNC_ID_ZW_MEMORY_GET_ID, std::vector<uint8>(memoryId, memoryId + sizeof(memoryId)));
+
+		WriteExchange(capture, FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES, std::vector<uint8>(1, 0x1c));
+		WriteExchange(capture, FUNC_ID_ZW_GET_SUC_NODE_ID, std::vector<uint8>(1, 1));
+
+		// No optional functions, so the driver goes straight on to the init data
+		uint8 const capabilities[] =
+		{ 1, 0, 0x00, 0x86, 0x00, 0x01, 0x00, 0x5a };
+		data.assign(capabilities, capabilities + sizeof(capabilities));
+		data.resize(data.size() + 32, 0);
+		WriteExchange(capture, FUNC_ID_SERIAL_API_GET_CAPABILITIES, data);
+
+		uint8 const initData[] =
+		{ 5, 0x08, NUM_NODE_BITFIELD_BYTES };
+		data.assign(initData, initData + sizeof(initData));
+		data.resize(data.size() + NUM_NODE_BITFIELD_BYTES, 0);
+		for (uint32 id = 1; id <= _nodeCount && id <= NUM_NODE_BITFIELD_BYTES * 8; ++id)
+		{
+			data[sizeof(initData) + (id - 1) / 8] |= (uint8) (1 << ((id - 1) % 8));
+		}
+		data.push_back(0x05);
+		data.push_back(0x00);
+		WriteExchange(capture, FUNC_ID_SERIAL_API_GET_INIT_DATA, data);
+
+		delete capture;
+		return path;
+	}
+
+	void Usage(char const* _name)
+	{
+		fprintf(stderr, "Usage: %s [--json] [--filter <substring>] [--min-time <ms>] [--config <dir>] [--user <dir>]\n", _name);
+	}
+}
+
+namespace OpenZWave
+{
+	namespace Bench
+	{
+		std::vector<Benchmark>& GetBenchmarks()
+		{
+			static std::vector<Benchmark> s_benchmarks;
+			return s_benchmarks;
+		}
+
+		std::string const& GetUserPath()
+		{
+			return s_userPath;
+		}
+
+//-----------------------------------------------------------------------------
+// <Bench::StartDriver>
+// Add a driver on a replayed controller and wait for its nodes
+//-----------------------------------------------------------------------------
+		bool StartDriver(uint32 _nodeCount)
+		{
+			if (!s_controllerPath.empty() && (s_driverNodes == _nodeCount))
+			{
+				return true;
+			}
+			StopDriver();
+
+			// Each capture is written once, and replayed by every driver after that
+			std::string& path = s_captures[_nodeCount];
+			if (path.empty())
+			{
+				path = WriteCapture(_nodeCount);
+			}
+
+			std::unique_lock<std::mutex> lock(s_nodesMutex);
+			s_nodesAddedCount = 0;
+			if (path.empty() || !Manager::Get()->AddDriver(path, Driver::ControllerInterface_Replay))
+			{
+				return false;
+			}
+			s_controllerPath = path;
+			s_driverNodes = _nodeCount;
+
+			// Nodes read from the cache are added as well as those the controller reports
+			return s_nodesAdded.wait_for(lock, c_startTimeout, []
+			{	return s_nodesAddedCount >= s_driverNodes;});
+		}
+
+//-----------------------------------------------------------------------------
+// <Bench::StopDriver>
+// Remove the bench driver
+//-----------------------------------------------------------------------------
+		void StopDriver()
+		{
+			if (!s_controllerPath.empty())
+			{
+				Manager::Get()->RemoveDriver(s_controllerPath);
+				s_controllerPath.clear();
+				s_driverNodes = 0;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <Bench::GetDriver>
+// Find the bench driver the way the rest of the library does
+//-----------------------------------------------------------------------------
+		Driver* GetDriver()
+		{
+			if (s_controllerPath.empty() && !StartDriver(1))
+			{
+				fprintf(stderr, "The bench driver did not start\n");
+				exit(1);
+			}
+			Internal::Msg msg("Bench", 0xff, REQUEST, FUNC_ID_ZW_GET_VERSION, false);
+			msg.SetHomeId(c_homeId);
+			return msg.GetDriver();
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	char const* filter = NULL;
+	double minTime = 200e6;
+	std::string configPath = "../../../config/";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--json"))
+		{
+			json = true;
+		}
+		else if (!strcmp(argv[i], "--filter") && (i + 1 < argc))
+		{
+			filter = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--min-time") && (i + 1 < argc))
+		{
+			minTime = atof(argv[++i]) * 1e6;
+		}
+		else if (!strcmp(argv[i], "--config") && (i + 1 < argc))
+		{
+			configPath = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--user") && (i + 1 < argc))
+		{
+			s_userPath = argv[++i];
+		}
+		else
+		{
+			Usage(argv[0]);
+			return 1;
+		}
+	}
+	if (s_userPath.empty() || s_userPath[s_userPath.size() - 1] != '/')
+	{
+		s_userPath += "/";
+	}
+
+	// Only warnings are logged, so the Log::Write benchmarks measure the cost of a disabled level
+	Options::Create(configPath, s_userPath, "");
+	Options::Get()->AddOptionString("LogFileName", "ozw-bench.log", false);
+	Options::Get()->AddOptionBool("ConsoleOutput", false);
+	Options::Get()->AddOptionInt("SaveLogLevel", LogLevel_Warning);
+	Options::Get()->AddOptionInt("QueueLogLevel", LogLevel_Warning);
+	Options::Get()->AddOptionBool("SaveConfiguration", false);
+	Options::Get()->AddOptionBool("SerialReplayRealtime", false);
+	Options::Get()->AddOptionString("NetworkKey", "0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,0x10", false);
+	Options::Get()->Lock();
+	Manager::Create();
+	Manager::Get()->AddWatcher(OnNotification, NULL);
+
+	std::vector<Bench::Benchmark> const& benchmarks = Bench::GetBenchmarks();
+	std::vector<Result> results;
+	if (!json)
+	{
+		printf("%-40s %12s %14s %14s %14s\n", "Benchmark", "Iterations", "ns/op", "min ns/op", "max ns/op");
+	}
+	for (size_t i = 0; i < benchmarks.size(); ++i)
+	{
+		if (filter && !strstr(benchmarks[i].m_name, filter))
+		{
+			continue;
+		}
+		Result result = Run(benchmarks[i], minTime);
+		results.push_back(result);
+		if (!json)
+		{
+			PrintTable(result);
+		}
+	}
+	if (json)
+	{
+		PrintJSON(results);
+	}
+
+	Bench::StopDriver();
+	Manager::Get()->RemoveWatcher(OnNotification, NULL);
+	Manager::Destroy();
+	Options::Destroy();
+	return 0;
+}
@@ -1519,6 +1519,7 @@ DISTFILES =	.gitignore \
 	cpp/build/OZW_RunTests.sh \
 	cpp/build/libopenzwave.pc.in \
 	cpp/build/ozw_config.in \
+	cpp/build/ozw_config_bundle.cpp \
 	cpp/build/sh2ju.sh \
 	cpp/build/support.mk \
 	cpp/build/testconfig.pl \
@@ -1587,10 +1588,20 @@ DISTFILES =	.gitignore \
 	cpp/hidapi/windows/hidapi.sln \
 	cpp/hidapi/windows/hidapi.vcproj \
 	cpp/hidapi/windows/hidtest.vcproj \
+	cpp/src/AESKey.cpp \
+	cpp/src/AESKey.h \
+	cpp/src/AirtimeCounter.cpp \
+	cpp/src/AirtimeCounter.h \
+	cpp/src/AirtimeThrottle.cpp \
+	cpp/src/AirtimeThrottle.h \
 	cpp/src/Bitfield.cpp \
 	cpp/src/Bitfield.h \
 	cpp/src/CompatOptionManager.cpp \
 	cpp/src/CompatOptionManager.h \
+	cpp/src/ConfigBundle.cpp \
+	cpp/src/ConfigBundle.h \
+	cpp/src/ConfigLoader.cpp \
+	cpp/src/ConfigLoader.h \
 	cpp/src/DNSThread.cpp \
 	cpp/src/DNSThread.h \
 	cpp/src/Defs.h \
@@ -1601,16 +1612,22 @@ DISTFILES =	.gitignore \
 	cpp/src/Group.h \
 	cpp/src/Http.cpp \
 	cpp/src/Http.h \
+	cpp/src/LatencyHistogram.cpp \
+	cpp/src/LatencyHistogram.h \
 	cpp/src/Localization.cpp \
 	cpp/src/Localization.h \
 	cpp/src/Manager.cpp \
 	cpp/src/Manager.h \
 	cpp/src/ManufacturerSpecificDB.cpp \
 	cpp/src/ManufacturerSpecificDB.h \
+	cpp/src/MetricsExporter.cpp \
+	cpp/src/MetricsExporter.h \
 	cpp/src/Msg.cpp \
 	cpp/src/Msg.h \
 	cpp/src/Node.cpp \
 	cpp/src/Node.h \
+	cpp/src/NoncePool.cpp \
+	cpp/src/NoncePool.h \
 	cpp/src/Notification.cpp \
 	cpp/src/Notification.h \
 	cpp/src/NotificationCCTypes.cpp \
@@ -1622,6 +1639,8 @@ DISTFILES =	.gitignore \
 	cpp/src/Scene.h \
 	cpp/src/SensorMultiLevelCCTypes.cpp \
 	cpp/src/SensorMultiLevelCCTypes.h \
+	cpp/src/StringPool.cpp \
+	cpp/src/StringPool.h \
 	cpp/src/TimerThread.cpp \
 	cpp/src/TimerThread.h \
 	cpp/src/Utils.cpp \
@@ -1781,6 +1800,10 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/Mutex.cpp \
 	cpp/src/platform/Mutex.h \
 	cpp/src/platform/Ref.h \
+	cpp/src/platform/ReplayController.cpp \
+	cpp/src/platform/ReplayController.h \
+	cpp/src/platform/SerialCapture.cpp \
+	cpp/src/platform/SerialCapture.h \
 	cpp/src/platform/SerialController.cpp \
 	cpp/src/platform/SerialController.h \
 	cpp/src/platform/Stream.cpp \
@@ -1789,6 +1812,8 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/Thread.h \
 	cpp/src/platform/TimeStamp.cpp \
 	cpp/src/platform/TimeStamp.h \
+	cpp/src/platform/Trace.cpp \
+	cpp/src/platform/Trace.h \
 	cpp/src/platform/Wait.cpp \
 	cpp/src/platform/Wait.h \
 	cpp/src/platform/unix/DNSImpl.cpp \
@@ -1860,6 +1885,8 @@ DISTFILES =	.gitignore \
 	cpp/src/value_classes/ValueByte.h \
 	cpp/src/value_classes/ValueDecimal.cpp \
 	cpp/src/value_classes/ValueDecimal.h \
+	cpp/src/value_classes/ValueHandle.cpp \
+	cpp/src/value_classes/ValueHandle.h \
 	cpp/src/value_classes/ValueID.cpp \
 	cpp/src/value_classes/ValueID.h \
 	cpp/src/value_classes/ValueInt.cpp \
@@ -1877,7 +1904,19 @@ DISTFILES =	.gitignore \
 	cpp/src/value_classes/ValueString.cpp \
 	cpp/src/value_classes/ValueString.h \
 	cpp/test/Makefile \
+	cpp/test/Configuration_test.cpp \
+	cpp/test/Localization_test.cpp \
 	cpp/test/ValueID_test.cpp \
+	cpp/test/bench/AES_bench.cpp \
+	cpp/test/bench/Bench.h \
+	cpp/test/bench/CommandClass_bench.cpp \
+	cpp/test/bench/Driver_bench.cpp \
+	cpp/test/bench/ManufacturerSpecificDB_bench.cpp \
+	cpp/test/bench/Msg_bench.cpp \
+	cpp/test/bench/Platform_bench.cpp \
+	cpp/test/bench/ValueStore_bench.cpp \
+	cpp/test/bench/ZWSecurity_bench.cpp \
+	cpp/test/bench/bench_main.cpp \
 	cpp/test/include/gtest/gtest-death-test.h \
 	cpp/test/include/gtest/gtest-matchers.h \
 	cpp/test/include/gtest/gtest-message.h \